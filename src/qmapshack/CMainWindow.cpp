@@ -48,6 +48,7 @@
 #include "map/CMapDraw.h"
 #include "map/CMapItem.h"
 #include "map/CMapList.h"
+#include "map/CTileScheduler.h"
 #include "print/CScreenshotDialog.h"
 #include "realtime/CRtWorkspace.h"
 #include "setup/IAppSetup.h"
@@ -111,6 +112,7 @@ CMainWindow::CMainWindow()
     IGisItem::init();
     CGisItemWpt::init();
     wptIconManager = new CWptIconManager(this);
+    tileScheduler = new CTileScheduler(this);
 
     IUnit::setUnitType((IUnit::type_e)cfg.value("MainWindow/units", IUnit::eTypeMetric).toInt(), this);
     IUnit::setSlopeMode((IUnit::slope_mode_e)cfg.value("Units/slopeMode", IUnit::eSlopeDegrees).toInt());
@@ -36,6 +36,7 @@ class CGeoSearchConfig;
 class CToolBarConfig;
 class CGeoSearchWeb;
 struct SGisLine;
+class CTileScheduler;
 class CWptIconManager;
 class CHelp;
 
@@ -244,6 +245,7 @@ private:
 
     CGeoSearchWeb * geoSearchWeb;
     CWptIconManager * wptIconManager;
+    CTileScheduler * tileScheduler;
 
     QList<QDockWidget *> docks;
     QList<QDockWidget *> activeDocks;
@@ -212,6 +212,67 @@ qreal GPS_Math_DistanceQuick(const qreal u1, const qreal v1, const qreal u2, con
 }
 
 
+void GPS_Math_Distance(const qreal * lon, const qreal * lat, qint32 N, qreal * dist, qreal maxError)
+{
+    if(N <= 0)
+    {
+        return;
+    }
+
+    dist[0] = 0;
+
+    if(maxError <= 0)
+    {
+        for(qint32 i = 1; i < N; i++)
+        {
+            dist[i] = GPS_Math_Distance(lon[i - 1], lat[i - 1], lon[i], lat[i]);
+        }
+        return;
+    }
+
+    const qreal a  = 6378137.0, f = 1.0 / 298.257223563;  // WGS-84 ellipsiod
+    const qreal e2 = f * (2 - f);
+
+    QVector<qreal> cosLat(N);
+    qreal * c = cosLat.data();
+    for(qint32 i = 0; i < N; i++)
+    {
+        c[i] = qCos(lat[i]);
+    }
+
+    // Pass 1: Approximate the ellipsoid locally by the radii of curvature in the
+    // meridian (M) and the prime vertical (N) at the segment's mean latitude. There
+    // are no branches in this loop. Thus it can be vectorized by the compiler.
+    for(qint32 i = 1; i < N; i++)
+    {
+        const qreal cosPhi = 0.5 * (c[i - 1] + c[i]);
+        const qreal w      = 1 - e2 * (1 - cosPhi * cosPhi);
+        const qreal radN   = a / qSqrt(w);
+        const qreal radM   = radN * (1 - e2) / w;
+
+        qreal dLon = lon[i] - lon[i - 1];
+        dLon = dLon > PI ? dLon - TWOPI : (dLon < -PI ? dLon + TWOPI : dLon);
+
+        const qreal x = radN * cosPhi * dLon;
+        const qreal y = radM * (lat[i] - lat[i - 1]);
+        dist[i] = qSqrt(x * x + y * y);
+    }
+
+    // Pass 2: The error of the approximation is below d^3 / (12 * a^2 * cos^2(phi)).
+    // Compute all segments exceeding maxError by Vincenty's formula.
+    const qreal limit = 12 * a * a * maxError;
+    for(qint32 i = 1; i < N; i++)
+    {
+        const qreal cosPhi = 0.5 * (c[i - 1] + c[i]);
+        const qreal d      = dist[i];
+        if(d * d * d > limit * cosPhi * cosPhi)
+        {
+            dist[i] = GPS_Math_Distance(lon[i - 1], lat[i - 1], lon[i], lat[i]);
+        }
+    }
+}
+
+
 static qreal GPS_Math_distPointLine3D(const point3D &x1, const point3D &x2, const point3D &x0)
 {
     point3D v1, v2, v3, v1x2;
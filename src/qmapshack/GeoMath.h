@@ -70,6 +70,23 @@ qreal   GPS_Math_Distance(const qreal u1, const qreal v1, const qreal u2, const
 qreal   GPS_Math_Distance(const qreal u1, const qreal v1, const qreal u2, const qreal v2);
 /// use for short distances, much quicker processing
 qreal   GPS_Math_DistanceQuick(const qreal u1, const qreal v1, const qreal u2, const qreal v2);
+/**
+   @brief Get the distances between consecutive points of a line
+
+   All segments are computed by a local ellipsoidal approximation first. Every
+   segment whose error might exceed maxError is computed again by Vincenty's
+   formula. The error of the approximation grows with the cube of the segment's
+   length and the inverse square of the cosine of it's latitude. Thus short
+   segments are computed by the quick path while long segments or segments
+   close to the poles fall back to Vincenty's formula.
+
+   @param lon       the longitude of each point [rad]
+   @param lat       the latitude of each point [rad]
+   @param N         the number of points
+   @param dist      an array of N elements receiving the distance to the previous point [m], dist[0] is 0
+   @param maxError  the max. acceptable error per segment [m], 0 will use Vincenty's formula for all segments
+ */
+void    GPS_Math_Distance(const qreal * lon, const qreal * lat, qint32 N, qreal * dist, qreal maxError);
 void    GPS_Math_DouglasPeucker(QVector<pointDP>& line, qreal d);
 QPointF GPS_Math_Wpt_Projection(const QPointF& pt1, qreal distance, qreal bearing);
 bool    GPS_Math_LineCrossesRect(const QPointF& p1, const QPointF& p2, const QRectF& rect);
@@ -1086,6 +1086,11 @@ void CCanvas::convertPx2Rad(QPointF& pos) const
     map->convertPx2Rad(pos);
 }
 
+void CCanvas::convertPx2M(QPointF& pos) const
+{
+    map->convertPx2M(pos);
+}
+
 void CCanvas::displayInfo(const QPoint& px)
 {
     if(CMainWindow::self().isMapToolTip())
@@ -1268,14 +1273,76 @@ bool CCanvas::setDrawContextSize(const QSize& s)
 
 void CCanvas::print(QPainter& p, const QRectF& area, const QPointF& focus, bool printScale)
 {
-    const QSize oldSize = size();
-    const QSize newSize(area.size().toSize());
+    const QSize size(area.size().toSize());
+    printArea(p, size, focus, QRect(QPoint(0, 0), size), printScale ? QRectF(QPointF(0, 0), size) : QRectF());
+}
+
+bool CCanvas::printTiled(const QSize& area, const QPointF& focus, const QSize& tileSize, bool printScale,
+                         const std::function<bool(const QImage&, const QPoint&)>& sink)
+{
+    // derive the tile's centers from the area's center in pixel. This has to be done
+    // in advance as rendering a tile will change the draw context's point of focus.
+    QPointF center = focus;
+    map->convertRad2Px(center);
+    const QPointF topLeft = center - QPointF(area.width(), area.height()) / 2;
+
+    QList<QRect> tiles;
+    QList<QPointF> centers;
+    for(int y = 0; y < area.height(); y += tileSize.height())
+    {
+        for(int x = 0; x < area.width(); x += tileSize.width())
+        {
+            const QRect tile(x, y, qMin(tileSize.width(), area.width() - x), qMin(tileSize.height(), area.height() - y));
+
+            QPointF focusTile = topLeft + QPointF(tile.x() + tile.width() / 2.0, tile.y() + tile.height() / 2.0);
+            map->convertPx2Rad(focusTile);
+
+            tiles << tile;
+            centers << focusTile;
+        }
+    }
+
+    // Each tile is rendered with a margin. Thus icons and labels of items close to
+    // the tile's border are drawn, even if the item itself is in the next tile.
+    const QSize margin(DIRTY_AREA_MARGIN, DIRTY_AREA_MARGIN);
+
+    const int N = tiles.size();
+    for(int n = 0; n < N; n++)
+    {
+        const QRect& rect = tiles[n];
+
+        QImage tile(rect.size(), QImage::Format_ARGB32_Premultiplied);
+        tile.fill(Qt::transparent);
+
+        QPainter p(&tile);
+        USE_ANTI_ALIASING(p, true);
+        p.translate(-margin.width(), -margin.height());
+
+        // the grid and the scale are aligned to the whole area, the tile will just clip them
+        const QPoint offset = QPoint(margin.width(), margin.height()) - rect.topLeft();
+        printArea(p, rect.size() + margin * 2, centers[n], QRect(offset, area), printScale ? QRectF(offset, area) : QRectF());
+        p.end();
+
+        if(!sink(tile, rect.topLeft()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void CCanvas::printArea(QPainter& p, const QSize& size, const QPointF& focus, const QRect& rectArea, const QRectF& rectScale)
+{
+    const QSize oldSize = this->size();
+
+    setDrawContextSize(size);
 
-    setDrawContextSize(newSize);
+    const QTransform transform = p.transform();
 
     // ----- start to draw thread based content -----
     // move coordinate system to center of the screen
-    p.translate(newSize.width() >> 1, newSize.height() >> 1);
+    p.translate(size.width() >> 1, size.height() >> 1);
 
     redraw_e redraw = eRedrawAll;
 
@@ -1295,17 +1362,17 @@ void CCanvas::print(QPainter& p, const QRectF& area, const QPointF& focus, bool
     }
 
     // restore coordinate system to default
-    p.resetTransform();
+    p.setTransform(transform);
     // ----- start to draw fast content -----
 
-    QRect r(QPoint(0, 0), area.size().toSize());
+    QRect r(QPoint(0, 0), size);
 
-    grid->draw(p, r);
+    grid->draw(p, rectArea);
     gis->draw(p, r);
     rt->draw(p, r);
-    if(printScale)
+    if(!rectScale.isNull())
     {
-        drawScale(p, r);
+        drawScale(p, rectScale);
     }
 
     setDrawContextSize(oldSize);
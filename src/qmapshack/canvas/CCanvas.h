@@ -25,6 +25,7 @@
 #include <QPainter>
 #include <QPointer>
 #include <QWidget>
+#include <functional>
 
 #include "gis/IGisItem.h"
 
@@ -72,6 +73,8 @@ public:
     void convertGridPos2Str(const QPointF& pos, QString& str, bool simple);
     void convertRad2Px(QPointF &pos) const;
     void convertPx2Rad(QPointF& pos) const;
+    /// convert a pixel coordinate into the coordinate of the map's projection
+    void convertPx2M(QPointF& pos) const;
 
     void setupBackgroundColor();
 
@@ -108,6 +111,7 @@ public:
         , eRedrawGis = 0x04
         , eRedrawMouse = 0x08
         , eRedrawRt = 0x10
+        , eRedrawGisArea = 0x20 ///< redraw the GIS areas marked dirty only
         , eRedrawAll = 0xFFFFFFFF
     };
 
@@ -164,6 +168,23 @@ public:
 
     void print(QPainter &p, const QRectF& area, const QPointF &focus, bool printScale = true);
 
+    /**
+       @brief Render an area of the map tile by tile
+
+       Each tile is rendered into an image of at most tileSize and passed to
+       the sink. Thus the memory needed does not depend on the size of the
+       area. The tiles are rendered row by row, from left to right.
+
+       @param area      the size of the area [px]
+       @param focus     the center of the area [rad]
+       @param tileSize  the maximum size of a tile [px]
+       @param printScale    draw the scale into the bottom right corner of the area
+       @param sink      called with each tile and it's offset within the area. Return false to abort.
+       @return False if the sink aborted.
+     */
+    bool printTiled(const QSize& area, const QPointF& focus, const QSize& tileSize, bool printScale,
+                    const std::function<bool(const QImage&, const QPoint&)>& sink);
+
     /**
        @brief Set a single map file to be shown on the canvas
 
@@ -221,6 +242,16 @@ private:
     {
         drawScale(p, rect());
     }
+    /**
+       @brief Render the map with the draw contexts resized to size
+
+       @param p         the painter to draw on
+       @param size      the size of the rendered area [px]
+       @param focus     the center of the rendered area [rad]
+       @param rectArea  the rectangle the grid is aligned to, in coordinates of the rendered area
+       @param rectScale the rectangle the scale is aligned to, in coordinates of the rendered area. No scale if null.
+     */
+    void printArea(QPainter& p, const QSize& size, const QPointF& focus, const QRect& rectArea, const QRectF& rectScale);
     void setZoom(bool in, redraw_e & needsRedraw);
     void setSizeTrackProfile();
     /**
@@ -22,6 +22,8 @@
 
 
 #define BUFFER_BORDER 50
+/// with more dirty areas a complete redraw is done anyway
+#define MAX_DIRTY_AREAS 100
 
 
 #define N_DEFAULT_ZOOM_LEVELS 31
@@ -164,6 +166,53 @@ void IDrawContext::setScales(const CCanvas::scales_type_e type)
     }
 }
 
+void IDrawContext::addDirtyArea(const QRectF& area)
+{
+    QMutexLocker lock(&mutex);
+    if(dirtyAll)
+    {
+        return;
+    }
+
+    dirtyAreas << area;
+    if(dirtyAreas.size() > MAX_DIRTY_AREAS)
+    {
+        dirtyAreas.clear();
+        dirtyAll = true;
+    }
+}
+
+bool IDrawContext::getDirtyRect(const buffer_t& current, const buffer_t& last, const QList<QRectF>& areas, QRect& dirty) const
+{
+    // the last buffer can only be reused if nothing but the dirty areas have changed
+    if(areas.isEmpty()
+       || (last.image.size() != current.image.size())
+       || (last.pjsrc != current.pjsrc)
+       || (last.zoomFactor != current.zoomFactor)
+       || (last.scale != current.scale)
+       || (last.ref1 != current.ref1)
+       || (last.ref3 != current.ref3))
+    {
+        return false;
+    }
+
+    QPointF ref = current.ref1;
+    convertRad2Px(ref);
+
+    QRectF rect;
+    for(const QRectF& area : areas)
+    {
+        QPolygonF poly(area);
+        convertRad2Px(poly);
+        rect |= poly.boundingRect().translated(-ref).adjusted(-DIRTY_AREA_MARGIN, -DIRTY_AREA_MARGIN, DIRTY_AREA_MARGIN, DIRTY_AREA_MARGIN);
+    }
+
+    dirty = rect.toAlignedRect() & current.image.rect();
+
+    // redrawing most of the buffer is not worth the overhead
+    return (2 * dirty.width() * dirty.height()) < (current.image.width() * current.image.height());
+}
+
 bool IDrawContext::needsRedraw() const
 {
     mutex.lock();
@@ -316,10 +365,35 @@ void IDrawContext::convertRad2Px(QPolygonF& poly) const
         return;
     }
 
-    mutex.lock(); // --------- start serialize with thread
+    // both serialize with the thread on their own
+    convertRad2M(poly);
+    convertM2Px(poly);
+}
 
-    QPointF f = focus;
-    convertRad2M(f);
+void IDrawContext::getViewport(QPolygonF& viewport) const
+{
+    QPointF pt1(0, 0);
+    QPointF pt2(viewWidth, 0);
+    QPointF pt3(viewWidth, viewHeight);
+    QPointF pt4(0, viewHeight);
+
+    convertPx2Rad(pt1);
+    convertPx2Rad(pt2);
+    convertPx2Rad(pt3);
+    convertPx2Rad(pt4);
+
+    viewport.clear();
+    viewport << pt1 << pt2 << pt3 << pt4;
+}
+
+void IDrawContext::convertRad2M(QPolygonF& poly) const
+{
+    if(pjsrc == nullptr)
+    {
+        return;
+    }
+
+    QMutexLocker lock(&mutex); // --------- serialize with thread
 
     const int N = poly.size();
 
@@ -376,13 +450,49 @@ void IDrawContext::convertRad2Px(QPolygonF& poly) const
             convertRad2M(o);
             pPt->rx() = 2 * o.x() + pPt->x();
         }
+    }
+}
 
-        *pPt = (*pPt - f) / (scale * zoomFactor) + center;
+void IDrawContext::convertM2Px(QPointF& p) const
+{
+    mutex.lock(); // --------- start serialize with thread
+
+    QPointF f = focus;
+    convertRad2M(f);
+
+    p = (p - f) / (scale * zoomFactor) + center;
+
+    mutex.unlock(); // --------- stop serialize with thread
+}
+
+void IDrawContext::convertM2Px(QPolygonF& poly) const
+{
+    mutex.lock(); // --------- start serialize with thread
+
+    QPointF f = focus;
+    convertRad2M(f);
+
+    const QPointF s = scale * zoomFactor;
+    for(QPointF& pt : poly)
+    {
+        pt = (pt - f) / s + center;
     }
 
     mutex.unlock(); // --------- stop serialize with thread
 }
 
+void IDrawContext::convertPx2M(QPointF& p) const
+{
+    mutex.lock(); // --------- start serialize with thread
+
+    QPointF f = focus;
+    convertRad2M(f);
+
+    p = f + (p - center) * scale * zoomFactor;
+
+    mutex.unlock(); // --------- stop serialize with thread
+}
+
 
 void IDrawContext::draw(QPainter& p, CCanvas::redraw_e needsRedraw, const QPointF& f)
 {
@@ -461,6 +571,12 @@ void IDrawContext::draw(QPainter& p, CCanvas::redraw_e needsRedraw, const QPoint
     {
         intNeedsRedraw = true;
     }
+    // anything but a request for the dirty areas needs a complete redraw
+    if(needsRedraw & maskRedraw & ~CCanvas::eRedrawGisArea)
+    {
+        dirtyAll = true;
+        dirtyAreas.clear();
+    }
     mutex.unlock(); // --------- stop serialize with thread
 
     if((needsRedraw & maskRedraw) && !isRunning())
@@ -478,6 +594,16 @@ void IDrawContext::run()
 //    qDebug() << "start thread" << objectName();
 
     IDrawContext::buffer_t& currentBuffer = buffer[!bufIndex];
+    const IDrawContext::buffer_t& lastBuffer = buffer[bufIndex];
+
+    /*
+        All dirty areas since the last buffer has been drawn. As a
+        loop might be aborted, each loop has to redraw the areas of
+        all previous loops, too.
+     */
+    QList<QRectF> areas;
+    bool all = false;
+
     while(intNeedsRedraw)
     {
         // copy all projection information need by the
@@ -492,11 +618,28 @@ void IDrawContext::run()
         currentBuffer.focus      = focus;
         intNeedsRedraw           = false;
 
+        areas      += dirtyAreas;
+        all         = all || dirtyAll;
+        dirtyAreas.clear();
+        dirtyAll    = false;
+
         mutex.unlock();
 
 //        qDebug() << "bufferScale" << (currentBuffer.scale * currentBuffer.zoomFactor);
-        // ----- reset buffer -----
-        currentBuffer.image.fill(Qt::transparent);
+        currentBuffer.isPartial = !all && getDirtyRect(currentBuffer, lastBuffer, areas, currentBuffer.dirty);
+        if(currentBuffer.isPartial)
+        {
+            // ----- copy last buffer and reset dirty area -----
+            QPainter p(&currentBuffer.image);
+            p.setCompositionMode(QPainter::CompositionMode_Source);
+            p.drawImage(0, 0, lastBuffer.image);
+            p.fillRect(currentBuffer.dirty, Qt::transparent);
+        }
+        else
+        {
+            // ----- reset buffer -----
+            currentBuffer.image.fill(Qt::transparent);
+        }
 
         drawt(currentBuffer);
 
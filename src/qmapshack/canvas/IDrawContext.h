@@ -30,6 +30,8 @@
 #include "canvas/CCanvas.h"
 
 #define CANVAS_MAX_ZOOM_LEVELS 31
+/// the margin added to dirty areas for icons, labels and line widths [px]
+#define DIRTY_AREA_MARGIN 100
 
 class IDrawContext : public QThread
 {
@@ -55,6 +57,9 @@ public:
         QPointF ref3;  //< bottom right corner
         QPointF ref4;  //< bottom left corner
         QPointF focus; //< point of focus
+
+        bool isPartial = false; //< true if just the dirty area is redrawn
+        QRect dirty; //< the area to redraw [px], if isPartial is true
     };
 
     /**
@@ -99,6 +104,44 @@ public:
      */
     void convertRad2Px(QPointF& p) const;
     void convertRad2Px(QPolygonF& poly) const;
+    /**
+       @brief Get the area currently visible
+       @param viewport      the corners of the viewport [rad]
+     */
+    void getViewport(QPolygonF& viewport) const;
+
+    /**
+       @brief Convert a polyline of geo coordinates in [rad] into the currently used projection
+
+       Together with convertM2Px() this splits convertRad2Px() into the expensive projection,
+       that only depends on the projection, and the cheap scaling, that depends on zoom
+       and point of focus. Thus projected coordinates can be cached.
+
+       @param poly          the polyline to convert
+     */
+    void convertRad2M(QPolygonF& poly) const;
+    /**
+       @brief Convert coordinates of the currently used projection to pixel coordinates of the viewport
+       @param p             the point to convert
+     */
+    void convertM2Px(QPointF& p) const;
+    void convertM2Px(QPolygonF& poly) const;
+    /**
+       @brief Convert a pixel coordinate from the viewport to a coordinate of the currently used projection
+       @param p             the point to convert
+     */
+    void convertPx2M(QPointF& p) const;
+
+    /**
+       @brief Mark an area to be redrawn
+
+       If all redraw requests since the last redraw have been made
+       with CCanvas::eRedrawGisArea and the viewport is still the same,
+       the last buffer is reused and just the areas marked are redrawn.
+
+       @param area          the area [rad]
+     */
+    void addDirtyArea(const QRectF& area);
 
     /**
        @brief Check if the internal needs redraw flag is set
@@ -221,6 +264,22 @@ private:
     QPointF ref2; //< top right corner of next buffer
     QPointF ref3; //< bottom right corner of next buffer
     QPointF ref4; //< bottom left corner of next buffer
+
+    /// all areas marked dirty since the last redraw [rad]
+    QList<QRectF> dirtyAreas;
+    /// set if the next redraw has to be a complete one
+    bool dirtyAll = true;
+
+    /**
+       @brief Get the area of a buffer to redraw
+
+       @param current       the buffer to draw next
+       @param last          the buffer drawn last
+       @param areas         the dirty areas [rad]
+       @param dirty         the area to redraw in buffer coordinates [px]
+       @return False if the buffer has to be redrawn completely.
+     */
+    bool getDirtyRect(const buffer_t& current, const buffer_t& last, const QList<QRectF>& areas, QRect& dirty) const;
 };
 
 extern QPointF operator*(const QPointF& p1, const QPointF& p2);
@@ -167,25 +167,7 @@ void CDeviceGarmin::createProjectsFromFiles(QString subdirecoty, QString fileEnd
     QStringList entries = dirLoop.entryList(QStringList("*." + fileEnding));
     for(const QString &entry : entries)
     {
-        const QString filename = dirLoop.absoluteFilePath(entry);
-        IGisProject * project = nullptr;
-        if (fileEnding == "fit")
-        {
-            project = new CFitProject(filename, this);
-        }
-        if (fileEnding == "gpx")
-        {
-            project = new CGpxProject(filename, this);
-        }
-        if (fileEnding == "tcx")
-        {
-            project = new CTcxProject(filename, this);
-        }
-
-        if(!project->isValid())
-        {
-            delete project;
-        }
+        addProjectFile(dirLoop.absoluteFilePath(entry));
     }
 }
 
@@ -324,7 +306,7 @@ void CDeviceGarmin::saveImages(CGisItemWpt& wpt)
             {
                 filename += ".jpg";
             }
-            image.pixmap.save(dirCache.absoluteFilePath(filename));
+            image.save(dirCache.absoluteFilePath(filename));
         }
     }
     else
@@ -338,7 +320,7 @@ void CDeviceGarmin::saveImages(CGisItemWpt& wpt)
         for(const CGisItemWpt::image_t& image : images)
         {
             filename = QString("%1.%2.jpg").arg(key).arg(cntImages);
-            image.pixmap.save(dirImages.absoluteFilePath(filename));
+            image.save(dirImages.absoluteFilePath(filename));
 
             IGisItem::link_t link;
             link.uri  = pathPictures + "/" + filename;
@@ -370,9 +352,7 @@ void CDeviceGarmin::loadImages(CGisItemWpt& wpt)
         for(const QString &file : entries)
         {
             CGisItemWpt::image_t image;
-            image.pixmap.load(dirCache.absoluteFilePath(file));
-
-            if(!image.pixmap.isNull())
+            if(image.load(dirCache.absoluteFilePath(file)))
             {
                 image.fileName  = file;
                 image.info      = QFileInfo(file).completeBaseName();
@@ -398,7 +378,7 @@ void CDeviceGarmin::loadImages(CGisItemWpt& wpt)
             }
             CGisItemWpt::image_t image;
             image.fileName = link.text;
-            image.pixmap.load(dir.absoluteFilePath(link.uri.toString()));
+            image.load(dir.absoluteFilePath(link.uri.toString()));
 
             images << image;
         }
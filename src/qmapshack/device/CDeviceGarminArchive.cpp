@@ -44,19 +44,12 @@ void CDeviceGarminArchive::slotExpanded(QTreeWidgetItem * item)
 
     setText(CGisListWks::eColumnName, tr("Archive - loaded"));
 
-    QMutexLocker lock(&IGisItem::mutexItems);
     CDeviceMountLock mountLock(*this);
-    CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
     qDebug() << "reading files from device: " << dir.path();
     QStringList entries = dir.entryList(QStringList("*.gpx"));
     for(const QString &entry : entries)
     {
-        const QString filename = dir.absoluteFilePath(entry);
-        IGisProject * project = new CGpxProject(filename, this);
-        if(!project->isValid())
-        {
-            delete project;
-        }
+        addProjectFile(dir.absoluteFilePath(entry));
     }
 }
 
@@ -71,6 +64,7 @@ void CDeviceGarminArchive::slotCollapsed(QTreeWidgetItem * item)
     CDeviceMountLock mountLock(*this);
     CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
 
+    stopLoading();
     qDeleteAll(takeChildren());
 
     setText(CGisListWks::eColumnName, tr("Archive - expand to load"));
@@ -0,0 +1,375 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "canvas/CCanvas.h"
+#include "device/CDeviceLoader.h"
+#include "device/IDevice.h"
+#include "gis/CGisListWks.h"
+#include "gis/CGisWorkspace.h"
+#include "gis/fit/CFitProject.h"
+#include "gis/fit/defs/CFitProfileLookup.h"
+#include "gis/fit/defs/fit_const.h"
+#include "gis/gpx/CGpxProject.h"
+#include "gis/tcx/CTcxProject.h"
+#include "setup/IAppSetup.h"
+
+#include <QtWidgets>
+
+/// increase this to invalidate all cache entries, e.g. if the QMS format changes
+#define CACHE_VERSION 1
+/// cache entries not used for that many days are removed
+#define CACHE_MAX_AGE 90
+/// the maximum time [ms] spent to create projects in the GUI thread at once
+#define MAX_TIME_SLICE 50
+
+class CDeviceLoaderWorker : public QRunnable
+{
+public:
+    CDeviceLoaderWorker(CDeviceLoader& loader, CDeviceLoader::job_t * job)
+        : loader(loader)
+        , job(job)
+    {
+    }
+
+    void run() override
+    {
+        loader.load(*job);
+        loader.loaded(job);
+    }
+
+private:
+    CDeviceLoader& loader;
+    CDeviceLoader::job_t * job;
+};
+
+class CDeviceCacheWriter : public QRunnable
+{
+public:
+    CDeviceCacheWriter(const QString& filename, const QByteArray& data)
+        : filename(filename)
+        , data(data)
+    {
+    }
+
+    void run() override
+    {
+        QSaveFile file(filename);
+        if(!file.open(QIODevice::WriteOnly))
+        {
+            qWarning() << "Failed to write device cache" << filename;
+            return;
+        }
+        file.write(qCompress(data));
+        file.commit();
+    }
+
+private:
+    QString filename;
+    QByteArray data;
+};
+
+class CDeviceCacheCleaner : public QRunnable
+{
+public:
+    CDeviceCacheCleaner(const QDir& dir)
+        : dir(dir)
+    {
+    }
+
+    void run() override
+    {
+        const QDateTime& limit = QDateTime::currentDateTime().addDays(-CACHE_MAX_AGE);
+
+        const QFileInfoList& entries = dir.entryInfoList(QStringList("*.qms"), QDir::Files);
+        for(const QFileInfo& entry : entries)
+        {
+            if(entry.lastModified() < limit)
+            {
+                QFile::remove(entry.absoluteFilePath());
+            }
+        }
+    }
+
+private:
+    QDir dir;
+};
+
+CDeviceLoader::CDeviceLoader(IDevice *device)
+    : device(device)
+    , dirCache(QDir(IAppSetup::getPlatformInstance()->defaultCachePath()).absoluteFilePath("Devices"))
+{
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setInterval(0);
+    connect(timer, &QTimer::timeout, this, &CDeviceLoader::slotCreateProjects);
+
+    dirCache.mkpath(dirCache.absolutePath());
+
+    // clean up the cache once per session
+    static bool isCacheCleaned = false;
+    if(!isCacheCleaned)
+    {
+        isCacheCleaned = true;
+        pool.start(new CDeviceCacheCleaner(dirCache));
+    }
+
+    // The FIT profiles are created on demand. Make sure this is done in the GUI thread.
+    CFitProfileLookup::getProfile(fitGlobalMesgNrInvalid);
+}
+
+CDeviceLoader::~CDeviceLoader()
+{
+    abort = 1;
+    pool.clear();
+    pool.waitForDone();
+
+    // the placeholders are owned by the device
+    qDeleteAll(jobs);
+    mountLock.reset();
+}
+
+QString CDeviceLoader::getCacheFilename(const QString& filename) const
+{
+    const QFileInfo fi(filename);
+
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    md5.addData(QString("%1|%2|%3|%4")
+                .arg(CACHE_VERSION)
+                .arg(fi.absoluteFilePath())
+                .arg(fi.size())
+                .arg(fi.lastModified().toMSecsSinceEpoch())
+                .toUtf8());
+
+    return dirCache.absoluteFilePath(md5.result().toHex() + ".qms");
+}
+
+void CDeviceLoader::addFile(const QString& filename)
+{
+    // the files are read after the caller might have unmounted the device
+    if(mountLock.isNull())
+    {
+        mountLock.reset(new CDeviceMountLock(*device));
+    }
+
+    job_t * job = new job_t(filename);
+    job->suffix = QFileInfo(filename).suffix().toLower();
+
+    job->placeholder = new QTreeWidgetItem(device);
+    job->placeholder->setIcon(CGisListWks::eColumnIcon, QIcon("://icons/32x32/Time.png"));
+    job->placeholder->setText(CGisListWks::eColumnName, tr("%1 - loading...").arg(QFileInfo(filename).completeBaseName()));
+    job->placeholder->setFlags(Qt::ItemIsEnabled);
+
+    jobs << job;
+    pool.start(new CDeviceLoaderWorker(*this, job));
+}
+
+void CDeviceLoader::load(job_t& job)
+{
+    if(abort)
+    {
+        return;
+    }
+
+    job.cacheFilename = getCacheFilename(job.filename);
+
+    QFile cache(job.cacheFilename);
+    if(cache.exists() && cache.open(QIODevice::ReadWrite))
+    {
+        job.cache = qUncompress(cache.readAll());
+        // mark the entry as used
+        cache.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        cache.close();
+
+        if(!job.cache.isEmpty())
+        {
+            return;
+        }
+    }
+
+    // Decode the file. Anything failing here is tried again by the
+    // project's usual constructor in the GUI thread. It will report
+    // the error.
+    try
+    {
+        if(job.suffix == "fit")
+        {
+            job.fitFile.setFileName(job.filename);
+            if(job.fitFile.open(QIODevice::ReadOnly))
+            {
+                job.fit.decodeFile();
+                job.fitFile.close();
+                job.isDecoded = true;
+            }
+        }
+        else if(job.suffix == "gpx")
+        {
+            CGpxProject::readGpx(job.filename, job.xml);
+            job.isDecoded = true;
+        }
+    }
+    catch(QString&)
+    {
+        job.isDecoded = false;
+    }
+}
+
+void CDeviceLoader::loaded(job_t * job)
+{
+    mutex.lock();
+    ready << job;
+    mutex.unlock();
+
+    // continue within the GUI thread
+    QMetaObject::invokeMethod(this, "slotLoaded", Qt::QueuedConnection);
+}
+
+void CDeviceLoader::slotLoaded()
+{
+    if(!timer->isActive())
+    {
+        timer->start();
+    }
+}
+
+CDeviceLoader::job_t * CDeviceLoader::takeReady()
+{
+    QMutexLocker lock(&mutex);
+    return ready.isEmpty() ? nullptr : ready.takeFirst();
+}
+
+IGisProject * CDeviceLoader::createProject(job_t& job)
+{
+    if(!job.cache.isEmpty())
+    {
+        /*
+            Create an empty project of the original type. No file name
+            makes the constructors skip loading. The file name is restored
+            along with the content.
+         */
+        IGisProject * project = nullptr;
+        if(job.suffix == "fit")
+        {
+            project = new CFitProject(QString(), device);
+        }
+        else if(job.suffix == "gpx")
+        {
+            project = new CGpxProject(QString(), device);
+        }
+        else if(job.suffix == "tcx")
+        {
+            project = new CTcxProject(QString(), device);
+        }
+
+        if(project != nullptr)
+        {
+            project->setFilename(job.filename);
+
+            QDataStream stream(&job.cache, QIODevice::ReadOnly);
+            stream.setByteOrder(QDataStream::LittleEndian);
+            stream.setVersion(QDataStream::Qt_5_2);
+            project->restore(stream);
+        }
+        return project;
+    }
+
+    IGisProject * project = nullptr;
+    if(job.suffix == "fit")
+    {
+        project = job.isDecoded ? new CFitProject(job.filename, job.fit, device) : new CFitProject(job.filename, device);
+    }
+    else if(job.suffix == "gpx")
+    {
+        project = job.isDecoded ? new CGpxProject(job.filename, job.xml, device) : new CGpxProject(job.filename, device);
+    }
+    else if(job.suffix == "tcx")
+    {
+        project = new CTcxProject(job.filename, device);
+    }
+
+    if((project != nullptr) && project->isValid())
+    {
+        storeInCache(job, project);
+    }
+
+    return project;
+}
+
+void CDeviceLoader::storeInCache(const job_t& job, IGisProject * project)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setVersion(QDataStream::Qt_5_2);
+    project->IGisProject::operator>>(stream);
+
+    pool.start(new CDeviceCacheWriter(job.cacheFilename, data));
+}
+
+void CDeviceLoader::slotCreateProjects()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    {
+        QMutexLocker lock(&IGisItem::mutexItems);
+        while(elapsed.elapsed() < MAX_TIME_SLICE)
+        {
+            job_t * job = takeReady();
+            if(job == nullptr)
+            {
+                break;
+            }
+            jobs.removeOne(job);
+
+            IGisProject * project = createProject(*job);
+            if(project != nullptr)
+            {
+                if(project->isValid())
+                {
+                    // move the project to the position of it's placeholder
+                    const int idx = device->indexOfChild(job->placeholder);
+                    device->removeChild(project);
+                    device->insertChild(idx, project);
+                }
+                else
+                {
+                    delete project;
+                }
+            }
+
+            delete job->placeholder;
+            delete job;
+        }
+    }
+
+    mutex.lock();
+    if(!ready.isEmpty())
+    {
+        timer->start();
+    }
+    mutex.unlock();
+
+    if(jobs.isEmpty())
+    {
+        mountLock.reset();
+    }
+
+    emit CGisWorkspace::self().sigChanged();
+    CCanvas::triggerCompleteUpdate(CCanvas::eRedrawGis);
+}
+
@@ -0,0 +1,129 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CDEVICELOADER_H
+#define CDEVICELOADER_H
+
+#include "gis/fit/CFitStream.h"
+
+#include <QAtomicInt>
+#include <QDir>
+#include <QDomDocument>
+#include <QFile>
+#include <QMutex>
+#include <QObject>
+#include <QScopedPointer>
+#include <QThreadPool>
+
+class CDeviceMountLock;
+class IDevice;
+class IGisProject;
+class QTimer;
+class QTreeWidgetItem;
+
+/**
+   @brief Load the project files of a device in the background
+
+   For each file a placeholder is added to the device at once. The files
+   are read and decoded by a pool of worker threads. As creating the
+   projects and their items is not thread safe, this is done in the GUI
+   thread. But in small time slices to keep the GUI responsive. Each
+   project replaces it's placeholder.
+
+   All projects loaded from a file are stored in QMS format in a local
+   cache. The cache is addressed by the file's path, size and time of
+   last modification. Thus an unchanged file is restored from the cache
+   the next time instead of being parsed again.
+ */
+class CDeviceLoader : public QObject
+{
+    Q_OBJECT
+public:
+    CDeviceLoader(IDevice * device);
+    virtual ~CDeviceLoader();
+
+    /**
+       @brief Queue a file to be loaded as project of the device
+
+       @param filename  the full path of a *.gpx, *.fit or *.tcx file
+     */
+    void addFile(const QString& filename);
+
+private slots:
+    void slotLoaded();
+    void slotCreateProjects();
+
+private:
+    friend class CDeviceLoaderWorker;
+
+    struct job_t
+    {
+        job_t(const QString& filename)
+            : filename(filename)
+            , fit(fitFile)
+        {
+        }
+
+        QString filename;
+        QString suffix;
+        QTreeWidgetItem * placeholder = nullptr;
+
+        /// the cache file of the project
+        QString cacheFilename;
+        /// the project in QMS format if found in the cache
+        QByteArray cache;
+
+        /// true if the file has been decoded into fit or xml
+        bool isDecoded = false;
+        QFile fitFile;
+        CFitStream fit;
+        QDomDocument xml;
+    };
+
+    /// called by the worker threads
+    void load(job_t& job);
+    /// called by the worker threads once a job is loaded
+    void loaded(job_t * job);
+    /// get the next loaded job, nullptr if there is none
+    job_t * takeReady();
+
+    IGisProject * createProject(job_t& job);
+    void storeInCache(const job_t& job, IGisProject * project);
+
+    QString getCacheFilename(const QString& filename) const;
+
+    IDevice * device;
+    /// keeps the device mounted as long as there are jobs
+    QScopedPointer<CDeviceMountLock> mountLock;
+    QDir dirCache;
+
+    QThreadPool pool;
+    QAtomicInt abort {0};
+
+    /// all jobs not finished yet
+    QList<job_t*> jobs;
+    /// all jobs loaded by the workers, ready to create the projects
+    QList<job_t*> ready;
+    /// serialize access to ready
+    QMutex mutex;
+
+    QTimer * timer;
+};
+
+#endif //CDEVICELOADER_H
+
@@ -58,11 +58,7 @@ CDeviceTwoNav::CDeviceTwoNav(const QString &path, const QString &key, const QStr
     QStringList entries = dirData.entryList(QStringList("*.gpx"));
     for(const QString &entry : entries)
     {
-        IGisProject * project =  new CGpxProject(dirData.absoluteFilePath(entry), this);
-        if(!project->isValid())
-        {
-            delete project;
-        }
+        addProjectFile(dirData.absoluteFilePath(entry));
     }
 
     entries = dirData.entryList(QDir::NoDotAndDotDot | QDir::Dirs);
@@ -80,11 +76,7 @@ CDeviceTwoNav::CDeviceTwoNav(const QString &path, const QString &key, const QStr
     entries = dirData.entryList(QStringList("*.gpx"));
     for(const QString &entry : entries)
     {
-        IGisProject * project =  new CGpxProject(dirData.absoluteFilePath(entry), this);
-        if(!project->isValid())
-        {
-            delete project;
-        }
+        addProjectFile(dirData.absoluteFilePath(entry));
     }
 }
 
@@ -19,6 +19,7 @@
 #include "canvas/CCanvas.h"
 #include "CMainWindow.h"
 #include "device/CDeviceGarmin.h"
+#include "device/CDeviceLoader.h"
 #include "device/IDevice.h"
 #include "gis/CGisListWks.h"
 #include "gis/prj/IGisProject.h"
@@ -30,6 +31,7 @@
 #endif
 
 int IDevice::cnt = 0;
+QHash<QString, int> IDevice::mountCount;
 
 IDevice::IDevice(const QString &path, type_e type, const QString &key, QTreeWidget *parent)
     : QTreeWidgetItem(parent, type)
@@ -50,11 +52,32 @@ IDevice::IDevice(const QString &path, type_e type, const QString &key, CDeviceGa
 
 IDevice::~IDevice()
 {
+    delete loader;
     cnt--;
 }
 
+void IDevice::addProjectFile(const QString& filename)
+{
+    if(loader == nullptr)
+    {
+        loader = new CDeviceLoader(this);
+    }
+    loader->addFile(filename);
+}
+
+void IDevice::stopLoading()
+{
+    delete loader;
+    loader = nullptr;
+}
+
 void IDevice::mount(const QString& path)
 {
+    if(mountCount[path]++ > 0)
+    {
+        return;
+    }
+
 #ifdef HAVE_DBUS
     QDBusMessage message = QDBusMessage::createMethodCall("org.freedesktop.UDisks2", path, "org.freedesktop.UDisks2.Filesystem", "Mount");
     QVariantMap args;
@@ -71,6 +94,12 @@ void IDevice::mount(const QString& path)
 
 void IDevice::umount(const QString &path)
 {
+    if(--mountCount[path] > 0)
+    {
+        return;
+    }
+    mountCount.remove(path);
+
 #ifdef HAVE_DBUS
     QDBusMessage message = QDBusMessage::createMethodCall("org.freedesktop.UDisks2", path, "org.freedesktop.UDisks2.Filesystem", "Unmount");
     QVariantMap args;
@@ -21,6 +21,7 @@
 #define IDEVICE_H
 
 #include <QDir>
+#include <QHash>
 #include <QTreeWidgetItem>
 
 #include "gis/IGisItem.h"
@@ -28,6 +29,7 @@
 class CGisDraw;
 class CGisItemWpt;
 class CDeviceGarmin;
+class CDeviceLoader;
 
 class IDevice : public QTreeWidgetItem
 {
@@ -45,6 +47,15 @@ public:
     virtual ~IDevice();
 
 
+    /**
+       @brief Mount/unmount a device
+
+       Calls are counted per path. The device is unmounted by the last
+       umount() matching a mount(). Thus nested mount locks, e.g. of
+       the device watcher and a device still loading, are safe.
+
+       @param path  the device's UDisks2 object path
+     */
     static void mount(const QString& path);
     static void umount(const QString &path);
     static int count()
@@ -110,10 +121,26 @@ protected:
      */
     bool testForExternalProject(const QString& filename);
 
+    /**
+       @brief Load a project file in the background
+
+       A placeholder is shown until the project is loaded. See CDeviceLoader.
+
+       @param filename  the full path of a *.gpx, *.fit or *.tcx file
+     */
+    void addProjectFile(const QString& filename);
+    /// stop loading all project files not loaded yet. Call this before removing the placeholders.
+    void stopLoading();
+
     static int cnt;
+    /// the number of mount() calls not matched by umount() yet, per path
+    static QHash<QString, int> mountCount;
 
     QDir dir;
     QString key;
+
+private:
+    CDeviceLoader * loader = nullptr;
 };
 
 class CDeviceMountLock
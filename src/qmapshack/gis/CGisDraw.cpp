@@ -18,14 +18,44 @@
 
 #include "gis/CGisDraw.h"
 #include "gis/CGisWorkspace.h"
+#include "gis/IGisItem.h"
+#include "gis/wpt/CWptClusterIndex.h"
 #include "helpers/CDraw.h"
 
 #include <QtWidgets>
 
+/// the minimum size of a waypoint cluster on the screen [px]
+#define CLUSTER_SIZE 64
+
+QList<CGisDraw*> CGisDraw::drawContexts;
+
 CGisDraw::CGisDraw(CCanvas *parent)
-    : IDrawContext("gis", CCanvas::eRedrawGis, parent)
+    : IDrawContext("gis", CCanvas::redraw_e(CCanvas::eRedrawGis | CCanvas::eRedrawGisArea), parent)
 {
     connect(&CGisWorkspace::self(), &CGisWorkspace::sigChanged, this, &CGisDraw::emitSigCanvasUpdate);
+    drawContexts << this;
+}
+
+CGisDraw::~CGisDraw()
+{
+    drawContexts.removeAll(this);
+}
+
+void CGisDraw::updateArea(const QRectF& area)
+{
+    for(CGisDraw * gis : drawContexts)
+    {
+        gis->addDirtyArea(area);
+        emit gis->sigCanvasUpdate(CCanvas::eRedrawGisArea);
+    }
+}
+
+void CGisDraw::updateAll()
+{
+    for(CGisDraw * gis : drawContexts)
+    {
+        gis->emitSigCanvasUpdate();
+    }
 }
 
 
@@ -34,6 +64,49 @@ void CGisDraw::draw(QPainter& p, const QRect& rect)
     CGisWorkspace::self().fastDraw(p, rect, this);
 }
 
+qint32 CGisDraw::getClusterLevel(const QPolygonF& viewport) const
+{
+    const QRectF& rectRad = viewport.boundingRect();
+    if(rectRad.width() <= 0)
+    {
+        return -1;
+    }
+
+    QPolygonF tmp = viewport;
+    convertRad2Px(tmp);
+
+    return CWptClusterIndex::getLevel(tmp.boundingRect().width() / rectRad.width(), CLUSTER_SIZE);
+}
+
+void CGisDraw::drawCluster(QPainter& p, const QPointF& pos, qint32 count, QList<QRectF>& blockedAreas) const
+{
+    const QString& str = QString::number(count);
+    const qint32 size  = qMax(24, p.fontMetrics().width(str) + 10);
+
+    CDraw::number(count, size, p, pos, Qt::darkBlue);
+
+    QRectF rect(0, 0, size, size);
+    rect.moveCenter(pos);
+    blockedAreas << rect;
+}
+
+bool CGisDraw::isInDirtyArea(const IGisItem& item) const
+{
+    if(!isPartial || !item.hasBoundingRect() || !item.isDrawnInBoundingRect())
+    {
+        return true;
+    }
+
+    const QRectF& area = item.getBoundingRect();
+
+    QPolygonF corners;
+    corners << area.topLeft() << area.topRight() << area.bottomRight() << area.bottomLeft();
+    convertRad2Px(corners);
+
+    const QRectF& rect = corners.boundingRect().adjusted(-DIRTY_AREA_MARGIN, -DIRTY_AREA_MARGIN, DIRTY_AREA_MARGIN, DIRTY_AREA_MARGIN);
+    return rect.intersects(dirtyArea);
+}
+
 void CGisDraw::drawt(buffer_t& currentBuffer)
 {
     QPointF pt1 = currentBuffer.ref1;
@@ -56,9 +129,33 @@ void CGisDraw::drawt(buffer_t& currentBuffer)
     QPolygonF viewport;
     viewport << pt1 << pt2 << pt3 << pt4;
 
+    if(currentBuffer.isPartial && (getClusterLevel(viewport) >= 0))
+    {
+        // a changed waypoint can change cluster markers anywhere in the viewport
+        currentBuffer.image.fill(Qt::transparent);
+        currentBuffer.isPartial = false;
+    }
+
     QPainter p(&currentBuffer.image);
     USE_ANTI_ALIASING(p, true);
+
+    isPartial = currentBuffer.isPartial;
+    if(isPartial)
+    {
+        /*
+            Paint the dirty area only. Items outside of it are not drawn
+            at all. Thus they keep the screen coordinates of the last
+            pass used for mouse interaction. The items drawn get the
+            complete viewport to get the same screen coordinates as
+            on a complete redraw.
+         */
+        p.setClipRect(currentBuffer.dirty);
+        dirtyArea = QRectF(currentBuffer.dirty).translated(pp);
+    }
+
     p.translate(-pp);
 
     CGisWorkspace::self().draw(p, viewport, this);
+
+    isPartial = false;
 }
@@ -22,18 +22,65 @@
 #include "canvas/IDrawContext.h"
 
 class CCanvas;
+class IGisItem;
 
 class CGisDraw : public IDrawContext
 {
 public:
     CGisDraw(CCanvas *parent);
-    virtual ~CGisDraw() = default;
+    virtual ~CGisDraw();
+
+    /**
+       @brief Redraw an area in all GIS draw contexts
+
+       @param area  the area [rad], e.g. the bounding rectangle of an item
+     */
+    static void updateArea(const QRectF& area);
+    /// redraw all GIS draw contexts completely
+    static void updateAll();
 
     using IDrawContext::draw;
     void draw(QPainter& p, const QRect& rect);
 
+    /**
+       @brief Get the level of waypoint clusters to draw for the current scale
+
+       @param viewport  the viewport [rad]
+       @return The level as used by CWptClusterIndex or -1 if waypoints are drawn without clustering.
+     */
+    qint32 getClusterLevel(const QPolygonF& viewport) const;
+
+    /**
+       @brief Draw a cluster marker with the number of waypoints it stands for
+
+       @param p             the painter to use
+       @param pos           the marker's center [px]
+       @param count         the number of waypoints
+       @param blockedAreas  the marker's area is appended
+     */
+    void drawCluster(QPainter& p, const QPointF& pos, qint32 count, QList<QRectF>& blockedAreas) const;
+
+    /**
+       @brief Test if an item has to be drawn in the current pass
+
+       On a partial redraw only items close to the dirty area are drawn. All
+       other items keep their pixels and the screen coordinates of the last pass.
+
+       @param item  the item to test
+       @return True if the item has to be drawn.
+     */
+    bool isInDirtyArea(const IGisItem& item) const;
+
 protected:
     void drawt(buffer_t& currentBuffer) override;
+
+private:
+    static QList<CGisDraw*> drawContexts;
+
+    /// true while a partial redraw is done
+    bool isPartial = false;
+    /// the dirty area of a partial redraw [px]
+    QRectF dirtyArea;
 };
 
 #endif //CGISDRAW_H
@@ -135,6 +135,7 @@ CGisListDB::CGisListDB(QWidget *parent)
     menuDatabase        = new QMenu(this);
     menuDatabase->addAction(actionAddFolder);
     actionSearch        = menuDatabase->addAction(QIcon("://icons/32x32/Zoom.png"), tr("Search Database"), this, SLOT(slotSearchDatabase()));
+    actionSearchArea    = menuDatabase->addAction(QIcon("://icons/32x32/SelectArea.png"), tr("Search Items in View"), this, SLOT(slotSearchDatabaseArea()));
     actionUpdate        = menuDatabase->addAction(QIcon("://icons/32x32/DatabaseSync.png"), tr("Sync. with Database"), this, SLOT(slotUpdateDatabase()));
     actionDelDatabase   = menuDatabase->addAction(QIcon("://icons/32x32/DeleteOne.png"), tr("Remove Database"), this, SLOT(slotDelDatabase()));
     menuDatabase->addSeparator();
@@ -363,6 +364,7 @@ void CGisListDB::slotContextMenu(const QPoint& point)
         actionUpdate->setEnabled(enabled);
         actionAddFolder->setEnabled(enabled);
         actionSearch->setEnabled(enabled);
+        actionSearchArea->setEnabled(enabled);
 
         menuDatabase->exec(p);
 
@@ -989,6 +991,25 @@ void CGisListDB::slotSearchDatabase()
     isInternalEdit++;
 }
 
+void CGisListDB::slotSearchDatabaseArea()
+{
+    CGisListDBEditLock lock(false, this, "slotSearchDatabaseArea");
+
+    IDBFolder * db = dynamic_cast<IDBFolder*>(currentItem());
+    if(db == nullptr)
+    {
+        return;
+    }
+
+    isInternalEdit--;
+    dlgSearch = new CSearchDatabase(*db, this);
+    connect(dlgSearch.data(), &CSearchDatabase::sigItemChanged, this, &CGisListDB::slotItemChanged);
+    dlgSearch->slotSearchArea();
+    dlgSearch->exec();
+    delete dlgSearch;
+    isInternalEdit++;
+}
+
 
 void CGisListDB::slotReadyRead()
 {
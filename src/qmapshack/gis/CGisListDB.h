@@ -66,6 +66,7 @@ private slots:
     void slotDelItem();
     void slotUpdateDatabase();
     void slotSearchDatabase();
+    void slotSearchDatabaseArea();
     void slotRenameFolder();
     void slotCopyFolder();
     void slotMoveFolder();
@@ -97,6 +98,7 @@ private:
     QAction * actionDelDatabase;
     QAction * actionUpdate;
     QAction * actionSearch;
+    QAction * actionSearchArea;
 
 
     QMenu * menuItem;
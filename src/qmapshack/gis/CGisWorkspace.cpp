@@ -39,6 +39,7 @@
 #include "gis/search/CGeoSearchWeb.h"
 #include "gis/search/CSearch.h"
 #include "gis/search/CSearchExplanationDialog.h"
+#include "gis/search/CSearchIndex.h"
 #include "gis/trk/CCombineTrk.h"
 #include "gis/trk/CGisItemTrk.h"
 #include "gis/wpt/CGisItemWpt.h"
@@ -60,6 +61,8 @@ CGisWorkspace::CGisWorkspace(QMenu *menuProject, QWidget *parent)
     pSelf = this;
     setupUi(this);
 
+    searchIndex = new CSearchIndex(this);
+
     treeWks->setExternalMenu(menuProject);
 
     SETTINGS;
@@ -82,6 +85,7 @@ CGisWorkspace::CGisWorkspace(QMenu *menuProject, QWidget *parent)
     connect(treeWks, &CGisListWks::sigChanged, this, &CGisWorkspace::sigChanged);
     connect(sliderOpacity, &QSlider::valueChanged, this, &CGisWorkspace::slotSetGisLayerOpacity);
     connect(lineFilter, &CSearchLineEdit::sigWorkspaceSearchChanged, this, &CGisWorkspace::slotSearch);
+    connect(searchIndex, &CSearchIndex::sigQueryFinished, this, &CGisWorkspace::slotSearchFinished);
     connect(treeWks, &CGisListWks::itemPressed, this, &CGisWorkspace::slotWksItemPressed);
     connect(treeWks, &CGisListWks::itemSelectionChanged, this, &CGisWorkspace::slotWksItemSelectionChanged);
     connect(treeWks, &CGisListWks::sigItemDeleted, this, &CGisWorkspace::slotWksItemSelectionChanged);
@@ -167,10 +171,70 @@ void CGisWorkspace::slotSetGisLayerOpacity(int val)
 void CGisWorkspace::slotSearch(const CSearch& currentSearch)
 {
     this->currentSearch = currentSearch;
+    // drop the result of any search still running
+    searchSerial++;
+
+    if(!currentSearch.isIndexable())
+    {
+        applySearch();
+        return;
+    }
+
+    /*
+        Bring the index up to date. This is cheap as only items
+        added or changed since the last search have to be indexed.
+        The query itself runs in the background.
+     */
+    {
+        QMutexLocker lock(&IGisItem::mutexItems);
+        QList<IGisItem*> items;
+
+        const int N = treeWks->topLevelItemCount();
+        for(int n = 0; n < N; n++)
+        {
+            IGisProject * project = dynamic_cast<IGisProject*>(treeWks->topLevelItem(n));
+            if(project == nullptr)
+            {
+                continue;
+            }
+
+            const int M = project->childCount();
+            for(int m = 0; m < M; m++)
+            {
+                IGisItem * item = dynamic_cast<IGisItem*>(project->child(m));
+                if(item != nullptr)
+                {
+                    items << item;
+                }
+            }
+        }
+
+        searchKeys = searchIndex->sync(items);
+    }
+
+    searchIndex->query(currentSearch, searchSerial);
+}
+
+void CGisWorkspace::slotSearchFinished(quint32 serial, const QSet<QString>& matches)
+{
+    if(serial != searchSerial)
+    {
+        return;
+    }
+
+    currentSearch.setIndexResult(searchKeys, matches);
+    applySearch();
+}
+
+void CGisWorkspace::applySearch()
+{
     {
         CCanvasCursorLock cursorLock(Qt::WaitCursor, __func__);
         QMutexLocker lock(&IGisItem::mutexItems);
 
+        // hide/show all items in one batch
+        treeWks->setUpdatesEnabled(false);
+
         const int N = treeWks->topLevelItemCount();
         for(int n = 0; n < N; n++)
         {
@@ -183,6 +247,8 @@ void CGisWorkspace::slotSearch(const CSearch& currentSearch)
             item->setWorkspaceFilter(currentSearch);
             item->setExpanded(!lineFilter->text().isEmpty());
         }
+
+        treeWks->setUpdatesEnabled(true);
     }
     CCanvas::triggerCompleteUpdate(CCanvas::eRedrawGis);
 }
@@ -446,6 +512,19 @@ void CGisWorkspace::getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGi
     }
 }
 
+void CGisWorkspace::getSelectedItems(QList<IGisItem*>& items)
+{
+    QMutexLocker lock(&IGisItem::mutexItems);
+    for(QTreeWidgetItem * item : treeWks->selectedItems())
+    {
+        IGisItem * gisItem = dynamic_cast<IGisItem*>(item);
+        if(gisItem != nullptr)
+        {
+            items << gisItem;
+        }
+    }
+}
+
 void CGisWorkspace::getItemsByArea(const QRectF& area, IGisItem::selflags_t flags, QList<IGisItem *> &items)
 {
     QMutexLocker lock(&IGisItem::mutexItems);
@@ -654,8 +733,6 @@ void CGisWorkspace::editItemByKey(const IGisItem::key_t& key)
             continue;
         }
     }
-
-    emit sigChanged();
 }
 
 void CGisWorkspace::copyItemByKey(const IGisItem::key_t &key)
@@ -748,8 +825,6 @@ void CGisWorkspace::changeWptSymByKey(const QList<IGisItem::key_t>& keys, const
     {
         project->blockUpdateItems(false);
     }
-
-    emit sigChanged();
 }
 
 
@@ -807,8 +882,6 @@ void CGisWorkspace::addEleToWptTrkByKey(const QList<IGisItem::key_t>& keys)
     {
         project->blockUpdateItems(false);
     }
-
-    emit sigChanged();
 }
 
 void CGisWorkspace::projWptByKey(const IGisItem::key_t& key)
@@ -985,8 +1058,6 @@ void CGisWorkspace::addTrkInfoByKey(const IGisItem::key_t& key)
     {
         trk->addTrkPtDesc();
     }
-
-    emit sigChanged();
 }
 
 void CGisWorkspace::reverseTrkByKey(const IGisItem::key_t& key)
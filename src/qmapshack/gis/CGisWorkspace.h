@@ -34,6 +34,7 @@
 class CGisDraw;
 class IGisProject;
 class CSearchExplanationDialog;
+class CSearchIndex;
 
 enum event_types_e
 {
@@ -295,6 +296,12 @@ public:
 
     void getItemsByKeys(const QList<IGisItem::key_t>& keys, QList<IGisItem*>& items);
 
+    /**
+       @brief Get all items selected in the workspace
+       @param items     a list to receive the temporary pointers to the selected items
+     */
+    void getSelectedItems(QList<IGisItem*>& items);
+
     void getNogoAreas(QList<IGisItem *> &nogos);
     /**
        @brief Delete all items with matching key from workspace
@@ -441,6 +448,11 @@ public:
     }
 
 signals:
+    /**
+       @brief Emitted if items are added or removed, causes a complete redraw
+
+       Changes to existing items don't need it. They mark their area dirty by themselves.
+     */
     void sigChanged();
 
 public slots:
@@ -452,6 +464,7 @@ public slots:
 private slots:
     void slotSetGisLayerOpacity(int val);
     void slotSearch(const CSearch& currentSearch);
+    void slotSearchFinished(quint32 serial, const QSet<QString>& matches);
 
     void slotWksItemSelectionChanged();
     void slotWksItemPressed(QTreeWidgetItem * item);
@@ -462,6 +475,9 @@ private:
 
     static CGisWorkspace * pSelf;
 
+    /// apply currentSearch to all projects in one go
+    void applySearch();
+
     /**
         The item key of last item pressed in the workspace list.
         The key will be reset by getItemsByPos() which is used by
@@ -470,6 +486,12 @@ private:
     IGisItem::key_t keyWksSelection;
     CSearch currentSearch;
 
+    CSearchIndex * searchIndex;
+    /// the serial of the last search. Results of older searches are dropped.
+    quint32 searchSerial = 0;
+    /// the keys of all items covered by the last indexed search
+    QSet<QString> searchKeys;
+
     enum tags_hidden_e
     {
         eTagsHiddenTrue,
@@ -28,6 +28,7 @@
 #include "gis/ovl/CGisItemOvlArea.h"
 #include "gis/prj/IGisProject.h"
 #include "gis/rte/CGisItemRte.h"
+#include "gis/search/CSearchIndex.h"
 #include "gis/trk/CGisItemTrk.h"
 #include "gis/wpt/CGisItemWpt.h"
 #include "GeoMath.h"
@@ -433,6 +434,7 @@ void IGisItem::changed(const QString &what, const QString &icon)
     stream.setVersion(QDataStream::Qt_5_2);
 
     *this >> stream;
+    getBlobs(history.blobs);
 
     QCryptographicHash md5(QCryptographicHash::Md5);
     md5.addData(event.data);
@@ -441,6 +443,8 @@ void IGisItem::changed(const QString &what, const QString &icon)
     history.histIdxCurrent = history.events.size() - 1;
 
     updateDecoration(eMarkChanged, eMarkNone);
+    updateSearchIndex();
+    updateDirtyArea();
 }
 
 void IGisItem::updateHistory()
@@ -458,12 +462,49 @@ void IGisItem::updateHistory()
     stream.setVersion(QDataStream::Qt_5_2);
 
     *this >> stream;
+    getBlobs(history.blobs);
 
     QCryptographicHash md5(QCryptographicHash::Md5);
     md5.addData(event.data);
     event.hash = md5.result().toHex();
 
     updateDecoration(eMarkChanged, eMarkNone);
+    updateSearchIndex();
+    updateDirtyArea();
+}
+
+void IGisItem::updateSearchIndex()
+{
+    // an item without a key is still under construction and can't be in the index
+    if(!key.item.isEmpty())
+    {
+        CSearchIndex::itemChanged(this);
+    }
+}
+
+void IGisItem::updateDirtyArea()
+{
+    // an item without a key is still under construction and has never been drawn
+    if(key.item.isEmpty())
+    {
+        return;
+    }
+
+    if(!isDrawnInBoundingRect())
+    {
+        isDrawn = false;
+        CGisDraw::updateAll();
+        return;
+    }
+
+    if(isDrawn)
+    {
+        CGisDraw::updateArea(boundingRectDrawn);
+    }
+    CGisDraw::updateArea(boundingRect);
+
+    boundingRectDrawn   = boundingRect;
+    isDrawn             = true;
 }
 
 void IGisItem::setupHistory()
@@ -502,6 +543,7 @@ void IGisItem::setupHistory()
         stream.setByteOrder(QDataStream::LittleEndian);
         stream.setVersion(QDataStream::Qt_5_2);
         *this >> stream;
+        getBlobs(history.blobs);
 
         QCryptographicHash md5(QCryptographicHash::Md5);
         md5.addData(event.data);
@@ -536,6 +578,8 @@ void IGisItem::loadHistory(int idx)
     *this << stream;
 
     history.histIdxCurrent = idx;
+    updateSearchIndex();
+    updateDirtyArea();
 }
 
 void IGisItem::cutHistoryAfter()
@@ -544,6 +588,7 @@ void IGisItem::cutHistoryAfter()
     {
         history.events.pop_back();
     }
+    pruneHistoryBlobs();
 }
 
 void IGisItem::cutHistoryBefore()
@@ -552,6 +597,7 @@ void IGisItem::cutHistoryBefore()
     {
         history.events[i].data.clear();
     }
+    pruneHistoryBlobs();
 }
 
 void IGisItem::squashHistory()
@@ -576,6 +622,38 @@ void IGisItem::squashHistory()
     {
         history.events.pop_front();
     }
+    pruneHistoryBlobs();
+}
+
+void IGisItem::pruneHistoryBlobs()
+{
+    if(history.blobs.isEmpty() || (history.histIdxCurrent == NOIDX))
+    {
+        return;
+    }
+
+    // the blobs in use are only known by restoring each event
+    blobs_t blobs;
+    for(const history_event_t& event : history.events)
+    {
+        if(event.data.isEmpty())
+        {
+            continue;
+        }
+
+        QDataStream stream(event.data);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream.setVersion(QDataStream::Qt_5_2);
+        *this << stream;
+        getBlobs(blobs);
+    }
+
+    QDataStream stream(history.events[history.histIdxCurrent].data);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setVersion(QDataStream::Qt_5_2);
+    *this << stream;
+
+    history.blobs = blobs;
 }
 
 bool IGisItem::isReadOnly() const
@@ -1075,6 +1153,17 @@ const QSet<QString> &IGisItem::getKeywords() const
     return keywords;
 }
 
+QStringList IGisItem::getFullTextFields() const
+{
+    QStringList fields;
+    fields << getName() << getComment() << getDescription();
+    if(!keywords.isEmpty())
+    {
+        fields << QStringList(getKeywordsSorted()).join(", ");
+    }
+    return fields;
+}
+
 QList<QString> IGisItem::getKeywordsSorted() const
 {
     QList<QString> sortedKeywords = keywords.toList();
@@ -26,9 +26,11 @@
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QDomNode>
+#include <QHash>
 #include <QMap>
 #include <QMutex>
 #include <QPainter>
+#include <QSharedPointer>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -58,6 +60,9 @@ public:
         QByteArray data;
     };
 
+    /// encoded data, e.g. images, addressed by it's MD5 hash
+    typedef QHash<QByteArray, QSharedPointer<const QByteArray> > blobs_t;
+
     struct history_t
     {
         history_t() : histIdxInitial(NOIDX), histIdxCurrent(NOIDX)
@@ -69,11 +74,24 @@ public:
             histIdxInitial = NOIDX;
             histIdxCurrent = NOIDX;
             events.clear();
+            blobs.clear();
+            derived.clear();
         }
 
         qint32 histIdxInitial;
         qint32 histIdxCurrent;
         QList<history_event_t> events;
+        /**
+           Large data referenced by the events' data by key only. Each blob is
+           stored once, no matter how many events refer to it.
+         */
+        blobs_t blobs;
+        /**
+           Data derived from the item's state when it was saved, e.g. a track's
+           secondary data. It's written once for the history instead of with every
+           entry and is used as long as it matches the entry loaded.
+         */
+        QByteArray derived;
     };
 
 
@@ -312,6 +330,15 @@ public:
 
     virtual const QString& getComment() const = 0;
     virtual const QString& getDescription() const = 0;
+
+    /**
+       @brief Get all text fields covered by a full text search
+
+       See CSearchIndex. Fields might contain HTML.
+
+       @return A list of fields. Empty fields can be omitted.
+     */
+    virtual QStringList getFullTextFields() const;
     virtual const QList<link_t>& getLinks() const = 0;
     virtual QDateTime getTimestamp() const = 0;
 
@@ -343,6 +370,31 @@ public:
         return boundingRect;
     }
 
+    /**
+       @brief Test if the item has coordinates at all
+
+       Items without any points have an inverted bounding rectangle. Note that
+       a waypoint's bounding rectangle has no size and might be at 0°/0°.
+     */
+    bool hasBoundingRect() const
+    {
+        const QRectF& rect = getBoundingRect();
+        return (rect.topLeft() != NOPOINTF) && (rect.left() <= rect.right());
+    }
+
+    /**
+       @brief Test if the item is drawn within it's bounding rectangle
+
+       The bounding rectangle is extended by DIRTY_AREA_MARGIN to take care of
+       icons and labels. Items drawing beyond that have to return false. They will
+       trigger a complete redraw on any change and are drawn on every
+       partial redraw.
+     */
+    virtual bool isDrawnInBoundingRect() const
+    {
+        return true;
+    }
+
     /**
        @brief Get screen option object to display and handle actions for this item.
        @param mouse     a pointer to the mouse object initiating the action
@@ -470,6 +522,17 @@ public:
         return history;
     }
 
+    /**
+       @brief Get the history to be written to a file or the database
+
+       The data derived from the current state is added, see history_t::derived.
+     */
+    const history_t& getHistoryToSave()
+    {
+        history.derived = getDerivedData();
+        return history;
+    }
+
     /**
        @brief Load a given state of change from the history
        @param idx
@@ -610,10 +673,32 @@ protected:
     void writeWpt(QDomElement &xml, const wpt_t &wpt, bool strictGpx11);
     /// generate a unique key from item's data
     virtual void genKey() const;
+    /**
+       @brief Add the large data serialized by key only to a set of blobs
+
+       The item's serialization must not contain large data that stays the same
+       across changes, e.g. images. Such data is written by key only and the
+       blob is stored once in history_t::blobs.
+     */
+    virtual void getBlobs(blobs_t& blobs) const
+    {
+        Q_UNUSED(blobs);
+    }
+    /// drop blobs no longer used by any history event
+    void pruneHistoryBlobs();
+    /// get data derived from the current state that is expensive to compute
+    virtual QByteArray getDerivedData() const
+    {
+        return QByteArray();
+    }
     /// setup the history structure right after the creation of the item
     void setupHistory();
     /// update current history entry (e.g. to save the flags)
     virtual void updateHistory();
+    /// refresh the item in the full text search index, if it is in the index at all
+    void updateSearchIndex();
+    /// redraw the item's area on the map, the area before the change and after
+    void updateDirtyArea();
     /// convert a color string from GPX to a QT color
     QColor str2color(const QString& name);
     /// convert a QT color to a string to be used in a GPX file
@@ -646,8 +731,11 @@ protected:
     /// each item has an icon for the tree widget
     QPixmap icon;
     QPixmap displayIcon;
-    /// the dimensions of the item
-    QRectF boundingRect;
+    /// the dimensions of the item, NOPOINTF as top left corner if not derived yet
+    QRectF boundingRect {NOPOINTF, NOPOINTF};
+    /// the dimensions of the item when it has been drawn the last time
+    QRectF boundingRectDrawn;
+    bool isDrawn = false;
     /// that's where the real data is. An item is completely defined by it's history
     history_t history;
     /// the hash in the database when the item was loaded/saved
@@ -91,6 +91,18 @@ bool CDBFolderMysql::search(const QString& str, QSqlQuery &query)
     return true;
 }
 
+bool CDBFolderMysql::searchArea(const QRectF& area, QSqlQuery& query)
+{
+    query.prepare("SELECT id FROM itemsbbox WHERE MBRIntersects(bbox, ST_Envelope(LineString(Point(:west, :south), Point(:east, :north))))");
+    query.bindValue(":west",  qMin(area.left(), area.right()));
+    query.bindValue(":east",  qMax(area.left(), area.right()));
+    query.bindValue(":south", qMin(area.top(), area.bottom()));
+    query.bindValue(":north", qMax(area.top(), area.bottom()));
+    QUERY_EXEC(return false);
+
+    return true;
+}
+
 void CDBFolderMysql::copyFolder(quint64 child, quint64 parent) //override;
 {
     QSqlQuery query(IDB::db);
@@ -78,6 +78,18 @@ bool CDBFolderSqlite::search(const QString& str, QSqlQuery& query)
     return true;
 }
 
+bool CDBFolderSqlite::searchArea(const QRectF& area, QSqlQuery& query)
+{
+    query.prepare("SELECT id FROM itemsbbox WHERE west<=:east AND east>=:west AND south<=:north AND north>=:south");
+    query.bindValue(":west",  qMin(area.left(), area.right()));
+    query.bindValue(":east",  qMax(area.left(), area.right()));
+    query.bindValue(":south", qMin(area.top(), area.bottom()));
+    query.bindValue(":north", qMax(area.top(), area.bottom()));
+    QUERY_EXEC(return false);
+
+    return true;
+}
+
 void CDBFolderSqlite::copyFolder(quint64 child, quint64 parent) //override;
 {
     QSqlQuery query(IDB::db);
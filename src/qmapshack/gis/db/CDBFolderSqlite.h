@@ -38,6 +38,7 @@ public:
     QString getDBInfo() const;
 
     bool search(const QString& str, QSqlQuery &query) override;
+    bool searchArea(const QRectF& area, QSqlQuery& query) override;
 
     void copyFolder(quint64 child, quint64 parent) override;
 private:
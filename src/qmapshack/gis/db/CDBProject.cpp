@@ -298,8 +298,16 @@ CDBProject::action_e CDBProject::checkForAction2(IGisItem * item, quint64 &itemI
             "your version and take the one from the database"
             ).arg(item->getNameEx()).arg(user).arg(date);
 
+        const bool resume = inTransaction;
+        commitTransaction();
+
         CResolveDatabaseConflict dialog (msg, item, action2ForAll, CMainWindow::self().getBestWidgetForParent());
         action = dialog.getAction();
+
+        if(resume)
+        {
+            beginTransaction();
+        }
     }
     else
     {
@@ -320,7 +328,7 @@ void CDBProject::updateItem(IGisItem *&item, quint64 idItem, action_e& action2Fo
     QDataStream in(&data, QIODevice::WriteOnly);
     in.setByteOrder(QDataStream::LittleEndian);
     in.setVersion(QDataStream::Qt_5_2);
-    in << item->getHistory();
+    in << item->getHistoryToSave();
 
     // prepare icon to be saved
     QBuffer buffer;
@@ -331,7 +339,7 @@ void CDBProject::updateItem(IGisItem *&item, quint64 idItem, action_e& action2Fo
 
     QString hashInDb = item->getLastDatabaseHash();
 
-    query.prepare("UPDATE items SET type=:type, keyqms=:keyqms, icon=:icon, name=:name, date=:date, comment=:comment, data=:data, hash=:hash WHERE id=:id AND hash=:oldhash");
+    query.prepare("UPDATE items SET type=:type, keyqms=:keyqms, icon=:icon, name=:name, date=:date, comment=:comment, data=:data, hash=:hash, west=:west, east=:east, south=:south, north=:north WHERE id=:id AND hash=:oldhash");
     query.bindValue(":type",    item->type());
     query.bindValue(":keyqms",  item->getKey().item);
     query.bindValue(":icon",    buffer.data());
@@ -340,6 +348,7 @@ void CDBProject::updateItem(IGisItem *&item, quint64 idItem, action_e& action2Fo
     query.bindValue(":comment", item->getInfo(IGisItem::eFeatureShowName | IGisItem::eFeatureShowFullText));
     query.bindValue(":data",    data);
     query.bindValue(":hash",    item->getHash());
+    IDB::bindBoundingBox(query, *item);
     query.bindValue(":id",      idItem);
     query.bindValue(":oldhash", hashInDb);
     QUERY_EXEC(throw eReasonQueryFail);
@@ -379,7 +388,7 @@ void CDBProject::updateItem(IGisItem *&item, quint64 idItem, action_e& action2Fo
         {
             // hashInDb has been updated by checkForAction2() by the one stored in the database
             // therefore the update should succeed now.
-            query.prepare("UPDATE items SET type=:type, keyqms=:keyqms, icon=:icon, name=:name, date=:date, comment=:comment, data=:data, hash=:hash WHERE id=:id AND hash=:oldhash");
+            query.prepare("UPDATE items SET type=:type, keyqms=:keyqms, icon=:icon, name=:name, date=:date, comment=:comment, data=:data, hash=:hash, west=:west, east=:east, south=:south, north=:north WHERE id=:id AND hash=:oldhash");
             query.bindValue(":type",    item->type());
             query.bindValue(":keyqms",  item->getKey().item);
             query.bindValue(":icon",    buffer.data());
@@ -388,6 +397,7 @@ void CDBProject::updateItem(IGisItem *&item, quint64 idItem, action_e& action2Fo
             query.bindValue(":comment", item->getInfo(IGisItem::eFeatureShowName | IGisItem::eFeatureShowFullText));
             query.bindValue(":data",    data);
             query.bindValue(":hash",    item->getHash());
+            IDB::bindBoundingBox(query, *item);
             query.bindValue(":id",      idItem);
             query.bindValue(":oldhash", hashInDb);
             QUERY_EXEC(throw eReasonQueryFail);
@@ -423,7 +433,7 @@ quint64 CDBProject::insertItem(IGisItem * item, QSqlQuery &query)
     QDataStream in(&data, QIODevice::WriteOnly);
     in.setByteOrder(QDataStream::LittleEndian);
     in.setVersion(QDataStream::Qt_5_2);
-    in << item->getHistory();
+    in << item->getHistoryToSave();
 
     // prepare icon to be saved
     QBuffer buffer;
@@ -432,7 +442,7 @@ quint64 CDBProject::insertItem(IGisItem * item, QSqlQuery &query)
     pixmap.save(&buffer, "PNG");
     buffer.seek(0);
 
-    query.prepare("INSERT INTO items (type, keyqms, icon, name, date, comment, data, hash) VALUES (:type, :keyqms, :icon, :name, :date, :comment, :data, :hash)");
+    query.prepare("INSERT INTO items (type, keyqms, icon, name, date, comment, data, hash, west, east, south, north) VALUES (:type, :keyqms, :icon, :name, :date, :comment, :data, :hash, :west, :east, :south, :north)");
     query.bindValue(":type",    item->type());
     query.bindValue(":keyqms",  item->getKey().item);
     query.bindValue(":icon",    buffer.data());
@@ -441,6 +451,7 @@ quint64 CDBProject::insertItem(IGisItem * item, QSqlQuery &query)
     query.bindValue(":comment", item->getInfo(IGisItem::eFeatureShowName | IGisItem::eFeatureShowFullText));
     query.bindValue(":data",    data);
     query.bindValue(":hash",    item->getHash());
+    IDB::bindBoundingBox(query, *item);
     QUERY_EXEC(throw eReasonQueryFail);
 
     if(query.numRowsAffected())
@@ -461,29 +472,18 @@ quint64 CDBProject::insertItem(IGisItem * item, QSqlQuery &query)
     return idItem;
 }
 
-CDBProject::action_e CDBProject::checkForAction1(IGisItem * item, quint64& itemId, CSelectSaveAction::result_e& action1ForAll, QSqlQuery &query)
+CDBProject::action_e CDBProject::checkForAction1(IGisItem * item, quint64& itemId, CSelectSaveAction::result_e& action1ForAll, const db_state_t& state)
 {
     int action = eActionNone;
 
     // test if item exists in database
-    quint32 itemType = 0;
-    query.prepare("SELECT id, type FROM items WHERE keyqms=:keyqms");
-    query.bindValue(":keyqms", item->getKey().item);
-    QUERY_EXEC(throw eReasonQueryFail);
-
-
-    if(query.next())
+    auto dbItem = state.items.constFind(item->getKey().item);
+    if(dbItem != state.items.constEnd())
     {
-        itemId      = query.value(0).toULongLong();
-        itemType    = query.value(1).toUInt();
+        itemId = dbItem->id;
 
         // check if relation already exists.
-        query.prepare("SELECT id FROM folder2item WHERE parent=:parent AND child=:child");
-        query.bindValue(":parent", id);
-        query.bindValue(":child", itemId);
-        QUERY_EXEC(throw eReasonQueryFail);
-
-        if(!query.next())
+        if(!state.links.contains(itemId))
         {
             // item is already in database but folder relation does not exit
             CSelectSaveAction::result_e result  = action1ForAll;
@@ -491,7 +491,7 @@ CDBProject::action_e CDBProject::checkForAction1(IGisItem * item, quint64& itemI
             if(action1ForAll == CSelectSaveAction::eResultNone)
             {
                 // Build the dialog to ask for user action
-                IGisItem * item1 = IGisItem::newGisItem(itemType, itemId, db, nullptr);
+                IGisItem * item1 = IGisItem::newGisItem(dbItem->type, itemId, db, nullptr);
 
                 if(nullptr == item1)
                 {
@@ -499,6 +499,9 @@ CDBProject::action_e CDBProject::checkForAction1(IGisItem * item, quint64& itemI
                     throw eReasonUnexpected;
                 }
 
+                const bool resume = inTransaction;
+                commitTransaction();
+
                 CSelectSaveAction dlg(item, item1, CMainWindow::self().getBestWidgetForParent());
                 dlg.exec();
 
@@ -507,6 +510,11 @@ CDBProject::action_e CDBProject::checkForAction1(IGisItem * item, quint64& itemI
                 {
                     action1ForAll = result;
                 }
+
+                if(resume)
+                {
+                    beginTransaction();
+                }
             }
 
             if(result == CSelectSaveAction::eResultNone)
@@ -550,6 +558,66 @@ CDBProject::action_e CDBProject::checkForAction1(IGisItem * item, quint64& itemI
     return (action_e)action;
 }
 
+bool CDBProject::fetchDbState(const QStringList& keys, db_state_t& state, QSqlQuery& query)
+{
+    for(const QString& key : keys)
+    {
+        state.items.remove(key);
+    }
+
+    // SQLite does not allow more than 999 parameters per statement
+    const int N = keys.count();
+    for(int n = 0; n < N; n += 500)
+    {
+        const QStringList chunk = keys.mid(n, 500);
+
+        QString placeholders = QString("?,").repeated(chunk.count());
+        placeholders.chop(1);
+
+        query.prepare("SELECT id, type, keyqms FROM items WHERE keyqms IN (" + placeholders + ")");
+        for(const QString& key : chunk)
+        {
+            query.addBindValue(key);
+        }
+        QUERY_EXEC(return false);
+
+        while(query.next())
+        {
+            state.items[query.value(2).toString()] = {query.value(0).toULongLong(), query.value(1).toUInt()};
+        }
+    }
+
+    state.links.clear();
+    query.prepare("SELECT child FROM folder2item WHERE parent=:parent");
+    query.bindValue(":parent", id);
+    QUERY_EXEC(return false);
+    while(query.next())
+    {
+        state.links << query.value(0).toULongLong();
+    }
+
+    return true;
+}
+
+void CDBProject::beginTransaction()
+{
+    inTransaction = db.transaction();
+}
+
+void CDBProject::commitTransaction()
+{
+    if(!inTransaction)
+    {
+        return;
+    }
+
+    inTransaction = false;
+    if(!db.commit())
+    {
+        qWarning() << "Failed to commit transaction:" << db.lastError();
+    }
+}
+
 bool CDBProject::save()
 {
     return save(CSelectSaveAction::eResultNone, eActionNone);
@@ -576,8 +644,28 @@ bool CDBProject::save(CSelectSaveAction::result_e action1ForAll, action_e action
     }
 
     int N = childCount();
+
+    // look up all changed items at once instead of querying them one by one
+    QStringList keys;
+    for(int i = 0; i < N; i++)
+    {
+        IGisItem * item = dynamic_cast<IGisItem*>(child(i));
+        if((nullptr != item) && item->isChanged())
+        {
+            keys << item->getKey().item;
+        }
+    }
+
+    db_state_t state;
+    if(!fetchDbState(keys, state, query))
+    {
+        return false;
+    }
+
     PROGRESS_SETUP(tr("Save ..."), 0, N, CMainWindow::getBestWidgetForParent());
 
+    bool refetch = false;
+    beginTransaction();
     for(int i = 0; (i < N) && !stop; i++)
     {
         try
@@ -596,9 +684,19 @@ bool CDBProject::save(CSelectSaveAction::result_e action1ForAll, action_e action
                 continue;
             }
 
+            // after a conflict the state of the item has to be read again
+            if(refetch)
+            {
+                refetch = false;
+                if(!fetchDbState(QStringList(item->getKey().item), state, query))
+                {
+                    throw eReasonQueryFail;
+                }
+            }
+
             quint64 idItem = 0;
 
-            int action = checkForAction1(item, idItem, action1ForAll, query);
+            int action = checkForAction1(item, idItem, action1ForAll, state);
 
             if(action & eActionInsert)
             {
@@ -631,11 +729,17 @@ bool CDBProject::save(CSelectSaveAction::result_e action1ForAll, action_e action
                 query.bindValue(":parent", id);
                 query.bindValue(":child", idItem);
                 QUERY_EXEC(throw eReasonQueryFail);
+
+                state.items[item->getKey().item] = {idItem, quint32(item->type())};
+                state.links << idItem;
             }
             item->updateDecoration(IGisItem::eMarkNone, IGisItem::eMarkChanged | IGisItem::eMarkNotPart | IGisItem::eMarkNotInDB);
         }
         catch(reasons_e reason)
         {
+            // keep what has been saved so far, like it would be without transaction
+            commitTransaction();
+
             CProgressDialog::setAllVisible(false);
             switch(reason)
             {
@@ -649,13 +753,20 @@ bool CDBProject::save(CSelectSaveAction::result_e action1ForAll, action_e action
                 break;
 
             case eReasonConflict:
+                refetch = true;
                 i--;
                 break;
             }
 
             CProgressDialog::setAllVisible(true);
+
+            if(!stop)
+            {
+                beginTransaction();
+            }
         }
     }
+    commitTransaction();
 
     // serialize metadata of project
     QByteArray data;
@@ -691,6 +802,8 @@ void CDBProject::showItems(CEvtD2WShowItems * evt, action_e action2ForAll)
         qDeleteAll(takeChildren());
     }
 
+    // read all items and write the healed ones in a single transaction
+    beginTransaction();
     for(const evt_item_t &item : evt->items)
     {
         IGisItem * gisItem = IGisItem::newGisItem(item.type, item.id, db, this);
@@ -721,6 +834,7 @@ void CDBProject::showItems(CEvtD2WShowItems * evt, action_e action2ForAll)
             }
         }
     }
+    commitTransaction();
 
     sortItems();
     postStatus(false);
@@ -821,6 +935,24 @@ void CDBProject::update()
     {
         // Iterate over all children and update
         const int N = childCount();
+
+        QStringList keys;
+        for(int i = 0; i < N; i++)
+        {
+            IGisItem * item = dynamic_cast<IGisItem*>(child(i));
+            if(item != nullptr)
+            {
+                keys << item->getKey().item;
+            }
+        }
+
+        db_state_t state;
+        if(!fetchDbState(keys, state, query))
+        {
+            return;
+        }
+
+        beginTransaction();
         for(int i = 0; i < N; i++)
         {
             IGisItem * item = dynamic_cast<IGisItem*>(child(i));
@@ -829,24 +961,13 @@ void CDBProject::update()
                 continue;
             }
 
-            const IGisItem::key_t& key = item->getKey();
-            // update item from database
-            query.prepare("SELECT id FROM items WHERE keyqms=:keyqms");
-            query.bindValue(":keyqms", key.item);
-            QUERY_EXEC(return );
-
-            if(query.next())
+            auto dbItem = state.items.constFind(item->getKey().item);
+            if(dbItem != state.items.constEnd())
             {
                 // item is in the database
-                quint64 idItem = query.value(0).toULongLong();
-
-                QSqlQuery query2(db);
-                query2.prepare("SELECT id FROM folder2item WHERE parent=:parent AND child=:child");
-                query2.bindValue(":parent", getId());
-                query2.bindValue(":child", idItem);
-                query2.exec();
+                const quint64 idItem = dbItem->id;
 
-                if(query2.next())
+                if(state.links.contains(idItem))
                 {
                     // item is connected to this project
                     item->updateFromDB(idItem, db);
@@ -865,6 +986,7 @@ void CDBProject::update()
                 item->updateDecoration(IGisItem::eMarkNotInDB | IGisItem::eMarkChanged, IGisItem::eMarkNone);
             }
         }
+        commitTransaction();
 
         postStatus(false);
     }
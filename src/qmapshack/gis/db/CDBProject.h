@@ -21,6 +21,7 @@
 
 #include "gis/db/CSelectSaveAction.h"
 #include "gis/prj/IGisProject.h"
+#include <QSet>
 #include <QSqlDatabase>
 class CEvtD2WShowItems;
 class CEvtD2WHideItems;
@@ -137,7 +138,44 @@ protected:
     void updateItem(IGisItem *&item, quint64 idItem, action_e& action2ForAll, QSqlQuery& query);
 
 
-    action_e checkForAction1(IGisItem * item, quint64 &itemId, CSelectSaveAction::result_e &action1ForAll, QSqlQuery& query);
+    struct db_item_t
+    {
+        quint64 id;
+        quint32 type;
+    };
+
+    /// the database state of the project's items
+    struct db_state_t
+    {
+        /// the items found in the database by their key
+        QHash<QString, db_item_t> items;
+        /// the ids of all items linked to the project
+        QSet<quint64> links;
+    };
+
+    /**
+       @brief Read the database state of a list of items with as few queries as possible
+
+       The keys are looked up in chunks. Keys not found are removed from the state.
+       The links of the project are read completely.
+
+       @param keys      a list of item keys
+       @param state     the state to update
+       @param query     the query object to use
+       @return False on a database error.
+     */
+    bool fetchDbState(const QStringList& keys, db_state_t& state, QSqlQuery& query);
+
+    /**
+       @brief Group all following statements into a single transaction
+
+       As long as the transaction is open it has to be committed before any dialog is
+       shown. Else other users are blocked while this user thinks about an answer.
+     */
+    void beginTransaction();
+    void commitTransaction();
+
+    action_e checkForAction1(IGisItem * item, quint64 &itemId, CSelectSaveAction::result_e &action1ForAll, const db_state_t& state);
     action_e checkForAction2(IGisItem * item, quint64 &itemId, QString &hashItem, action_e &action2ForAll, QSqlQuery& query);
 
     /**
@@ -159,6 +197,8 @@ protected:
     };
 
     Qt::CheckState checkState = Qt::Unchecked;
+
+    bool inTransaction = false;
 };
 
 #endif //CDBPROJECT_H
@@ -16,6 +16,8 @@
 
 **********************************************************************************************/
 
+#include "canvas/CCanvas.h"
+#include "CMainWindow.h"
 #include "gis/CGisListDB.h"
 #include "gis/CGisWorkspace.h"
 #include "gis/db/CDBFolderGroup.h"
@@ -26,6 +28,7 @@
 #include "gis/db/IDBFolder.h"
 #include "gis/db/macros.h"
 
+#include <proj_api.h>
 #include <QtSql>
 #include <QtWidgets>
 
@@ -38,6 +41,7 @@ CSearchDatabase::CSearchDatabase(IDBFolder &dbFolder, CGisListDB *parent)
     labelName->setText(tr("Search database '%1':").arg(dbFolder.getDBName()));
 
     connect(pushSearch, &QPushButton::clicked, this, &CSearchDatabase::slotSearch);
+    connect(pushSearchArea, &QPushButton::clicked, this, &CSearchDatabase::slotSearchArea);
     connect(pushClose, &QPushButton::clicked, this, &CSearchDatabase::accept);
     connect(treeResult, &QTreeWidget::itemChanged, this, &CSearchDatabase::slotItemChanged);
 }
@@ -77,14 +81,37 @@ void CSearchDatabase::slotItemChanged(QTreeWidgetItem * item, int column)
 }
 
 void CSearchDatabase::slotSearch()
+{
+    QSqlQuery query(dbFolder.getDb());
+    dbFolder.search(lineQuery->text(), query);
+    showResult(query);
+}
+
+void CSearchDatabase::slotSearchArea()
+{
+    CCanvas * canvas = CMainWindow::self().getVisibleCanvas();
+    if(canvas == nullptr)
+    {
+        return;
+    }
+
+    QPointF pt1 = canvas->rect().topLeft();
+    QPointF pt2 = canvas->rect().bottomRight();
+    canvas->convertPx2Rad(pt1);
+    canvas->convertPx2Rad(pt2);
+
+    QSqlQuery query(dbFolder.getDb());
+    dbFolder.searchArea(QRectF(pt1 * RAD_TO_DEG, pt2 * RAD_TO_DEG), query);
+    showResult(query);
+}
+
+void CSearchDatabase::showResult(QSqlQuery& query)
 {
     internalEdit = true;
 
     treeResult->clear();
 
     QSqlDatabase& db = dbFolder.getDb();
-    QSqlQuery query(db);
-    dbFolder.search(lineQuery->text(), query);
 
     QMap<quint64, IDBFolder*> folders;
 
@@ -25,6 +25,7 @@
 class CGisListDB;
 class IDBFolder;
 class QSqlDatabase;
+class QSqlQuery;
 
 class CSearchDatabase : public QDialog, private Ui::ISearchDatabase
 {
@@ -38,11 +39,17 @@ public:
 signals:
     void sigItemChanged(QTreeWidgetItem * item, int column);
 
+public slots:
+    /// search for all items intersecting the visible map
+    void slotSearchArea();
+
 private slots:
     void slotSearch();
     void slotItemChanged(QTreeWidgetItem * item, int column);
 
 private:
+    /// show the items of a query returning item IDs
+    void showResult(QSqlQuery& query);
     void addWithParentFolders(QTreeWidget * result, IDBFolder * folder, QMap<quint64, IDBFolder *> &folders, QSqlDatabase &sqlDB);
     void updateFolder(IDBFolder * folder, CEvtW2DAckInfo * evt);
     IDBFolder& dbFolder;
@@ -19,7 +19,9 @@
 #include "CMainWindow.h"
 #include "gis/db/IDB.h"
 #include "gis/db/macros.h"
+#include "gis/IGisItem.h"
 
+#include <proj_api.h>
 #include <QtSql>
 #include <QtWidgets>
 
@@ -124,15 +126,38 @@ quint64 IDB::getLastInsertID(QSqlDatabase& db, const QString& table)
 {
     QSqlQuery query(db);
 
+    // Both functions are bound to the connection. Selecting them
+    // from the table would return one row per row in the table.
+    Q_UNUSED(table)
     if(db.driverName() == "QSQLITE")
     {
-        QUERY_RUN("SELECT last_insert_rowid() from " + table, return 0)
+        QUERY_RUN("SELECT last_insert_rowid()", return 0)
     }
     else if(db.driverName() == "QMYSQL")
     {
-        QUERY_RUN("SELECT last_insert_id() from " + table, return 0)
+        QUERY_RUN("SELECT last_insert_id()", return 0)
     }
 
     query.next();
     return query.value(0).toULongLong();
 }
+
+void IDB::bindBoundingBox(QSqlQuery& query, const IGisItem& item)
+{
+    if(!item.hasBoundingRect())
+    {
+        const QVariant null(QVariant::Double);
+        query.bindValue(":west",  null);
+        query.bindValue(":east",  null);
+        query.bindValue(":south", null);
+        query.bindValue(":north", null);
+        return;
+    }
+
+    const QRectF& rect = item.getBoundingRect();
+    // the bounding rectangle's top is north and it's bottom is south
+    query.bindValue(":west",  rect.left()   * RAD_TO_DEG);
+    query.bindValue(":east",  rect.right()  * RAD_TO_DEG);
+    query.bindValue(":south", rect.bottom() * RAD_TO_DEG);
+    query.bindValue(":north", rect.top()    * RAD_TO_DEG);
+}
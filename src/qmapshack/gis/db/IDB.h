@@ -23,6 +23,9 @@
 #include <QMap>
 #include <QSqlDatabase>
 
+class IGisItem;
+class QSqlQuery;
+
 class IDB
 {
     Q_DECLARE_TR_FUNCTIONS(IDB)
@@ -35,6 +38,17 @@ public:
 
     static quint64 getLastInsertID(QSqlDatabase& db, const QString& table);
 
+    /**
+       @brief Bind an item's bounding box to the placeholders :west, :east, :south and :north
+
+       The values are in [°]. Items without any coordinates get NULL values and
+       by that are not part of the spatial index.
+
+       @param query     the prepared query
+       @param item      the item
+     */
+    static void bindBoundingBox(QSqlQuery& query, const IGisItem& item);
+
     bool isUsable() const
     {
         return db.isOpen();
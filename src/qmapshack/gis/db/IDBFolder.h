@@ -170,6 +170,20 @@ public:
         return false;
     }
 
+    /**
+       @brief Search the database for items within an area.
+
+       This must be overridden by the database folder classes. As a result the query will
+       contain a list of item IDs of all items with a bounding box intersecting the area.
+
+       @param area      The area as rectangle with west/north as top left corner [°]
+       @param query     The sql query item to use
+     */
+    virtual bool searchArea(const QRectF& area, QSqlQuery& query)
+    {
+        return false;
+    }
+
     bool isSiblingFrom(IDBFolder * folder) const;
 
     void exportToGpx();
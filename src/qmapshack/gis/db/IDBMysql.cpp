@@ -125,10 +125,19 @@ bool IDBMysql::initDB()
                "last_user      TEXT DEFAULT NULL,"
                "last_change    DATETIME DEFAULT NOW() ON UPDATE NOW(),"
                "trash          DATETIME DEFAULT NULL,"
+               "west           DOUBLE DEFAULT NULL,"
+               "east           DOUBLE DEFAULT NULL,"
+               "south          DOUBLE DEFAULT NULL,"
+               "north          DOUBLE DEFAULT NULL,"
                "FULLTEXT INDEX searchindex(comment),"
                "UNIQUE KEY (keyqms)"
                ")", return false);
 
+    if(!createSpatialIndex())
+    {
+        return false;
+    }
+
     QUERY_RUN("CREATE TRIGGER items_insert_last_user "
               "BEFORE INSERT ON items "
               "FOR EACH ROW SET NEW.last_user = USER();"
@@ -159,6 +168,11 @@ bool IDBMysql::initDB()
                "FOREIGN KEY(child) REFERENCES items(id)"
                ")", return false);
 
+    if(!createIndices())
+    {
+        return false;
+    }
+
     QUERY_RUN("CREATE TRIGGER folder2item_insert "
               "BEFORE INSERT ON folder2item "
               "FOR EACH ROW UPDATE items SET trash=NULL "
@@ -195,6 +209,22 @@ bool IDBMysql::migrateDB(int version)
                 throw -1;
             }
         }
+
+        if(version < 7)
+        {
+            if(!migrateDB6to7())
+            {
+                throw -1;
+            }
+        }
+
+        if(version < 8)
+        {
+            if(!migrateDB7to8())
+            {
+                throw -1;
+            }
+        }
     }
     catch(int i)
     {
@@ -316,3 +346,139 @@ bool IDBMysql::migrateDB5to6()
     return true;
 }
 
+bool IDBMysql::migrateDB6to7()
+{
+    return createIndices();
+}
+
+bool IDBMysql::createIndices()
+{
+    QSqlQuery query(db);
+
+    // InnoDB only creates single column indices for the foreign keys. The
+    // composite ones serve the `parent=:parent AND child=:child` tests, too.
+    QUERY_RUN("CREATE INDEX folder2folder_parent ON folder2folder (parent, child)", return false);
+    QUERY_RUN("CREATE INDEX folder2folder_child ON folder2folder (child, parent)",  return false);
+    QUERY_RUN("CREATE INDEX folder2item_parent ON folder2item (parent, child)",     return false);
+    QUERY_RUN("CREATE INDEX folder2item_child ON folder2item (child, parent)",      return false);
+
+    return true;
+}
+
+bool IDBMysql::migrateDB7to8()
+{
+    QSqlQuery query(db);
+
+    QUERY_RUN("ALTER TABLE items "
+              "ADD COLUMN west DOUBLE DEFAULT NULL, "
+              "ADD COLUMN east DOUBLE DEFAULT NULL, "
+              "ADD COLUMN south DOUBLE DEFAULT NULL, "
+              "ADD COLUMN north DOUBLE DEFAULT NULL", return false);
+
+    /*
+        Adding the bounding box is no change of the item. But the trigger
+        would set last_user of every item. Thus it is disabled while the
+        bounding boxes are written. last_change is kept by assigning it
+        explicitly.
+     */
+    QUERY_RUN("SELECT Count(*) FROM information_schema.TRIGGERS "
+              "WHERE TRIGGER_SCHEMA=DATABASE() AND TRIGGER_NAME='items_update_last_user'", return false);
+    const bool hasTriggerLastUser = query.next() && (query.value(0).toInt() > 0);
+    QUERY_RUN("DROP TRIGGER IF EXISTS items_update_last_user", return false);
+
+    // get number of items in the database
+    QUERY_RUN("SELECT Count(*) FROM items", return false);
+    query.next();
+    quint32 N = query.value(0).toUInt();
+
+    // over all items
+    QUERY_RUN("SELECT id, type FROM items", return false);
+    PROGRESS_SETUP(tr("Update to database version 8. Migrate all GIS items."), 0, N, CMainWindow::self().getBestWidgetForParent());
+    progress.enableCancel(false);
+    quint32 cnt = 0;
+    while(query.next())
+    {
+        PROGRESS(cnt++,;
+                 );
+
+        quint64 itemId      = query.value(0).toULongLong();
+        quint32 itemType    = query.value(1).toUInt();
+        IGisItem *item      = IGisItem::newGisItem(itemType, itemId, db, nullptr);
+
+        if(nullptr == item)
+        {
+            continue;
+        }
+
+        QSqlQuery query2(db);
+        query2.prepare("UPDATE items SET west=:west, east=:east, south=:south, north=:north, last_change=last_change WHERE id=:id");
+        IDB::bindBoundingBox(query2, *item);
+        query2.bindValue(":id", itemId);
+        if(!query2.exec())
+        {
+            qWarning() << query2.lastQuery();
+            qWarning() << query2.lastError();
+        }
+
+        delete item;
+    }
+
+    if(hasTriggerLastUser)
+    {
+        QUERY_RUN("CREATE TRIGGER items_update_last_user "
+                  "BEFORE UPDATE ON items "
+                  "FOR EACH ROW SET NEW.last_user = USER();"
+                  , return false);
+    }
+
+    // the index is created last and filled in one go
+    if(!createSpatialIndex())
+    {
+        return false;
+    }
+
+    QUERY_RUN("INSERT INTO itemsbbox (id, bbox) "
+              "SELECT id, ST_Envelope(LineString(Point(west, south), Point(east, north))) "
+              "FROM items WHERE west IS NOT NULL"
+              , return false);
+
+    return true;
+}
+
+bool IDBMysql::createSpatialIndex()
+{
+    QSqlQuery query(db);
+
+    // A spatial index needs a geometry column that is not NULL. Thus
+    // the bounding boxes are kept in an extra table with items
+    // without coordinates left out.
+    QUERY_RUN("CREATE TABLE itemsbbox ("
+              "id             INTEGER PRIMARY KEY,"
+              "bbox           GEOMETRY NOT NULL,"
+              "SPATIAL INDEX(bbox)"
+              ")", return false);
+
+    QUERY_RUN("CREATE TRIGGER itemsbbox_insert "
+              "AFTER INSERT ON items "
+              "FOR EACH ROW INSERT INTO itemsbbox (id, bbox) "
+              "SELECT NEW.id, ST_Envelope(LineString(Point(NEW.west, NEW.south), Point(NEW.east, NEW.north))) "
+              "FROM DUAL WHERE NEW.west IS NOT NULL;"
+              , return false);
+
+    QUERY_RUN("CREATE TRIGGER itemsbbox_update "
+              "AFTER UPDATE ON items "
+              "FOR EACH ROW BEGIN "
+              "DELETE FROM itemsbbox WHERE id=OLD.id; "
+              "INSERT INTO itemsbbox (id, bbox) "
+              "SELECT NEW.id, ST_Envelope(LineString(Point(NEW.west, NEW.south), Point(NEW.east, NEW.north))) "
+              "FROM DUAL WHERE NEW.west IS NOT NULL; "
+              "END;"
+              , return false);
+
+    QUERY_RUN("CREATE TRIGGER itemsbbox_delete "
+              "AFTER DELETE ON items "
+              "FOR EACH ROW DELETE FROM itemsbbox WHERE id=OLD.id;"
+              , return false);
+
+    return true;
+}
@@ -35,6 +35,13 @@ protected:
     bool migrateDB(int version) override;
     bool migrateDB4to5();
     bool migrateDB5to6();
+    bool migrateDB6to7();
+    bool migrateDB7to8();
+
+    /// add the indices on the relation tables
+    bool createIndices();
+    /// add the spatial index over the items' bounding boxes
+    bool createSpatialIndex();
 };
 
 #endif //IDBMYSQL_H
@@ -114,9 +114,18 @@ bool IDBSqlite::initDB()
                   "hash           TEXT NOT NULL,"
                   "last_user      TEXT DEFAULT 'QMapShack',"
                   "last_change    DATETIME DEFAULT CURRENT_TIMESTAMP,"
-                  "trash          DATETIME DEFAULT NULL"
+                  "trash          DATETIME DEFAULT NULL,"
+                  "west           REAL DEFAULT NULL,"
+                  "east           REAL DEFAULT NULL,"
+                  "south          REAL DEFAULT NULL,"
+                  "north          REAL DEFAULT NULL"
                   ")", throw -1)
 
+        if(!createSpatialIndex())
+        {
+            throw -1;
+        }
+
         QUERY_RUN("CREATE TRIGGER items_update_last_change "
                   "AFTER UPDATE ON items BEGIN "
                   "UPDATE items SET last_change=CURRENT_TIMESTAMP WHERE id=NEW.id; "
@@ -141,7 +150,12 @@ bool IDBSqlite::initDB()
                   "child          INTEGER NOT NULL,"
                   "FOREIGN KEY(parent) REFERENCES folders(id),"
                   "FOREIGN KEY(child) REFERENCES items(id)"
-                  ")", return false)
+                  ")", throw -1)
+
+        if(!createIndices())
+        {
+            throw -1;
+        }
 
         QUERY_RUN("CREATE TRIGGER folder2item_insert "
                   "BEFORE INSERT ON folder2item BEGIN "
@@ -231,6 +245,22 @@ bool IDBSqlite::migrateDB(int version)
             }
         }
 
+        if(version < 7)
+        {
+            if(!migrateDB6to7())
+            {
+                throw -1;
+            }
+        }
+
+        if(version < 8)
+        {
+            if(!migrateDB7to8())
+            {
+                throw -1;
+            }
+        }
+
         QUERY_RUN("END TRANSACTION;", throw -1);
     }
     catch(int i)
@@ -487,3 +517,128 @@ bool IDBSqlite::migrateDB5to6()
     return true;
 }
 
+bool IDBSqlite::migrateDB6to7()
+{
+    return createIndices();
+}
+
+bool IDBSqlite::createIndices()
+{
+    QSqlQuery query(db);
+
+    // Each relation is looked up by parent (folder content) and by child (parent folders,
+    // lost & found, triggers). Having the other column in the index, too, makes it a
+    // covering one for the `parent=:parent AND child=:child` tests.
+    QUERY_RUN("CREATE INDEX IF NOT EXISTS folder2folder_parent ON folder2folder (parent, child)", return false);
+    QUERY_RUN("CREATE INDEX IF NOT EXISTS folder2folder_child ON folder2folder (child, parent)",  return false);
+    QUERY_RUN("CREATE INDEX IF NOT EXISTS folder2item_parent ON folder2item (parent, child)",     return false);
+    QUERY_RUN("CREATE INDEX IF NOT EXISTS folder2item_child ON folder2item (child, parent)",      return false);
+
+    return true;
+}
+
+bool IDBSqlite::migrateDB7to8()
+{
+    QSqlQuery query(db);
+
+    QUERY_RUN("ALTER TABLE items ADD COLUMN west REAL DEFAULT NULL",  return false);
+    QUERY_RUN("ALTER TABLE items ADD COLUMN east REAL DEFAULT NULL",  return false);
+    QUERY_RUN("ALTER TABLE items ADD COLUMN south REAL DEFAULT NULL", return false);
+    QUERY_RUN("ALTER TABLE items ADD COLUMN north REAL DEFAULT NULL", return false);
+
+    /*
+        Adding the bounding box is no change of the item. But the trigger
+        would set last_change of every item. Thus it is disabled while the
+        bounding boxes are written. Its definition depends on the database
+        version the database was created with. Thus it is restored as it was.
+     */
+    QUERY_RUN("SELECT sql FROM sqlite_master WHERE type='trigger' AND name='items_update_last_change'", return false);
+    const QString sqlTriggerLastChange = query.next() ? query.value(0).toString() : QString();
+    QUERY_RUN("DROP TRIGGER IF EXISTS items_update_last_change", return false);
+
+    // get number of items in the database
+    QUERY_RUN("SELECT Count(*) FROM items", return false);
+    query.next();
+    quint32 N = query.value(0).toUInt();
+
+    // over all items
+    QUERY_RUN("SELECT id, type FROM items", return false);
+    PROGRESS_SETUP(tr("Update to database version 8. Migrate all GIS items."), 0, N, CMainWindow::self().getBestWidgetForParent());
+    progress.enableCancel(false);
+    quint32 cnt = 0;
+    while(query.next())
+    {
+        PROGRESS(cnt++,;
+                 );
+
+        quint64 idItem      = query.value(0).toULongLong();
+        quint32 typeItem    = query.value(1).toUInt();
+
+        IGisItem *item = IGisItem::newGisItem(typeItem, idItem, db, nullptr);
+
+        if(nullptr == item)
+        {
+            continue;
+        }
+
+        QSqlQuery query2(db);
+        query2.prepare("UPDATE items SET west=:west, east=:east, south=:south, north=:north WHERE id=:id");
+        IDB::bindBoundingBox(query2, *item);
+        query2.bindValue(":id", idItem);
+        if(!query2.exec())
+        {
+            qWarning() << query2.lastQuery();
+            qWarning() << query2.lastError();
+        }
+
+        delete item;
+    }
+
+    if(!sqlTriggerLastChange.isEmpty())
+    {
+        QUERY_RUN(sqlTriggerLastChange, return false);
+    }
+
+    // the index is created last and filled in one go
+    if(!createSpatialIndex())
+    {
+        return false;
+    }
+
+    QUERY_RUN("INSERT INTO itemsbbox(id, west, east, south, north) "
+              "SELECT id, west, east, south, north FROM items WHERE west IS NOT NULL", return false);
+
+    return true;
+}
+
+bool IDBSqlite::createSpatialIndex()
+{
+    QSqlQuery query(db);
+
+    // The R*Tree module is part of most SQLite builds. If it is missing,
+    // a plain table with the same columns will do, just slower.
+    if(!query.exec("CREATE VIRTUAL TABLE itemsbbox USING rtree(id, west, east, south, north)"))
+    {
+        qWarning() << "SQLite without R*Tree module:" << query.lastError();
+        QUERY_RUN("CREATE TABLE itemsbbox (id INTEGER PRIMARY KEY, west REAL, east REAL, south REAL, north REAL)", return false);
+        QUERY_RUN("CREATE INDEX itemsbbox_area ON itemsbbox (west, east, south, north)", return false);
+    }
+
+    QUERY_RUN("CREATE TRIGGER itemsbbox_insert "
+              "AFTER INSERT ON items WHEN NEW.west IS NOT NULL BEGIN "
+              "INSERT INTO itemsbbox(id, west, east, south, north) VALUES(NEW.id, NEW.west, NEW.east, NEW.south, NEW.north); "
+              "END;", return false);
+
+    QUERY_RUN("CREATE TRIGGER itemsbbox_update "
+              "AFTER UPDATE OF west, east, south, north ON items BEGIN "
+              "DELETE FROM itemsbbox WHERE id=OLD.id; "
+              "INSERT INTO itemsbbox(id, west, east, south, north) SELECT NEW.id, NEW.west, NEW.east, NEW.south, NEW.north WHERE NEW.west IS NOT NULL; "
+              "END;", return false);
+
+    QUERY_RUN("CREATE TRIGGER itemsbbox_delete "
+              "AFTER DELETE ON items BEGIN "
+              "DELETE FROM itemsbbox WHERE id=OLD.id; "
+              "END;", return false);
+
+    return true;
+}
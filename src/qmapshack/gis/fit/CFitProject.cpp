@@ -44,6 +44,27 @@ CFitProject::CFitProject(const QString &filename, IDevice *parent)
     loadFitFromFile(filename, false);
 }
 
+CFitProject::CFitProject(const QString &filename, CFitStream& in, IDevice *parent)
+    : IGisProject(eTypeFit, filename, parent)
+{
+    setIcon(CGisListWks::eColumnIcon, QIcon("://icons/32x32/FitProject.png"));
+    blockUpdateItems(true);
+    try
+    {
+        createGisItems(in);
+        markAsSaved();
+        setToolTip(CGisListWks::eColumnName, getInfo());
+        valid = true;
+    }
+    catch(QString &errormsg)
+    {
+        qWarning() << "Failed to load FIT file:" << errormsg;
+        valid = false;
+    }
+
+    sortItems();
+    blockUpdateItems(false);
+}
 
 void CFitProject::loadFitFromFile(const QString &filename, bool showErrorMsg)
 {
@@ -116,7 +137,11 @@ void CFitProject::createGisItems(QFile& file)
 {
     CFitStream in(file);
     in.decodeFile();
+    createGisItems(in);
+}
 
+void CFitProject::createGisItems(CFitStream& in)
+{
     QString name = "";
 
     // remark: we consider activity and course files types. trk is for both types. There is one trk per fit file
@@ -31,6 +31,8 @@ class CFitProject final : public IGisProject
 public:
     CFitProject(const QString& filename, CGisListWks * parent);
     CFitProject(const QString& filename, IDevice * parent);
+    /// create project from a stream already decoded by CFitStream::decodeFile()
+    CFitProject(const QString& filename, CFitStream& in, IDevice * parent);
     virtual ~CFitProject();
 
 
@@ -54,6 +56,7 @@ private:
     void loadFitFromFile(const QString &filename, bool showErrorMsg);
     void tryOpeningFitFile(const QString &filename);
     void createGisItems(QFile& file);
+    void createGisItems(CFitStream& in);
 };
 
 #endif //CFITPROJECT_H
@@ -54,16 +54,23 @@ bool CFitStream::hasMoreMesg() const
 
 const CFitMessage& CFitStream::nextMesgOf(quint16 mesgNum)
 {
-    while(hasMoreMesg())
+    static const CFitMessage dummyMessage;
+
+    const QHash<quint16, QVector<qint32> >& index = decode.getMessageIndex();
+    QHash<quint16, QVector<qint32> >::const_iterator positions = index.constFind(mesgNum);
+    if(positions != index.constEnd())
     {
-        const CFitMessage& mesg = nextMesg();
-        if (mesg.getGlobalMesgNr() == mesgNum)
+        // the positions are in ascending order
+        QVector<qint32>::const_iterator pos = std::lower_bound(positions->constBegin(), positions->constEnd(), readPos);
+        if(pos != positions->constEnd())
         {
-            return mesg;
+            readPos = *pos + 1;
+            return decode.getMessages().at(*pos);
         }
     }
 
-    static const CFitMessage dummyMessage;
+    // no more messages of that type, the stream is at it's end
+    readPos = decode.getMessages().size();
     return dummyMessage;
 }
 
@@ -79,13 +86,15 @@ const CFitMessage& CFitStream::firstMesgOf(quint16 mesgNum)
 int CFitStream::countMesgOf(quint16 mesgNr)
 {
     reset();
-    int c = 0;
-    while(nextMesgOf(mesgNr).getGlobalMesgNr() != fitGlobalMesgNrInvalid)
-    {
-        c++;
-    }
-    reset();
-    return c;
+    return decode.getMessageIndex().value(mesgNr).size();
 }
 
+QVector<qint32> CFitStream::indexOfMesg(quint16 mesgNum) const
+{
+    return decode.getMessageIndex().value(mesgNum);
+}
 
+const CFitMessage& CFitStream::mesgAt(qint32 pos) const
+{
+    return decode.getMessages().at(pos);
+}
@@ -27,7 +27,8 @@ class CFitMessage;
 
 /*
    Encapsulates the access to the FIT messages. Looping over the read FIT messages can be done using the
-   methods nextMesg() and hasMoreMesg() (Iterator pattern).
+   methods nextMesg() and hasMoreMesg() (Iterator pattern). Messages of a given type are looked up by an
+   index over the global message number. Thus there is no need to scan all messages.
  */
 class CFitStream final
 {
@@ -73,6 +74,21 @@ public:
 
     int countMesgOf(quint16 mesgNr);
 
+    /**
+       return: the indices of all messages of the given type (xx_MESG_NUM) in stream order
+     */
+    QVector<qint32> indexOfMesg(quint16 mesgNum) const;
+
+    /**
+       return: the message at the given stream position
+     */
+    const CFitMessage& mesgAt(qint32 pos) const;
+
+    /**
+       return: typed columns of all record messages with a valid position
+     */
+    const CFitRecordColumns& getRecords() const { return decode.getRecords(); }
+
 
     QString getFileName() const { return file.fileName(); }
 
@@ -39,8 +39,7 @@ CFitDecoder::CFitDecoder()
 
 CFitDecoder::~CFitDecoder()
 {
-    qDeleteAll(stateMap);
-    stateMap.clear();
+    qDeleteAll(stateMap, stateMap + eDecoderStateEnd);
 
     data.messages.clear();
 }
@@ -50,6 +49,8 @@ void CFitDecoder::resetSharedData()
     data.definitions = QMap<quint8, CFitDefinitionMessage>();
     data.definitionHistory = QList<CFitDefinitionMessage>();
     data.messages = QList<CFitMessage>();
+    data.messageIndex = QHash<quint16, QVector<qint32> >();
+    data.records.clear();
     data.devFieldProfiles = QList<CFitFieldProfile>();
     data.lastDefinition = nullptr;
     data.lastMessage = nullptr;
@@ -91,29 +92,61 @@ void CFitDecoder::printDebugInfo()
 QList<QString> decoderStateNames = {"File Header", "Record", "Record Content", "Field Definition",
                                     "Development Field Definition", "Field Data", "CRC", "End"};
 
-void printByte(QFile& file, decode_state_e state, quint8 dataByte)
+void printByte(quint32 pos, decode_state_e state, quint8 dataByte)
 {
     FITDEBUG(3, qDebug() << QString("decoding byte %1 - %2 - %3")
-             .arg(file.pos(), 6, 10, QLatin1Char(' '))
+             .arg(pos, 6, 10, QLatin1Char(' '))
              .arg(dataByte, 8, 2, QLatin1Char('0'))
              .arg(decoderStateNames.at(state)));
 }
 
 void CFitDecoder::decode(QFile &file)
 {
-    resetSharedData();
+    const qint64 size = file.size();
+    if(size > std::numeric_limits<quint32>::max())
+    {
+        throw tr("FIT decoding error: file %1 is too large.").arg(file.fileName());
+    }
+
+    uchar * mem = file.map(0, size);
+    if(mem == nullptr)
+    {
+        // mapping is not supported by all devices (e.g. MTP). Fall back to reading the whole file.
+        file.seek(0);
+        const QByteArray buffer = file.readAll();
+        decode((const quint8*)buffer.constData(), buffer.size(), file.fileName());
+        return;
+    }
+
+    try
+    {
+        decode(mem, quint32(size), file.fileName());
+    }
+    catch(QString& errormsg)
+    {
+        file.unmap(mem);
+        throw errormsg;
+    }
+    // the messages hold copies of all field data, nothing refers to the mapping
+    file.unmap(mem);
+}
 
-    file.seek(0);
+void CFitDecoder::decode(const quint8 * dataBlock, quint32 size, const QString& filename)
+{
+    resetSharedData();
 
-    quint8 dataByte;
+    quint32 pos = 0;
     decode_state_e state = eDecoderStateFileHeader;
-    while (!file.atEnd())
+    while (pos < size)
     {
-        file.getChar((char *) &dataByte);
         try
         {
-            printByte(file, state, dataByte);
-            state = stateMap[state]->processByte(dataByte);
+            printByte(pos, state, dataBlock[pos]);
+
+            quint32 used = 0;
+            state = stateMap[state]->processBlock(dataBlock + pos, size - pos, used);
+            pos += used;
+
             if (state == eDecoderStateEnd)
             {
                 // end of file, everything ok
@@ -129,10 +162,20 @@ void CFitDecoder::decode(QFile &file)
     }
     // unexpected end of file
     printDebugInfo();
-    throw tr("FIT decoding error: unexpected end of file %1.").arg(file.fileName());
+    throw tr("FIT decoding error: unexpected end of file %1.").arg(filename);
 }
 
 const QList<CFitMessage>& CFitDecoder::getMessages() const
 {
     return data.messages;
 }
+
+const QHash<quint16, QVector<qint32> >& CFitDecoder::getMessageIndex() const
+{
+    return data.messageIndex;
+}
+
+const CFitRecordColumns& CFitDecoder::getRecords() const
+{
+    return data.records;
+}
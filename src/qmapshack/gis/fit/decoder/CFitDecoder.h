@@ -32,15 +32,31 @@ public:
     CFitDecoder();
     ~CFitDecoder();
 
+    /**
+       @brief Decode a FIT file
+
+       The file is mapped into memory if possible. Else it is read into a buffer.
+       The mapping only replaces reading the file byte by byte. The decoding
+       is not lazy: each field is still copied and converted into a CFitField
+       of a CFitMessage (QVariant and QByteArray on the heap). The mapping is
+       released once the file is decoded and nothing refers to it afterwards.
+
+       throws: QString in case of a decoding failure
+     */
     void decode(QFile& file);
     const QList<CFitMessage>& getMessages() const;
+    /// the indices into getMessages() for each global message number
+    const QHash<quint16, QVector<qint32> >& getMessageIndex() const;
+    /// typed columns of all record messages with a valid position
+    const CFitRecordColumns& getRecords() const;
 
 private:
+    void decode(const quint8 * dataBlock, quint32 size, const QString& filename);
     void resetSharedData();
     void printDebugInfo();
 
-    // map containing all states for the decoder. Needs to be pointer because decoder state is abstract class
-    QMap<decode_state_e, IFitDecoderState *> stateMap;
+    // all states for the decoder, indexed by decode_state_e. Needs to be pointer because decoder state is abstract class
+    IFitDecoderState * stateMap[eDecoderStateEnd];
 
     // shared data passed along the decoder state instances.
     IFitDecoderState::shared_state_data_t data;
@@ -31,7 +31,7 @@ CFitDefinitionMessage::CFitDefinitionMessage()
 
 CFitDefinitionMessage::CFitDefinitionMessage(const CFitDefinitionMessage& copy)
     : globalMesgNr(copy.globalMesgNr), architecture(copy.architecture), nrOfFields(copy.nrOfFields),
-    nrOfDevFields(copy.nrOfDevFields), localMesgNr(copy.localMesgNr), devFlag(copy.devFlag), fields(copy.fields),
+    nrOfDevFields(copy.nrOfDevFields), localMesgNr(copy.localMesgNr), devFlag(copy.devFlag), dataSize(copy.dataSize), fields(copy.fields),
     devFields(copy.devFields), messageProfile(CFitProfileLookup::getProfile(globalMesgNr))
 {
     for(CFitFieldDefinition& field : fields)
@@ -42,7 +42,7 @@ CFitDefinitionMessage::CFitDefinitionMessage(const CFitDefinitionMessage& copy)
 
 CFitDefinitionMessage::CFitDefinitionMessage(quint8 localMesgNr, bool devFlag)
     : globalMesgNr(fitGlobalMesgNrInvalid), architecture(0), nrOfFields(0), nrOfDevFields(0), localMesgNr(localMesgNr),
-    devFlag(devFlag), fields(), devFields(), messageProfile(CFitProfileLookup::getProfile(fitGlobalMesgNrInvalid))
+    devFlag(devFlag), dataSize(0), fields(), devFields(), messageProfile(CFitProfileLookup::getProfile(fitGlobalMesgNrInvalid))
 {
 }
 
@@ -83,6 +83,20 @@ void CFitDefinitionMessage::addDevField(CFitFieldDefinition fieldDef)
     devFields.append(fieldDef);
 }
 
+void CFitDefinitionMessage::updateDataSize()
+{
+    dataSize = 0;
+    const int N = qMin(int(nrOfFields), fields.size());
+    for(int i = 0; i < N; i++)
+    {
+        dataSize += fields[i].getSize();
+    }
+    for(const CFitFieldDefinition& devField : devFields)
+    {
+        dataSize += devField.getSize();
+    }
+}
+
 bool CFitDefinitionMessage::hasField(const quint8 fieldNum) const
 {
     for (int i = 0; i < fields.size(); i++)
@@ -46,6 +46,8 @@ public:
     quint8 getNrOfDevFields()   const { return nrOfDevFields; }
     quint8 getLocalMesgNr()     const { return localMesgNr;  }
     bool developerFlag()        const { return devFlag; }
+    /// the size of a data message's field data in bytes, valid after updateDataSize()
+    quint32 getDataSize()       const { return dataSize; }
 
     const CFitProfile& profile() const { return *messageProfile; }
 
@@ -55,6 +57,13 @@ public:
 
     void addField(CFitFieldDefinition field);
     void addDevField(CFitFieldDefinition field);
+    /**
+       @brief Calculate the total size of all fields once the definition is complete
+
+       Fields added later on (e.g. a timestamp for compressed timestamp headers)
+       are not part of the data message and do not count.
+     */
+    void updateDataSize();
     bool hasField(const quint8 fieldNum) const;
     const CFitFieldDefinition& getField(const quint8 fieldNum) const;
     const CFitFieldDefinition& getFieldByIndex(const quint16 index) const;
@@ -70,6 +79,7 @@ private:
     quint8 nrOfDevFields;
     quint8 localMesgNr;
     bool devFlag;
+    quint32 dataSize;
     QList<CFitFieldDefinition> fields;
     QList<CFitFieldDefinition> devFields;
     const CFitProfile* messageProfile;
@@ -24,7 +24,6 @@
 #include "gis/fit/defs/CFitBaseType.h"
 #include "gis/fit/defs/CFitFieldProfile.h"
 #include "gis/fit/defs/CFitProfile.h"
-#include "gis/fit/defs/CFitProfileLookup.h"
 
 
 void CFitFieldBuilder::evaluateSubfieldsAndExpandComponents(CFitMessage& mesg)
@@ -41,8 +40,8 @@ void CFitFieldBuilder::evaluateSubfieldsAndExpandComponents(CFitMessage& mesg)
 
 CFitField CFitFieldBuilder::buildField(const CFitFieldDefinition& def, quint8* fieldData, const CFitMessage& message)
 {
-    const CFitFieldProfile* fieldProfile = CFitProfileLookup::getFieldForProfile(message.getGlobalMesgNr(), def.getDefNr());
-    return buildField(*fieldProfile, def, fieldData, message);
+    // the field's profile has been looked up once while reading the definition
+    return buildField(def.profile(), def, fieldData, message);
 }
 
 CFitField CFitFieldBuilder::buildField(const CFitFieldProfile &fieldProfile, const CFitFieldDefinition &def, quint8 *fieldData, const CFitMessage& message)
@@ -50,21 +50,102 @@ decode_state_e CFitFieldDataState::process(quint8 &dataByte)
 
     if (allFieldRead && allDevFielRead)
     {
-        // Now that the entire message is decoded we may evaluate subfields and expand components
-        CFitFieldBuilder::evaluateSubfieldsAndExpandComponents(mesg);
-
-        devProfile(mesg);
-
-        reset();
-        FITDEBUG(2, qDebug() << mesg.messageInfo())
-        // after all fields read, go to next record header
-        return eDecoderStateRecord;
+        return endOfMessage(mesg);
     }
 
     // there are more fields to read for the current message
     return eDecoderStateFieldData;
 }
 
+decode_state_e CFitFieldDataState::processBlock(const quint8 * dataBlock, quint32 size, quint32& used)
+{
+    CFitMessage& mesg = *latestMessage();
+    const CFitDefinitionMessage& defMesg = *definition(mesg.getLocalMesgNr());
+    const quint32 dataSize = defMesg.getDataSize();
+
+    // The complete message has to be in the block and must not reach into the file's CRC.
+    // Anything else (including messages without data) is left to the byte by byte processing.
+    if(fieldIndex != 0 || devFieldIndex != 0 || fieldDataIndex != 0 || dataSize == 0
+       || dataSize > size || bytesLeftToRead() < dataSize + 2)
+    {
+        return IFitDecoderState::processBlock(dataBlock, size, used);
+    }
+
+    consumeBlock(dataBlock, dataSize);
+    used = dataSize;
+
+    // the definition's field layout is fixed, thus the fields can be read one after the other.
+    // This saves the state machine's per byte overhead only, each field is still built as a
+    // CFitField with it's value copied into QVariant and QByteArray.
+    const QList<CFitFieldDefinition>& fields = defMesg.getFields();
+    for(quint8 i = 0; i < defMesg.getNrOfFields(); i++)
+    {
+        const CFitFieldDefinition& fieldDef = fields[i];
+        // the field data is swapped in place, thus copy it
+        memcpy(fieldData, dataBlock, fieldDef.getSize());
+        dataBlock += fieldDef.getSize();
+        addFitField(mesg, fieldDef);
+    }
+
+    for(const CFitFieldDefinition& fieldDef : defMesg.getDevFields())
+    {
+        memcpy(fieldData, dataBlock, fieldDef.getSize());
+        dataBlock += fieldDef.getSize();
+        addDevField(mesg, fieldDef);
+    }
+
+    endOfMessage(mesg);
+    if (bytesLeftToRead() == 2)
+    {
+        // end of file, 2 bytes left, this is the crc
+        return eDecoderStateFileCrc;
+    }
+    return eDecoderStateRecord;
+}
+
+decode_state_e CFitFieldDataState::endOfMessage(CFitMessage& mesg)
+{
+    // Now that the entire message is decoded we may evaluate subfields and expand components
+    CFitFieldBuilder::evaluateSubfieldsAndExpandComponents(mesg);
+
+    devProfile(mesg);
+    endMessage();
+
+    reset();
+    FITDEBUG(2, qDebug() << mesg.messageInfo())
+    // after all fields read, go to next record header
+    return eDecoderStateRecord;
+}
+
+void CFitFieldDataState::addFitField(CFitMessage& mesg, const CFitFieldDefinition& fieldDef)
+{
+    // new field with data
+    CFitField f = CFitFieldBuilder::buildField(fieldDef, fieldData, mesg);
+    mesg.addField(f);
+
+    // The special case time record.
+    // timestamp has always the same value for all enums. it does not matter against which we're comparing.
+    if (fieldDef.getDefNr() == eRecordTimestamp)
+    {
+        setTimestamp(f.getValue().toUInt());
+    }
+}
+
+void CFitFieldDataState::addDevField(CFitMessage& mesg, const CFitFieldDefinition& fieldDef)
+{
+    // handling developer data for mapping the field data to its definitions:
+    // part 2, reading field data and attach dynamic profile
+    CFitFieldProfile* fieldProfile = devFieldProfile(fieldDef.getDefNr());
+    if (fieldProfile->getBaseType().nr() == eBaseTypeNrInvalid)
+    {
+        // test if profile exists
+        throw tr("Missing field definition for development field.");
+    }
+
+    CFitField f = CFitFieldBuilder::buildField(*fieldProfile, fieldDef, fieldData, mesg);
+    mesg.addField(f);
+}
+
 
 bool CFitFieldDataState::handleFitField()
 {
@@ -77,17 +158,7 @@ bool CFitFieldDataState::handleFitField()
         if (fieldDataIndex >= fieldDef.getSize())
         {
             // all bytes are read for current field
-
-            // new field with data
-            CFitField f = CFitFieldBuilder::buildField(fieldDef, fieldData, mesg);
-            mesg.addField(f);
-
-            // The special case time record.
-            // timestamp has always the same value for all enums. it does not matter against which we're comparing.
-            if (fieldDef.getDefNr() == eRecordTimestamp)
-            {
-                setTimestamp(f.getValue().toUInt());
-            }
+            addFitField(mesg, fieldDef);
 
             // new field follows, reset
             fieldDataIndex = 0;
@@ -107,17 +178,7 @@ bool CFitFieldDataState::handleDevField()
         const CFitFieldDefinition& fieldDef = defMesg->getDevFieldByIndex(devFieldIndex);
         if (fieldDataIndex >= fieldDef.getSize())
         {
-            // handling developer data for mapping the field data to its definitions:
-            // part 2, reading field data and attach dynamic profile
-            CFitFieldProfile* fieldProfile = devFieldProfile(fieldDef.getDefNr());
-            if (fieldProfile->getBaseType().nr() == eBaseTypeNrInvalid)
-            {
-                // test if profile exists
-                throw tr("Missing field definition for development field.");
-            }
-
-            CFitField f = CFitFieldBuilder::buildField(*fieldProfile, fieldDef, fieldData, mesg);
-            mesg.addField(f);
+            addDevField(mesg, fieldDef);
 
             // new field follows, reset
             fieldDataIndex = 0;
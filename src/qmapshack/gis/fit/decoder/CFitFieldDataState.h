@@ -31,10 +31,14 @@ public:
     virtual ~CFitFieldDataState() {}
     void reset() override;
     decode_state_e process(quint8 &dataByte) override;
+    decode_state_e processBlock(const quint8 * dataBlock, quint32 size, quint32& used) override;
 
 private:
     bool handleFitField();
     bool handleDevField();
+    void addFitField(CFitMessage& mesg, const CFitFieldDefinition& fieldDef);
+    void addDevField(CFitMessage& mesg, const CFitFieldDefinition& fieldDef);
+    decode_state_e endOfMessage(CFitMessage& mesg);
     void devProfile(CFitMessage& mesg);
     CFitFieldProfile buildDevFieldProfile(CFitMessage& mesg);
 
@@ -104,10 +104,13 @@ void CFitMessage::addField(CFitField &  field)
 
 bool CFitMessage::isFieldValueValid(const quint8 fieldDefNum) const
 {
-    return fields[fieldDefNum].isValidValue();
+    // do not use operator[] as it returns a copy of the field
+    QMap<quint8, CFitField>::const_iterator field = fields.constFind(fieldDefNum);
+    return (field != fields.constEnd()) && field->isValidValue();
 }
 
 const QVariant CFitMessage::getFieldValue(const quint8 fieldDefNum) const
 {
-    return fields[fieldDefNum].getValue();
+    QMap<quint8, CFitField>::const_iterator field = fields.constFind(fieldDefNum);
+    return field != fields.constEnd() ? field->getValue() : QVariant();
 }
@@ -0,0 +1,72 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/fit/decoder/CFitMessage.h"
+#include "gis/fit/decoder/CFitRecordColumns.h"
+#include "gis/fit/defs/fit_fields.h"
+
+void CFitRecordColumns::clear()
+{
+    mesgIdx.clear();
+    valid.clear();
+    timestamp.clear();
+    lat.clear();
+    lon.clear();
+    ele.clear();
+    speed.clear();
+    heartRate.clear();
+    cadence.clear();
+    temperature.clear();
+}
+
+void CFitRecordColumns::append(qint32 idx, const CFitMessage& mesg)
+{
+    if(!mesg.isFieldValueValid(eRecordPositionLong) || !mesg.isFieldValueValid(eRecordPositionLat))
+    {
+        return;
+    }
+
+    quint8 flags = 0;
+    if(mesg.isFieldValueValid(eRecordHeartRate))
+    {
+        flags |= eValidHeartRate;
+    }
+    if(mesg.isFieldValueValid(eRecordTemperature))
+    {
+        flags |= eValidTemperature;
+    }
+    if(mesg.isFieldValueValid(eRecordCadence))
+    {
+        flags |= eValidCadence;
+    }
+    if(mesg.isFieldValueValid(eRecordSpeed))
+    {
+        flags |= eValidSpeed;
+    }
+
+    mesgIdx << idx;
+    valid << flags;
+    timestamp << mesg.getFieldValue(eRecordTimestamp).toUInt();
+    lon << mesg.getFieldValue(eRecordPositionLong).toInt();
+    lat << mesg.getFieldValue(eRecordPositionLat).toInt();
+    ele << mesg.getFieldValue(eRecordEnhancedAltitude).toFloat();
+    speed << mesg.getFieldValue(eRecordSpeed).toFloat();
+    heartRate << quint8(mesg.getFieldValue(eRecordHeartRate).toUInt());
+    cadence << quint8(mesg.getFieldValue(eRecordCadence).toUInt());
+    temperature << qint8(mesg.getFieldValue(eRecordTemperature).toInt());
+}
@@ -0,0 +1,75 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CFITRECORDCOLUMNS_H
+#define CFITRECORDCOLUMNS_H
+
+#include <QtCore>
+
+class CFitMessage;
+
+/**
+   @brief Column store for the record messages of a FIT file
+
+   The values needed to build a track point are copied into typed arrays
+   as soon as a record message is decoded completely (including expanded
+   components and scale/offset). Building a track from these columns
+   avoids the lookup and conversion of each single field by QVariant.
+
+   Only records with a valid position are stored.
+ */
+class CFitRecordColumns final
+{
+public:
+    enum valid_e
+    {
+        eValidHeartRate     = 0x01
+        , eValidTemperature = 0x02
+        , eValidCadence     = 0x04
+        , eValidSpeed       = 0x08
+    };
+
+    void clear();
+    void append(qint32 mesgIdx, const CFitMessage& mesg);
+
+    qint32 size() const
+    {
+        return mesgIdx.size();
+    }
+
+    /// the index of the record in the decoder's message list
+    QVector<qint32> mesgIdx;
+    /// combination of valid_e flags
+    QVector<quint8> valid;
+    /// seconds since UTC 00:00 Dec 31 1989
+    QVector<quint32> timestamp;
+    /// [semicircles]
+    QVector<qint32> lat;
+    /// [semicircles]
+    QVector<qint32> lon;
+    /// enhanced altitude [m]
+    QVector<float> ele;
+    /// speed as decoded from the record
+    QVector<float> speed;
+    QVector<quint8> heartRate;
+    QVector<quint8> cadence;
+    QVector<qint8> temperature;
+};
+
+#endif //CFITRECORDCOLUMNS_H
+
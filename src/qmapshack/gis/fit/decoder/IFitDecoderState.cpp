@@ -17,6 +17,7 @@
 **********************************************************************************************/
 
 #include "gis/fit/decoder/IFitDecoderState.h"
+#include "gis/fit/defs/fit_enums.h"
 
 decode_state_e IFitDecoderState::processByte(quint8 &dataByte)
 {
@@ -36,6 +37,23 @@ decode_state_e IFitDecoderState::processByte(quint8 &dataByte)
     return state;
 }
 
+decode_state_e IFitDecoderState::processBlock(const quint8 * dataBlock, quint32 size, quint32& used)
+{
+    Q_UNUSED(size)
+
+    quint8 dataByte = dataBlock[0];
+    used = 1;
+    return processByte(dataByte);
+}
+
+void IFitDecoderState::consumeBlock(const quint8 * dataBlock, quint32 size)
+{
+    data.fileBytesRead += size;
+    for(quint32 i = 0; i < size; i++)
+    {
+        buildCrc(dataBlock[i]);
+    }
+}
 
 void IFitDecoderState::buildCrc(quint8 byte)
 {
@@ -76,6 +94,15 @@ void IFitDecoderState::addMessage(const CFitDefinitionMessage& definition)
 {
     data.messages.append(CFitMessage(definition));
     data.lastMessage = &data.messages.last();
+    data.messageIndex[definition.getGlobalMesgNr()] << (data.messages.size() - 1);
+}
+
+void IFitDecoderState::endMessage()
+{
+    if(data.lastMessage->getGlobalMesgNr() == eMesgNumRecord)
+    {
+        data.records.append(data.messages.size() - 1, *data.lastMessage);
+    }
 }
 
 void IFitDecoderState::addDefinition(const CFitDefinitionMessage &definition)
@@ -86,6 +113,7 @@ void IFitDecoderState::addDefinition(const CFitDefinitionMessage &definition)
 
 void IFitDecoderState::endDefinition()
 {
+    data.lastDefinition->updateDataSize();
     data.definitionHistory.append(*data.lastDefinition);
 }
 
@@ -21,6 +21,7 @@
 
 #include "gis/fit/decoder/CFitDefinitionMessage.h"
 #include "gis/fit/decoder/CFitMessage.h"
+#include "gis/fit/decoder/CFitRecordColumns.h"
 #include "gis/fit/defs/CFitFieldProfile.h"
 
 #include <QtCore>
@@ -54,6 +55,10 @@ public:
         QMap<quint8, CFitDefinitionMessage> definitions;
         QList<CFitDefinitionMessage> definitionHistory;
         QList<CFitMessage> messages;
+        /// the indices into messages for each global message number
+        QHash<quint16, QVector<qint32> > messageIndex;
+        /// typed columns of all record messages
+        CFitRecordColumns records;
         QList<CFitFieldProfile> devFieldProfiles;
     };
 
@@ -62,16 +67,33 @@ public:
 
     virtual void reset() = 0;
     decode_state_e processByte(quint8 &dataByte);
+    /**
+       @brief Process as many bytes of a block as the state can handle in one go
+
+       The default implementation processes a single byte. States that know
+       the size of their data in advance can override this to avoid the
+       byte by byte processing.
+
+       @param dataBlock     pointer to the next byte in the file
+       @param size          number of bytes left in the file
+       @param used          returns the number of bytes processed
+       @return The next decoder state
+     */
+    virtual decode_state_e processBlock(const quint8 * dataBlock, quint32 size, quint32& used);
 
 protected:
     virtual decode_state_e process(quint8 &dataByte) = 0;
 
     CFitMessage* latestMessage() const { return data.lastMessage; }
     void addMessage(const CFitDefinitionMessage& definition);
+    /// to be called when all fields of the latest message are decoded
+    void endMessage();
 
     void setFileLength(quint32 fileLength);
     void resetFileBytesRead();
     void incFileBytesRead();
+    /// count the bytes of a block as read and add them to the CRC
+    void consumeBlock(const quint8 * dataBlock, quint32 size);
     quint32 bytesLeftToRead();
 
     CFitDefinitionMessage* latestDefinition() const { return data.lastDefinition; }
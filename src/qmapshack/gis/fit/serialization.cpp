@@ -94,18 +94,34 @@ static bool readFitRecord(const CFitMessage &mesg, IGisItem::wpt_t &pt)
     return false;
 }
 
-static bool readFitRecord(const CFitMessage &mesg, CTrackData::trkpt_t &pt)
+static void readFitRecord(const CFitRecordColumns &records, qint32 row, CTrackData::trkpt_t &pt)
 {
-    if(readFitRecord(mesg, (IGisItem::wpt_t &)pt))
-    {
-        pt.speed = mesg.getFieldValue(eRecordSpeed).toDouble();
-
-        readKnownExtensions(pt.extensions, mesg);
+    pt.lon = toDegree(records.lon[row]);
+    pt.lat = toDegree(records.lat[row]);
+    pt.ele = (int) records.ele[row];
+    pt.time = toDateTime(records.timestamp[row]);
+    pt.speed = records.speed[row];
 
-        pt.extensions.squeeze();
-        return true;
+    // see gis/trk/CKnownExtension for the keys of the extensions
+    const quint8 valid = records.valid[row];
+    if(valid & CFitRecordColumns::eValidHeartRate)
+    {
+        pt.extensions["gpxtpx:TrackPointExtension|gpxtpx:hr"] = uint(records.heartRate[row]);
     }
-    return false;
+    if(valid & CFitRecordColumns::eValidTemperature)
+    {
+        pt.extensions["gpxtpx:TrackPointExtension|gpxtpx:atemp"] = int(records.temperature[row]);
+    }
+    if(valid & CFitRecordColumns::eValidCadence)
+    {
+        pt.extensions["gpxtpx:TrackPointExtension|gpxtpx:cad"] = uint(records.cadence[row]);
+    }
+    if(valid & CFitRecordColumns::eValidSpeed)
+    {
+        pt.extensions["speed"] = records.speed[row] / 1000.;
+    }
+
+    pt.extensions.squeeze();
 }
 
 static void readFitLocation(const CFitMessage &mesg, IGisItem::wpt_t &wpt)
@@ -233,21 +249,36 @@ void CGisItemTrk::readTrkFromFit(CFitStream &stream)
     // Record messages can either be at the beginning or in chronological order within the record
     // messages. Garmin devices uses the chronological ordering. We only consider the chronological
     // order, otherwise timestamps (of records and events) must be compared to each other.
+    //
+    // The records are read from the decoder's typed columns. Events and segment points are looked up
+    // by the stream's index. All three are merged by their position in the stream.
+    const CFitRecordColumns& records = stream.getRecords();
+    const QVector<qint32> events = stream.indexOfMesg(eMesgNumEvent);
+    const QVector<qint32> segmentPoints = stream.indexOfMesg(eMesgNumSegmentPoint);
+
+    static const qint32 NOPOS = std::numeric_limits<qint32>::max();
+    qint32 r = 0;
+    qint32 e = 0;
+    qint32 s = 0;
+
     CTrackData::trkseg_t seg;
-    do
+    seg.pts.reserve(records.size() + segmentPoints.size());
+    while(r < records.size() || e < events.size() || s < segmentPoints.size())
     {
-        const CFitMessage& mesg = stream.nextMesg();
-        if(mesg.getGlobalMesgNr() == eMesgNumRecord)
+        const qint32 posRecord = r < records.size() ? records.mesgIdx[r] : NOPOS;
+        const qint32 posEvent = e < events.size() ? events[e] : NOPOS;
+        const qint32 posSegmentPoint = s < segmentPoints.size() ? segmentPoints[s] : NOPOS;
+
+        if(posRecord < posEvent && posRecord < posSegmentPoint)
         {
             // for documentation: MesgNumActivity, MesgNumSession, MesgNumLap, MesgNumLength could also contain data
             CTrackData::trkpt_t pt;
-            if(readFitRecord(mesg, pt))
-            {
-                seg.pts.append(std::move(pt));
-            }
+            readFitRecord(records, r++, pt);
+            seg.pts.append(std::move(pt));
         }
-        else if(mesg.getGlobalMesgNr() ==  eMesgNumEvent)
+        else if(posEvent < posSegmentPoint)
         {
+            const CFitMessage& mesg = stream.mesgAt(events[e++]);
             if(mesg.getFieldValue(eEventEvent).toUInt() == eEventTimer)
             {
                 uint event = mesg.getFieldValue(eEventEventType).toUInt();
@@ -261,16 +292,15 @@ void CGisItemTrk::readTrkFromFit(CFitStream &stream)
                 }
             }
         }
-        else if(mesg.getGlobalMesgNr() == eMesgNumSegmentPoint)
+        else
         {
             CTrackData::trkpt_t pt;
-            if(readFitSegmentPoint(mesg, pt, timeCreated))
+            if(readFitSegmentPoint(stream.mesgAt(segmentPoints[s++]), pt, timeCreated))
             {
                 seg.pts.append(std::move(pt));
             }
         }
     }
-    while (stream.hasMoreMesg());
 
     // append last segment if it is not empty.
     // navigation course files do not have to have start / stop event, so add the segment now.
@@ -75,6 +75,24 @@ CGpxProject::CGpxProject(const QString &filename, const IGisProject * project, I
     valid = true;
 }
 
+CGpxProject::CGpxProject(const QString &filename, const QDomDocument& xml, IDevice * parent)
+    : IGisProject(eTypeGpx, filename, parent)
+{
+    setIcon(CGisListWks::eColumnIcon, QIcon("://icons/32x32/GpxProject.png"));
+    blockUpdateItems(true);
+    try
+    {
+        loadGpx(filename, xml, this);
+    }
+    catch(QString &errormsg)
+    {
+        QMessageBox::critical(CMainWindow::getBestWidgetForParent(),
+                              tr("Failed to load file %1...").arg(filename), errormsg, QMessageBox::Abort);
+        valid = false;
+    }
+    blockUpdateItems(false);
+}
+
 CGpxProject::~CGpxProject()
 {
 }
@@ -108,6 +126,14 @@ void CGpxProject::loadGpx(const QString &filename, CGpxProject *project)
         return;
     }
 
+    QDomDocument xml;
+    readGpx(filename, xml);
+    loadGpx(filename, xml, project);
+}
+
+void CGpxProject::readGpx(const QString &filename, QDomDocument& xml)
+{
+    QFile file(filename);
     if(!file.open(QIODevice::ReadOnly))
     {
         throw tr("Failed to open %1").arg(filename);
@@ -115,7 +141,6 @@ void CGpxProject::loadGpx(const QString &filename, CGpxProject *project)
 
 
     // load file content to xml document
-    QDomDocument xml;
     QString msg;
     int line;
     int column;
@@ -125,7 +150,10 @@ void CGpxProject::loadGpx(const QString &filename, CGpxProject *project)
         throw tr("Failed to read: %1\nline %2, column %3:\n %4").arg(filename).arg(line).arg(column).arg(msg);
     }
     file.close();
+}
 
+void CGpxProject::loadGpx(const QString &filename, const QDomDocument& xml, CGpxProject *project)
+{
     int N;
     QDomElement xmlGpx = xml.documentElement();
     if(xmlGpx.tagName() != "gpx")
@@ -23,6 +23,7 @@
 
 class CGisListWks;
 class CGisDraw;
+class QDomDocument;
 
 class CGpxProject : public IGisProject
 {
@@ -31,6 +32,8 @@ public:
     CGpxProject(const QString &filename, CGisListWks * parent);
     CGpxProject(const QString &filename, IDevice * parent);
     CGpxProject(const QString &filename, const IGisProject * project, IDevice * parent);
+    /// create project from a file already read by readGpx()
+    CGpxProject(const QString &filename, const QDomDocument& xml, IDevice * parent);
     virtual ~CGpxProject();
 
     const QString getFileDialogFilter() const override
@@ -51,6 +54,18 @@ public:
     static bool saveAs(const QString& fn, IGisProject& project, bool strictGpx11);
 
     static void loadGpx(const QString &filename, CGpxProject *project);
+    static void loadGpx(const QString &filename, const QDomDocument& xml, CGpxProject *project);
+
+    /**
+       @brief Read a GPX file into a XML document
+
+       This does not touch any project. Thus it can be done by any thread.
+
+       @param filename  the GPX file
+       @param xml       the document to read the file into
+       throws: QString in case of a failure
+     */
+    static void readGpx(const QString &filename, QDomDocument& xml);
 
 private:
     void loadGpx(const QString& filename);
@@ -775,7 +775,7 @@ QString CDetailsPrj::getStatistics(const wpt_info_t &info) const
 
 QImage CDetailsPrj::getImage(const wpt_info_t &info) const
 {
-    QImage image(info.images.first().pixmap);
+    QImage image(info.images.first().getImage());
 
     int w = image.width();
     int h = image.height();
@@ -352,6 +352,8 @@ void IGisProject::switchOnCorrelation()
 
 void IGisProject::updateItems()
 {
+    wptClustersChanged = true;
+
     if(noUpdate)
     {
         return;
@@ -515,6 +517,16 @@ void IGisProject::setupName(const QString &defaultName)
     setText(CGisListWks::eColumnName, getName());
 }
 
+void IGisProject::restore(QDataStream& stream)
+{
+    *this << stream;
+
+    markAsSaved();
+    setupName(QFileInfo(filename).completeBaseName().replace("_", " "));
+    setToolTip(CGisListWks::eColumnName, getInfo());
+    valid = true;
+}
+
 void IGisProject::markAsSaved()
 {
     setText(CGisListWks::eColumnDecoration, autoSave ? "A" : "");
@@ -873,6 +885,28 @@ void IGisProject::insertCopyOfItem(IGisItem * item, int off, CSelectCopyAction::
     }
 }
 
+void IGisProject::updateWptClusters()
+{
+    if(!wptClustersChanged)
+    {
+        return;
+    }
+    wptClustersChanged = false;
+
+    wptClusters.beginUpdate();
+    for(int i = 0; i < childCount(); i++)
+    {
+        CGisItemWpt * wpt = dynamic_cast<CGisItemWpt*>(child(i));
+        // waypoints with a bubble or an area are never part of a cluster
+        if((nullptr == wpt) || wpt->isHidden() || wpt->hasBubble() || wpt->hasRadius())
+        {
+            continue;
+        }
+        wptClusters.update(wpt);
+    }
+    wptClusters.endUpdate();
+}
+
 void IGisProject::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CGisDraw * gis)
 {
     if(!isVisible())
@@ -880,6 +914,34 @@ void IGisProject::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
         return;
     }
 
+    /*
+        At coarse scales waypoints close to each other are drawn as a
+        single cluster marker. Only waypoints alone in their cell are
+        drawn as usual.
+     */
+    const qint32 level = gis->getClusterLevel(viewport);
+    QSet<CGisItemWpt*> wptsSeparate;
+    if(level >= 0)
+    {
+        updateWptClusters();
+
+        QList<CWptClusterIndex::cluster_t> clusters;
+        wptClusters.getClusters(level, viewport.boundingRect(), clusters);
+        for(const CWptClusterIndex::cluster_t& cluster : clusters)
+        {
+            if(cluster.wpts.isEmpty())
+            {
+                QPointF pos = cluster.pos;
+                gis->convertRad2Px(pos);
+                gis->drawCluster(p, pos, cluster.count, blockedAreas);
+            }
+            else
+            {
+                wptsSeparate += cluster.wpts.toSet();
+            }
+        }
+    }
+
     for(int i = 0; i < childCount(); i++)
     {
         if(gis->needsRedraw())
@@ -893,6 +955,21 @@ void IGisProject::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
             continue;
         }
 
+        if(level >= 0)
+        {
+            CGisItemWpt * wpt = dynamic_cast<CGisItemWpt*>(item);
+            if((wpt != nullptr) && wptClusters.contains(wpt) && !wptsSeparate.contains(wpt))
+            {
+                wpt->setInCluster();
+                continue;
+            }
+        }
+
+        if(!gis->isInDirtyArea(*item))
+        {
+            continue;
+        }
+
         item->drawItem(p, viewport, blockedAreas, gis);
     }
 }
@@ -937,6 +1014,11 @@ void IGisProject::drawLabel(QPainter& p, const QPolygonF& viewport, QList<QRectF
             continue;
         }
 
+        if(!gis->isInDirtyArea(*item))
+        {
+            continue;
+        }
+
         item->drawLabel(p, viewport, blockedAreas, fm, gis);
     }
 }
@@ -1199,6 +1281,8 @@ void IGisProject::setWorkspaceFilter(const CSearch& search)
 
 void IGisProject::applyFilters()
 {
+    wptClustersChanged = true;
+
     const int N = childCount();
 
     for(int n = 0; n < N; n++)
@@ -24,6 +24,7 @@
 #include "gis/rte/router/IRouter.h"
 #include "gis/search/CProjectFilterItem.h"
 #include "gis/search/CSearch.h"
+#include "gis/wpt/CWptClusterIndex.h"
 #include "helpers/CSelectCopyAction.h"
 #include <QDebug>
 #include <QMessageBox>
@@ -478,6 +479,16 @@ public:
      */
     virtual QDataStream& operator>>(QDataStream& stream) const;
 
+    /**
+       @brief Restore the project from a stream written by operator>>()
+
+       This is used to restore projects from a cache instead of loading
+       the original file. The project is marked as saved and valid.
+
+       @param stream the binary data stream
+     */
+    void restore(QDataStream& stream);
+
     /**
        @brief writeMetadata
        @param doc
@@ -562,6 +573,8 @@ protected:
     void readMetadata(const QDomNode& xml, metadata_t& metadata);
     void updateItems();
     void updateItemCounters();
+    /// update wptClusters if waypoints have changed
+    void updateWptClusters();
     void updateDecoration();
     void sortItems();
     void sortItems(QList<IGisItem*>& items) const;
@@ -612,6 +625,11 @@ protected:
 
     qint32 cntItemsByType[IGisItem::eTypeMax];
 
+    /// the waypoints drawn as clusters at coarse scales
+    CWptClusterIndex wptClusters;
+    /// set if the waypoints have to be synchronized with wptClusters before drawing
+    bool wptClustersChanged = true;
+
     qint32 cntTrkPts                 = 0;
     qint32 cntWpts                   = 0;
 
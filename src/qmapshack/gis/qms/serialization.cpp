@@ -28,7 +28,7 @@
 
 #include <QtWidgets>
 
-#define VER_TRK         quint8(7)
+#define VER_TRK         quint8(9)
 #define VER_WPT         quint8(4)
 #define VER_RTE         quint8(4)
 #define VER_AREA        quint8(2)
@@ -40,16 +40,17 @@
 #define VER_WPT_T       quint8(1)
 #define VER_GC_T        quint8(3)
 #define VER_GCLOG_T     quint8(1)
-#define VER_IMAGE       quint8(1)
+#define VER_IMAGE       quint8(2)
 #define VER_PROJECT     quint8(5)
 #define VER_COPYRIGHT   quint8(1)
 #define VER_PERSON      quint8(1)
-#define VER_HIST        quint8(1)
+#define VER_HIST        quint8(2)
 #define VER_HIST_EVT    quint8(3)
 #define VER_ITEM        quint8(3)
 #define VER_CVALUE      quint8(1)
 #define VER_CLIMIT      quint8(1)
 #define VER_ENERGYCYCLE quint8(1)
+#define VER_TRK_DERIVED quint8(1)
 
 #define MAGIC_SIZE      10
 #define MAGIC_TRK       "QMTrk     "
@@ -165,6 +166,13 @@ QDataStream& operator<<(QDataStream& stream, const IGisItem::history_t& h)
     stream << h.histIdxInitial;
     stream << h.histIdxCurrent;
     stream << h.events;
+
+    stream << qint32(h.blobs.size());
+    for(const QSharedPointer<const QByteArray>& blob : h.blobs)
+    {
+        stream << *blob;
+    }
+    stream << h.derived;
     return stream;
 }
 
@@ -176,6 +184,24 @@ QDataStream& operator>>(QDataStream& stream, IGisItem::history_t& h)
     stream >> h.histIdxCurrent;
     stream >> h.events;
 
+    h.blobs.clear();
+    if(version > 1)
+    {
+        qint32 N;
+        stream >> N;
+        for(qint32 n = 0; n < N; n++)
+        {
+            QByteArray data;
+            QByteArray key;
+            stream >> data;
+
+            const CWptImageCache::blob_t& blob = CWptImageCache::intern(data, key);
+            h.blobs[key] = blob;
+        }
+
+        stream >> h.derived;
+    }
+
     if(h.histIdxCurrent >= h.events.size())
     {
         h.histIdxCurrent = h.events.size() - 1;
@@ -317,11 +343,9 @@ QDataStream& operator>>(QDataStream& stream, CGisItemWpt::geocache_t& geocache)
 
 QDataStream& operator<<(QDataStream& stream, const CGisItemWpt::image_t& image)
 {
-    QBuffer imgBuf;
-    image.pixmap.save(&imgBuf, "JPEG");
-
+    // the data itself is stored once in the history, see IGisItem::history_t::blobs
     stream << VER_IMAGE;
-    stream << imgBuf.data();
+    stream << image.getKey();
     stream << image.direction;
     stream << image.info;
     stream << image.filePath;
@@ -333,16 +357,24 @@ QDataStream& operator<<(QDataStream& stream, const CGisItemWpt::image_t& image)
 QDataStream& operator>>(QDataStream& stream, CGisItemWpt::image_t& image)
 {
     quint8 version;
-    QBuffer imgBuf;
+    QByteArray data;
 
     stream >> version;
-    stream >> imgBuf.buffer();
+    stream >> data;
     stream >> image.direction;
     stream >> image.info;
     stream >> image.filePath;
     stream >> image.fileName;
 
-    image.pixmap.load(&imgBuf, "JPEG");
+    if(version > 1)
+    {
+        image.setKey(data);
+    }
+    else
+    {
+        // the image is decoded on demand
+        image.setData(data);
+    }
 
     return stream;
 }
@@ -665,6 +697,14 @@ QDataStream& CGisItemTrk::operator<<(QDataStream& stream)
     trk.segs.clear();
     in >> trk.segs;
 
+    // the secondary data is stored once with the history, see getDerivedData()
+    secondaryDataCache = history.derived;
+    hasSecondaryData = false;
+    if(version == 8)
+    {
+        in >> secondaryDataCache;
+    }
+
     /* [Issue #408] Export of a database is broken
 
         Exporting the database is done in a thread other than the main GUI thread.
@@ -683,6 +723,85 @@ QDataStream& CGisItemTrk::operator<<(QDataStream& stream)
     return stream;
 }
 
+QByteArray CGisItemTrk::saveSecondaryData() const
+{
+    QVector<qreal> deltaDistance;
+    QVector<qreal> slope;
+    QVector<qreal> speed;
+
+    deltaDistance.reserve(cntVisiblePoints);
+    slope.reserve(cntVisiblePoints);
+    speed.reserve(cntVisiblePoints);
+
+    for(const CTrackData::trkpt_t& trkpt : trk)
+    {
+        if(trkpt.isHidden())
+        {
+            continue;
+        }
+
+        deltaDistance << trkpt.deltaDistance;
+        slope << trkpt.slope1;
+        speed << trkpt.speed;
+    }
+
+    if(deltaDistance.isEmpty())
+    {
+        return QByteArray();
+    }
+
+    QByteArray buffer;
+    QDataStream out(&buffer, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.setVersion(QDataStream::Qt_5_2);
+
+    out << VER_TRK_DERIVED;
+    out << getSecondaryDataHash();
+    out << deltaDistance;
+    out << slope;
+    out << speed;
+
+    return buffer;
+}
+
+bool CGisItemTrk::loadSecondaryData(const QByteArray& data, QVector<qreal>& deltaDistance, QVector<qreal>& slope, QVector<qreal>& speed) const
+{
+    quint8 version;
+    QByteArray hash;
+
+    QDataStream in(data);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setVersion(QDataStream::Qt_5_2);
+
+    // data of a later version might be computed differently
+    in >> version;
+    if(version != VER_TRK_DERIVED)
+    {
+        return false;
+    }
+
+    in >> hash;
+    if(hash != getSecondaryDataHash())
+    {
+        return false;
+    }
+
+    in >> deltaDistance;
+    in >> slope;
+    in >> speed;
+
+    qint32 cntVisible = 0;
+    for(const CTrackData::trkpt_t& trkpt : trk)
+    {
+        cntVisible += trkpt.isHidden() ? 0 : 1;
+    }
+
+    return (in.status() == QDataStream::Ok)
+           && (deltaDistance.size() == cntVisible)
+           && (slope.size() == cntVisible)
+           && (speed.size() == cntVisible);
+}
+
 QDataStream& CGisItemWpt::operator<<(QDataStream& stream)
 {
     quint8 version;
@@ -1095,7 +1214,7 @@ QDataStream& IGisProject::operator>>(QDataStream& stream) const
         }
         stream << VER_ITEM;
         stream << quint8(item->type());
-        stream << item->getHistory();
+        stream << item->getHistoryToSave();
         stream << quint8(item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged);
         stream << item->getLastDatabaseHash();
     }
@@ -1108,7 +1227,7 @@ QDataStream& IGisProject::operator>>(QDataStream& stream) const
         }
         stream << VER_ITEM;
         stream << quint8(item->type());
-        stream << item->getHistory();
+        stream << item->getHistoryToSave();
         stream << quint8(item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged);
         stream << item->getLastDatabaseHash();
     }
@@ -1121,7 +1240,7 @@ QDataStream& IGisProject::operator>>(QDataStream& stream) const
         }
         stream << VER_ITEM;
         stream << quint8(item->type());
-        stream << item->getHistory();
+        stream << item->getHistoryToSave();
         stream << quint8(item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged);
         stream << item->getLastDatabaseHash();
     }
@@ -1134,7 +1253,7 @@ QDataStream& IGisProject::operator>>(QDataStream& stream) const
         }
         stream << VER_ITEM;
         stream << quint8(item->type());
-        stream << item->getHistory();
+        stream << item->getHistoryToSave();
         stream << quint8(item->data(1, Qt::UserRole).toUInt() & IGisItem::eMarkChanged);
         stream << item->getLastDatabaseHash();
     }
@@ -338,6 +338,97 @@ int CRouterBRouter::calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& c
     return synchronousRequest(points, nogos, coords, costs);
 }
 
+bool CRouterBRouter::hasConcurrentRouting()
+{
+    // never flood the public service with requests
+    return hasFastRouting() && setup->installMode == CRouterBRouterSetup::eModeLocal;
+}
+
+int CRouterBRouter::calcRoutes(const QVector<QPointF>& p1, const QVector<QPointF>& p2, QVector<QPolygonF>& coords, QVector<qreal>& costs)
+{
+    if(!hasConcurrentRouting())
+    {
+        return IRouter::calcRoutes(p1, p2, coords, costs);
+    }
+
+    const int N = qMin(p1.size(), p2.size());
+    coords.fill(QPolygonF(), N);
+    costs.fill(-1, N);
+
+    if(N == 0)
+    {
+        return 0;
+    }
+
+    if (!mutex.tryLock())
+    {
+        return -1;
+    }
+
+    if (localBRouter->isBRouterNotRunning())
+    {
+        localBRouter->startBRouter();
+    }
+
+    synchronous = true;
+
+    QList<IGisItem*> nogos;
+    CGisWorkspace::self().getNogoAreas(nogos);
+
+    // The network access manager limits the number of parallel
+    // connections per host. Issue all requests at once and let
+    // it do the scheduling.
+    QEventLoop eventLoop;
+    int pending = N;
+    QVector<QNetworkReply*> replies(N, nullptr);
+    for(int i = 0; i < N; i++)
+    {
+        const QVector<QPointF> points = {p1[i] * RAD_TO_DEG, p2[i] * RAD_TO_DEG};
+        QNetworkReply * reply = networkAccessManager->get(getRequest(points, nogos));
+        connect(reply, &QNetworkReply::finished, &eventLoop, [&pending, &eventLoop]()
+        {
+            if(--pending == 0)
+            {
+                eventLoop.quit();
+            }
+        });
+        replies[i] = reply;
+    }
+
+    //Processing userinputevents in local eventloop would cause a SEGV when clicking 'abort' of calling LineOp
+    eventLoop.exec(QEventLoop::ExcludeUserInputEvents);
+
+    int cnt = 0;
+    for(int i = 0; i < N; i++)
+    {
+        QNetworkReply * reply = replies[i];
+        if(reply->error() == QNetworkReply::NoError)
+        {
+            try
+            {
+                parseResponse(reply->readAll(), coords[i], &costs[i]);
+            }
+            catch(const QString&)
+            {
+                coords[i].clear();
+            }
+        }
+
+        if(coords[i].isEmpty())
+        {
+            costs[i] = -1;
+        }
+        else
+        {
+            cnt++;
+        }
+        reply->deleteLater();
+    }
+
+    mutex.unlock();
+    return cnt;
+}
+
 int CRouterBRouter::synchronousRequest(const QVector<QPointF> &points, const QList<IGisItem *> &nogos, QPolygonF &coords, qreal* costs = nullptr)
 {
     if (!mutex.tryLock())
@@ -379,63 +470,7 @@ int CRouterBRouter::synchronousRequest(const QVector<QPointF> &points, const QLi
         }
         slotClearError();
 
-        const QByteArray &res = reply->readAll();
-
-        if(res.isEmpty())
-        {
-            throw tr("response is empty");
-        }
-
-        QDomDocument xml;
-        xml.setContent(res);
-        const QDomElement &xmlGpx = xml.documentElement();
-
-        if(xmlGpx.isNull() || xmlGpx.tagName() != "gpx")
-        {
-            throw QString(res);
-        }
-        setup->parseBRouterVersion(xmlGpx.attribute("creator"));
-
-        // read the shape
-        const QDomNodeList &xmlLatLng = xmlGpx.firstChildElement("trk")
-                                        .firstChildElement("trkseg")
-                                        .elementsByTagName("trkpt");
-        for(int n = 0; n < xmlLatLng.size(); n++)
-        {
-            const QDomElement &elem   = xmlLatLng.item(n).toElement();
-            coords << QPointF();
-            QPointF &point = coords.last();
-            point.setX(elem.attribute("lon").toFloat() * DEG_TO_RAD);
-            point.setY(elem.attribute("lat").toFloat() * DEG_TO_RAD);
-        }
-
-        //find costs of route (copied and adapted from CGisItemRte::setResultFromBrouter)
-        if(costs != nullptr)
-        {
-            const QDomNodeList &nodes = xml.childNodes();
-            for (int i = 0; i < nodes.count(); i++)
-            {
-                const QDomNode &node = nodes.at(i);
-                if (!node.isComment())
-                {
-                    continue;
-                }
-                const QString &commentTxt = node.toComment().data();
-                // ' track-length = 180864 filtered ascend = 428 plain-ascend = -172 cost=270249 '
-                const QRegExp rxAscDes("(\\s*track-length\\s*=\\s*)(-?\\d+)(\\s*)(filtered ascend\\s*=\\s*-?\\d+)(\\s*)(plain-ascend\\s*=\\s*-?\\d+)(\\s*)(cost\\s*=\\s*)(-?\\d+)(\\s*)");
-                int pos = rxAscDes.indexIn(commentTxt);
-                if (pos > -1)
-                {
-                    bool ok;
-                    *costs = rxAscDes.cap(9).toDouble(&ok);
-                    if(!ok)
-                    {
-                        *costs = -1;
-                    }
-                }
-                break;
-            }
-        }
+        parseResponse(reply->readAll(), coords, costs);
     }
     catch(const QString& msg)
     {
@@ -454,6 +489,65 @@ int CRouterBRouter::synchronousRequest(const QVector<QPointF> &points, const QLi
     return coords.size();
 }
 
+void CRouterBRouter::parseResponse(const QByteArray &res, QPolygonF &coords, qreal *costs)
+{
+    if(res.isEmpty())
+    {
+        throw tr("response is empty");
+    }
+
+    QDomDocument xml;
+    xml.setContent(res);
+    const QDomElement &xmlGpx = xml.documentElement();
+
+    if(xmlGpx.isNull() || xmlGpx.tagName() != "gpx")
+    {
+        throw QString(res);
+    }
+    setup->parseBRouterVersion(xmlGpx.attribute("creator"));
+
+    // read the shape
+    const QDomNodeList &xmlLatLng = xmlGpx.firstChildElement("trk")
+                                    .firstChildElement("trkseg")
+                                    .elementsByTagName("trkpt");
+    for(int n = 0; n < xmlLatLng.size(); n++)
+    {
+        const QDomElement &elem   = xmlLatLng.item(n).toElement();
+        coords << QPointF();
+        QPointF &point = coords.last();
+        point.setX(elem.attribute("lon").toFloat() * DEG_TO_RAD);
+        point.setY(elem.attribute("lat").toFloat() * DEG_TO_RAD);
+    }
+
+    //find costs of route (copied and adapted from CGisItemRte::setResultFromBrouter)
+    if(costs != nullptr)
+    {
+        const QDomNodeList &nodes = xml.childNodes();
+        for (int i = 0; i < nodes.count(); i++)
+        {
+            const QDomNode &node = nodes.at(i);
+            if (!node.isComment())
+            {
+                continue;
+            }
+            const QString &commentTxt = node.toComment().data();
+            // ' track-length = 180864 filtered ascend = 428 plain-ascend = -172 cost=270249 '
+            const QRegExp rxAscDes("(\\s*track-length\\s*=\\s*)(-?\\d+)(\\s*)(filtered ascend\\s*=\\s*-?\\d+)(\\s*)(plain-ascend\\s*=\\s*-?\\d+)(\\s*)(cost\\s*=\\s*)(-?\\d+)(\\s*)");
+            int pos = rxAscDes.indexIn(commentTxt);
+            if (pos > -1)
+            {
+                bool ok;
+                *costs = rxAscDes.cap(9).toDouble(&ok);
+                if(!ok)
+                {
+                    *costs = -1;
+                }
+            }
+            break;
+        }
+    }
+}
+
 void CRouterBRouter::calcRoute(const IGisItem::key_t& key)
 {
     mutex.lock();
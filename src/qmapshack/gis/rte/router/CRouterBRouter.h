@@ -48,7 +48,9 @@ public:
 
     void calcRoute(const IGisItem::key_t& key) override;
     int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs = nullptr) override;
+    int calcRoutes(const QVector<QPointF>& p1, const QVector<QPointF>& p2, QVector<QPolygonF>& coords, QVector<qreal>& costs) override;
     bool hasFastRouting() override;
+    bool hasConcurrentRouting() override;
     QString getOptions() override;
     void routerSelected() override;
 
@@ -75,6 +77,7 @@ private:
     bool isMinimumVersion(int major, int minor, int patch) const;
     void updateBRouterStatus() const;
     int synchronousRequest(const QVector<QPointF>& points, const QList<IGisItem *> &nogos, QPolygonF &coords, qreal *costs);
+    void parseResponse(const QByteArray& res, QPolygonF& coords, qreal *costs);
     QNetworkRequest getRequest(const QVector<QPointF>& routePoints, const QList<IGisItem *> &nogos) const;
     QUrl getServiceUrl() const;
 
@@ -0,0 +1,281 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/CGisWorkspace.h"
+#include "gis/db/macros.h"
+#include "gis/rte/router/CRouterCache.h"
+#include "helpers/CSettings.h"
+#include "setup/IAppSetup.h"
+
+#include <QtSql>
+
+#undef  DB_VERSION
+#define DB_VERSION 1
+
+/// the maximum number of points held in memory
+#define MAX_POINTS_IN_MEMORY 2000000
+/// the maximum number of segments kept in the database
+#define MAX_SEGMENTS_IN_DB  100000
+/// the number of used segments collected before their time of use is written
+#define MAX_KEYS_USED       1000
+
+CRouterCache * CRouterCache::pSelf = nullptr;
+
+CRouterCache::CRouterCache(QObject *parent)
+    : QObject(parent)
+    , cache(MAX_POINTS_IN_MEMORY)
+{
+    pSelf = this;
+
+    SETTINGS;
+    persistent = cfg.value("Route/cacheOnDisk", persistent).toBool();
+
+    if(persistent)
+    {
+        openDB();
+    }
+}
+
+CRouterCache::~CRouterCache()
+{
+    SETTINGS;
+    cfg.setValue("Route/cacheOnDisk", persistent);
+
+    closeDB();
+}
+
+void CRouterCache::setPersistent(bool yes)
+{
+    if(persistent == yes)
+    {
+        return;
+    }
+
+    persistent = yes;
+    if(persistent)
+    {
+        openDB();
+    }
+    else
+    {
+        closeDB();
+    }
+}
+
+void CRouterCache::openDB()
+{
+    db = QSqlDatabase::addDatabase("QSQLITE", "RouterCache");
+    db.setDatabaseName(QDir(IAppSetup::getPlatformInstance()->userDataPath()).filePath("routercache.db"));
+    if(!db.open())
+    {
+        qWarning() << "Failed to open router cache" << db.lastError();
+        return;
+    }
+
+    QSqlQuery query(db);
+    QUERY_RUN("PRAGMA synchronous=OFF",        return )
+    QUERY_RUN("PRAGMA temp_store=MEMORY",      return )
+    QUERY_RUN("PRAGMA page_size=8192",         return )
+
+    if(!query.exec("SELECT version FROM versioninfo") || !query.next() || (query.value(0).toInt() != DB_VERSION))
+    {
+        // it's just a cache. No need to migrate anything.
+        QUERY_RUN("DROP TABLE IF EXISTS versioninfo", NO_CMD)
+        QUERY_RUN("DROP TABLE IF EXISTS segments",    NO_CMD)
+        initDB();
+    }
+
+    // drop the segments not used for the longest time
+    query.prepare("DELETE FROM segments WHERE hash IN (SELECT hash FROM segments ORDER BY lastused DESC LIMIT -1 OFFSET :max)");
+    query.bindValue(":max", MAX_SEGMENTS_IN_DB);
+    QUERY_EXEC(NO_CMD);
+}
+
+void CRouterCache::closeDB()
+{
+    if(!db.isValid())
+    {
+        return;
+    }
+
+    flushLastUsed();
+
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase("RouterCache");
+}
+
+void CRouterCache::initDB()
+{
+    QSqlQuery query(db);
+
+    if(query.exec( "CREATE TABLE versioninfo ( version TEXT )"))
+    {
+        query.prepare( "INSERT INTO versioninfo (version) VALUES(:version)");
+        query.bindValue(":version", DB_VERSION);
+        QUERY_EXEC();
+    }
+
+    QUERY_RUN("CREATE TABLE segments ("
+              "hash           BLOB PRIMARY KEY,"
+              "costs          REAL NOT NULL,"
+              "coords         BLOB NOT NULL,"
+              "lastused       INTEGER NOT NULL"
+              ")", NO_CMD)
+
+    QUERY_RUN("CREATE INDEX segments_lastused ON segments (lastused)", NO_CMD)
+}
+
+void CRouterCache::flushLastUsed()
+{
+    if(keysUsed.isEmpty() || !db.isOpen())
+    {
+        keysUsed.clear();
+        return;
+    }
+
+    db.transaction();
+
+    QSqlQuery query(db);
+    query.prepare("UPDATE segments SET lastused=:lastused WHERE hash=:hash");
+    query.bindValue(":lastused", QDateTime::currentDateTimeUtc().toSecsSinceEpoch());
+    for(const QByteArray& key : keysUsed)
+    {
+        query.bindValue(":hash", key);
+        QUERY_EXEC(break);
+    }
+
+    if(!db.commit())
+    {
+        qWarning() << "Failed to commit transaction:" << db.lastError();
+    }
+
+    keysUsed.clear();
+}
+
+QByteArray CRouterCache::getNogoHash() const
+{
+    QList<IGisItem*> nogos;
+    CGisWorkspace::self().getNogoAreas(nogos);
+
+    // the order of the items in the workspace does not matter
+    QStringList hashes;
+    for(IGisItem * item : nogos)
+    {
+        hashes << item->getKey().item + item->getHash();
+    }
+    hashes.sort();
+
+    return QCryptographicHash::hash(hashes.join("|").toUtf8(), QCryptographicHash::Md5);
+}
+
+QByteArray CRouterCache::getKey(const QString& router, const QByteArray& nogos, const QPointF& p1, const QPointF& p2) const
+{
+    QCryptographicHash sha1(QCryptographicHash::Sha1);
+    sha1.addData(router.toUtf8());
+    sha1.addData(nogos);
+
+    // about 0.6 m at the equator
+    const qint32 pts[4] =
+    {
+        qint32(qRound(p1.x() * 1e7)), qint32(qRound(p1.y() * 1e7))
+        , qint32(qRound(p2.x() * 1e7)), qint32(qRound(p2.y() * 1e7))
+    };
+
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream << pts[0] << pts[1] << pts[2] << pts[3];
+    sha1.addData(buffer);
+
+    return sha1.result();
+}
+
+bool CRouterCache::lookup(const QByteArray& key, QPolygonF& coords, qreal& costs)
+{
+    const bool useDB = persistent && db.isOpen();
+
+    segment_t * segment = cache.object(key);
+    if(segment != nullptr)
+    {
+        coords = segment->coords;
+        costs  = segment->costs;
+    }
+    else
+    {
+        if(!useDB)
+        {
+            return false;
+        }
+
+        QSqlQuery query(db);
+        query.prepare("SELECT costs, coords FROM segments WHERE hash=:hash");
+        query.bindValue(":hash", key);
+        QUERY_EXEC(return false);
+
+        if(!query.next())
+        {
+            return false;
+        }
+
+        costs = query.value(0).toReal();
+        QByteArray buffer = query.value(1).toByteArray();
+        QDataStream stream(&buffer, QIODevice::ReadOnly);
+        stream >> coords;
+
+        cache.insert(key, new segment_t {coords, costs}, coords.size());
+    }
+
+    if(useDB)
+    {
+        // the time of use is written in batches
+        keysUsed << key;
+        if(keysUsed.size() >= MAX_KEYS_USED)
+        {
+            flushLastUsed();
+        }
+    }
+
+    return true;
+}
+
+void CRouterCache::insert(const QByteArray& key, const QPolygonF& coords, qreal costs)
+{
+    if(coords.isEmpty())
+    {
+        return;
+    }
+
+    cache.insert(key, new segment_t {coords, costs}, coords.size());
+
+    if(!persistent || !db.isOpen())
+    {
+        return;
+    }
+
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream << coords;
+
+    QSqlQuery query(db);
+    query.prepare("INSERT OR REPLACE INTO segments (hash, costs, coords, lastused) VALUES (:hash, :costs, :coords, :lastused)");
+    query.bindValue(":hash", key);
+    query.bindValue(":costs", costs);
+    query.bindValue(":coords", buffer);
+    query.bindValue(":lastused", QDateTime::currentDateTimeUtc().toSecsSinceEpoch());
+    QUERY_EXEC(NO_CMD);
+}
@@ -0,0 +1,123 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CROUTERCACHE_H
+#define CROUTERCACHE_H
+
+#include <QCache>
+#include <QObject>
+#include <QPolygonF>
+#include <QSet>
+#include <QSqlDatabase>
+
+/**
+   @brief A cache of routed segments
+
+   Each segment is addressed by a hash over the router setup, the no-go
+   areas and the segment's end points rounded to about 0.6m. Thus a segment
+   is routed again as soon as any of these change.
+
+   Segments are kept in memory. Optionally they are stored in a SQLite
+   database, too. By that they survive a restart of QMapShack. This is
+   off by default and can be enabled in the router setup.
+ */
+class CRouterCache : public QObject
+{
+    Q_OBJECT
+public:
+    static CRouterCache& self()
+    {
+        return *pSelf;
+    }
+
+    virtual ~CRouterCache();
+
+    /**
+       @brief Create the key to address a segment
+
+       @param router    a string identifying the router and all it's options
+       @param nogos     the hash over all no-go areas as returned by getNogoHash()
+       @param p1        the start point [rad]
+       @param p2        the end point [rad]
+       @return The key as binary hash
+     */
+    QByteArray getKey(const QString& router, const QByteArray& nogos, const QPointF& p1, const QPointF& p2) const;
+
+    /**
+       @brief Get the hash over all no-go areas currently in the workspace
+
+       This has to iterate over the whole workspace. Thus call it once for all
+       segments of a routing request.
+     */
+    QByteArray getNogoHash() const;
+
+    /**
+       @brief Get a segment from the cache
+
+       @param key       the segment's key
+       @param coords    the segment's routed coordinates [rad]
+       @param costs     the segment's costs as reported by the router
+       @return True if the segment is known.
+     */
+    bool lookup(const QByteArray& key, QPolygonF& coords, qreal& costs);
+
+    /**
+       @brief Add a segment to the cache
+
+       @param key       the segment's key
+       @param coords    the segment's routed coordinates [rad]
+       @param costs     the segment's costs as reported by the router
+     */
+    void insert(const QByteArray& key, const QPolygonF& coords, qreal costs);
+
+    /// enable/disable storing segments in the database
+    void setPersistent(bool yes);
+    bool isPersistent() const
+    {
+        return persistent;
+    }
+
+private:
+    friend class CRouterSetup;
+    CRouterCache(QObject * parent);
+
+    void openDB();
+    void closeDB();
+    void initDB();
+    /// write the time of use of all segments used since the last call in one transaction
+    void flushLastUsed();
+
+    static CRouterCache * pSelf;
+
+    struct segment_t
+    {
+        QPolygonF coords;
+        qreal costs;
+    };
+
+    /// the segments in memory, costs are the number of points
+    QCache<QByteArray, segment_t> cache;
+
+    bool persistent = false;
+    QSqlDatabase db;
+    /// the segments used since the last update of their time of use in the database
+    QSet<QByteArray> keysUsed;
+};
+
+#endif //CROUTERCACHE_H
+
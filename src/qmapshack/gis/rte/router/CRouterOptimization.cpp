@@ -21,9 +21,28 @@
 #include <GeoMath.h>
 #include <helpers/CProgressDialog.h>
 
+#include <QtCore>
+
+/// the number of nearest points to test for Or-opt moves
+#define NUM_NEIGHBOURS 8
+/// the maximum number of cached routes kept from one optimization to the next
+#define MAX_CACHED_ROUTES 20000
+
+QHash<CRouterOptimization::edge_key_t, CRouterOptimization::routing_cache_item_t> CRouterOptimization::routingCache;
+qreal CRouterOptimization::minAirToCostFactor = -1;
+qreal CRouterOptimization::totalAirToCosts = 0;
+qreal CRouterOptimization::totalNumOfRoutes = 0;
+QString CRouterOptimization::routerOptions;
+
 CRouterOptimization::CRouterOptimization()
 {
-    routerOptions = CRouterSetup::self().getOptions();
+}
+
+CRouterOptimization::point_key_t CRouterOptimization::pointKey(const QPointF& pt)
+{
+    const quint32 x = quint32(qint32(qRound(pt.x() * 1e8)));
+    const quint32 y = quint32(qint32(qRound(pt.y() * 1e8)));
+    return (point_key_t(x) << 32) | y;
 }
 
 int CRouterOptimization::optimize(SGisLine &line)
@@ -38,17 +57,19 @@ int CRouterOptimization::optimize(SGisLine &line)
         return 0; //There is nothing to optimize
     }
 
+    // if possible get all costs at once. All steps below will work on real costs then.
+    if(!calcCostMatrix(line))
+    {
+        return -1;
+    }
+
+    buildNeighbourLists(line);
+
     CProgressDialog progress(tr("Optimizing route"), 0, line.length() + 2, nullptr);
 
     //Optimize using air distance and known distances, since this is much faster than routing, especially brouter
-    SGisLine newAirdistanceOrder;
     SGisLine oldAirdistanceOrder = line;
-    qreal gain = createNextBestOrder(oldAirdistanceOrder, newAirdistanceOrder);
-    while(gain < 0)
-    {
-        oldAirdistanceOrder = newAirdistanceOrder;
-        gain = createNextBestOrder(oldAirdistanceOrder, newAirdistanceOrder);
-    }
+    localSearch(oldAirdistanceOrder);
     //Do routing and calculate cost for order found
     qreal airdistanceOrderCosts = getRealRouteCosts(oldAirdistanceOrder);
 
@@ -92,6 +113,10 @@ int CRouterOptimization::optimize(SGisLine &line)
 
         SGisLine newWorkingOrder;
         qreal bestInsertionGain = createNextBestOrder(lastWorkingOrder, newWorkingOrder);
+        if(bestInsertionGain >= 0)
+        {
+            bestInsertionGain = orOptStep(lastWorkingOrder, newWorkingOrder);
+        }
 
         if(bestInsertionGain < 0)
         {
@@ -219,6 +244,230 @@ qreal CRouterOptimization::twoOptStep(const SGisLine &oldOrder, SGisLine &newOrd
     return bestTwoOptGain;
 }
 
+qreal CRouterOptimization::orOptStep(const SGisLine &oldOrder, SGisLine &newOrder)
+{
+    const int N = oldOrder.length();
+
+    QHash<point_key_t, int> positions;
+    for(int i = 0; i < N; i++)
+    {
+        positions[pointKey(oldOrder[i].coord)] = i;
+    }
+
+    qreal bestGain = 0;
+    int bestBegin = -1;
+    int bestLength = 0;
+    int bestBase = -1;
+    bool bestReversed = false;
+
+    for(int length = 1; length <= 3; length++)
+    {
+        // Keep start and end fixed
+        for(int begin = 1; begin + length < N; begin++)
+        {
+            const int end = begin + length - 1;
+            const IGisLine::point_t& first = oldOrder[begin];
+            const IGisLine::point_t& last = oldOrder[end];
+
+            const qreal removeGain = bestKnownDistance(oldOrder[begin - 1], first)
+                                     + bestKnownDistance(last, oldOrder[end + 1])
+                                     - bestKnownDistance(oldOrder[begin - 1], oldOrder[end + 1]);
+            if(removeGain <= 0)
+            {
+                continue;
+            }
+
+            // costs might not be symmetric. Thus reversing the chain changes it's costs, too.
+            qreal reverseCosts = 0;
+            for(int i = begin; i < end; i++)
+            {
+                reverseCosts += bestKnownDistance(oldOrder[i + 1], oldOrder[i])
+                                - bestKnownDistance(oldOrder[i], oldOrder[i + 1]);
+            }
+
+            QSet<int> bases;
+            for(const point_key_t& key : neighbours.value(pointKey(first.coord)) + neighbours.value(pointKey(last.coord)))
+            {
+                const int pos = positions.value(key, -1);
+                if(pos < 0)
+                {
+                    continue;
+                }
+                // insert after or before the neighbour
+                bases << pos << pos - 1;
+            }
+
+            for(int base : bases)
+            {
+                // the chain is inserted between base and base + 1
+                if(base < 0 || base >= N - 1 || (base >= begin - 1 && base <= end))
+                {
+                    continue;
+                }
+
+                const IGisLine::point_t& a = oldOrder[base];
+                const IGisLine::point_t& b = oldOrder[base + 1];
+                const qreal edgeCosts = bestKnownDistance(a, b);
+
+                const qreal forwardGain = bestKnownDistance(a, first) + bestKnownDistance(last, b) - edgeCosts - removeGain;
+                if(forwardGain < bestGain)
+                {
+                    bestGain = forwardGain;
+                    bestBegin = begin;
+                    bestLength = length;
+                    bestBase = base;
+                    bestReversed = false;
+                }
+
+                const qreal reverseGain = bestKnownDistance(a, last) + bestKnownDistance(first, b) - edgeCosts - removeGain + reverseCosts;
+                if(reverseGain < bestGain)
+                {
+                    bestGain = reverseGain;
+                    bestBegin = begin;
+                    bestLength = length;
+                    bestBase = base;
+                    bestReversed = true;
+                }
+            }
+        }
+    }
+
+    newOrder = SGisLine(oldOrder);
+    if(bestBegin >= 0 && bestBase >= 0)
+    {
+        QVector<IGisLine::point_t> chain = oldOrder.mid(bestBegin, bestLength);
+        if(bestReversed)
+        {
+            std::reverse(chain.begin(), chain.end());
+        }
+
+        newOrder.remove(bestBegin, bestLength);
+        // removing the chain will shift the base if the base was behind it
+        const int insertAt = bestBase < bestBegin ? bestBase + 1 : bestBase + 1 - bestLength;
+        for(int i = 0; i < chain.size(); i++)
+        {
+            newOrder.insert(insertAt + i, chain[i]);
+        }
+    }
+    return bestGain;
+}
+
+void CRouterOptimization::localSearch(SGisLine &order)
+{
+    SGisLine newOrder;
+    forever
+    {
+        qreal gain = createNextBestOrder(order, newOrder);
+        if(gain >= 0)
+        {
+            gain = orOptStep(order, newOrder);
+        }
+
+        if(gain >= 0)
+        {
+            break;
+        }
+        order = newOrder;
+    }
+}
+
+void CRouterOptimization::buildNeighbourLists(const SGisLine &line)
+{
+    neighbours.clear();
+
+    const int N = line.length();
+    for(int i = 0; i < N; i++)
+    {
+        QVector<QPair<qreal, point_key_t> > candidates;
+        for(int j = 0; j < N; j++)
+        {
+            if(i != j)
+            {
+                candidates << qMakePair(bestKnownDistance(line[i], line[j]), pointKey(line[j].coord));
+            }
+        }
+
+        const int K = qMin(NUM_NEIGHBOURS, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + K, candidates.end());
+
+        QVector<point_key_t>& list = neighbours[pointKey(line[i].coord)];
+        for(int k = 0; k < K; k++)
+        {
+            list << candidates[k].second;
+        }
+    }
+}
+
+bool CRouterOptimization::calcCostMatrix(const SGisLine &line)
+{
+    if(!CRouterSetup::self().hasConcurrentRouting())
+    {
+        return true;
+    }
+
+    // collect all missing routes. No route leads back to
+    // the start and no route starts at the end.
+    const int N = line.length();
+    QVector<QPointF> from;
+    QVector<QPointF> to;
+    for(int i = 0; i < N - 1; i++)
+    {
+        for(int j = 1; j < N; j++)
+        {
+            if(i == j)
+            {
+                continue;
+            }
+
+            const edge_key_t& key = qMakePair(pointKey(line[i].coord), pointKey(line[j].coord));
+            if(key.first != key.second && !routingCache.contains(key))
+            {
+                from << line[i].coord;
+                to << line[j].coord;
+            }
+        }
+    }
+
+    if(from.isEmpty())
+    {
+        return true;
+    }
+
+    // request the routes in chunks to be able to report progress
+    const int total = from.size();
+    const int chunk = qMax(16, 4 * QThread::idealThreadCount());
+
+    CProgressDialog progress(tr("Calculate costs between all points"), 0, total, nullptr);
+    for(int i = 0; i < total; i += chunk)
+    {
+        const int n = qMin(chunk, total - i);
+
+        QVector<QPolygonF> routes;
+        QVector<qreal> costs;
+        if(CRouterSetup::self().calcRoutes(from.mid(i, n), to.mid(i, n), routes, costs) < 0)
+        {
+            // the router is busy, go on with routes on demand
+            return true;
+        }
+
+        for(int k = 0; k < n; k++)
+        {
+            if(costs[k] >= 0)
+            {
+                addRoute(from[i + k], to[i + k], {routes[k], costs[k]});
+            }
+        }
+
+        progress.setValue(i + n);
+        if(progress.wasCanceled())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 qreal CRouterOptimization::getRealRouteCosts(const SGisLine &line, qreal costCutoff)
 {
     qreal costs = 0;
@@ -241,18 +490,10 @@ qreal CRouterOptimization::getRealRouteCosts(const SGisLine &line, qreal costCut
 
 qreal CRouterOptimization::bestKnownDistance(const IGisLine::point_t& start, const IGisLine::point_t& end)
 {
-    //10 digits after the decimal point in exponential format should be by far enough
-    QString start_key = QString::number(start.coord.x(), 'e', 10) + QString::number(start.coord.y(), 'e', 10);
-    QString end_key = QString::number(end.coord.x(), 'e', 10) + QString::number(end.coord.y(), 'e', 10);
-
-    if(!routingCache.contains(start_key))
-    {
-        routingCache[start_key] = {};
-    }
-
-    if(routingCache[start_key].contains(end_key))
+    const QHash<edge_key_t, routing_cache_item_t>::const_iterator it = routingCache.constFind(qMakePair(pointKey(start.coord), pointKey(end.coord)));
+    if(it != routingCache.constEnd())
     {
-        return routingCache[start_key][end_key].costs;
+        return it->costs;
     }
     else
     {
@@ -274,15 +515,10 @@ qreal CRouterOptimization::bestKnownDistance(const IGisLine::point_t& start, con
 
 const CRouterOptimization::routing_cache_item_t* CRouterOptimization::getRoute(const QPointF& start, const QPointF& end)
 {
-    QString start_key = QString::number(start.x(), 'e', 10) + QString::number(start.y(), 'e', 10);
-    QString end_key = QString::number(end.x(), 'e', 10) + QString::number(end.y(), 'e', 10);
-
-    if(!routingCache.contains(start_key))
-    {
-        routingCache[start_key] = {};
-    }
+    const edge_key_t& key = qMakePair(pointKey(start), pointKey(end));
 
-    if(!routingCache[start_key].contains(end_key))
+    QHash<edge_key_t, routing_cache_item_t>::const_iterator it = routingCache.constFind(key);
+    if(it == routingCache.constEnd())
     {
         routing_cache_item_t cacheItem;
         int response = CRouterSetup::self().calcRoute(start, end, cacheItem.route, &cacheItem.costs);
@@ -290,17 +526,23 @@ const CRouterOptimization::routing_cache_item_t* CRouterOptimization::getRoute(c
         {
             return nullptr;
         }
-        routingCache[start_key][end_key] = cacheItem;
+        addRoute(start, end, cacheItem);
+        it = routingCache.constFind(key);
+    }
+    return &it.value();
+}
 
-        qreal airToCostFactor = cacheItem.costs / GPS_Math_DistanceQuick(start.x(), start.y(), end.x(), end.y());
-        if( airToCostFactor < minAirToCostFactor || minAirToCostFactor < 0)
-        {
-            minAirToCostFactor = airToCostFactor;
-        }
-        totalAirToCosts += airToCostFactor;
-        totalNumOfRoutes++;
+void CRouterOptimization::addRoute(const QPointF& start, const QPointF& end, const routing_cache_item_t& item)
+{
+    routingCache[qMakePair(pointKey(start), pointKey(end))] = item;
+
+    qreal airToCostFactor = item.costs / GPS_Math_DistanceQuick(start.x(), start.y(), end.x(), end.y());
+    if( airToCostFactor < minAirToCostFactor || minAirToCostFactor < 0)
+    {
+        minAirToCostFactor = airToCostFactor;
     }
-    return &routingCache[start_key][end_key];
+    totalAirToCosts += airToCostFactor;
+    totalNumOfRoutes++;
 }
 
 int CRouterOptimization::fillSubPts(SGisLine &line)
@@ -326,7 +568,20 @@ void CRouterOptimization::checkRouter()
     const QString& options = CRouterSetup::self().getOptions();
     if(routerOptions != options)
     {
-        routingCache.clear();
+        resetCache();
         routerOptions = options;
     }
+    else if(routingCache.size() > MAX_CACHED_ROUTES)
+    {
+        // Never drop routes while optimizing. getRoute() returns pointers into the cache.
+        resetCache();
+    }
+}
+
+void CRouterOptimization::resetCache()
+{
+    routingCache.clear();
+    minAirToCostFactor = -1;
+    totalAirToCosts = 0;
+    totalNumOfRoutes = 0;
 }
@@ -20,7 +20,7 @@
 #define CROUTEROPTIMIZATION_H
 #include <gis/IGisLine.h>
 #include <QCoreApplication>
-#include <QMap>
+#include <QHash>
 #include <QPolygonF>
 
 class CRouterOptimization
@@ -38,22 +38,60 @@ private:
         qreal costs;
     };
 
+    /// a coordinate [rad] packed into a single integer, resolution is about 6cm
+    using point_key_t = quint64;
+    using edge_key_t = QPair<point_key_t, point_key_t>;
+
+    static point_key_t pointKey(const QPointF& pt);
+
     /// returns value by which the costs were changed
     qreal createNextBestOrder(const SGisLine& oldOrder, SGisLine& newOrder);
     qreal twoOptStep(const SGisLine &oldOrder, SGisLine &newOrder);
+    /**
+       @brief Move a chain of 1 to 3 points to a better place, optionally reversed
+
+       This is the segment insertion part of 3-opt. Only places next to the
+       chain's neighbours (see buildNeighbourLists()) are tested.
+     */
+    qreal orOptStep(const SGisLine &oldOrder, SGisLine &newOrder);
+    /// apply createNextBestOrder() and orOptStep() until there is no gain anymore
+    void localSearch(SGisLine& order);
 
     qreal getRealRouteCosts(const SGisLine& line, qreal costCutoff = -1);
     qreal bestKnownDistance(const IGisLine::point_t &start, const IGisLine::point_t &end);
     const routing_cache_item_t *getRoute(const QPointF& from, const QPointF& to);
+    void addRoute(const QPointF& from, const QPointF& to, const routing_cache_item_t& item);
     int fillSubPts(SGisLine& line);
-    /// checks if router settings were changed and if yes, discards the routingCache
+    /// checks if router settings were changed or the cache grew too large and if yes, discards the routingCache
     void checkRouter();
+    /// discard the routingCache together with the statistics derived from it
+    static void resetCache();
+
+    /**
+       @brief Calculate the costs between all points of the line in one go
+
+       This is only done if the router can handle several requests concurrently.
+       Routes already known are not calculated again.
+
+       @return False if the user canceled the operation.
+     */
+    bool calcCostMatrix(const SGisLine& line);
+    /// collect the nearest points by best known distance for each point of the line
+    void buildNeighbourLists(const SGisLine& line);
+
+    /**
+       The cache is shared by all instances. Thus optimizing the same set of
+       points again or after some edits will use the routes already known.
+       It is discarded as soon as the router or it's options change or when
+       it has grown too large. This is done before an optimization starts only.
+     */
+    static QHash<edge_key_t, routing_cache_item_t> routingCache;
+    static qreal minAirToCostFactor;
+    static qreal totalAirToCosts;
+    static qreal totalNumOfRoutes;
+    static QString routerOptions;
 
-    QMap<QString, QMap<QString, routing_cache_item_t> > routingCache;
-    qreal minAirToCostFactor = -1;
-    qreal totalAirToCosts = 0;
-    qreal totalNumOfRoutes = 0;
-    QString routerOptions = "";
+    QHash<point_key_t, QVector<point_key_t> > neighbours;
 };
 
 #endif // CROUTEROPTIMIZATION_H
@@ -31,6 +31,74 @@
 
 QPointer<CProgressDialog> CRouterRoutino::progress;
 
+/**
+   @brief Calculate every step-th route of a list with a dedicated database handle
+ */
+class CRoutinoWorker : public QRunnable
+{
+public:
+    CRoutinoWorker(Routino_Database * data, Routino_Profile * profile, Routino_Translation * translation,
+                   int options, bool quickest, const QVector<QPointF>& p1, const QVector<QPointF>& p2,
+                   int first, int step, QPolygonF * coords, qreal * costs)
+        : data(data)
+        , profile(profile)
+        , translation(translation)
+        , options(options)
+        , quickest(quickest)
+        , p1(p1)
+        , p2(p2)
+        , first(first)
+        , step(step)
+        , coords(coords)
+        , costs(costs)
+    {
+    }
+
+    void run() override
+    {
+        const int N = p1.size();
+        for(int i = first; i < N; i += step)
+        {
+            Routino_Waypoint* waypoints[2] = {0};
+            waypoints[0] = Routino_FindWaypoint(data, profile, p1[i].y() * RAD_TO_DEG, p1[i].x() * RAD_TO_DEG);
+            waypoints[1] = Routino_FindWaypoint(data, profile, p2[i].y() * RAD_TO_DEG, p2[i].x() * RAD_TO_DEG);
+            if(waypoints[0] == nullptr || waypoints[1] == nullptr)
+            {
+                continue;
+            }
+
+            Routino_Output * route = Routino_CalculateRoute(data, profile, translation, waypoints, 2, options, nullptr);
+            if(route == nullptr)
+            {
+                continue;
+            }
+
+            for(Routino_Output * next = route; next != nullptr; next = next->next)
+            {
+                if(next->type != ROUTINO_POINT_WAYPOINT)
+                {
+                    coords[i] << QPointF(next->lon, next->lat);
+                }
+                costs[i] = quickest ? next->time : next->dist;
+            }
+            Routino_DeleteRoute(route);
+        }
+    }
+
+private:
+    Routino_Database * data;
+    Routino_Profile * profile;
+    Routino_Translation * translation;
+    const int options;
+    const bool quickest;
+    const QVector<QPointF>& p1;
+    const QVector<QPointF>& p2;
+    const int first;
+    const int step;
+    QPolygonF * coords;
+    qreal * costs;
+};
+
 int ProgressFunc(double complete)
 {
     if(CRouterRoutino::progress.isNull())
@@ -192,6 +260,11 @@ bool CRouterRoutino::hasFastRouting()
     return IRouter::hasFastRouting() && (comboDatabase->count() != 0);
 }
 
+bool CRouterRoutino::hasConcurrentRouting()
+{
+    return hasFastRouting();
+}
+
 QString CRouterRoutino::getOptions()
 {
     QString str;
@@ -201,6 +274,12 @@ QString CRouterRoutino::getOptions()
     return str;
 }
 
+QString CRouterRoutino::getCacheKey()
+{
+    // the same profile will route differently on another database
+    return IRouter::getCacheKey() + ":" + comboDatabase->currentText();
+}
+
 void CRouterRoutino::setupPath(const QString& path)
 {
     if(dbPaths.contains(path))
@@ -264,6 +343,8 @@ void CRouterRoutino::buildDatabaseList()
             /* determine the profile to use for each database*/
             QVariantMap dmap;
             dmap["db"] = QVariant ((qulonglong)data);
+            dmap["path"] = dir.absolutePath();
+            dmap["prefix"] = prefix;
 
             /* check possible profiles.xml locations and use the first available */
             int pError = 0;
@@ -319,6 +400,8 @@ void CRouterRoutino::buildDatabaseList()
 
 void CRouterRoutino::freeDatabaseList()
 {
+    freeDatabasePool();
+
     for(int i = 0; i < comboDatabase->count(); i++)
     {
         QVariantMap map = comboDatabase->itemData(i, Qt::UserRole).toMap();
@@ -328,6 +411,16 @@ void CRouterRoutino::freeDatabaseList()
     comboDatabase->clear();
 }
 
+void CRouterRoutino::freeDatabasePool()
+{
+    for(Routino_Database * data : databasePool)
+    {
+        Routino_UnloadDatabase(data);
+    }
+    databasePool.clear();
+    databasePoolKey.clear();
+}
+
 int CRouterRoutino::loadProfiles(const QString& profilesPath)
 {
     int res = 0;
@@ -567,3 +660,115 @@ int CRouterRoutino::calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& c
     mutex.unlock();
     return coords.size();
 }
+
+int CRouterRoutino::calcRoutes(const QVector<QPointF>& p1, const QVector<QPointF>& p2, QVector<QPolygonF>& coords, QVector<qreal>& costs)
+{
+    const int N = qMin(p1.size(), p2.size());
+    coords.fill(QPolygonF(), N);
+    costs.fill(-1, N);
+
+    if(N == 0)
+    {
+        return 0;
+    }
+
+    if(!mutex.tryLock())
+    {
+        return -1;
+    }
+
+    int cnt = 0;
+    try
+    {
+        QVariantMap map = comboDatabase->currentData(Qt::UserRole).toMap();
+        Routino_Database * data = (Routino_Database*)(map["db"].toULongLong());
+        if(nullptr == data)
+        {
+            throw QString();
+        }
+
+        loadProfiles(map["profilesPath"].toString());
+
+        QString strProfile      = comboProfile->currentData(Qt::UserRole).toString();
+        QString strLanguage     = comboLanguage->currentData(Qt::UserRole).toString();
+
+        Routino_Profile *profile         = Routino_GetProfile(strProfile.toUtf8());
+        if( profile == NULL )
+        {
+            throw tr("Required profile '%1' is not in the current profiles file.").arg(strProfile);
+        }
+        Routino_Translation *translation = Routino_GetTranslation(strLanguage.toUtf8());
+
+        // validate once for all threads. The other handles access the same data.
+        int res = Routino_ValidateProfile(data, profile);
+        if(res != 0)
+        {
+            throw xlateRoutinoError(Routino_errno);
+        }
+
+        int options = ROUTINO_ROUTE_LIST_HTML_ALL;
+        const bool quickest = comboMode->currentIndex() == 1;
+        options |= quickest ? ROUTINO_ROUTE_QUICKEST : ROUTINO_ROUTE_SHORTEST;
+
+        const int nThreads = qMax(1, qMin(QThread::idealThreadCount(), N));
+
+        // (re-)load additional database handles for all threads but the first one
+        const QString& key = map["path"].toString() + "/" + map["prefix"].toString();
+        if(databasePoolKey != key)
+        {
+            freeDatabasePool();
+            databasePoolKey = key;
+        }
+
+        while(databasePool.count() < nThreads - 1)
+        {
+#ifdef Q_OS_WIN
+            Routino_Database * db = Routino_LoadDatabase(map["path"].toString().toLocal8Bit(), map["prefix"].toString().toLocal8Bit());
+#else
+            Routino_Database * db = Routino_LoadDatabase(map["path"].toString().toUtf8(), map["prefix"].toString().toUtf8());
+#endif
+            if(db == nullptr)
+            {
+                break;
+            }
+            databasePool << db;
+        }
+
+        QList<Routino_Database*> handles;
+        handles << data << databasePool.mid(0, nThreads - 1);
+
+        QPolygonF * pCoords = coords.data();
+        qreal * pCosts = costs.data();
+
+        QThreadPool pool;
+        pool.setMaxThreadCount(handles.count());
+        for(int i = 0; i < handles.count(); i++)
+        {
+            pool.start(new CRoutinoWorker(handles[i], profile, translation, options, quickest, p1, p2, i, handles.count(), pCoords, pCosts));
+        }
+        pool.waitForDone();
+
+        for(int i = 0; i < N; i++)
+        {
+            if(coords[i].isEmpty())
+            {
+                costs[i] = -1;
+            }
+            else
+            {
+                cnt++;
+            }
+        }
+    }
+    catch(const QString& msg)
+    {
+        if(!msg.isEmpty())
+        {
+            mutex.unlock();
+            throw msg;
+        }
+    }
+
+    mutex.unlock();
+    return cnt;
+}
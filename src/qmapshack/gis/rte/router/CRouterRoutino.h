@@ -40,10 +40,13 @@ public:
 
     void calcRoute(const IGisItem::key_t& key) override;
     int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal *costs) override;
+    int calcRoutes(const QVector<QPointF>& p1, const QVector<QPointF>& p2, QVector<QPolygonF>& coords, QVector<qreal>& costs) override;
 
     bool hasFastRouting() override;
+    bool hasConcurrentRouting() override;
 
     QString getOptions() override;
+    QString getCacheKey() override;
 
     static QPointer<CProgressDialog> progress;
 
@@ -57,6 +60,7 @@ private:
     virtual ~CRouterRoutino();
     void buildDatabaseList();
     void freeDatabaseList();
+    void freeDatabasePool();
     int loadProfiles(const QString& profilesPath);
     void updateHelpText();
     QString xlateRoutinoError(int err);
@@ -65,6 +69,15 @@ private:
     QStringList dbPaths;
     QString currentProfilesPath;
 
+    /**
+       Additional handles of the current database. The Routino library can
+       route concurrently as long as each thread uses it's own database handle.
+       The pool is loaded on demand by calcRoutes().
+     */
+    QList<Routino_Database*> databasePool;
+    /// the database path and prefix of the handles in databasePool
+    QString databasePoolKey;
+
     QMutex mutex {QMutex::NonRecursive};
 };
 
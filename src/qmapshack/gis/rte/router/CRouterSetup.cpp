@@ -20,6 +20,7 @@
 #include "gis/CGisWorkspace.h"
 #include "gis/rte/CGisItemRte.h"
 #include "gis/rte/router/CRouterBRouter.h"
+#include "gis/rte/router/CRouterCache.h"
 #include "gis/rte/router/CRouterMapQuest.h"
 #include "gis/rte/router/CRouterRoutino.h"
 #include "gis/rte/router/CRouterSetup.h"
@@ -43,7 +44,11 @@ CRouterSetup::CRouterSetup(QWidget * parent)
     stackedWidget->addWidget(new CRouterMapQuest(this));
     stackedWidget->addWidget(new CRouterBRouter(this));
 
+    new CRouterCache(this);
+    checkCacheOnDisk->setChecked(CRouterCache::self().isPersistent());
+
     connect(comboRouter, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &CRouterSetup::slotSelectRouter);
+    connect(checkCacheOnDisk, &QCheckBox::toggled, &CRouterCache::self(), &CRouterCache::setPersistent);
 
     SETTINGS;
     comboRouter->setCurrentIndex(cfg.value("Route/current", 0).toInt());
@@ -65,6 +70,16 @@ bool CRouterSetup::hasFastRouting()
     return false;
 }
 
+bool CRouterSetup::hasConcurrentRouting()
+{
+    IRouter * router = dynamic_cast<IRouter*>(stackedWidget->currentWidget());
+    if(router)
+    {
+        return router->hasConcurrentRouting();
+    }
+    return false;
+}
+
 void CRouterSetup::slotSelectRouter(int i)
 {
     stackedWidget->setCurrentIndex(i);
@@ -89,12 +104,93 @@ int CRouterSetup::calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coo
     IRouter * router = dynamic_cast<IRouter*>(stackedWidget->currentWidget());
     if(router)
     {
-        return router->calcRoute(p1, p2, coords, costs);
+        CRouterCache& cache = CRouterCache::self();
+        const QByteArray& key = cache.getKey(router->getCacheKey(), cache.getNogoHash(), p1, p2);
+
+        qreal c = -1;
+        if(!cache.lookup(key, coords, c))
+        {
+            const int res = router->calcRoute(p1, p2, coords, &c);
+            if(res < 0)
+            {
+                return res;
+            }
+            cache.insert(key, coords, c);
+        }
+
+        if(costs != nullptr)
+        {
+            *costs = c;
+        }
+        return coords.size();
     }
 
     return false;
 }
 
+int CRouterSetup::calcRoutes(const QVector<QPointF>& p1, const QVector<QPointF>& p2, QVector<QPolygonF>& coords, QVector<qreal>& costs)
+{
+    IRouter * router = dynamic_cast<IRouter*>(stackedWidget->currentWidget());
+    if(router)
+    {
+        const int N = qMin(p1.size(), p2.size());
+        coords.fill(QPolygonF(), N);
+        costs.fill(-1, N);
+
+        CRouterCache& cache = CRouterCache::self();
+        const QString& routerKey = router->getCacheKey();
+        const QByteArray& nogoHash = cache.getNogoHash();
+
+        // serve what is known and request the rest
+        int cnt = 0;
+        QVector<int> missing;
+        QVector<QByteArray> keys(N);
+        QVector<QPointF> missingP1, missingP2;
+        for(int i = 0; i < N; i++)
+        {
+            keys[i] = cache.getKey(routerKey, nogoHash, p1[i], p2[i]);
+            if(cache.lookup(keys[i], coords[i], costs[i]))
+            {
+                cnt++;
+            }
+            else
+            {
+                missing << i;
+                missingP1 << p1[i];
+                missingP2 << p2[i];
+            }
+        }
+
+        if(missing.isEmpty())
+        {
+            return cnt;
+        }
+
+        QVector<QPolygonF> missingCoords;
+        QVector<qreal> missingCosts;
+        const int res = router->calcRoutes(missingP1, missingP2, missingCoords, missingCosts);
+        if(res < 0)
+        {
+            return res;
+        }
+
+        for(int i = 0; i < missing.size(); i++)
+        {
+            const int idx = missing[i];
+            if(missingCosts[i] >= 0)
+            {
+                coords[idx] = missingCoords[i];
+                costs[idx] = missingCosts[i];
+                cache.insert(keys[idx], coords[idx], costs[idx]);
+            }
+        }
+
+        return cnt + res;
+    }
+
+    return -1;
+}
+
 QString CRouterSetup::getOptions()
 {
     IRouter * router = dynamic_cast<IRouter*>(stackedWidget->currentWidget());
@@ -35,9 +35,11 @@ public:
 
     void calcRoute(const IGisItem::key_t &key);
     int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal *costs = nullptr);
+    int calcRoutes(const QVector<QPointF>& p1, const QVector<QPointF>& p2, QVector<QPolygonF>& coords, QVector<qreal>& costs);
     QString getOptions();
 
     bool hasFastRouting();
+    bool hasConcurrentRouting();
 
     enum router_e {RouterRoutino, RouterMapquest, RouterBRouter};
 
@@ -28,3 +28,27 @@ IRouter::~IRouter()
 {
 }
 
+
+int IRouter::calcRoutes(const QVector<QPointF>& p1, const QVector<QPointF>& p2, QVector<QPolygonF>& coords, QVector<qreal>& costs)
+{
+    const int N = qMin(p1.size(), p2.size());
+    coords.fill(QPolygonF(), N);
+    costs.fill(-1, N);
+
+    int cnt = 0;
+    for(int i = 0; i < N; i++)
+    {
+        qreal c = -1;
+        if(calcRoute(p1[i], p2[i], coords[i], &c) < 0)
+        {
+            return -1;
+        }
+
+        if(!coords[i].isEmpty())
+        {
+            costs[i] = c;
+            cnt++;
+        }
+    }
+    return cnt;
+}
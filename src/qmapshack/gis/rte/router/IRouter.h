@@ -31,13 +31,50 @@ public:
 
     virtual void calcRoute(const IGisItem::key_t& key) = 0;
     virtual int calcRoute(const QPointF& p1, const QPointF& p2, QPolygonF& coords, qreal* costs = nullptr) = 0;
+
+    /**
+       @brief Calculate routes for a list of point pairs
+
+       The default implementation calls calcRoute() for each pair one after
+       the other. Routers that can serve several requests at once should
+       override this and hasConcurrentRouting().
+
+       @param p1        list of start points [rad]
+       @param p2        list of end points [rad], same size as p1
+       @param coords    the resulting routes
+       @param costs     the resulting costs, -1 for each route that failed
+       @return -1 if the router is busy or can't route at all, else the number of routes found.
+     */
+    virtual int calcRoutes(const QVector<QPointF>& p1, const QVector<QPointF>& p2, QVector<QPolygonF>& coords, QVector<qreal>& costs);
+
     virtual bool hasFastRouting()
     {
         return fastRouting;
     }
 
+    /**
+       @brief Check if calcRoutes() will serve the requests concurrently
+
+       Only then it is worth to request more routes than actually needed.
+     */
+    virtual bool hasConcurrentRouting()
+    {
+        return false;
+    }
+
     virtual QString getOptions() = 0;
 
+    /**
+       @brief Get a string identifying the router and all options that affect a route
+
+       It is used to address routed segments in CRouterCache. The default
+       implementation combines the class name and getOptions().
+     */
+    virtual QString getCacheKey()
+    {
+        return metaObject()->className() + QString(":") + getOptions();
+    }
+
     virtual void routerSelected() {}
 
 private:
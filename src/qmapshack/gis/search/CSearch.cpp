@@ -17,6 +17,7 @@
 **********************************************************************************************/
 
 #include "CSearch.h"
+#include "gis/search/CSearchIndex.h"
 
 Qt::CaseSensitivity CSearch::caseSensitivity = Qt::CaseInsensitive;
 CSearch::search_mode_e CSearch::searchMode = CSearch::eSearchModeText;
@@ -226,7 +227,39 @@ CSearch::CSearch(QString searchstring)
     }
 }
 
+bool CSearch::isIndexable() const
+{
+    return ((search.property == eSearchPropertyGeneralFullText) || (search.property == eSearchPropertyGeneralName))
+           && ((search.searchType == eSearchTypeWith) || (search.searchType == eSearchTypeWithout));
+}
+
+void CSearch::setIndexResult(const QSet<QString>& indexedKeys, const QSet<QString>& matchingKeys)
+{
+    hasIndexResult      = true;
+    this->indexedKeys   = indexedKeys;
+    this->matchingKeys  = matchingKeys;
+}
+
 bool CSearch::getSearchResult(IGisItem *item)
+{
+    if(isIndexable())
+    {
+        if(hasIndexResult)
+        {
+            const QString& key = CSearchIndex::getItemKey(item);
+            if(indexedKeys.contains(key))
+            {
+                return matchingKeys.contains(key);
+            }
+        }
+        // items added after the query or no query at all
+        return CSearchIndex::match(*this, item);
+    }
+
+    return getPropertyResult(item);
+}
+
+bool CSearch::getPropertyResult(IGisItem *item)
 {
     bool passed = true;
     if(searchTypeLambdaMap.contains(search.searchType))
@@ -21,6 +21,7 @@
 
 #include <functional>
 #include <QList>
+#include <QSet>
 #include <QString>
 
 #include "gis/IGisItem.h"
@@ -135,8 +136,8 @@ public:
 
     struct search_t
     {
-        searchProperty_e property;
-        search_type_e searchType;
+        searchProperty_e property = eSearchPropertyNoMatch;
+        search_type_e searchType = eSearchTypeNone;
         searchValue_t searchValue;
     };
 
@@ -182,8 +183,35 @@ public:
         return searchPropertyMeaningMap.value(searchPropertyEnumMap.value(property), tr("No information available"));
     }
 
+    const search_t& getSearch() const
+    {
+        return search;
+    }
+
     bool getSearchResult(IGisItem * item);
 
+    /**
+       @brief Test an item by it's search property values, without any index
+
+       For full text searches the value is the item's info text. Thus it
+       covers more than the text used by CSearchIndex.
+     */
+    bool getPropertyResult(IGisItem * item);
+
+    /// true if the search can be answered by CSearchIndex
+    bool isIndexable() const;
+
+    /**
+       @brief Attach the result of an indexed query to the search
+
+       getSearchResult() will use the result for all items covered by the
+       query. All other items are tested one by one.
+
+       @param indexedKeys   the keys of all items covered by the query
+       @param matchingKeys  the keys of all items matching the search
+     */
+    void setIndexResult(const QSet<QString>& indexedKeys, const QSet<QString>& matchingKeys);
+
     static Qt::CaseSensitivity getCaseSensitivity()
     {
         return caseSensitivity;
@@ -223,6 +251,10 @@ private:
     bool syntaxError = false;
     bool autoDetectedProperty = false;
 
+    bool hasIndexResult = false;
+    QSet<QString> indexedKeys;
+    QSet<QString> matchingKeys;
+
     static QMap<QString, search_type_e> keywordSearchTypeMap;
     static QMap<QString, search_type_e> initKeywordSearchTypeMap();
 
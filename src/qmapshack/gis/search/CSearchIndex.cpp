@@ -0,0 +1,519 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/IGisItem.h"
+#include "gis/search/CSearch.h"
+#include "gis/search/CSearchIndex.h"
+
+#include <QtCore>
+
+CSearchIndex * CSearchIndex::pSelf = nullptr;
+
+/// the length of the longest substrings in CSearchIndex::grams
+#define MAX_GRAM 3
+
+class CSearchIndexWorker : public QRunnable
+{
+public:
+    CSearchIndexWorker(CSearchIndex& index, const CSearchIndex::query_t& q, quint32 serial, quint32 cntQuery)
+        : index(index)
+        , q(q)
+        , serial(serial)
+        , cntQuery(cntQuery)
+    {
+    }
+
+    void run() override
+    {
+        // a newer query has been requested in the meantime
+        if(index.isOutdated(cntQuery))
+        {
+            return;
+        }
+
+        const QSet<QString>& matches = index.run(q);
+
+        // report from within the GUI thread
+        QMetaObject::invokeMethod(&index, "slotQueryFinished", Qt::QueuedConnection, Q_ARG(quint32, serial), Q_ARG(QSet<QString>, matches));
+    }
+
+private:
+    CSearchIndex& index;
+    CSearchIndex::query_t q;
+    quint32 serial;
+    quint32 cntQuery;
+};
+
+class CSearchIndexUpdater : public QRunnable
+{
+public:
+    CSearchIndexUpdater(CSearchIndex& index, const QList<CSearchIndex::item_t>& items)
+        : index(index)
+        , items(items)
+        , dropOthers(false)
+    {
+    }
+
+    CSearchIndexUpdater(CSearchIndex& index, const QList<CSearchIndex::item_t>& items, const QSet<QString>& keys)
+        : index(index)
+        , items(items)
+        , keys(keys)
+        , dropOthers(true)
+    {
+    }
+
+    void run() override
+    {
+        index.update(items, dropOthers ? &keys : nullptr);
+    }
+
+private:
+    CSearchIndex& index;
+    QList<CSearchIndex::item_t> items;
+    QSet<QString> keys;
+    bool dropOthers;
+};
+
+CSearchIndex::CSearchIndex(QObject *parent)
+    : QObject(parent)
+{
+    pSelf = this;
+    pool.setMaxThreadCount(1);
+
+    qRegisterMetaType<QSet<QString> >("QSet<QString>");
+}
+
+CSearchIndex::~CSearchIndex()
+{
+    pool.clear();
+    pool.waitForDone();
+    pSelf = nullptr;
+}
+
+void CSearchIndex::slotQueryFinished(quint32 serial, const QSet<QString>& matches)
+{
+    emit sigQueryFinished(serial, matches);
+}
+
+QString CSearchIndex::getItemKey(IGisItem * item)
+{
+    const IGisItem::key_t& key = item->getKey();
+    return key.device + "/" + key.project + "/" + key.item;
+}
+
+void CSearchIndex::tokenize(const QString& text, QSet<QString>& tokens)
+{
+    const QString& lower = text.toLower();
+    const int N = lower.size();
+
+    int start = -1;
+    for(int i = 0; i <= N; i++)
+    {
+        if((i < N) && lower[i].isLetterOrNumber())
+        {
+            if(start < 0)
+            {
+                start = i;
+            }
+        }
+        else if(start >= 0)
+        {
+            tokens << lower.mid(start, i - start);
+            start = -1;
+        }
+    }
+}
+
+CSearchIndex::item_t CSearchIndex::getItem(const QString& key, IGisItem * item)
+{
+    item_t data;
+    data.key    = key;
+    data.hash   = item->getHash();
+    data.name   = item->getValueByKeyword(eSearchPropertyGeneralName).toString();
+    data.fields = item->getFullTextFields();
+    return data;
+}
+
+QString CSearchIndex::getText(QStringList fields)
+{
+    static const QRegExp reTag("<[^>]*>");
+
+    for(QString& field : fields)
+    {
+        if(!field.contains('<'))
+        {
+            continue;
+        }
+
+        // a cheap replacement for IGisItem::removeHtml(). No QTextDocument per item.
+        field.replace(reTag, " ");
+        field.replace("&nbsp;", " ");
+        field.replace("&lt;", "<");
+        field.replace("&gt;", ">");
+        field.replace("&quot;", "\"");
+        field.replace("&amp;", "&");
+    }
+
+    return fields.join("\n");
+}
+
+CSearchIndex::query_t CSearchIndex::getQuery(const CSearch& search)
+{
+    const CSearch::search_t& s = search.getSearch();
+
+    query_t q;
+    q.fullText  = s.property == eSearchPropertyGeneralFullText;
+    q.without   = s.searchType == CSearch::eSearchTypeWithout;
+    q.cs        = CSearch::getCaseSensitivity();
+    q.needle    = s.searchValue.toString();
+    return q;
+}
+
+bool CSearchIndex::match(const query_t& q, const QString& name, const QString& text)
+{
+    const QString& value = q.fullText ? text : name;
+    if(q.without)
+    {
+        return !value.isEmpty() && !value.contains(q.needle, q.cs);
+    }
+    return value.contains(q.needle, q.cs);
+}
+
+bool CSearchIndex::match(const CSearch& search, IGisItem * item)
+{
+    const query_t& q = getQuery(search);
+    if(q.fullText)
+    {
+        return match(q, QString(), getText(item->getFullTextFields()));
+    }
+    return match(q, item->getValueByKeyword(eSearchPropertyGeneralName).toString(), QString());
+}
+
+void CSearchIndex::itemChanged(IGisItem * item)
+{
+    if(pSelf == nullptr)
+    {
+        return;
+    }
+
+    const QString& key = getItemKey(item);
+    {
+        QMutexLocker lock(&pSelf->mutex);
+        if(!pSelf->ids.contains(key) && !pSelf->pending.contains(key))
+        {
+            return;
+        }
+        pSelf->pending << key;
+    }
+
+    pSelf->pool.start(new CSearchIndexUpdater(*pSelf, {getItem(key, item)}));
+}
+
+QSet<QString> CSearchIndex::sync(const QList<IGisItem*>& items)
+{
+    QSet<QString> keys;
+    keys.reserve(items.size());
+
+    // collect the data of all new or changed items. Everything else is done in the background.
+    QList<item_t> changed;
+    for(IGisItem * item : items)
+    {
+        const QString& key = getItemKey(item);
+        keys << key;
+
+        {
+            QMutexLocker lock(&mutex);
+            const qint32 id = ids.value(key, -1);
+            if((id != -1) && (docs[id].hash == item->getHash()))
+            {
+                continue;
+            }
+            pending << key;
+        }
+
+        changed << getItem(key, item);
+    }
+
+    pool.start(new CSearchIndexUpdater(*this, changed, keys));
+
+    return keys;
+}
+
+void CSearchIndex::update(const QList<item_t>& items, const QSet<QString> * keys)
+{
+    for(const item_t& item : items)
+    {
+        update(item);
+    }
+
+    if(keys == nullptr)
+    {
+        return;
+    }
+
+    // drop all items gone since the last time
+    QMutexLocker lock(&mutex);
+    QHash<QString, qint32>::iterator it = ids.begin();
+    while(it != ids.end())
+    {
+        if(keys->contains(it.key()))
+        {
+            ++it;
+            continue;
+        }
+
+        remove(it.value());
+        it = ids.erase(it);
+    }
+}
+
+void CSearchIndex::update(const item_t& item)
+{
+    // tokenize outside the lock to keep queries running
+    doc_t doc;
+    doc.key     = item.key;
+    doc.hash    = item.hash;
+    doc.name    = item.name;
+    doc.text    = getText(item.fields);
+    tokenize(doc.text, doc.tokens);
+
+    QMutexLocker lock(&mutex);
+    pending.remove(item.key);
+
+    qint32 id = ids.value(item.key, -1);
+    if(id != -1)
+    {
+        remove(id);
+    }
+
+    if(freeIds.isEmpty())
+    {
+        id = docs.size();
+        docs.resize(id + 1);
+    }
+    else
+    {
+        id = freeIds.takeLast();
+    }
+
+    for(const QString& token : doc.tokens)
+    {
+        QSet<qint32>& posting = postings[token];
+        if(posting.isEmpty())
+        {
+            addToVocabulary(token);
+        }
+        posting << id;
+    }
+
+    docs[id] = doc;
+    ids[item.key] = id;
+}
+
+void CSearchIndex::remove(qint32 id)
+{
+    doc_t& doc = docs[id];
+    for(const QString& token : doc.tokens)
+    {
+        QHash<QString, QSet<qint32> >::iterator it = postings.find(token);
+        if(it == postings.end())
+        {
+            continue;
+        }
+
+        it->remove(id);
+        if(it->isEmpty())
+        {
+            postings.erase(it);
+            removeFromVocabulary(token);
+        }
+    }
+
+    doc = doc_t();
+    freeIds << id;
+}
+
+void CSearchIndex::addToVocabulary(const QString& token)
+{
+    const int N = token.size();
+    for(int len = 1; len <= MAX_GRAM; len++)
+    {
+        for(int i = 0; i + len <= N; i++)
+        {
+            grams[token.mid(i, len)] << token;
+        }
+    }
+}
+
+void CSearchIndex::removeFromVocabulary(const QString& token)
+{
+    const int N = token.size();
+    for(int len = 1; len <= MAX_GRAM; len++)
+    {
+        for(int i = 0; i + len <= N; i++)
+        {
+            QHash<QString, QSet<QString> >::iterator it = grams.find(token.mid(i, len));
+            if(it == grams.end())
+            {
+                continue;
+            }
+
+            it->remove(token);
+            if(it->isEmpty())
+            {
+                grams.erase(it);
+            }
+        }
+    }
+}
+
+QSet<QString> CSearchIndex::lookup(const QString& str) const
+{
+    // all substrings that short are in the index
+    if(str.size() <= MAX_GRAM)
+    {
+        return grams.value(str);
+    }
+
+    // start with the smallest set of tokens sharing a trigram
+    const QSet<QString> * smallest = nullptr;
+    const int N = str.size() - MAX_GRAM;
+    for(int i = 0; i <= N; i++)
+    {
+        QHash<QString, QSet<QString> >::const_iterator it = grams.constFind(str.mid(i, MAX_GRAM));
+        if(it == grams.constEnd())
+        {
+            return QSet<QString>();
+        }
+
+        if((smallest == nullptr) || (it->size() < smallest->size()))
+        {
+            smallest = &it.value();
+        }
+    }
+
+    QSet<QString> tokens;
+    for(const QString& token : *smallest)
+    {
+        if(token.contains(str))
+        {
+            tokens << token;
+        }
+    }
+    return tokens;
+}
+
+bool CSearchIndex::isOutdated(quint32 cntQuery)
+{
+    QMutexLocker lock(&mutex);
+    return cntQuery != cntQueries;
+}
+
+void CSearchIndex::query(const CSearch& search, quint32 serial)
+{
+    quint32 cntQuery;
+    {
+        QMutexLocker lock(&mutex);
+        cntQuery = ++cntQueries;
+    }
+
+    // updates of the index must not be dropped. Thus outdated queries skip themselves.
+    pool.start(new CSearchIndexWorker(*this, getQuery(search), serial, cntQuery));
+}
+
+QSet<QString> CSearchIndex::run(const query_t& q)
+{
+    QMutexLocker lock(&mutex);
+
+    /*
+        Any item containing the search string contains each token of the
+        search string as part of one of its own tokens. Thus the intersection
+        of these items is a superset of the result.
+     */
+    QSet<QString> tokens;
+    tokenize(q.needle, tokens);
+
+    bool useCandidates = false;
+    QSet<qint32> candidates;
+    for(const QString& token : tokens)
+    {
+        QSet<qint32> hits;
+        for(const QString& word : lookup(token))
+        {
+            hits.unite(postings.value(word));
+        }
+
+        if(useCandidates)
+        {
+            candidates.intersect(hits);
+        }
+        else
+        {
+            candidates.swap(hits);
+            useCandidates = true;
+        }
+
+        if(candidates.isEmpty())
+        {
+            break;
+        }
+    }
+
+    QSet<QString> matches;
+    if(useCandidates && !q.without)
+    {
+        for(qint32 id : candidates)
+        {
+            const doc_t& doc = docs[id];
+            if(match(q, doc.name, doc.text))
+            {
+                matches << doc.key;
+            }
+        }
+        return matches;
+    }
+
+    const qint32 N = docs.size();
+    for(qint32 id = 0; id < N; id++)
+    {
+        const doc_t& doc = docs[id];
+        if(doc.key.isEmpty())
+        {
+            continue;
+        }
+
+        if(useCandidates && !candidates.contains(id))
+        {
+            // can't contain the search string
+            const QString& value = q.fullText ? doc.text : doc.name;
+            if(!value.isEmpty())
+            {
+                matches << doc.key;
+            }
+            continue;
+        }
+
+        if(match(q, doc.name, doc.text))
+        {
+            matches << doc.key;
+        }
+    }
+
+    return matches;
+}
+
@@ -0,0 +1,198 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CSEARCHINDEX_H
+#define CSEARCHINDEX_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+class CSearch;
+class IGisItem;
+
+/**
+   @brief An inverted token index over the text of all items in the workspace
+
+   Each item's name, comment, description, keywords and geocache fields are
+   split into lower case tokens. For each token the index keeps the set of
+   items containing it. A full text or name search is answered by intersecting
+   the item sets of all tokens of the search string. Only the remaining
+   candidates are tested against the exact search semantics. None of the
+   items is touched for that.
+
+   Tokens of the search string are looked up as substrings of the indexed
+   tokens. For that the vocabulary is indexed by all it's substrings of up
+   to three characters. Longer tokens are matched against the tokens sharing
+   all of their trigrams only.
+
+   The index is kept up to date by IGisItem::changed() and by sync(). The
+   latter adds all items not known yet and drops all items gone since the last
+   call. The text of the items is collected in the GUI thread. Tokenizing and
+   updating the index as well as queries run in a background thread, in the
+   order requested. The result of a query is reported by sigQueryFinished().
+
+   Items are addressed by getItemKey(). Thus the index never holds a pointer
+   to an item.
+ */
+class CSearchIndex : public QObject
+{
+    Q_OBJECT
+public:
+    CSearchIndex(QObject * parent);
+    virtual ~CSearchIndex();
+
+    static CSearchIndex& self()
+    {
+        return *pSelf;
+    }
+
+    /**
+       @brief Refresh an item after it has been changed
+
+       Items not in the index are ignored. They will be added by the next
+       call to sync(). It is safe to call this if there is no index at all.
+
+       @param item  the changed item
+     */
+    static void itemChanged(IGisItem * item);
+
+    /**
+       @brief Bring the index in line with a list of items
+
+       Items not in the index or with a different hash are indexed. All
+       other items in the index are dropped. IGisItem::mutexItems has to
+       be locked. The index is updated in the background.
+
+       @param items     all items to be covered by the index
+       @return The keys of all items as returned by getItemKey()
+     */
+    QSet<QString> sync(const QList<IGisItem*>& items);
+
+    /**
+       @brief Start a query in the background
+
+       Pending queries not started yet are dropped. The query is run after
+       all updates of the index requested before. The result is reported
+       by sigQueryFinished().
+
+       @param search    an indexable search, see CSearch::isIndexable()
+       @param serial    an arbitrary number passed back with the result
+     */
+    void query(const CSearch& search, quint32 serial);
+
+    /// the key of an item used by the index
+    static QString getItemKey(IGisItem * item);
+
+    /**
+       @brief Test a single item against an indexable search without the index
+
+       The same text and semantics as for an indexed query are used.
+
+       @param search    an indexable search, see CSearch::isIndexable()
+       @param item      the item to test
+       @return True if the item matches
+     */
+    static bool match(const CSearch& search, IGisItem * item);
+
+signals:
+    /**
+       @brief Emitted in the GUI thread once a query is done
+
+       @param serial    the number passed to query()
+       @param matches   the keys of all matching items
+     */
+    void sigQueryFinished(quint32 serial, const QSet<QString>& matches);
+
+private slots:
+    /// relay the result of a worker to the GUI thread
+    void slotQueryFinished(quint32 serial, const QSet<QString>& matches);
+
+private:
+    friend class CSearchIndexWorker;
+    friend class CSearchIndexUpdater;
+
+    /// the data of an item collected in the GUI thread
+    struct item_t
+    {
+        QString key;
+        QString hash;
+        QString name;
+        QStringList fields;
+    };
+
+    struct doc_t
+    {
+        QString key;
+        QString hash;
+        /// the text to test name searches against
+        QString name;
+        /// the text to test full text searches against
+        QString text;
+        QSet<QString> tokens;
+    };
+
+    struct query_t
+    {
+        bool fullText;
+        bool without;
+        Qt::CaseSensitivity cs;
+        QString needle;
+    };
+
+    static query_t getQuery(const CSearch& search);
+    static bool match(const query_t& q, const QString& name, const QString& text);
+    static item_t getItem(const QString& key, IGisItem * item);
+    static QString getText(QStringList fields);
+    static void tokenize(const QString& text, QSet<QString>& tokens);
+
+    /// index the items and drop all other items if keys is not null. Called by the worker.
+    void update(const QList<item_t>& items, const QSet<QString> * keys);
+    void update(const item_t& item);
+    void remove(qint32 id);
+    void addToVocabulary(const QString& token);
+    void removeFromVocabulary(const QString& token);
+    /// get all tokens in the vocabulary containing str
+    QSet<QString> lookup(const QString& str) const;
+    bool isOutdated(quint32 cntQuery);
+    QSet<QString> run(const query_t& q);
+
+    static CSearchIndex * pSelf;
+
+    QMutex mutex;
+    QVector<doc_t> docs;
+    QVector<qint32> freeIds;
+    QHash<QString, qint32> ids;
+    QHash<QString, QSet<qint32> > postings;
+    /// all substrings of up to three characters of the tokens in postings
+    QHash<QString, QSet<QString> > grams;
+    /// the keys of items scheduled for indexing
+    QSet<QString> pending;
+    /// the number of queries requested so far
+    quint32 cntQueries = 0;
+
+    /// a single thread. Updates and queries are run in order.
+    QThreadPool pool;
+};
+
+#endif //CSEARCHINDEX_H
+
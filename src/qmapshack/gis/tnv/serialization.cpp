@@ -305,7 +305,7 @@ bool CGisItemTrk::saveTwoNav(const QString &filename)
                         }
 
                         fn = makeUniqueName(fn, dir);
-                        img.pixmap.save(dir.absoluteFilePath(fn));
+                        img.save(dir.absoluteFilePath(fn));
 
                         list.clear();
                         list << fn;
@@ -569,7 +569,7 @@ void CGisItemWpt::saveTwoNav(QTextStream& out, const QDir& dir)
         }
 
         fn = makeUniqueName(fn, dir);
-        img.pixmap.save(dir.absoluteFilePath(fn));
+        img.save(dir.absoluteFilePath(fn));
         out << "a .\\" << fn << endl;
     }
 
@@ -802,7 +802,7 @@ void CGisItemWpt::readTwoNav(const CTwoNavProject::wpt_t &tnvWpt)
         CGisItemWpt::image_t image;
         image.fileName  = img.filename;
         image.info      = img.info;
-        image.pixmap    = img.image;
+        image.setImage(img.image);
         images << image;
     }
 
@@ -578,9 +578,7 @@ void CDetailsTrk::setMouseClickFocus(const CTrackData::trkpt_t *pt)
 {
     if(nullptr != pt)
     {
-        treeTrackPoint->blockSignals(true);
-        treeTrackPoint->setCurrentItem(treeTrackPoint->topLevelItem(pt->idxTotal));
-        treeTrackPoint->blockSignals(false);
+        treeTrackPoint->setCurrentTrkPt(pt->idxTotal);
     }
 }
 
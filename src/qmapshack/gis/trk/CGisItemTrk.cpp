@@ -43,6 +43,10 @@
 #define MIN_DIST_CLOSE_TO   10
 #define MIN_DIST_FOCUS      200
 
+#define DRAW_CHUNK_SIZE     64
+/// the max. error of the distance between two track points [m]
+#define MAX_DIST_ERROR      0.001
+
 #define WPT_FOCUS_DIST_IN   (50 * 50)
 #define WPT_FOCUS_DIST_OUT  (200 * 200)
 
@@ -1054,6 +1058,7 @@ void CGisItemTrk::consolidatePoints()
 
 void CGisItemTrk::deriveSecondaryData()
 {
+    invalidateDrawCache();
     consolidatePoints();
 
     qreal north = -90;
@@ -1076,6 +1081,14 @@ void CGisItemTrk::deriveSecondaryData()
 
     trk.removeEmptySegments();
 
+    // the data restored from a file or the database is used once, if it still matches
+    QVector<qreal> deltaDistance;
+    QVector<qreal> cachedSlope;
+    QVector<qreal> cachedSpeed;
+    const bool useCache = !secondaryDataCache.isEmpty() && loadSecondaryData(secondaryDataCache, deltaDistance, cachedSlope, cachedSpeed);
+    secondaryDataCache.clear();
+    hasSecondaryData = true;
+
     // no data -> nothing to do
     if(trk.isEmpty())
     {
@@ -1084,6 +1097,24 @@ void CGisItemTrk::deriveSecondaryData()
 
     activities.updateFlags();
 
+    // the distances between all visible points are computed in one go
+    if(!useCache)
+    {
+        QVector<qreal> lon;
+        QVector<qreal> lat;
+        for(const CTrackData::trkpt_t& trkpt : trk)
+        {
+            if(!trkpt.isHidden())
+            {
+                lon << trkpt.lon * DEG_TO_RAD;
+                lat << trkpt.lat * DEG_TO_RAD;
+            }
+        }
+
+        deltaDistance.resize(lon.count());
+        GPS_Math_Distance(lon.constData(), lat.constData(), lon.count(), deltaDistance.data(), MAX_DIST_ERROR);
+    }
+
     CTrackData::trkpt_t * lastValid  = nullptr;
     CTrackData::trkpt_t * lastTrkpt  = nullptr;
     qreal timestampStart = NOFLOAT;
@@ -1114,7 +1145,7 @@ void CGisItemTrk::deriveSecondaryData()
 
         if(lastTrkpt != nullptr)
         {
-            trkpt.deltaDistance  = lastTrkpt->distanceTo(trkpt);
+            trkpt.deltaDistance  = deltaDistance[trkpt.idxVisible];
             trkpt.distance       = lastTrkpt->distance + trkpt.deltaDistance;
             trkpt.elapsedSeconds = trkpt.time.toMSecsSinceEpoch() / 1000.0 - timestampStart;
 
@@ -1173,65 +1204,74 @@ void CGisItemTrk::deriveSecondaryData()
     {
         CTrackData::trkpt_t& trkpt = *lintrk[p];
 
-        qreal d1 = trkpt.distance;
-        qreal e1 = trkpt.ele;
-        qreal t1 = trkpt.time.toMSecsSinceEpoch() / 1000.0;
-        for(int n = p; n > 0; --n)
+        if(useCache)
         {
-            CTrackData::trkpt_t & trkpt2 = *lintrk[n];
-            if(trkpt2.ele == NOINT)
+            trkpt.slope1 = cachedSlope[p];
+            trkpt.slope2 = trkpt.slope1 == NOFLOAT ? NOFLOAT : qTan(trkpt.slope1 * DEG_TO_RAD) * 100;
+            trkpt.speed  = cachedSpeed[p];
+        }
+        else
+        {
+            qreal d1 = trkpt.distance;
+            qreal e1 = trkpt.ele;
+            qreal t1 = trkpt.time.toMSecsSinceEpoch() / 1000.0;
+            for(int n = p; n > 0; --n)
             {
-                continue;
+                CTrackData::trkpt_t & trkpt2 = *lintrk[n];
+                if(trkpt2.ele == NOINT)
+                {
+                    continue;
+                }
+
+                if(trkpt.distance - trkpt2.distance >= 25)
+                {
+                    d1 = trkpt2.distance;
+                    e1 = trkpt2.ele;
+                    t1 = trkpt2.time.toMSecsSinceEpoch() / 1000.0;
+                    break;
+                }
             }
 
-            if(trkpt.distance - trkpt2.distance >= 25)
+            qreal d2 = trkpt.distance;
+            qreal e2 = trkpt.ele;
+            qreal t2 = trkpt.time.toMSecsSinceEpoch() / 1000.0;
+            for(int n = p; n < lintrk.size(); ++n)
             {
-                d1 = trkpt2.distance;
-                e1 = trkpt2.ele;
-                t1 = trkpt2.time.toMSecsSinceEpoch() / 1000.0;
-                break;
+                CTrackData::trkpt_t & trkpt2 = *lintrk[n];
+                if(trkpt2.ele == NOINT)
+                {
+                    continue;
+                }
+
+                if(trkpt2.distance - trkpt.distance >= 25)
+                {
+                    d2 = trkpt2.distance;
+                    e2 = trkpt2.ele;
+                    t2 = trkpt2.time.toMSecsSinceEpoch() / 1000.0;
+                    break;
+                }
             }
-        }
 
-        qreal d2 = trkpt.distance;
-        qreal e2 = trkpt.ele;
-        qreal t2 = trkpt.time.toMSecsSinceEpoch() / 1000.0;
-        for(int n = p; n < lintrk.size(); ++n)
-        {
-            CTrackData::trkpt_t & trkpt2 = *lintrk[n];
-            if(trkpt2.ele == NOINT)
+            if(d1 < d2)
             {
-                continue;
+                qreal a      = qAtan((e2 - e1) / (d2 - d1));
+                trkpt.slope1 = a * 360.0 / (2 * M_PI);
+                trkpt.slope2 = qTan(trkpt.slope1 * DEG_TO_RAD) * 100;
             }
-
-            if(trkpt2.distance - trkpt.distance >= 25)
+            else
             {
-                d2 = trkpt2.distance;
-                e2 = trkpt2.ele;
-                t2 = trkpt2.time.toMSecsSinceEpoch() / 1000.0;
-                break;
+                trkpt.slope1 = NOFLOAT;
+                trkpt.slope2 = NOFLOAT;
             }
-        }
 
-        if(d1 < d2)
-        {
-            qreal a      = qAtan((e2 - e1) / (d2 - d1));
-            trkpt.slope1 = a * 360.0 / (2 * M_PI);
-            trkpt.slope2 = qTan(trkpt.slope1 * DEG_TO_RAD) * 100;
-        }
-        else
-        {
-            trkpt.slope1 = NOFLOAT;
-            trkpt.slope2 = NOFLOAT;
-        }
-
-        if(t1 < t2)
-        {
-            trkpt.speed = (d2 - d1) / (t2 - t1);
-        }
-        else
-        {
-            trkpt.speed = NOFLOAT;
+            if(t1 < t2)
+            {
+                trkpt.speed = (d2 - d1) / (t2 - t1);
+            }
+            else
+            {
+                trkpt.speed = NOFLOAT;
+            }
         }
 
         // verify data
@@ -1284,6 +1324,31 @@ void CGisItemTrk::deriveSecondaryData()
 }
 
 
+QByteArray CGisItemTrk::getSecondaryDataHash() const
+{
+    QByteArray buffer;
+    buffer.reserve(cntTotalPoints * (2 * sizeof(qreal) + sizeof(qint32) + sizeof(qint64) + 1));
+
+    for(const CTrackData::trkpt_t& trkpt : trk)
+    {
+        const qint64 time   = trkpt.time.toMSecsSinceEpoch();
+        const char hidden   = trkpt.isHidden();
+
+        buffer.append((const char*)&trkpt.lon, sizeof(trkpt.lon));
+        buffer.append((const char*)&trkpt.lat, sizeof(trkpt.lat));
+        buffer.append((const char*)&trkpt.ele, sizeof(trkpt.ele));
+        buffer.append((const char*)&time, sizeof(time));
+        buffer.append(hidden);
+    }
+
+    return QCryptographicHash::hash(buffer, QCryptographicHash::Md5);
+}
+
+QByteArray CGisItemTrk::getDerivedData() const
+{
+    return hasSecondaryData ? saveSecondaryData() : secondaryDataCache;
+}
+
 void CGisItemTrk::findWaypointsCloseBy(CProgressDialog& progress, quint32& current)
 {
     IGisProject * project = getParentProject();
@@ -1885,52 +1950,25 @@ void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
         return;
     }
 
-    QPointF pt1;
     QPointF p1 = viewport[0];
     QPointF p2 = viewport[2];
     gis->convertRad2Px(p1);
     gis->convertRad2Px(p2);
     QRectF extViewport(p1, p2);
 
-    if(mode == eModeNormal)
-    {
-        // in normal mode the trackline without points marked as deleted is drawn
-        for(const CTrackData::trkpt_t &pt : trk)
-        {
-            if(pt.isHidden())
-            {
-                continue;
-            }
+    // in full mode the complete track including points marked as deleted
+    // is drawn as gray line first. Then the track without points marked as
+    // deleted is drawn with it's configured color
+    updateDrawCache(gis, mode != eModeNormal);
 
-            pt1.setX(pt.lon);
-            pt1.setY(pt.lat);
-            pt1 *= DEG_TO_RAD;
-            lineSimple << pt1;
-        }
-    }
-    else
+    // the complete lines are needed for the mouse interaction
+    lineSimple = drawCache.lineSimple;
+    gis->convertM2Px(lineSimple);
+    if(mode != eModeNormal)
     {
-        // in full mode the complete track including points marked as deleted
-        // is drawn as gray line first. Then the track without points marked as
-        // deleted is drawn with it's configured color
-        for(const CTrackData::trkpt_t &pt : trk)
-        {
-            pt1.setX(pt.lon);
-            pt1.setY(pt.lat);
-            pt1 *= DEG_TO_RAD;
-
-            lineFull << pt1;
-
-            if(pt.isHidden())
-            {
-                continue;
-            }
-
-            lineSimple << pt1;
-        }
+        lineFull = drawCache.lineFull;
+        gis->convertM2Px(lineFull);
     }
-    gis->convertRad2Px(lineSimple);
-    gis->convertRad2Px(lineFull);
 
     // draw the full line first
     if(mode == eModeRange)
@@ -1956,9 +1994,49 @@ void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
     }
     // -------------------------
 
-    // draw the reduced track line
+    /*
+        Draw the reduced track line. The tolerance is chosen to be
+        at most half a pixel. Only chunks of the line touching the
+        viewport are scaled to pixel coordinates at all.
+     */
+    QPointF m1 = extViewport.topLeft();
+    QPointF m2 = extViewport.bottomRight();
+    gis->convertPx2M(m1);
+    gis->convertPx2M(m2);
+    const QRectF viewportM = QRectF(m1, m2).normalized();
+    const qreal pixelSize  = viewportM.width() / extViewport.width();
+
     QList<QPolygonF> lines;
-    splitLineToViewport(lineSimple, extViewport, lines);
+    QList<QPolygonF> runs;
+    QList<QVector<qint32> > runsIdx;
+    if(pixelSize > 0)
+    {
+        const draw_level_t& level = getDrawLevel(qFloor(qLn(0.5 * pixelSize) / qLn(2.0)));
+
+        const int N = level.chunks.size();
+        for(int n = 0; n < N; n++)
+        {
+            if(!level.chunks[n].intersects(viewportM))
+            {
+                continue;
+            }
+
+            // join all following chunks touching the viewport
+            const int first = n * DRAW_CHUNK_SIZE;
+            while((n + 1 < N) && level.chunks[n + 1].intersects(viewportM))
+            {
+                n++;
+            }
+            const int count = qMin((n + 1) * DRAW_CHUNK_SIZE + 1, level.line.size()) - first;
+
+            QPolygonF run = level.line.mid(first, count);
+            gis->convertM2Px(run);
+            splitLineToViewport(run, extViewport, lines);
+
+            runs << run;
+            runsIdx << level.idx.mid(first, count);
+        }
+    }
 
     const CMainWindow& w = CMainWindow::self();
     if(key == keyUserFocus && w.isShowTrackHighlight())
@@ -1995,11 +2073,17 @@ void CGisItemTrk::drawItem(QPainter& p, const QPolygonF& viewport, QList<QRectF>
     }
     else if(getColorizeSource() == "activity")
     {
-        drawColorizedByActivity(p);
+        for(int i = 0; i < runs.size(); i++)
+        {
+            drawColorizedByActivity(p, runs[i], runsIdx[i]);
+        }
     }
     else
     {
-        drawColorized(p);
+        for(int i = 0; i < runs.size(); i++)
+        {
+            drawColorized(p, runs[i], runsIdx[i]);
+        }
     }
 
     if (isNogo())
@@ -2113,42 +2197,42 @@ void CGisItemTrk::setPen(QPainter& p, QPen& pen, trkact_t act) const
     p.setPen(pen);
 }
 
-void CGisItemTrk::drawColorizedByActivity(QPainter& p) const
+void CGisItemTrk::drawColorizedByActivity(QPainter& p, const QPolygonF& line, const QVector<qint32>& idx) const
 {
     QPen pen;
     pen.setWidth(penWidthFg);
     pen.setCapStyle(Qt::RoundCap);
 
-    for(const CTrackData::trkseg_t &segment : trk.segs)
+    const CTrackData::trkpt_t *ptPrev = nullptr;
+    qint32 segPrev = NOIDX;
+
+    const int N = qMin(line.size(), idx.size());
+    for(int n = 0; n < N; n++)
     {
-        const CTrackData::trkpt_t *ptPrev = nullptr;
+        const QPair<qint32, qint32>& i = drawCache.trkpts[idx[n]];
+        const CTrackData::trkpt_t& pt  = trk.segs[i.first].pts[i.second];
 
-        for(const CTrackData::trkpt_t &pt : segment.pts)
+        // segments are not connected
+        if((nullptr == ptPrev) || (segPrev != i.first))
         {
-            if(pt.isHidden())
-            {
-                continue;
-            }
-            if(nullptr == ptPrev)
-            {
-                setPen(p, pen, pt.getAct());
-                ptPrev = &pt;
-                continue;
-            }
-
-            p.drawLine(lineSimple[ptPrev->idxVisible], lineSimple[pt.idxVisible]);
+            setPen(p, pen, pt.getAct());
+            ptPrev  = &pt;
+            segPrev = i.first;
+            continue;
+        }
 
-            if(ptPrev->getAct() != pt.getAct())
-            {
-                setPen(p, pen, pt.getAct());
-            }
+        p.drawLine(line[n - 1], line[n]);
 
-            ptPrev = &pt;
+        if(ptPrev->getAct() != pt.getAct())
+        {
+            setPen(p, pen, pt.getAct());
         }
+
+        ptPrev = &pt;
     }
 }
 
-void CGisItemTrk::drawColorized(QPainter &p) const
+void CGisItemTrk::drawColorized(QPainter &p, const QPolygonF& line, const QVector<qint32>& idx) const
 {
     auto valueFunc = CKnownExtension::get(getColorizeSource()).valueFunc;
 
@@ -2164,48 +2248,160 @@ void CGisItemTrk::drawColorized(QPainter &p) const
 
     const qreal factor = CKnownExtension::get(getColorizeSource()).factor;
 
-    for(const CTrackData::trkseg_t &segment : trk.segs)
+    qint32 segPrev = NOIDX;
+    QColor colorStart;
+
+    const int N = qMin(line.size(), idx.size());
+    for(int n = 0; n < N; n++)
     {
-        const CTrackData::trkpt_t *ptPrev = nullptr;
-        QColor colorStart;
+        const QPair<qint32, qint32>& i = drawCache.trkpts[idx[n]];
+        const CTrackData::trkpt_t& pt  = trk.segs[i.first].pts[i.second];
 
-        for(const CTrackData::trkpt_t &pt : segment.pts)
+        // segments are not connected
+        if(segPrev != i.first)
         {
-            if(pt.isHidden())
-            {
-                continue;
-            }
-            if(nullptr == ptPrev)
-            {
-                ptPrev = &pt;
-                continue;
-            }
+            segPrev = i.first;
+            colorStart = QColor();
+            continue;
+        }
+
+        float colorAt = ( factor * valueFunc(pt) - getColorizeLimitLow() ) / (getColorizeLimitHigh() - getColorizeLimitLow());
+        colorAt = qMin(qMax(colorAt, 0.f), 1.f);
+
+        const QColor &colorEnd = colors.pixel(0, ((1.f - colorAt) * 255.f));
+        if(!colorStart.isValid())
+        {
+            colorStart = colorEnd;
+        }
 
-            float colorAt = ( factor * valueFunc(pt) - getColorizeLimitLow() ) / (getColorizeLimitHigh() - getColorizeLimitLow());
-            colorAt = qMin(qMax(colorAt, 0.f), 1.f);
+        QLinearGradient grad(line[n - 1], line[n]);
+        grad.setColorAt(0.f, colorStart);
+        grad.setColorAt(1.f, colorEnd);
+
+        QPen pen;
+        pen.setBrush(QBrush(grad));
+        pen.setWidth(penWidthFg);
+        pen.setCapStyle(Qt::RoundCap);
+
+        p.setPen(pen);
+        p.drawLine(line[n - 1], line[n]);
+
+        colorStart = colorEnd;
+    }
+}
 
-            const QColor &colorEnd = colors.pixel(0, ((1.f - colorAt) * 255.f));
-            if(!colorStart.isValid())
+void CGisItemTrk::invalidateDrawCache()
+{
+    QMutexLocker lock(&mutexItems);
+    drawCache = draw_cache_t();
+}
+
+void CGisItemTrk::updateDrawCache(CGisDraw * gis, bool withInvisible)
+{
+    const QString& projection = gis->getProjection();
+    if(!drawCache.valid || (drawCache.projection != projection))
+    {
+        drawCache = draw_cache_t();
+        drawCache.valid         = true;
+        drawCache.projection    = projection;
+
+        const int N = trk.segs.size();
+        for(int s = 0; s < N; s++)
+        {
+            const QVector<CTrackData::trkpt_t>& pts = trk.segs[s].pts;
+            const int M = pts.size();
+            for(int i = 0; i < M; i++)
             {
-                colorStart = colorEnd;
+                const CTrackData::trkpt_t& pt = pts[i];
+                if(pt.isHidden())
+                {
+                    continue;
+                }
+
+                drawCache.lineSimple << QPointF(pt.lon, pt.lat) * DEG_TO_RAD;
+                drawCache.trkpts << qMakePair(s, i);
             }
+        }
+        gis->convertRad2M(drawCache.lineSimple);
+    }
 
-            QLinearGradient grad(lineSimple[ptPrev->idxVisible], lineSimple[pt.idxVisible]);
-            grad.setColorAt(0.f, colorStart);
-            grad.setColorAt(1.f, colorEnd);
+    if(withInvisible && drawCache.lineFull.isEmpty())
+    {
+        for(const CTrackData::trkpt_t &pt : trk)
+        {
+            drawCache.lineFull << QPointF(pt.lon, pt.lat) * DEG_TO_RAD;
+        }
+        gis->convertRad2M(drawCache.lineFull);
+    }
+}
 
-            QPen pen;
-            pen.setBrush(QBrush(grad));
-            pen.setWidth(penWidthFg);
-            pen.setCapStyle(Qt::RoundCap);
+const CGisItemTrk::draw_level_t& CGisItemTrk::getDrawLevel(qint32 exponent)
+{
+    auto it = drawCache.levels.constFind(exponent);
+    if(it != drawCache.levels.constEnd())
+    {
+        return *it;
+    }
 
-            p.setPen(pen);
-            p.drawLine(lineSimple[ptPrev->idxVisible], lineSimple[pt.idxVisible]);
+    draw_level_t& level = drawCache.levels[exponent];
 
-            ptPrev = &pt;
-            colorStart = colorEnd;
+    const qreal tolerance = qPow(2.0, exponent);
+    const QPolygonF& line = drawCache.lineSimple;
+    const QVector<QPair<qint32, qint32> >& trkpts = drawCache.trkpts;
+
+    // reduce each segment on it's own as segments are not connected when colorized
+    QVector<pointDP> dp;
+    const int N = line.size();
+    int first = 0;
+    while(first < N)
+    {
+        int last = first;
+        while((last + 1 < N) && (trkpts[last + 1].first == trkpts[first].first))
+        {
+            last++;
+        }
+
+        dp.clear();
+        for(int i = first; i <= last; i++)
+        {
+            pointDP pt(line[i].x(), line[i].y(), 0);
+            pt.idx = i;
+            dp << pt;
+        }
+
+        GPS_Math_DouglasPeucker(dp, tolerance);
+
+        // keep the points where the activity changes
+        const QVector<CTrackData::trkpt_t>& pts = trk.segs[trkpts[first].first].pts;
+        for(int i = first + 1; i <= last; i++)
+        {
+            if(pts[trkpts[i - 1].second].getAct() != pts[trkpts[i].second].getAct())
+            {
+                dp[i - first - 1].used = true;
+                dp[i - first].used = true;
+            }
+        }
+
+        for(const pointDP& pt : dp)
+        {
+            if(pt.used)
+            {
+                level.idx << pt.idx;
+                level.line << line[pt.idx];
+            }
         }
+
+        first = last + 1;
     }
+
+    // the chunks overlap by one point to cover the line between them
+    const int M = level.line.size();
+    for(int i = 0; i < M; i += DRAW_CHUNK_SIZE)
+    {
+        level.chunks << QPolygonF(level.line.mid(i, DRAW_CHUNK_SIZE + 1)).boundingRect();
+    }
+
+    return level;
 }
 
 
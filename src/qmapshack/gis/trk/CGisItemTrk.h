@@ -313,8 +313,15 @@ public:
     qreal getMax(const QString& source) const;
 
 private:
-    void drawColorized(QPainter &p) const;
-    void drawColorizedByActivity(QPainter& p) const;
+    /**
+       @brief Draw the track line with a color per point
+
+       @param p     the painter
+       @param line  a part of the track line in screen pixel coordinates
+       @param idx   the visible index of each point in line
+     */
+    void drawColorized(QPainter &p, const QPolygonF& line, const QVector<qint32>& idx) const;
+    void drawColorizedByActivity(QPainter& p, const QPolygonF& line, const QVector<qint32>& idx) const;
     void setPen(QPainter& p, QPen& pen, trkact_t act) const;
     /**@}*/
 
@@ -676,6 +683,35 @@ private:
      */
     void deriveSecondaryData();
 
+    /**
+       @brief Serialize the expensive part of the secondary data
+
+       That is the distance to the previous point, the slope and the speed of
+       all visible points. A hash over the track points is added. Thus the
+       data can be restored by deriveSecondaryData() as long as the track
+       points do not change.
+
+       @return A versioned binary blob, empty if there is no secondary data.
+     */
+    QByteArray saveSecondaryData() const;
+
+    /**
+       @brief Restore the data serialized by saveSecondaryData()
+
+       @param data          the binary blob
+       @param deltaDistance the distance to the previous point for each visible point
+       @param slope         the slope [°] for each visible point
+       @param speed         the speed for each visible point
+       @return True if the data matches the current track points.
+     */
+    bool loadSecondaryData(const QByteArray& data, QVector<qreal>& deltaDistance, QVector<qreal>& slope, QVector<qreal>& speed) const;
+
+    /// a hash over all track point data the secondary data depends on
+    QByteArray getSecondaryDataHash() const;
+
+    /// the secondary data to be saved once with the history, see saveSecondaryData()
+    QByteArray getDerivedData() const override;
+
     /**
      * @brief Reset internal data like range selection and details dialog
      */
@@ -836,6 +872,15 @@ private:
     /// drawing and mouse interaction is dependent on the mode
     mode_e mode = eModeNormal;
 
+    /**
+       The secondary data as read from a file or the database. It is used
+       by the next call of deriveSecondaryData(). Until then it is saved
+       back unchanged.
+     */
+    QByteArray secondaryDataCache;
+    /// true if deriveSecondaryData() has been called for the current track data
+    bool hasSecondaryData = false;
+
     /**
        \defgroup TrackStatistics Some statistical values over the complete track
      */
@@ -871,6 +916,55 @@ private:
     QPolygonF lineSimple;   //< the current track line as screen pixel coordinates
     QPolygonF lineFull;     //< visible and invisible points
 
+    /// a track line reduced to what makes a difference at a certain zoom level
+    struct draw_level_t
+    {
+        /// the visible index of each point
+        QVector<qint32> idx;
+        /// the points in projected coordinates
+        QPolygonF line;
+        /// the bounding rectangles of consecutive chunks of points in projected coordinates
+        QVector<QRectF> chunks;
+    };
+
+    /**
+       @brief The track line prepared for drawing
+
+       Projecting the track points is the expensive part of drawing. Thus the projected
+       coordinates are kept until the projection or the track changes. Scaling them
+       to screen pixels for the current zoom level and point of focus is cheap.
+
+       The reduced lines are created on demand and kept for each tolerance used so far.
+     */
+    struct draw_cache_t
+    {
+        bool valid = false;
+        /// the projection used for the projected coordinates
+        QString projection;
+        /// visible points in projected coordinates, the index is the visible index
+        QPolygonF lineSimple;
+        /// visible and invisible points in projected coordinates, only created on demand
+        QPolygonF lineFull;
+        /// segment and point index of each visible point
+        QVector<QPair<qint32, qint32> > trkpts;
+        /// the reduced lines by the exponent of their tolerance to the base of 2
+        QMap<qint32, draw_level_t> levels;
+    };
+
+    draw_cache_t drawCache;
+
+    /// drop all projected data, must be called on any change of the track points
+    void invalidateDrawCache();
+    /// make sure the cached coordinates match the projection of the draw context
+    void updateDrawCache(CGisDraw * gis, bool withInvisible);
+    /**
+       @brief Get the visible track line reduced by the Douglas-Peucker algorithm
+
+       @param exponent  the tolerance is 2^exponent in the projection's unit
+       @return A reference to the reduced line in the cache.
+     */
+    const draw_level_t& getDrawLevel(qint32 exponent);
+
     qint32 penWidthFg = 1;  //< inner trackline width
     qint32 penWidthBg = 3;  //< outer trackline width
     qint32 penWidthHi = 11; //< highlighted trackline width
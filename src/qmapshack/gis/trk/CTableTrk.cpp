@@ -17,25 +17,32 @@
 **********************************************************************************************/
 
 #include "gis/trk/CTableTrk.h"
+#include "gis/trk/CTableTrkModel.h"
 #include "helpers/CElevationDialog.h"
 #include "helpers/CSettings.h"
 #include "units/IUnit.h"
 
-
-#include <proj_api.h>
 #include <QtWidgets>
 
 CTableTrk::CTableTrk(QWidget *parent)
-    : QTreeWidget(parent)
+    : QTreeView(parent)
     , INotifyTrk(CGisItemTrk::eVisualTrkTable)
 {
+    // rows are formatted on demand by the model. With uniform row
+    // heights the view does not have to ask for all of them to lay
+    // out the scroll area.
+    setUniformRowHeights(true);
+
+    model = new CTableTrkModel(this);
+    setModel(model);
+
     SETTINGS;
     cfg.beginGroup("TrackDetails");
     header()->restoreState(cfg.value("trackPointListState").toByteArray());
     cfg.endGroup();
 
-    connect(this, &CTableTrk::itemSelectionChanged, this, &CTableTrk::slotItemSelectionChanged);
-    connect(this, &CTableTrk::itemDoubleClicked, this, &CTableTrk::slotItemDoubleClicked);
+    connect(selectionModel(), &QItemSelectionModel::currentChanged, this, &CTableTrk::slotCurrentChanged);
+    connect(this, &CTableTrk::doubleClicked, this, &CTableTrk::slotDoubleClicked);
 }
 
 CTableTrk::~CTableTrk()
@@ -54,80 +61,62 @@ CTableTrk::~CTableTrk()
 
 void CTableTrk::showTopItem()
 {
-    scrollTo(indexFromItem(topLevelItem(0), QAbstractItemView::PositionAtCenter));
+    scrollTo(model->index(0, 0), QAbstractItemView::PositionAtCenter);
 }
 
-void CTableTrk::showNextInvalid()
+void CTableTrk::showInvalid(int row, int step)
 {
-    qint32 index = 0;
-    QTreeWidgetItem * item = currentItem();
-    if(item != nullptr)
-    {
-        index = indexOfTopLevelItem(item) + 1;
-    }
-
-    const qint32 N = topLevelItemCount();
-    for(; index < N; index++)
+    const int N = model->rowCount();
+    for(; (row >= 0) && (row < N); row += step)
     {
-        QTreeWidgetItem * item = topLevelItem(index);
-        if(item->data(eColNum, Qt::UserRole).toUInt() != 0)
+        if(model->isInvalid(row))
         {
-            scrollTo(indexFromItem(item, QAbstractItemView::PositionAtCenter));
+            scrollTo(model->index(row, 0), QAbstractItemView::PositionAtCenter);
             break;
         }
     }
 }
 
+void CTableTrk::showNextInvalid()
+{
+    const QModelIndex& index = currentIndex();
+    showInvalid(index.isValid() ? index.row() + 1 : 0, 1);
+}
+
 void CTableTrk::showPrevInvalid()
 {
-    qint32 index = 0;
-    QTreeWidgetItem * item = currentItem();
-    if(item != nullptr)
-    {
-        index = indexOfTopLevelItem(item) - 1;
-    }
+    const QModelIndex& index = currentIndex();
+    showInvalid(index.isValid() ? index.row() - 1 : 0, -1);
+}
 
-    for(; index >= 0; index--)
+void CTableTrk::setCurrentTrkPt(qint32 idxTotal)
+{
+    const int row = model->getRowByTotalIndex(idxTotal);
+    if(row < 0)
     {
-        QTreeWidgetItem * item = topLevelItem(index);
-        if(item->data(eColNum, Qt::UserRole).toUInt() != 0)
-        {
-            scrollTo(indexFromItem(item, QAbstractItemView::PositionAtCenter));
-            break;
-        }
+        return;
     }
+
+    ignoreCurrentChanged = true;
+    setCurrentIndex(model->index(row, 0));
+    ignoreCurrentChanged = false;
 }
 
 
 void CTableTrk::setTrack(CGisItemTrk * track)
 {
-    setColumnCount(eColMax);
-
-    QStringList labels;
-    labels << "#";
-    labels << tr("Time");
-    labels << tr("Ele.");
-    labels << tr("Delta");
-    labels << tr("Dist.");
-    labels << tr("Speed");
-    labels << tr("Slope");
-    labels << tr("Ascent");
-    labels << tr("Descent");
-    labels << tr("Position");
-    setHeaderLabels(labels);
-
     if(trk != nullptr)
     {
         trk->unregisterVisual(this);
     }
 
-    clear();
     trk = track;
+    model->setTrack(trk);
 
     if(trk != nullptr)
     {
         trk->registerVisual(this);
-        updateData();
+        header()->resizeSections(QHeaderView::ResizeToContents);
     }
 
     adjustSize();
@@ -140,128 +129,48 @@ void CTableTrk::updateData()
         return;
     }
 
-    // use all valid flags as invalid mask. By that only
-    // invalid flags for properties with valid points count
-    quint32 invalidMask = (trk->getAllValidFlags() & CTrackData::trkpt_t::eValidMask) << 16;
+    // the row of a point might change. Keep the selection on the point itself.
+    const CTrackData::trkpt_t * trkpt = model->getTrkPt(currentIndex().row());
+    const qint32 idxTotal = trkpt != nullptr ? trkpt->idxTotal : NOIDX;
 
-    QList<QTreeWidgetItem*> items;
-    const CTrackData& t = trk->getTrackData();
-    for(const CTrackData::trkpt_t& trkpt : t)
-    {
-        QString val, unit;
-
-        QTreeWidgetItem * item = new QTreeWidgetItem();
-        item->setTextAlignment(eColNum,     Qt::AlignLeft);
-        item->setTextAlignment(eColEle,     Qt::AlignRight);
-        item->setTextAlignment(eColDelta,   Qt::AlignRight);
-        item->setTextAlignment(eColDist,    Qt::AlignRight);
-        item->setTextAlignment(eColAscent,  Qt::AlignRight);
-        item->setTextAlignment(eColDescent, Qt::AlignRight);
-        item->setTextAlignment(eColSpeed,   Qt::AlignRight);
-
-        if(!trk->isReadOnly())
-        {
-            item->setToolTip(eColEle, tr("Double click to edit elevation value"));
-        }
+    model->updateData();
 
-        QBrush bg = item->background(0);
-        if(trkpt.isInvalid(CTrackData::trkpt_t::invalid_e(invalidMask)) && !trkpt.isHidden())
-        {
-            bg = QColor(255, 100, 100);
-            item->setData(eColNum, Qt::UserRole, quint32(invalidMask));
-        }
-
-        QBrush fg( trkpt.isHidden() ? Qt::gray : Qt::black );
-        for(int i = 0; i < eColMax; i++)
-        {
-            item->setBackground(i, bg);
-            item->setForeground(i, fg);
-        }
-
-        item->setText(eColNum, QString::number(trkpt.idxTotal));
-
-        item->setText(eColTime, trkpt.time.isValid()
-                      ? IUnit::self().datetime2string(trkpt.time, true, QPointF(trkpt.lon, trkpt.lat) * DEG_TO_RAD)
-                      : "-"
-                      );
-
-        if(trkpt.ele != NOINT)
-        {
-            IUnit::self().meter2elevation(trkpt.ele, val, unit);
-            item->setText(eColEle, tr("%1%2").arg(val).arg(unit));
-        }
-        else
-        {
-            item->setText(eColEle, "-");
-        }
-
-        IUnit::self().meter2distance(trkpt.deltaDistance, val, unit);
-        item->setText(eColDelta, tr("%1%2").arg(val).arg(unit));
-
-        IUnit::self().meter2distance(trkpt.distance, val, unit);
-        item->setText(eColDist, tr("%1%2").arg(val).arg(unit));
-
-        if(trkpt.speed != NOFLOAT)
-        {
-            IUnit::self().meter2speed(trkpt.speed, val, unit);
-            item->setText(eColSpeed, tr("%1%2").arg(val).arg(unit));
-        }
-        else
-        {
-            item->setText(eColSpeed, "-");
-        }
-
-        IUnit::self().slope2string(trkpt.slope1, val, unit);
-        item->setText(eColSlope, (trkpt.slope1 != NOFLOAT)
-                      ? QString("%1%2").arg(val).arg(unit)
-                      : "-"
-                      );
-
-        IUnit::self().meter2elevation(trkpt.ascent, val, unit);
-        item->setText(eColAscent, tr("%1%2").arg(val).arg(unit));
-        IUnit::self().meter2elevation(trkpt.descent, val, unit);
-        item->setText(eColDescent, tr("%1%2").arg(val).arg(unit));
-
-        // position
-        QString str;
-        IUnit::degToStr(trkpt.lon, trkpt.lat, str);
-        item->setText(eColPosition, str);
-
-        items << item;
+    if(idxTotal != NOIDX)
+    {
+        setCurrentTrkPt(idxTotal);
     }
-
-    clear();
-    addTopLevelItems(items);
-    header()->resizeSections(QHeaderView::ResizeToContents);
 }
 
 
-void CTableTrk::slotItemSelectionChanged()
+void CTableTrk::slotCurrentChanged(const QModelIndex& current, const QModelIndex& previous)
 {
-    QTreeWidgetItem * item = currentItem();
-    if(nullptr != item)
+    if(ignoreCurrentChanged || (trk == nullptr))
     {
-        quint32 idx = item->text(eColNum).toUInt();
-        trk->setMouseFocusByTotalIndex(idx, CGisItemTrk::eFocusMouseMove, "CTableTrk");
+        return;
+    }
+
+    const CTrackData::trkpt_t * trkpt = model->getTrkPt(current.row());
+    if(nullptr != trkpt)
+    {
+        trk->setMouseFocusByTotalIndex(trkpt->idxTotal, CGisItemTrk::eFocusMouseMove, "CTableTrk");
     }
 }
 
-void CTableTrk::slotItemDoubleClicked(QTreeWidgetItem * item, int column)
+void CTableTrk::slotDoubleClicked(const QModelIndex& index)
 {
-    if(trk->isReadOnly())
+    if((trk == nullptr) || trk->isReadOnly())
     {
         return;
     }
 
-    qint32 idx = item->text(eColNum).toInt();
-    qint32 ele = trk->getElevation(idx);
-    qreal lon, lat;
-    IUnit::strToDeg(item->text(eColPosition), lon, lat);
-
-    if((column == eColEle) && (lon != NOFLOAT) && (lat != NOFLOAT))
+    const CTrackData::trkpt_t * trkpt = model->getTrkPt(index.row());
+    if((index.column() == CTableTrkModel::eColEle) && (trkpt != nullptr))
     {
+        const qint32 idx = trkpt->idxTotal;
+        const qint32 ele = trk->getElevation(idx);
+
         QVariant var(ele);
-        CElevationDialog dlg(this, var, QVariant(ele), QPointF(lon, lat));
+        CElevationDialog dlg(this, var, QVariant(ele), QPointF(trkpt->lon, trkpt->lat));
 
         if(dlg.exec() == QDialog::Accepted)
         {
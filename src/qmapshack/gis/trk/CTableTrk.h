@@ -20,9 +20,11 @@
 #define CTABLETRK_H
 
 #include <gis/trk/CGisItemTrk.h>
-#include <QTreeWidget>
+#include <QTreeView>
 
-class CTableTrk : public QTreeWidget, public INotifyTrk
+class CTableTrkModel;
+
+class CTableTrk : public QTreeView, public INotifyTrk
 {
     Q_OBJECT
 public:
@@ -36,32 +38,29 @@ public:
     void setMouseRangeFocus(const CTrackData::trkpt_t * pt1, const CTrackData::trkpt_t * pt2) override {}
     void setMouseClickFocus(const CTrackData::trkpt_t * pt) override {}
 
-
-    enum columns_t
-    {
-        eColNum
-        , eColTime
-        , eColEle
-        , eColDelta
-        , eColDist
-        , eColSpeed
-        , eColSlope
-        , eColAscent
-        , eColDescent
-        , eColPosition
-        , eColMax
-    };
-
     void showTopItem();
     void showNextInvalid();
     void showPrevInvalid();
 
+    /**
+       @brief Make the row of a track point the current one
+
+       @note This will not emit any selection signals
+
+       @param idxTotal  the track point's total index
+     */
+    void setCurrentTrkPt(qint32 idxTotal);
+
 private slots:
-    void slotItemSelectionChanged();
-    void slotItemDoubleClicked(QTreeWidgetItem * item, int column);
+    void slotCurrentChanged(const QModelIndex& current, const QModelIndex& previous);
+    void slotDoubleClicked(const QModelIndex& index);
 
 private:
+    void showInvalid(int row, int step);
+
     CGisItemTrk * trk = nullptr;
+    CTableTrkModel * model;
+    bool ignoreCurrentChanged = false;
 };
 
 #endif //CTABLETRK_H
@@ -0,0 +1,307 @@
+/**********************************************************************************************
+    Copyright (C) 2016 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/trk/CGisItemTrk.h"
+#include "gis/trk/CTableTrkModel.h"
+#include "units/IUnit.h"
+
+#include <proj_api.h>
+#include <QtWidgets>
+
+CTableTrkModel::CTableTrkModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void CTableTrkModel::setTrack(CGisItemTrk * track)
+{
+    beginResetModel();
+    trk = track;
+    buildIndex(index);
+    endResetModel();
+}
+
+void CTableTrkModel::buildIndex(QVector<idx_t>& idx)
+{
+    idx.clear();
+    invalidMask = 0;
+
+    if(trk == nullptr)
+    {
+        return;
+    }
+
+    invalidMask = (trk->getAllValidFlags() & CTrackData::trkpt_t::eValidMask) << 16;
+
+    const CTrackData& t = trk->getTrackData();
+    idx.reserve(trk->getCntTotalPoints());
+
+    const int N = t.segs.count();
+    for(int s = 0; s < N; s++)
+    {
+        const int M = t.segs[s].pts.count();
+        for(int p = 0; p < M; p++)
+        {
+            idx << idx_t {s, p};
+        }
+    }
+}
+
+void CTableTrkModel::updateData()
+{
+    QVector<idx_t> newIndex;
+    buildIndex(newIndex);
+
+    const int oldCount = index.count();
+    const int newCount = newIndex.count();
+
+    if(newCount < oldCount)
+    {
+        beginRemoveRows(QModelIndex(), newCount, oldCount - 1);
+        index.swap(newIndex);
+        endRemoveRows();
+    }
+    else if(newCount > oldCount)
+    {
+        beginInsertRows(QModelIndex(), oldCount, newCount - 1);
+        index.swap(newIndex);
+        endInsertRows();
+    }
+    else
+    {
+        index.swap(newIndex);
+    }
+
+    // all rows kept have to be formatted again
+    const int common = qMin(oldCount, newCount);
+    if(common > 0)
+    {
+        emit dataChanged(createIndex(0, 0), createIndex(common - 1, eColMax - 1));
+    }
+}
+
+int CTableTrkModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : index.count();
+}
+
+int CTableTrkModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : int(eColMax);
+}
+
+const CTrackData::trkpt_t * CTableTrkModel::getTrkPt(int row) const
+{
+    if((trk == nullptr) || (row < 0) || (row >= index.count()))
+    {
+        return nullptr;
+    }
+
+    const idx_t& idx = index[row];
+    const CTrackData& t = trk->getTrackData();
+    if((idx.seg >= t.segs.count()) || (idx.pt >= t.segs[idx.seg].pts.count()))
+    {
+        return nullptr;
+    }
+
+    return &t.segs[idx.seg].pts[idx.pt];
+}
+
+int CTableTrkModel::getRowByTotalIndex(qint32 idxTotal) const
+{
+    // the total index is the row in most cases
+    const CTrackData::trkpt_t * trkpt = getTrkPt(idxTotal);
+    if((trkpt != nullptr) && (trkpt->idxTotal == idxTotal))
+    {
+        return idxTotal;
+    }
+
+    const int N = index.count();
+    for(int row = 0; row < N; row++)
+    {
+        trkpt = getTrkPt(row);
+        if((trkpt != nullptr) && (trkpt->idxTotal == idxTotal))
+        {
+            return row;
+        }
+    }
+
+    return -1;
+}
+
+bool CTableTrkModel::isInvalid(int row) const
+{
+    const CTrackData::trkpt_t * trkpt = getTrkPt(row);
+    if(trkpt == nullptr)
+    {
+        return false;
+    }
+
+    return trkpt->isInvalid(CTrackData::trkpt_t::invalid_e(invalidMask)) && !trkpt->isHidden();
+}
+
+QVariant CTableTrkModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if((orientation != Qt::Horizontal) || (role != Qt::DisplayRole))
+    {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch(section)
+    {
+    case eColNum:
+        return "#";
+
+    case eColTime:
+        return tr("Time");
+
+    case eColEle:
+        return tr("Ele.");
+
+    case eColDelta:
+        return tr("Delta");
+
+    case eColDist:
+        return tr("Dist.");
+
+    case eColSpeed:
+        return tr("Speed");
+
+    case eColSlope:
+        return tr("Slope");
+
+    case eColAscent:
+        return tr("Ascent");
+
+    case eColDescent:
+        return tr("Descent");
+
+    case eColPosition:
+        return tr("Position");
+    }
+
+    return QVariant();
+}
+
+QVariant CTableTrkModel::data(const QModelIndex& idx, int role) const
+{
+    const CTrackData::trkpt_t * trkpt = idx.isValid() ? getTrkPt(idx.row()) : nullptr;
+    if(trkpt == nullptr)
+    {
+        return QVariant();
+    }
+
+    switch(role)
+    {
+    case Qt::TextAlignmentRole:
+        switch(idx.column())
+        {
+        case eColNum:
+            return int(Qt::AlignLeft);
+
+        case eColEle:
+        case eColDelta:
+        case eColDist:
+        case eColAscent:
+        case eColDescent:
+        case eColSpeed:
+            return int(Qt::AlignRight);
+        }
+        return QVariant();
+
+    case Qt::ToolTipRole:
+        if((idx.column() == eColEle) && !trk->isReadOnly())
+        {
+            return tr("Double click to edit elevation value");
+        }
+        return QVariant();
+
+    case Qt::BackgroundRole:
+        return isInvalid(idx.row()) ? QVariant(QBrush(QColor(255, 100, 100))) : QVariant();
+
+    case Qt::ForegroundRole:
+        return QBrush(trkpt->isHidden() ? Qt::gray : Qt::black);
+
+    case Qt::DisplayRole:
+        break;
+
+    default:
+        return QVariant();
+    }
+
+    QString val, unit;
+    switch(idx.column())
+    {
+    case eColNum:
+        return QString::number(trkpt->idxTotal);
+
+    case eColTime:
+        return trkpt->time.isValid()
+               ? IUnit::self().datetime2string(trkpt->time, true, QPointF(trkpt->lon, trkpt->lat) * DEG_TO_RAD)
+               : "-";
+
+    case eColEle:
+        if(trkpt->ele == NOINT)
+        {
+            return "-";
+        }
+        IUnit::self().meter2elevation(trkpt->ele, val, unit);
+        return tr("%1%2").arg(val).arg(unit);
+
+    case eColDelta:
+        IUnit::self().meter2distance(trkpt->deltaDistance, val, unit);
+        return tr("%1%2").arg(val).arg(unit);
+
+    case eColDist:
+        IUnit::self().meter2distance(trkpt->distance, val, unit);
+        return tr("%1%2").arg(val).arg(unit);
+
+    case eColSpeed:
+        if(trkpt->speed == NOFLOAT)
+        {
+            return "-";
+        }
+        IUnit::self().meter2speed(trkpt->speed, val, unit);
+        return tr("%1%2").arg(val).arg(unit);
+
+    case eColSlope:
+        if(trkpt->slope1 == NOFLOAT)
+        {
+            return "-";
+        }
+        IUnit::self().slope2string(trkpt->slope1, val, unit);
+        return QString("%1%2").arg(val).arg(unit);
+
+    case eColAscent:
+        IUnit::self().meter2elevation(trkpt->ascent, val, unit);
+        return tr("%1%2").arg(val).arg(unit);
+
+    case eColDescent:
+        IUnit::self().meter2elevation(trkpt->descent, val, unit);
+        return tr("%1%2").arg(val).arg(unit);
+
+    case eColPosition:
+    {
+        QString str;
+        IUnit::degToStr(trkpt->lon, trkpt->lat, str);
+        return str;
+    }
+    }
+
+    return QVariant();
+}
@@ -0,0 +1,121 @@
+/**********************************************************************************************
+    Copyright (C) 2016 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTABLETRKMODEL_H
+#define CTABLETRKMODEL_H
+
+#include "gis/trk/CTrackData.h"
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+class CGisItemTrk;
+
+/**
+   @brief A table model over all track points of a track
+
+   The model does not copy any data. It just keeps a flat index of
+   (segment, point) pairs to access the n-th track point in constant
+   time. All cell content is formatted on demand in data(). Thus only
+   the rows visible in the view are formatted at all.
+ */
+class CTableTrkModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    CTableTrkModel(QObject * parent);
+    virtual ~CTableTrkModel() = default;
+
+    enum columns_t
+    {
+        eColNum
+        , eColTime
+        , eColEle
+        , eColDelta
+        , eColDist
+        , eColSpeed
+        , eColSlope
+        , eColAscent
+        , eColDescent
+        , eColPosition
+        , eColMax
+    };
+
+    /**
+       @brief Set the track to be displayed
+
+       This will reset the model.
+
+       @param track     the track or nullptr to clear the model
+     */
+    void setTrack(CGisItemTrk * track);
+
+    /**
+       @brief Re-read the track after it has been changed
+
+       Rows present before and after the change are signaled by
+       dataChanged(). Rows added or removed at the end are signaled
+       by the according insert/remove signals. No model reset is done.
+     */
+    void updateData();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+       @brief Get access to the track point of a row
+       @param row   the row index
+       @return A pointer to the track point or nullptr if the row is out of range.
+     */
+    const CTrackData::trkpt_t * getTrkPt(int row) const;
+
+    /**
+       @brief Get the row of a track point by it's total index
+       @param idxTotal  the track point's total index
+       @return The row or -1 if there is no such point.
+     */
+    int getRowByTotalIndex(qint32 idxTotal) const;
+
+    /// true if the row shows a point that is flagged invalid and not hidden
+    bool isInvalid(int row) const;
+
+private:
+    struct idx_t
+    {
+        qint32 seg;
+        qint32 pt;
+    };
+
+    void buildIndex(QVector<idx_t>& idx);
+
+    CGisItemTrk * trk = nullptr;
+
+    /// flat index into the track's segments
+    QVector<idx_t> index;
+
+    /**
+       All valid flags as invalid mask. By that only invalid
+       flags for properties with valid points count.
+     */
+    quint32 invalidMask = 0;
+};
+
+#endif //CTABLETRKMODEL_H
+
@@ -245,7 +245,7 @@ void CDetailsGeoCache::slotRequestFinished(QNetworkReply * reply)
         {
             CGisItemWpt::image_t image;
             image.info = info;
-            image.pixmap.loadFromData(reply->readAll());
+            image.setData(reply->readAll());
             wpt.addImage(image);
 
             photoAlbum->reload(wpt.getImages());
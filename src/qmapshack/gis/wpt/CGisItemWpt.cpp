@@ -29,6 +29,7 @@
 #include "gis/wpt/CScrOptWpt.h"
 #include "gis/wpt/CScrOptWptRadius.h"
 #include "gis/wpt/CSetupIconAndName.h"
+#include "gis/wpt/CWptClusterIndex.h"
 #include "GeoMath.h"
 #include "helpers/CDraw.h"
 #include "helpers/CSettings.h"
@@ -85,7 +86,7 @@ CGisItemWpt::CGisItemWpt(const QPointF& pos, const CGisItemWpt& parentWpt, IGisP
     wpt.time    = QDateTime::currentDateTimeUtc();
 
     key.clear();
-    history.events.clear();
+    history.reset();
     flags = eFlagCreatedInQms | eFlagWriteAllowed;
 
     qreal ele = CMainWindow::self().getElevationAt(pos * DEG_TO_RAD);
@@ -110,7 +111,7 @@ CGisItemWpt::CGisItemWpt(const CGisItemWpt &parentWpt, IGisProject *project, int
     {
         wpt.name += tr("_Clone");
         key.clear();
-        history.events.clear();
+        history.reset();
         setupHistory();
     }
 
@@ -186,6 +187,10 @@ CGisItemWpt::CGisItemWpt(CFitStream& stream, IGisProject * project)
 
 CGisItemWpt::~CGisItemWpt()
 {
+    if(clusterIndex != nullptr)
+    {
+        clusterIndex->remove(this);
+    }
 }
 
 IGisItem * CGisItemWpt::createClone()
@@ -214,6 +219,17 @@ void CGisItemWpt::genKey() const
     IGisItem::genKey();
 }
 
+void CGisItemWpt::getBlobs(blobs_t& blobs) const
+{
+    for(const image_t& image : images)
+    {
+        if(!image.isNull())
+        {
+            blobs[image.getKey()] = image.getBlob();
+        }
+    }
+}
+
 QString CGisItemWpt::getLastName(const QString& name)
 {
     SETTINGS;
@@ -296,6 +312,18 @@ void CGisItemWpt::newWpt(QPointF& pt, const QString &name, const QString &desc,
     cfg.setValue("Waypoint/lastIcon", wpt->getIconName());
 }
 
+QStringList CGisItemWpt::getFullTextFields() const
+{
+    QStringList fields = IGisItem::getFullTextFields();
+    if(geocache.hasData)
+    {
+        fields << geocache.name << geocache.owner << geocache.type << geocache.container
+               << geocache.shortDesc << geocache.longDesc << geocache.hint
+               << geocache.country << geocache.state;
+    }
+    return fields;
+}
+
 QString CGisItemWpt::getInfo(quint32 feature) const
 {
     QString str = "<div>";
@@ -562,6 +590,83 @@ void CGisItemWpt::setLinks(const QList<link_t>& links)
     changed(tr("Changed links"), "://icons/48x48/Link.png");
 }
 
+QImage CGisItemWpt::image_t::getImage() const
+{
+    return CWptImageCache::getImage(key, blob);
+}
+
+QImage CGisItemWpt::image_t::getThumbnail(const QSize& size) const
+{
+    return CWptImageCache::getThumbnail(key, blob, size);
+}
+
+void CGisItemWpt::image_t::setImage(const QImage& img)
+{
+    QByteArray data;
+    if(!img.isNull())
+    {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        img.save(&buffer, "JPEG");
+    }
+
+    blob = CWptImageCache::intern(data, key);
+}
+
+QByteArray CGisItemWpt::image_t::getData() const
+{
+    return blob.isNull() ? QByteArray() : *blob;
+}
+
+bool CGisItemWpt::image_t::setData(const QByteArray& data)
+{
+    // JPEG data starts with a SOI marker
+    if(data.startsWith("\xFF\xD8") || data.isEmpty())
+    {
+        blob = CWptImageCache::intern(data, key);
+        return !data.isEmpty();
+    }
+
+    const QImage& img = QImage::fromData(data);
+    setImage(img);
+    return !img.isNull();
+}
+
+bool CGisItemWpt::image_t::setKey(const QByteArray& key)
+{
+    blob        = CWptImageCache::lookup(key);
+    this->key   = blob.isNull() ? QByteArray() : key;
+    return !blob.isNull();
+}
+
+bool CGisItemWpt::image_t::load(const QString& filename)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    return setData(file.readAll());
+}
+
+bool CGisItemWpt::image_t::save(const QString& filename) const
+{
+    const QString& suffix = QFileInfo(filename).suffix().toLower();
+    if((suffix != "jpg") && (suffix != "jpeg"))
+    {
+        return getImage().save(filename);
+    }
+
+    QFile file(filename);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    return file.write(getData()) >= 0;
+}
+
 void CGisItemWpt::setImages(const QList<image_t>& imgs)
 {
     images = imgs;
@@ -23,6 +23,7 @@
 
 #include "gis/IGisItem.h"
 #include "gis/tnv/CTwoNavProject.h"
+#include "gis/wpt/CWptImageCache.h"
 
 #include <QCoreApplication>
 #include <QPointer>
@@ -36,6 +37,7 @@ class CQlgtWpt;
 class QTextEdit;
 class QDir;
 class CFitStream;
+class CWptClusterIndex;
 class CGisItemWpt : public IGisItem
 {
     Q_DECLARE_TR_FUNCTIONS(CGisItemWpt)
@@ -90,13 +92,57 @@ public:
         QString getLogs() const;
     };
 
+    /**
+       @brief An image attached to the waypoint
+
+       The image is stored as JPEG data shared by all copies. It is
+       decoded on demand only. See CWptImageCache.
+     */
     struct image_t
     {
-        QImage pixmap;
+        /// get the decoded image
+        QImage getImage() const;
+        /// get the image scaled to fit into size. The result is cached.
+        QImage getThumbnail(const QSize& size) const;
+        /// replace the image, it will be encoded as JPEG
+        void setImage(const QImage& img);
+
+        /// get the encoded JPEG data
+        QByteArray getData() const;
+        /// set encoded image data, data of other formats than JPEG is converted
+        bool setData(const QByteArray& data);
+
+        /// get the key of the encoded data
+        const QByteArray& getKey() const
+        {
+            return key;
+        }
+        /// set the encoded data by key, the data must be in use, e.g. by a history
+        bool setKey(const QByteArray& key);
+        /// get the shared encoded data
+        const CWptImageCache::blob_t& getBlob() const
+        {
+            return blob;
+        }
+
+        /// load the image from a file, JPEG files are not decoded
+        bool load(const QString& filename);
+        /// save the image to a file, JPEG data is written as it is
+        bool save(const QString& filename) const;
+
+        bool isNull() const
+        {
+            return blob.isNull() || blob->isEmpty();
+        }
+
         qreal direction = 0;
         QString info;
         QString filePath;
         QString fileName;
+
+    private:
+        QByteArray key;
+        CWptImageCache::blob_t blob;
     };
 
     CGisItemWpt(const QPointF &pos, qreal ele, const QDateTime &time, const QString &name, const QString &icon, IGisProject *project);
@@ -269,6 +315,7 @@ public:
     {
         return wpt.desc;
     }
+    QStringList getFullTextFields() const override;
     const geocache_t& getGeoCache() const
     {
         return geocache;
@@ -333,6 +380,23 @@ public:
      */
     void removeLinksByType(const QString& type);
 
+    /**
+       @brief Tell the waypoint it is drawn as part of a cluster
+
+       The waypoint is treated like being outside the viewport. See CWptClusterIndex.
+     */
+    void setInCluster()
+    {
+        rectBubble  = QRect();
+        posScreen   = NOPOINTF;
+    }
+
+    /// the bubble is drawn anywhere around the waypoint
+    bool isDrawnInBoundingRect() const override
+    {
+        return !(flags & eFlagWptBubble);
+    }
+
     void toggleBubble();
     bool hasBubble()
     {
@@ -345,6 +409,7 @@ public:
     }
 
     void genKey() const override;
+    void getBlobs(blobs_t& blobs) const override;
     const searchValue_t getValueByKeyword(searchProperty_e keyword) override;
 
     static QString getLastName(const QString &name);
@@ -387,6 +452,10 @@ private:
     QPointF focus;
     QPointF posScreen = NOPOINTF;
 
+    /// the cluster index the waypoint is registered with
+    friend class CWptClusterIndex;
+    CWptClusterIndex * clusterIndex = nullptr;
+
     // additional data, common to all IGisItems, is found in IItem //
 
     // --- stop all waypoint data ----
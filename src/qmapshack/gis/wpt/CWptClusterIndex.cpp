@@ -0,0 +1,225 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/wpt/CGisItemWpt.h"
+#include "gis/wpt/CWptClusterIndex.h"
+
+#include <proj_api.h>
+#include <QtCore>
+
+/// only every n-th level is stored to save memory
+#define LEVEL_STEP 2
+/// cells with that many waypoints or less keep a list of their waypoints
+#define MAX_WPTS_LISTED 3
+
+CWptClusterIndex::~CWptClusterIndex()
+{
+    for(CGisItemWpt * wpt : entries.keys())
+    {
+        wpt->clusterIndex = nullptr;
+    }
+}
+
+qint32 CWptClusterIndex::getLevel(qreal pxPerRad, qreal size)
+{
+    const qreal cellsPerWorld = 2 * M_PI * pxPerRad / size;
+    if(cellsPerWorld < 1)
+    {
+        return 0;
+    }
+
+    const qint32 level = qFloor(std::log2(cellsPerWorld));
+    if(level > maxLevel)
+    {
+        return -1;
+    }
+
+    return level - (level % LEVEL_STEP);
+}
+
+void CWptClusterIndex::beginUpdate()
+{
+    generation++;
+}
+
+void CWptClusterIndex::update(CGisItemWpt * wpt)
+{
+    if((wpt->clusterIndex != nullptr) && (wpt->clusterIndex != this))
+    {
+        // the waypoint has been moved from another project
+        wpt->clusterIndex->remove(wpt);
+    }
+    wpt->clusterIndex = this;
+
+    const QPointF& pos = wpt->getPosition() * DEG_TO_RAD;
+    const qreal cellSize = 2 * M_PI / (1 << maxLevel);
+    const qint32 x = qBound(0, qFloor((pos.x() + M_PI) / cellSize), (1 << maxLevel) - 1);
+    const qint32 y = qBound(0, qFloor((pos.y() + M_PI_2) / cellSize), (1 << maxLevel) - 1);
+
+    QHash<CGisItemWpt*, entry_t>::iterator entry = entries.find(wpt);
+    if(entry != entries.end())
+    {
+        entry->generation = generation;
+        if(entry->pos == pos)
+        {
+            return;
+        }
+        removeFromCells(wpt, *entry);
+        entry->x    = x;
+        entry->y    = y;
+        entry->pos  = pos;
+    }
+    else
+    {
+        entry = entries.insert(wpt, entry_t {x, y, pos, generation});
+    }
+
+    addToCells(wpt, *entry);
+}
+
+void CWptClusterIndex::endUpdate()
+{
+    QList<CGisItemWpt*> wpts;
+    for(QHash<CGisItemWpt*, entry_t>::const_iterator entry = entries.constBegin(); entry != entries.constEnd(); entry++)
+    {
+        if(entry->generation != generation)
+        {
+            wpts << entry.key();
+        }
+    }
+
+    for(CGisItemWpt * wpt : wpts)
+    {
+        remove(wpt);
+    }
+}
+
+void CWptClusterIndex::remove(CGisItemWpt * wpt)
+{
+    QHash<CGisItemWpt*, entry_t>::iterator entry = entries.find(wpt);
+    if(entry == entries.end())
+    {
+        return;
+    }
+
+    removeFromCells(wpt, *entry);
+    entries.erase(entry);
+    wpt->clusterIndex = nullptr;
+}
+
+void CWptClusterIndex::addToCells(CGisItemWpt * wpt, const entry_t& entry)
+{
+    for(qint32 level = 0; level <= maxLevel; level += LEVEL_STEP)
+    {
+        const qint32 shift = maxLevel - level;
+        cell_t& cell = cells[getCellKey(level, entry.x >> shift, entry.y >> shift)];
+        cell.count++;
+        cell.sum += entry.pos;
+
+        if(cell.count > MAX_WPTS_LISTED)
+        {
+            cell.wpts.clear();
+            cell.isListed = false;
+        }
+        else if(cell.isListed)
+        {
+            cell.wpts << wpt;
+        }
+    }
+}
+
+void CWptClusterIndex::removeFromCells(CGisItemWpt * wpt, const entry_t& entry)
+{
+    for(qint32 level = 0; level <= maxLevel; level += LEVEL_STEP)
+    {
+        const qint32 shift = maxLevel - level;
+        const quint64 key = getCellKey(level, entry.x >> shift, entry.y >> shift);
+
+        QHash<quint64, cell_t>::iterator cell = cells.find(key);
+        if(cell == cells.end())
+        {
+            continue;
+        }
+
+        cell->count--;
+        if(cell->count == 0)
+        {
+            cells.erase(cell);
+            continue;
+        }
+
+        cell->sum -= entry.pos;
+        cell->wpts.removeOne(wpt);
+        // the list of an overflown cell is restored in getClusters() on demand
+    }
+}
+
+void CWptClusterIndex::getClusters(qint32 level, const QRectF& area, QList<cluster_t>& clusters)
+{
+    const qreal cellSize = 2 * M_PI / (1 << level);
+    const qint32 maxCell = (1 << level) - 1;
+    const qint32 x1 = qBound(0, qFloor((area.left() + M_PI) / cellSize), maxCell);
+    const qint32 x2 = qBound(0, qFloor((area.right() + M_PI) / cellSize), maxCell);
+    const qint32 y1 = qBound(0, qFloor((area.top() + M_PI_2) / cellSize), maxCell);
+    const qint32 y2 = qBound(0, qFloor((area.bottom() + M_PI_2) / cellSize), maxCell);
+
+    QList<cell_t*> visible;
+    bool restoreLists = false;
+    for(qint32 x = x1; x <= x2; x++)
+    {
+        for(qint32 y = y1; y <= y2; y++)
+        {
+            QHash<quint64, cell_t>::iterator cell = cells.find(getCellKey(level, x, y));
+            if(cell == cells.end())
+            {
+                continue;
+            }
+
+            if(!cell->isListed && (cell->count <= MAX_WPTS_LISTED))
+            {
+                cell->isListed = true;
+                restoreLists   = true;
+            }
+            visible << &(*cell);
+        }
+    }
+
+    if(restoreLists)
+    {
+        // A cell dropped below the limit by removing waypoints. All lists
+        // restored are empty. Fill them with a single pass over all waypoints.
+        const qint32 shift = maxLevel - level;
+        for(QHash<CGisItemWpt*, entry_t>::const_iterator entry = entries.constBegin(); entry != entries.constEnd(); entry++)
+        {
+            cell_t& cell = cells[getCellKey(level, entry->x >> shift, entry->y >> shift)];
+            if(cell.isListed && (cell.wpts.count() < cell.count))
+            {
+                cell.wpts << entry.key();
+            }
+        }
+    }
+
+    for(const cell_t * cell : visible)
+    {
+        cluster_t cluster;
+        cluster.pos     = cell->sum / cell->count;
+        cluster.count   = cell->count;
+        cluster.wpts    = cell->wpts;
+        clusters << cluster;
+    }
+}
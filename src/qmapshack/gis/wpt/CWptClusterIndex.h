@@ -0,0 +1,131 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CWPTCLUSTERINDEX_H
+#define CWPTCLUSTERINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+
+class CGisItemWpt;
+
+/**
+   @brief A hierarchical grid of waypoint clusters
+
+   The world is divided into grids of cells, one grid per zoom level.
+   A cell's size is half the size of the cell at the previous level.
+   Each cell holds the number of waypoints inside and their centroid.
+   Adding, moving or removing a waypoint updates just the cells on its
+   way from the coarsest to the finest level.
+
+   At coarse scales the cells of a level fitting the scale are drawn as
+   cluster markers. Thus the effort to draw depends on the number of
+   visible cells and not on the number of waypoints.
+
+   A waypoint keeps a pointer to the index it is registered with. It
+   will unregister itself on destruction.
+ */
+class CWptClusterIndex
+{
+public:
+    CWptClusterIndex() = default;
+    virtual ~CWptClusterIndex();
+
+    /// the finest level supported
+    static const qint32 maxLevel = 14;
+
+    struct cluster_t
+    {
+        /// the centroid of all waypoints [rad]
+        QPointF pos;
+        qint32 count = 0;
+        /// the waypoints, if the cluster is small enough to draw them separately
+        QList<CGisItemWpt*> wpts;
+    };
+
+    /**
+       @brief Get the level with cells of a minimum size
+
+       @param pxPerRad  the current scale in pixel per radian
+       @param size      the minimum size of a cell [px]
+       @return The level or -1 if the cells of the finest level are still too large.
+     */
+    static qint32 getLevel(qreal pxPerRad, qreal size);
+
+    /// start a synchronization, all waypoints not updated until endUpdate() are removed
+    void beginUpdate();
+    /// add a waypoint or update its position
+    void update(CGisItemWpt * wpt);
+    void endUpdate();
+
+    /// remove a waypoint
+    void remove(CGisItemWpt * wpt);
+
+    bool contains(CGisItemWpt * wpt) const
+    {
+        return entries.contains(wpt);
+    }
+
+    /**
+       @brief Get all clusters of a level within an area
+
+       @param level     the level as returned by getLevel()
+       @param area      the area of interest [rad]
+       @param clusters  a list to receive the clusters
+     */
+    void getClusters(qint32 level, const QRectF& area, QList<cluster_t>& clusters);
+
+private:
+    Q_DISABLE_COPY(CWptClusterIndex)
+
+    struct entry_t
+    {
+        /// the cell at the finest level
+        qint32 x;
+        qint32 y;
+        /// the position [rad]
+        QPointF pos;
+        quint32 generation;
+    };
+
+    struct cell_t
+    {
+        qint32 count = 0;
+        QPointF sum;
+        /// all waypoints, valid as long as isListed is true
+        QList<CGisItemWpt*> wpts;
+        bool isListed = true;
+    };
+
+    static quint64 getCellKey(qint32 level, qint32 x, qint32 y)
+    {
+        return (quint64(level) << 56) | (quint64(quint32(x)) << 28) | quint64(quint32(y));
+    }
+
+    void addToCells(CGisItemWpt * wpt, const entry_t& entry);
+    void removeFromCells(CGisItemWpt * wpt, const entry_t& entry);
+
+    QHash<CGisItemWpt*, entry_t> entries;
+    QHash<quint64, cell_t> cells;
+    quint32 generation = 0;
+};
+
+#endif //CWPTCLUSTERINDEX_H
+
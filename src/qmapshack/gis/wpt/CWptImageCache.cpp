@@ -0,0 +1,133 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "gis/wpt/CWptImageCache.h"
+
+#include <QtGui>
+
+/// the maximum memory [kB] used by decoded images
+#define MAX_IMAGE_MEMORY     65536
+/// the maximum memory [kB] used by thumbnails
+#define MAX_THUMBNAIL_MEMORY 16384
+
+QMutex CWptImageCache::mutex;
+QHash<QByteArray, QWeakPointer<const QByteArray> > CWptImageCache::blobs;
+int CWptImageCache::sizePurge = 256;
+QCache<QByteArray, QImage> CWptImageCache::images(MAX_IMAGE_MEMORY);
+QCache<QByteArray, QImage> CWptImageCache::thumbnails(MAX_THUMBNAIL_MEMORY);
+
+static int costOf(const QImage& img)
+{
+    return qMax(1, img.byteCount() >> 10);
+}
+
+CWptImageCache::blob_t CWptImageCache::intern(const QByteArray& data, QByteArray& key)
+{
+    key = QCryptographicHash::hash(data, QCryptographicHash::Md5);
+
+    QMutexLocker lock(&mutex);
+    blob_t blob = blobs.value(key).toStrongRef();
+    if(!blob.isNull())
+    {
+        return blob;
+    }
+
+    blob = blob_t(new QByteArray(data));
+    blobs[key] = blob;
+
+    if(blobs.size() > sizePurge)
+    {
+        QMutableHashIterator<QByteArray, QWeakPointer<const QByteArray> > iter(blobs);
+        while(iter.hasNext())
+        {
+            if(iter.next().value().isNull())
+            {
+                iter.remove();
+            }
+        }
+        sizePurge = qMax(256, blobs.size() * 2);
+    }
+
+    return blob;
+}
+
+CWptImageCache::blob_t CWptImageCache::lookup(const QByteArray& key)
+{
+    QMutexLocker lock(&mutex);
+    return blobs.value(key).toStrongRef();
+}
+
+QImage CWptImageCache::getImage(const QByteArray& key, const blob_t& blob)
+{
+    if(blob.isNull())
+    {
+        return QImage();
+    }
+
+    {
+        QMutexLocker lock(&mutex);
+        QImage * img = images.object(key);
+        if(img != nullptr)
+        {
+            return *img;
+        }
+    }
+
+    // decode without holding the lock
+    QImage img = QImage::fromData(*blob, "JPEG");
+    if(img.isNull())
+    {
+        return img;
+    }
+
+    QMutexLocker lock(&mutex);
+    images.insert(key, new QImage(img), costOf(img));
+    return img;
+}
+
+QImage CWptImageCache::getThumbnail(const QByteArray& key, const blob_t& blob, const QSize& size)
+{
+    if(blob.isNull() || size.isEmpty())
+    {
+        return QImage();
+    }
+
+    QByteArray keyThumbnail = key;
+    keyThumbnail += QByteArray::number(size.width()) + "x" + QByteArray::number(size.height());
+
+    {
+        QMutexLocker lock(&mutex);
+        QImage * img = thumbnails.object(keyThumbnail);
+        if(img != nullptr)
+        {
+            return *img;
+        }
+    }
+
+    const QImage& img = getImage(key, blob);
+    if(img.isNull())
+    {
+        return img;
+    }
+
+    QImage thumbnail = img.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    QMutexLocker lock(&mutex);
+    thumbnails.insert(keyThumbnail, new QImage(thumbnail), costOf(thumbnail));
+    return thumbnail;
+}
@@ -0,0 +1,96 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CWPTIMAGECACHE_H
+#define CWPTIMAGECACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSharedPointer>
+
+/**
+   @brief Shared storage of waypoint images
+
+   Waypoint images are kept as encoded JPEG data. The data is addressed
+   by it's MD5 hash. Equal data is stored just once, no matter how many
+   waypoints, copies of waypoints or history entries refer to it.
+
+   History entries serialize the key only. The data is kept alive and
+   written to disk once by IGisItem::history_t::blobs.
+
+   Images are decoded on demand only. The last images and thumbnails
+   used are kept in LRU caches shared by all widgets showing images.
+
+   All methods are thread-safe.
+ */
+class CWptImageCache
+{
+public:
+    typedef QSharedPointer<const QByteArray> blob_t;
+
+    /**
+       @brief Get the shared instance of encoded image data
+
+       @param data      the encoded image data
+       @param key       returns the key of the data
+       @return The shared blob with the data.
+     */
+    static blob_t intern(const QByteArray& data, QByteArray& key);
+
+    /**
+       @brief Get the shared instance of encoded image data by it's key
+
+       @param key       the key as returned by intern()
+       @return The shared blob or a null pointer if no blob with that key is in use.
+     */
+    static blob_t lookup(const QByteArray& key);
+
+    /**
+       @brief Get the decoded image
+
+       @param key       the blob's key as returned by intern()
+       @param blob      the blob as returned by intern()
+       @return The decoded image or a null image if decoding fails.
+     */
+    static QImage getImage(const QByteArray& key, const blob_t& blob);
+
+    /**
+       @brief Get the image scaled to fit into a given size
+
+       @param key       the blob's key as returned by intern()
+       @param blob      the blob as returned by intern()
+       @param size      the size to fit the image into, keeping the aspect ratio
+       @return The scaled image or a null image if decoding fails.
+     */
+    static QImage getThumbnail(const QByteArray& key, const blob_t& blob, const QSize& size);
+
+private:
+    static QMutex mutex;
+    /// all blobs in use. Unused blobs are purged whenever the hash grows too large.
+    static QHash<QByteArray, QWeakPointer<const QByteArray> > blobs;
+    static int sizePurge;
+    /// decoded images, the costs are in kB
+    static QCache<QByteArray, QImage> images;
+    /// scaled images, the costs are in kB
+    static QCache<QByteArray, QImage> thumbnails;
+};
+
+#endif //CWPTIMAGECACHE_H
+
@@ -301,8 +301,11 @@ void CGrid::draw(QPainter& p, const QRect& rect)
     p.setPen(QPen(color, 1));
     USE_ANTI_ALIASING(p, false);
 
-    qreal h = rect.height();
-    qreal w = rect.width();
+    // the rectangle's edges. The rectangle does not have to start at the origin.
+    const qreal l = rect.left();
+    const qreal t = rect.top();
+    const qreal r = l + rect.width();
+    const qreal b = t + rect.height();
 
     while(y > btmMin)
     {
@@ -330,19 +333,19 @@ void CGrid::draw(QPainter& p, const QRect& rect)
             map->convertRad2Px(p4);
 
             qreal xx, yy;
-            if(calcIntersection(0, 0, w, 0, p1.x(), p1.y(), p4.x(), p4.y(), xx, yy))
+            if(calcIntersection(l, t, r, t, p1.x(), p1.y(), p4.x(), p4.y(), xx, yy))
             {
                 horzTopTicks << val_t(xx, xVal);
             }
-            if(calcIntersection(0, h, w, h, p1.x(), p1.y(), p4.x(), p4.y(), xx, yy))
+            if(calcIntersection(l, b, r, b, p1.x(), p1.y(), p4.x(), p4.y(), xx, yy))
             {
                 horzBtmTicks << val_t(xx, xVal);
             }
-            if(calcIntersection(0, 0, 0, h, p1.x(), p1.y(), p2.x(), p2.y(), xx, yy))
+            if(calcIntersection(l, t, l, b, p1.x(), p1.y(), p2.x(), p2.y(), xx, yy))
             {
                 vertLftTicks << val_t(yy, yVal);
             }
-            if(calcIntersection(w, 0, w, h, p1.x(), p1.y(), p2.x(), p2.y(), xx, yy))
+            if(calcIntersection(r, t, r, b, p1.x(), p1.y(), p2.x(), p2.y(), xx, yy))
             {
                 vertRgtTicks << val_t(yy, yVal);
             }
@@ -371,22 +374,22 @@ void CGrid::draw(QPainter& p, const QRect& rect)
 
         for(const val_t &val : horzTopTicks)
         {
-            CDraw::text(qAbs(val.val) < 1.e-5 ? "0" : QString("%1%2").arg(val.val * RAD_TO_DEG).arg(QChar(0260)), p, QPoint(val.pos, yoff), textColor);
+            CDraw::text(qAbs(val.val) < 1.e-5 ? "0" : QString("%1%2").arg(val.val * RAD_TO_DEG).arg(QChar(0260)), p, QPoint(val.pos, t + yoff), textColor);
         }
 
         for(const val_t &val : horzBtmTicks)
         {
-            CDraw::text(qAbs(val.val) < 1.e-5 ? "0" : QString("%1%2").arg(val.val * RAD_TO_DEG).arg(QChar(0260)), p, QPoint(val.pos, h), textColor);
+            CDraw::text(qAbs(val.val) < 1.e-5 ? "0" : QString("%1%2").arg(val.val * RAD_TO_DEG).arg(QChar(0260)), p, QPoint(val.pos, b), textColor);
         }
 
         for(const val_t &val : vertLftTicks)
         {
-            CDraw::text(qAbs(val.val) < 1.e-5 ? "0" : QString("%1%2").arg(val.val * RAD_TO_DEG).arg(QChar(0260)), p, QPoint(xoff, val.pos), textColor);
+            CDraw::text(qAbs(val.val) < 1.e-5 ? "0" : QString("%1%2").arg(val.val * RAD_TO_DEG).arg(QChar(0260)), p, QPoint(l + xoff, val.pos), textColor);
         }
 
         for(const val_t &val : vertRgtTicks)
         {
-            CDraw::text(qAbs(val.val) < 1.e-5 ? "0" : QString("%1%2").arg(val.val * RAD_TO_DEG).arg(QChar(0260)), p, QPoint(w - xoff, val.pos), textColor);
+            CDraw::text(qAbs(val.val) < 1.e-5 ? "0" : QString("%1%2").arg(val.val * RAD_TO_DEG).arg(QChar(0260)), p, QPoint(r - xoff, val.pos), textColor);
         }
     }
     else
@@ -397,22 +400,22 @@ void CGrid::draw(QPainter& p, const QRect& rect)
 
         for(const val_t &val : horzTopTicks)
         {
-            CDraw::text(QString("%1").arg(qint32(val.val / 1000)), p, QPoint(val.pos, yoff), textColor);
+            CDraw::text(QString("%1").arg(qint32(val.val / 1000)), p, QPoint(val.pos, t + yoff), textColor);
         }
 
         for(const val_t &val : horzBtmTicks)
         {
-            CDraw::text(QString("%1").arg(qint32(val.val / 1000)), p, QPoint(val.pos, h), textColor);
+            CDraw::text(QString("%1").arg(qint32(val.val / 1000)), p, QPoint(val.pos, b), textColor);
         }
 
         for(const val_t &val : vertLftTicks)
         {
-            CDraw::text(QString("%1").arg(qint32(val.val / 1000)), p, QPoint(xoff, val.pos), textColor);
+            CDraw::text(QString("%1").arg(qint32(val.val / 1000)), p, QPoint(l + xoff, val.pos), textColor);
         }
 
         for(const val_t &val : vertRgtTicks)
         {
-            CDraw::text(QString("%1").arg(qint32(val.val / 1000)), p, QPoint(w - xoff, val.pos), textColor);
+            CDraw::text(QString("%1").arg(qint32(val.val / 1000)), p, QPoint(r - xoff, val.pos), textColor);
         }
     }
 }
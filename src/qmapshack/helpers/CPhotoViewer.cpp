@@ -65,12 +65,16 @@ void CPhotoViewer::setImageAtIdx(int i)
 {
     const QRect& rectScreen = rect();
     const QPoint& center    = rectScreen.center();
-    QImage& pixmap          = images[i].pixmap;
+    QImage pixmap;
 
     if(!images[i].filePath.isEmpty())
     {
         pixmap = QImage(images[i].filePath);
     }
+    if(pixmap.isNull())
+    {
+        pixmap = images[i].getImage();
+    }
 
     double width  = rectScreen.width() - 64;
     double height = rectScreen.height() - 64;
@@ -101,6 +105,9 @@ void CPhotoViewer::setImageAtIdx(int i)
         rectImage.moveCenter(center);
     }
 
+    // scale just once and not with every paint event
+    scaled = pixmap.scaled(rectImage.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
     rectClose.moveCenter(rectImage.topRight());
     rectPrev.setHeight(rectImage.height());
     rectPrev.moveBottomLeft(rectImage.bottomLeft());
@@ -122,7 +129,7 @@ void CPhotoViewer::paintEvent(QPaintEvent * e)
     p.setBrush(Qt::white);
     p.drawRect(rectImage);
 
-    p.drawImage(rectImage, images[idx].pixmap.scaled(rectImage.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    p.drawImage(rectImage, scaled);
 
     if(idx != (images.size() - 1))
     {
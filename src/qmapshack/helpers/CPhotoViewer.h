@@ -43,6 +43,8 @@ private:
 
     QList<CGisItemWpt::image_t> images;
     int idx;
+    /// the current image scaled to rectImage
+    QImage scaled;
     QRect rectImage {0, 0, 100, 100};
     QRect rectClose {0, 0, 32, 32};
     QRect rectPrev {0, 0, 32, 32};
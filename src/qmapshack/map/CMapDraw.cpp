@@ -437,6 +437,20 @@ void CMapDraw::reportStatusToCanvas(const QString& key, const QString& msg)
     canvas->reportStatus(key, msg);
 }
 
+void CMapDraw::reportProgressToMapList(const IMap * mapfile, qint32 progress)
+{
+    const int N = mapList->count();
+    for(int n = 0; n < N; n++)
+    {
+        CMapItem * item = mapList->item(n);
+        if(item && (item->mapfile == mapfile))
+        {
+            item->setProgress(progress);
+            break;
+        }
+    }
+}
+
 void CMapDraw::drawt(IDrawContext::buffer_t& currentBuffer) /* override */
 {
     bool seenActiveMap = false;
@@ -27,6 +27,7 @@ class CCanvas;
 class CMapList;
 class QSettings;
 class CMapItem;
+class IMap;
 struct poi_t;
 
 class CMapDraw : public IDrawContext
@@ -109,6 +110,14 @@ public:
      */
     void reportStatusToCanvas(const QString& key, const QString& msg);
 
+    /**
+       @brief Show the progress of a background job of a map file in the map list
+
+       @param mapfile   the reporting map file
+       @param progress  the progress in percent. 100 will remove the progress.
+     */
+    void reportProgressToMapList(const IMap * mapfile, qint32 progress);
+
     /**
        @brief Find a matching street polyline
 
@@ -77,6 +77,7 @@ void CMapItem::showChildren(bool yes)
 
         QTreeWidgetItem * item = new QTreeWidgetItem(this);
         item->setFlags(Qt::ItemIsEnabled);
+        item->setFirstColumnSpanned(true);
         tw->setItemWidget(item, 0, mapfile->getSetup());
     }
     else
@@ -87,6 +88,20 @@ void CMapItem::showChildren(bool yes)
     }
 }
 
+void CMapItem::setProgress(qint32 progress)
+{
+    if(progress < 100)
+    {
+        setText(1, QString("%1%").arg(progress));
+        setToolTip(1, tr("Building reduced images to draw the map at all scales."));
+    }
+    else
+    {
+        setText(1, "");
+        setToolTip(1, "");
+    }
+}
+
 void CMapItem::updateIcon()
 {
     if(filename.isEmpty())
@@ -150,6 +165,8 @@ void CMapItem::deactivate()
     // deny drag-n-drop again
     setFlags(flags() & ~Qt::ItemIsDragEnabled);
 
+    setProgress(100);
+
     map->reportStatusToCanvas(text(0), "");
 }
 
@@ -19,6 +19,7 @@
 #ifndef CMAPITEM_H
 #define CMAPITEM_H
 
+#include <QCoreApplication>
 #include <QMutex>
 #include <QPointer>
 #include <QTreeWidgetItem>
@@ -30,6 +31,7 @@ class QSettings;
 
 class CMapItem : public QTreeWidgetItem
 {
+    Q_DECLARE_TR_FUNCTIONS(CMapItem)
 public:
     CMapItem(QTreeWidget * parent, CMapDraw *map);
     virtual ~CMapItem();
@@ -81,6 +83,12 @@ public:
      */
     void showChildren(bool yes);
 
+    /**
+       @brief Show the progress of a background job next to the name
+       @param progress  the progress in percent, 100 or more will remove it
+     */
+    void setProgress(qint32 progress);
+
     QString getName() const
     {
         return text(0);
@@ -69,6 +69,11 @@ CMapList::CMapList(QWidget *parent)
     setupUi(this);
     lineFilter->addAction(actionClearFilter, QLineEdit::TrailingPosition);
 
+    // the 2nd column shows the progress of background jobs, if any
+    treeWidget->header()->setStretchLastSection(false);
+    treeWidget->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    treeWidget->header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+
     connect(treeWidget,     &CMapTreeWidget::customContextMenuRequested, this, &CMapList::slotContextMenu);
     connect(treeWidget,     &CMapTreeWidget::sigChanged,                 this, &CMapList::sigChanged);
     connect(actionActivate, &QAction::triggered,                         this, &CMapList::slotActivate);
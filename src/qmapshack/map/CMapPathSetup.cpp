@@ -20,6 +20,7 @@
 #include "map/CMapDraw.h"
 #include "map/CMapList.h"
 #include "map/CMapPathSetup.h"
+#include "map/CTileScheduler.h"
 
 #include <QtWidgets>
 
@@ -44,6 +45,8 @@ CMapPathSetup::CMapPathSetup(QStringList &paths, QString& pathCache)
     labelCacheRoot->setText(pathCache);
     connect(toolCacheRoot, &QToolButton::clicked, this, &CMapPathSetup::slotChangeCachePath);
 
+    spinRequestsPerHost->setValue(CTileScheduler::self().getMaxRequestsPerHost());
+
     labelHelp->setText(tr("Add or remove paths containing maps. There can be multiple maps in a path but no sub-path is parsed. Supported formats are: %1").arg(CMapDraw::getSupportedFormats().join(", ")));
 }
 
@@ -103,6 +106,7 @@ void CMapPathSetup::accept()
     }
 
     pathCache = QDir(labelCacheRoot->text()).absolutePath();
+    CTileScheduler::self().setMaxRequestsPerHost(spinRequestsPerHost->value());
 
     QDialog::accept();
 }
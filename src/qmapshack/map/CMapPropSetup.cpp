@@ -20,7 +20,9 @@
 #include "helpers/Signals.h"
 #include "map/CMapDraw.h"
 #include "map/CMapPropSetup.h"
+#include "map/CMapSeedDialog.h"
 #include "map/IMap.h"
+#include "map/IMapOnline.h"
 #include "units/IUnit.h"
 
 #include <QtWidgets>
@@ -50,12 +52,14 @@ CMapPropSetup::CMapPropSetup(IMap * mapfile, CMapDraw *map)
 
     connect(spinCacheSize,       static_cast<void (QSpinBox::*)(int) >(&QSpinBox::valueChanged), mapfile, &IMap::slotSetCacheSize);
     connect(spinCacheExpiration, static_cast<void (QSpinBox::*)(int) >(&QSpinBox::valueChanged), mapfile, &IMap::slotSetCacheExpiration);
+    connect(pushSeedCache,       &QPushButton::clicked,      this,    &CMapPropSetup::slotSeedCache);
 
     connect(toolOpenTypFile,    &QToolButton::pressed,      this,      &CMapPropSetup::slotLoadTypeFile);
     connect(toolClearTypFile,   &QToolButton::pressed,      this,      &CMapPropSetup::slotClearTypeFile);
 
     frameVectorItems->setVisible( mapfile->hasFeatureVectorItems() );
     frameTileCache->setVisible( mapfile->hasFeatureTileCache() );
+    pushSeedCache->setVisible(dynamic_cast<IMapOnline*>(mapfile) != nullptr);
 
     if(mapfile->hasFeatureLayers())
     {
@@ -155,3 +159,18 @@ void CMapPropSetup::slotClearTypeFile()
     mapfile->slotSetTypeFile("");
     slotPropertiesChanged();
 }
+
+void CMapPropSetup::slotSeedCache()
+{
+    IMapOnline * online = dynamic_cast<IMapOnline*>(mapfile);
+    if(online == nullptr)
+    {
+        return;
+    }
+
+    QPolygonF viewport;
+    map->getViewport(viewport);
+
+    CMapSeedDialog dlg(online, viewport);
+    dlg.exec();
+}
@@ -39,6 +39,7 @@ private slots:
     void slotSetMaxScale(bool checked);
     void slotLoadTypeFile();
     void slotClearTypeFile();
+    void slotSeedCache();
 
 private:
     static QPointF scale;
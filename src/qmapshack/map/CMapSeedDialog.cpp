@@ -0,0 +1,222 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "CMainWindow.h"
+#include "gis/CGisWorkspace.h"
+#include "gis/IGisLine.h"
+#include "helpers/CSettings.h"
+#include "map/CMapSeedDialog.h"
+#include "map/CTileSeeder.h"
+#include "map/IMapOnline.h"
+
+#include <QtWidgets>
+
+/// the maximum number of tiles of a single job
+#define MAX_SEED_TILES 250000
+/// the earth's radius as used to convert the corridor width [m]
+#define EARTH_RADIUS 6378137.0
+
+CMapSeedDialog::CMapSeedDialog(IMapOnline * map, const QPolygonF& viewport)
+    : QDialog(CMainWindow::getBestWidgetForParent())
+    , map(map)
+    , viewport(viewport)
+{
+    setupUi(this);
+    setWindowTitle(tr("Seed tile cache of %1...").arg(map->getName()));
+
+    qint32 minLevel, maxLevel;
+    map->getLevelRange(minLevel, maxLevel);
+    spinMinLevel->setRange(minLevel, maxLevel);
+    spinMaxLevel->setRange(minLevel, maxLevel);
+
+    SETTINGS;
+    cfg.beginGroup("MapSeed");
+    spinMinLevel->setValue(cfg.value("minLevel", minLevel).toInt());
+    spinMaxLevel->setValue(cfg.value("maxLevel", maxLevel).toInt());
+    spinRate->setValue(cfg.value("rate", spinRate->value()).toDouble());
+    spinCorridor->setValue(cfg.value("corridor", spinCorridor->value()).toInt());
+    cfg.endGroup();
+
+    connect(pushStart,     &QPushButton::clicked,  this, &CMapSeedDialog::slotStart);
+    connect(pushPause,     &QPushButton::clicked,  this, &CMapSeedDialog::slotPause);
+    connect(radioSelected, &QRadioButton::toggled, this, &CMapSeedDialog::slotSetupChanged);
+    connect(spinMinLevel,  static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &CMapSeedDialog::slotSetupChanged);
+    connect(spinRate,      static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &CMapSeedDialog::slotSetupChanged);
+
+    slotSetupChanged();
+}
+
+CMapSeedDialog::~CMapSeedDialog()
+{
+    SETTINGS;
+    cfg.beginGroup("MapSeed");
+    cfg.setValue("minLevel", spinMinLevel->value());
+    cfg.setValue("maxLevel", spinMaxLevel->value());
+    cfg.setValue("rate", spinRate->value());
+    cfg.setValue("corridor", spinCorridor->value());
+    cfg.endGroup();
+}
+
+void CMapSeedDialog::slotSetupChanged()
+{
+    spinCorridor->setEnabled(radioSelected->isChecked());
+    spinMaxLevel->setMinimum(spinMinLevel->value());
+
+    if(seeder != nullptr)
+    {
+        seeder->setRate(spinRate->value());
+    }
+}
+
+void CMapSeedDialog::getArea(QList<QPolygonF>& area) const
+{
+    if(radioVisible->isChecked())
+    {
+        area << viewport;
+        return;
+    }
+
+    QList<IGisItem*> items;
+    CGisWorkspace::self().getSelectedItems(items);
+
+    const qreal d = spinCorridor->value() / EARTH_RADIUS;
+    for(IGisItem * item : items)
+    {
+        IGisLine * line = dynamic_cast<IGisLine*>(item);
+        if(line == nullptr)
+        {
+            continue;
+        }
+
+        SGisLine l;
+        line->getPolylineFromData(l);
+        if(l.isEmpty())
+        {
+            continue;
+        }
+
+        if(item->type() == IGisItem::eTypeOvl)
+        {
+            QPolygonF polygon;
+            for(const IGisLine::point_t& pt : l)
+            {
+                polygon << pt.coord;
+            }
+            area << polygon;
+            continue;
+        }
+
+        // a box around each segment of tracks and routes
+        for(int i = 0; i < l.size(); i++)
+        {
+            const QRectF& rect = QRectF(l[qMax(0, i - 1)].coord, l[i].coord).normalized();
+            const qreal dx = d / qMax(0.01, qCos(rect.center().y()));
+            area << QPolygonF(rect.adjusted(-dx, -d, dx, d));
+        }
+    }
+}
+
+void CMapSeedDialog::slotStart()
+{
+    if(map.isNull())
+    {
+        return;
+    }
+
+    QList<QPolygonF> area;
+    getArea(area);
+    if(area.isEmpty())
+    {
+        QMessageBox::information(this, tr("Seed tile cache..."), tr("There are no tracks or areas selected in the workspace."), QMessageBox::Ok);
+        return;
+    }
+
+    QStringList urls;
+    for(qint32 level = spinMinLevel->value(); level <= spinMaxLevel->value(); level++)
+    {
+        QSet<QString> tiles;
+        if(!map->getTileUrls(area, level, tiles, MAX_SEED_TILES - urls.size()))
+        {
+            QMessageBox::warning(this, tr("Seed tile cache..."), tr("The area needs more than %1 tiles. Please reduce the area or the max. level.").arg(MAX_SEED_TILES), QMessageBox::Ok);
+            return;
+        }
+        urls += tiles.toList();
+    }
+
+    // tiles already in the cache are skipped. Thus a new job continues where the last one stopped
+    delete seeder;
+    seeder = new CTileSeeder(map->getDiskCache(), urls, map->getHeaders(), this);
+    seeder->setRate(spinRate->value());
+    connect(seeder, &CTileSeeder::sigProgress, this, &CMapSeedDialog::slotProgress);
+    connect(seeder, &CTileSeeder::sigFinished, this, &CMapSeedDialog::slotProgress);
+    seeder->start();
+
+    slotProgress();
+}
+
+void CMapSeedDialog::slotPause()
+{
+    if(seeder != nullptr)
+    {
+        seeder->pause();
+    }
+    slotProgress();
+}
+
+void CMapSeedDialog::slotProgress()
+{
+    const bool isRunning = (seeder != nullptr) && seeder->isRunning();
+    radioVisible->setEnabled(!isRunning);
+    radioSelected->setEnabled(!isRunning);
+    spinCorridor->setEnabled(!isRunning && radioSelected->isChecked());
+    spinMinLevel->setEnabled(!isRunning);
+    spinMaxLevel->setEnabled(!isRunning);
+    pushStart->setEnabled(!isRunning);
+    pushPause->setEnabled(isRunning);
+
+    if(seeder == nullptr)
+    {
+        return;
+    }
+
+    const CTileSeeder::progress_t& progress = seeder->getProgress();
+    const qint32 done = progress.cached + progress.downloaded + progress.failed;
+    progressBar->setMaximum(qMax(1, progress.total));
+    progressBar->setValue(done);
+
+    QString msg = tr("%1 of %2 tiles done: %3 in cache, %4 downloaded, %5 failed")
+                  .arg(done).arg(progress.total).arg(progress.cached).arg(progress.downloaded).arg(progress.failed);
+
+    msg += "\n" + tr("Downloaded: %1 MB").arg(progress.bytes / 1048576.0, 0, 'f', 1);
+    if(progress.bytesTotal >= 0)
+    {
+        msg += " " + tr("(estimated %1 MB)").arg(progress.bytesTotal / 1048576.0, 0, 'f', 1);
+    }
+
+    if(seeder->isFinished())
+    {
+        msg += "\n" + tr("Finished.");
+    }
+    else if(isRunning && (progress.eta >= 0))
+    {
+        msg += "\n" + tr("Remaining time: %1").arg(QTime(0, 0).addSecs(progress.eta).toString("HH:mm:ss"));
+    }
+
+    labelStatus->setText(msg);
+}
+
@@ -0,0 +1,61 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CMAPSEEDDIALOG_H
+#define CMAPSEEDDIALOG_H
+
+#include "ui_IMapSeedDialog.h"
+#include <QDialog>
+#include <QPointer>
+
+class CTileSeeder;
+class IMapOnline;
+
+/**
+   @brief Download all tiles of an online map for an area and a range of levels
+
+   The area is either the visible area or the tracks and areas selected
+   in the workspace. For tracks a corridor along the track is used.
+ */
+class CMapSeedDialog : public QDialog, private Ui::IMapSeedDialog
+{
+    Q_OBJECT
+public:
+    /**
+       @param map       the online map to seed
+       @param viewport  the visible area [rad]
+     */
+    CMapSeedDialog(IMapOnline * map, const QPolygonF& viewport);
+    virtual ~CMapSeedDialog();
+
+private slots:
+    void slotStart();
+    void slotPause();
+    void slotProgress();
+    void slotSetupChanged();
+
+private:
+    void getArea(QList<QPolygonF>& area) const;
+
+    QPointer<IMapOnline> map;
+    QPolygonF viewport;
+    CTileSeeder * seeder = nullptr;
+};
+
+#endif //CMAPSEEDDIALOG_H
+
@@ -32,6 +32,9 @@
 #include <ogr_spatialref.h>
 #include <proj_api.h>
 
+/// the number of coarser levels searched for a tile to draw in place of a missing one
+#define MAX_FALLBACK_LEVELS 5
+
 inline int lon2tile(double lon, int z)
 {
     return (int)(qRound(256 * (lon + 180.0) / 360.0 * qPow(2.0, z)));
@@ -326,6 +329,8 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
 
     if(isOutOfScale(bufferScale))
     {
+        // drop all requests of the last draw operation
+        emit sigQueueChanged();
         return;
     }
 
@@ -419,11 +424,137 @@ void CMapTMS::draw(IDrawContext::buffer_t& buf) /* override */
                 }
                 else
                 {
-                    urlQueue << url;
+                    QPointF pos(tile2lon(col, z) + tile2lon(col + 1, z), tile2lat(row, z) + tile2lat(row + 1, z));
+                    addToQueue(url, pos * 0.5 * DEG_TO_RAD, buf);
+
+                    drawFallback(layer, col, row, z, p);
                 }
             }
         }
+    }
 
-        emit sigQueueChanged();
+    emit sigQueueChanged();
+}
+
+static void getTilePolygon(qint32 col, qint32 row, qint32 z, QPolygonF& l)
+{
+    qreal xx1 = tile2lon(col, z) * DEG_TO_RAD;
+    qreal yy1 = tile2lat(row, z) * DEG_TO_RAD;
+    qreal xx2 = tile2lon(col + 1, z) * DEG_TO_RAD;
+    qreal yy2 = tile2lat(row + 1, z) * DEG_TO_RAD;
+
+    l.clear();
+    l << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
+}
+
+void CMapTMS::drawFallback(const layer_t& layer, qint32 col, qint32 row, qint32 z, QPainter& p)
+{
+    QPolygonF l;
+
+    // the closest coarser tile, the part covering the missing tile is scaled up
+    for(qint32 dz = 1; (dz <= MAX_FALLBACK_LEVELS) && (dz <= z); dz++)
+    {
+        const QString& url = createUrl(layer, col >> dz, row >> dz, z - dz);
+        if(!diskCache->contains(url))
+        {
+            continue;
+        }
+
+        QImage img;
+        diskCache->restore(url, img);
+        if(img.isNull())
+        {
+            continue;
+        }
+
+        const qint32 n  = 1 << dz;
+        const qreal w   = qreal(img.width())  / n;
+        const qreal h   = qreal(img.height()) / n;
+        const QRect rect = QRectF((col & (n - 1)) * w, (row & (n - 1)) * h, w, h).toAlignedRect();
+
+        getTilePolygon(col, row, z, l);
+        drawTile(img.copy(rect), l, p);
+        break;
+    }
+
+    // the finer tiles on top
+    for(qint32 r = 2 * row; r < 2 * (row + 1); r++)
+    {
+        for(qint32 c = 2 * col; c < 2 * (col + 1); c++)
+        {
+            const QString& url = createUrl(layer, c, r, z + 1);
+            if(!diskCache->contains(url))
+            {
+                continue;
+            }
+
+            QImage img;
+            diskCache->restore(url, img);
+
+            getTilePolygon(c, r, z + 1, l);
+            drawTile(img, l, p);
+        }
     }
 }
+
+void CMapTMS::getLevelRange(qint32& min, qint32& max) const /* override */
+{
+    min = minZoomLevel;
+    max = maxZoomLevel;
+}
+
+bool CMapTMS::getTileUrls(const QList<QPolygonF>& area, qint32 level, QSet<QString>& urls, qint32 max) /* override */
+{
+    QMutexLocker lock(&mutex);
+
+    const qint32 z      = level;
+    const qint32 maxIdx = (1 << z) - 1;
+
+    for(const layer_t &layer : layers)
+    {
+        if(!layer.enabled || (z < layer.minZoomLevel) || (z > layer.maxZoomLevel))
+        {
+            continue;
+        }
+
+        for(const QPolygonF& polygon : area)
+        {
+            // the mercator projection does not cover the poles
+            const QRectF& bbox = polygon.boundingRect();
+            const qreal north  = qBound(-85.0511, bbox.bottom() * RAD_TO_DEG, 85.0511);
+            const qreal south  = qBound(-85.0511, bbox.top() * RAD_TO_DEG, 85.0511);
+
+            qint32 col1 = qBound(0, lon2tile(bbox.left() * RAD_TO_DEG, z) / 256, maxIdx);
+            qint32 col2 = qBound(0, lon2tile(bbox.right() * RAD_TO_DEG, z) / 256, maxIdx);
+            qint32 row1 = qBound(0, lat2tile(north, z) / 256, maxIdx);
+            qint32 row2 = qBound(0, lat2tile(south, z) / 256, maxIdx);
+
+            for(qint32 row = row1; row <= row2; row++)
+            {
+                for(qint32 col = col1; col <= col2; col++)
+                {
+                    qreal xx1 = tile2lon(col, z) * DEG_TO_RAD;
+                    qreal yy1 = tile2lat(row, z) * DEG_TO_RAD;
+                    qreal xx2 = tile2lon(col + 1, z) * DEG_TO_RAD;
+                    qreal yy2 = tile2lat(row + 1, z) * DEG_TO_RAD;
+
+                    QPolygonF tile;
+                    tile << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
+                    // QPolygonF::intersects() needs Qt 5.10
+                    if(!polygon.boundingRect().intersects(tile.boundingRect()) || polygon.intersected(tile).isEmpty())
+                    {
+                        continue;
+                    }
+
+                    urls << createUrl(layer, col, row, z);
+                    if(urls.size() > max)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
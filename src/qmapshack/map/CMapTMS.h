@@ -37,6 +37,9 @@ public:
 
     void getLayers(QListWidget& list) override;
 
+    void getLevelRange(qint32& min, qint32& max) const override;
+    bool getTileUrls(const QList<QPolygonF>& area, qint32 level, QSet<QString>& urls, qint32 max) override;
+
     void saveConfig(QSettings& cfg) override;
     void loadConfig(QSettings& cfg) override;
 
@@ -46,6 +49,14 @@ private slots:
 private:
     struct layer_t;
     QString createUrl(const layer_t& layer, int x, int y, int z);
+    /**
+       @brief Draw cached tiles of other levels in place of a missing tile
+
+       The closest coarser tile in the cache is scaled up. Finer tiles in the
+       cache are drawn on top of it. By that the area is not left blank until
+       the tile is received.
+     */
+    void drawFallback(const layer_t& layer, qint32 col, qint32 row, qint32 z, QPainter& p);
 
     struct layer_t
     {
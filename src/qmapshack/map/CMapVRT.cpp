@@ -18,6 +18,8 @@
 
 #include "CMainWindow.h"
 #include "helpers/CDraw.h"
+#include "map/cache/CGdalDatasetPool.h"
+#include "map/cache/CRasterPyramid.h"
 #include "map/CMapDraw.h"
 #include "map/CMapVRT.h"
 #include "units/IUnit.h"
@@ -30,6 +32,35 @@
 #define TILESIZEX 64
 #define TILESIZEY 64
 
+class CMapVRTReader : public QRunnable
+{
+public:
+    CMapVRTReader(CMapVRT& vrt, CMapVRT::tile_t& tile)
+        : vrt(vrt)
+        , tile(tile)
+    {
+    }
+
+    void run() override
+    {
+        // no need to read anything that will not be drawn
+        if(vrt.map->needsRedraw())
+        {
+            return;
+        }
+
+        CGdalDatasetPool::CHandle dataset(*vrt.datasets);
+        if(dataset.isNull() || !CMapVRT::readImage(dataset, vrt.colortable, tile.area, tile.size, false, tile.img))
+        {
+            tile.img = QImage();
+        }
+    }
+
+private:
+    CMapVRT& vrt;
+    CMapVRT::tile_t& tile;
+};
+
 
 CMapVRT::CMapVRT(const QString &filename, CMapDraw *parent)
     : IMap(filename,eFeatVisibility, parent)
@@ -176,6 +207,16 @@ CMapVRT::CMapVRT(const QString &filename, CMapDraw *parent)
     qDebug() << "FF" << trFwd;
     qDebug() << "RR" << trInv;
 
+    datasets = CGdalDatasetPool::get(filename);
+
+    // a large map without overviews would not be drawn when zoomed out
+    if(!hasOverviews && (qreal(xsize_px) * ysize_px > TILELIMIT * TILESIZEX * TILESIZEY))
+    {
+        pyramid = CRasterPyramid::get(filename, colortable, QSize(xsize_px, ysize_px));
+        connect(pyramid.data(), &CRasterPyramid::sigProgress,   this, &CMapVRT::slotPyramidProgress);
+        connect(pyramid.data(), &CRasterPyramid::sigLevelReady, this, [this](){map->emitSigCanvasUpdate();});
+    }
+
     isActivated = true;
 }
 
@@ -184,6 +225,95 @@ CMapVRT::~CMapVRT()
     GDALClose(dataset);
 }
 
+void CMapVRT::readTiles(QVector<tile_t>& tiles)
+{
+    for(tile_t& tile : tiles)
+    {
+        pool.start(new CMapVRTReader(*this, tile));
+    }
+    pool.waitForDone();
+}
+
+void CMapVRT::slotPyramidProgress(qint32 progress)
+{
+    map->reportProgressToMapList(this, progress);
+}
+
+bool CMapVRT::readImage(GDALDataset * dataset, const QVector<QRgb>& colortable, const QRect& area, const QSize& size, bool smooth, QImage& img)
+{
+    const int rasterBandCount = dataset->GetRasterCount();
+
+    GDALRasterIOExtraArg extraArg;
+    INIT_RASTERIO_EXTRA_ARG(extraArg);
+    // averaging the indices of a color table makes no sense
+    extraArg.eResampleAlg = (smooth && (rasterBandCount > 1)) ? GRIORA_Average : GRIORA_NearestNeighbour;
+
+    CPLErr err = CE_Failure;
+
+    if(rasterBandCount == 1)
+    {
+        GDALRasterBand * pBand;
+        pBand = dataset->GetRasterBand(1);
+
+        img = QImage(size, QImage::Format_Indexed8);
+        img.setColorTable(colortable);
+
+        err = pBand->RasterIO(GF_Read
+                              , area.x(), area.y()
+                              , area.width(), area.height()
+                              , img.bits()
+                              , size.width(), size.height()
+                              , GDT_Byte, 0, img.bytesPerLine(), &extraArg);
+    }
+    else
+    {
+        img = QImage(size, QImage::Format_ARGB32);
+        img.fill(qRgba(255, 255, 255, 255));
+
+        QVector<quint8> buffer(size.width() * size.height());
+
+        QRgb testPix = qRgba(GCI_RedBand, GCI_GreenBand, GCI_BlueBand, GCI_AlphaBand);
+
+        for(int b = 1; b <= rasterBandCount; ++b)
+        {
+            GDALRasterBand * pBand;
+            pBand = dataset->GetRasterBand(b);
+
+            err = pBand->RasterIO(GF_Read
+                                  , area.x(), area.y()
+                                  , area.width(), area.height()
+                                  , buffer.data()
+                                  , size.width(), size.height()
+                                  , GDT_Byte, 0, 0, &extraArg);
+
+            if(!err)
+            {
+                int pbandColour = pBand->GetColorInterpretation();
+                unsigned int offset;
+
+                for (offset = 0; offset < sizeof(testPix) && *(((quint8 *)&testPix) + offset) != pbandColour; offset++)
+                {
+                }
+                if(offset < sizeof(testPix))
+                {
+                    quint8 * pTar   = img.bits() + offset;
+                    quint8 * pSrc   = buffer.data();
+                    const int size  = buffer.size();
+
+                    for(int i = 0; i < size; ++i)
+                    {
+                        *pTar = *pSrc;
+                        pTar += sizeof(testPix);
+                        pSrc += 1;
+                    }
+                }
+            }
+        }
+    }
+
+    return err == CE_None;
+}
+
 bool CMapVRT::testForOverviews(const QString& filename)
 {
     QFile file(filename);
@@ -413,16 +543,10 @@ void CMapVRT::draw(IDrawContext::buffer_t& buf) /* override */
                 break;
             }
 
+            // collect the tiles of a row to read them in parallel
+            QVector<tile_t> tiles;
             for(qreal x = left; x < right; x += dx)
             {
-                if(map->needsRedraw())
-                {
-                    break;
-                }
-
-                // read tile from file
-                CPLErr err = CE_Failure;
-
                 // reduce tile size at the border of the file
                 qreal dx_used   = dx;
                 qreal dy_used   = dy;
@@ -452,76 +576,24 @@ void CMapVRT::draw(IDrawContext::buffer_t& buf) /* override */
                     continue;
                 }
 
-                QImage img;
-                if(rasterBandCount == 1)
-                {
-                    GDALRasterBand * pBand;
-                    pBand = dataset->GetRasterBand(1);
-
-                    img = QImage(QSize(imgw_used, imgh_used), QImage::Format_Indexed8);
-                    img.setColorTable(colortable);
-
-                    err = pBand->RasterIO(GF_Read
-                                          , x, y
-                                          , dx_used, dy_used
-                                          , img.bits()
-                                          , imgw_used, imgh_used
-                                          , GDT_Byte, 0, 0);
-                }
-                else
-                {
-                    img = QImage(imgw_used, imgh_used, QImage::Format_ARGB32);
-                    img.fill(qRgba(255, 255, 255, 255));
-
-                    QVector<quint8> buffer(imgw_used * imgh_used);
-
-                    QRgb testPix = qRgba(GCI_RedBand, GCI_GreenBand, GCI_BlueBand, GCI_AlphaBand);
+                tile_t tile;
+                tile.area = QRect(qint32(x), qint32(y), qint32(dx_used), qint32(dy_used));
+                tile.size = QSize(qint32(imgw_used), qint32(imgh_used));
+                tiles << tile;
+            }
 
-                    for(int b = 1; b <= rasterBandCount; ++b)
-                    {
-                        GDALRasterBand * pBand;
-                        pBand = dataset->GetRasterBand(b);
-
-                        err = pBand->RasterIO(GF_Read
-                                              , x, y
-                                              , dx_used, dy_used
-                                              , buffer.data()
-                                              , imgw_used, imgh_used
-                                              , GDT_Byte, 0, 0);
-
-                        if(!err)
-                        {
-                            int pbandColour = pBand->GetColorInterpretation();
-                            unsigned int offset;
-
-                            for (offset = 0; offset < sizeof(testPix) && *(((quint8 *)&testPix) + offset) != pbandColour; offset++)
-                            {
-                            }
-                            if(offset < sizeof(testPix))
-                            {
-                                quint8 * pTar   = img.bits() + offset;
-                                quint8 * pSrc   = buffer.data();
-                                const int size  = buffer.size();
-
-                                for(int i = 0; i < size; ++i)
-                                {
-                                    *pTar = *pSrc;
-                                    pTar += sizeof(testPix);
-                                    pSrc += 1;
-                                }
-                            }
-                        }
-                    }
-                }
+            readTiles(tiles);
 
-                if(err)
+            for(const tile_t& tile : tiles)
+            {
+                if(tile.img.isNull())
                 {
                     continue;
                 }
 
-
+                const QRectF r(tile.area);
                 QPolygonF l;
-                l << QPointF(x, y) << QPointF(x + dx_used, y) << QPointF(x + dx_used, y + dy_used) << QPointF(x, y + dy_used);
+                l << r.topLeft() << r.topRight() << r.bottomRight() << r.bottomLeft();
                 l = trFwd.map(l);
 
                 pj_transform(pjsrc, pjtar, 1, 0, &l[0].rx(), &l[0].ry(), 0);
@@ -529,13 +601,71 @@ void CMapVRT::draw(IDrawContext::buffer_t& buf) /* override */
                 pj_transform(pjsrc, pjtar, 1, 0, &l[2].rx(), &l[2].ry(), 0);
                 pj_transform(pjsrc, pjtar, 1, 0, &l[3].rx(), &l[3].ry(), 0);
 
-                drawTile(img, l, p);
+                drawTile(tile.img, l, p);
             }
         }
     }
+    else if(!isOutOfScale(bufferScale) && !pyramid.isNull())
+    {
+        drawPyramid(p, QRectF(QPointF(left, top), QPointF(right, bottom)));
+    }
 
     p.setPen(Qt::black);
     p.setBrush(Qt::NoBrush);
     p.drawPolygon(boundingBox);
 }
 
+void CMapVRT::drawPyramid(QPainter& p, const QRectF& area)
+{
+    // reduce the map until the tile limit is met
+    qreal factor = 1;
+    qreal nTiles = area.width() * area.height() / (TILESIZEX * TILESIZEY);
+    while(nTiles > TILELIMIT)
+    {
+        factor *= 2;
+        nTiles /= 4;
+    }
+
+    const qint32 level = pyramid->findLevel(factor);
+    if(level == 0)
+    {
+        // not built yet
+        return;
+    }
+
+    const qreal tileSize = CRasterPyramid::TILESIZE * level;
+    const qint32 col1 = qFloor(area.left()   / tileSize);
+    const qint32 col2 = qCeil(area.right()   / tileSize) - 1;
+    const qint32 row1 = qFloor(area.top()    / tileSize);
+    const qint32 row2 = qCeil(area.bottom()  / tileSize) - 1;
+
+    for(qint32 row = row1; row <= row2; row++)
+    {
+        for(qint32 col = col1; col <= col2; col++)
+        {
+            if(map->needsRedraw())
+            {
+                return;
+            }
+
+            QImage img;
+            QRect rect;
+            if(!pyramid->getTile(level, col, row, img, rect))
+            {
+                continue;
+            }
+
+            const QRectF r(rect);
+            QPolygonF l;
+            l << r.topLeft() << r.topRight() << r.bottomRight() << r.bottomLeft();
+            l = trFwd.map(l);
+
+            pj_transform(pjsrc, pjtar, 1, 0, &l[0].rx(), &l[0].ry(), 0);
+            pj_transform(pjsrc, pjtar, 1, 0, &l[1].rx(), &l[1].ry(), 0);
+            pj_transform(pjsrc, pjtar, 1, 0, &l[2].rx(), &l[2].ry(), 0);
+            pj_transform(pjsrc, pjtar, 1, 0, &l[3].rx(), &l[3].ry(), 0);
+
+            drawTile(img, l, p);
+        }
+    }
+}
@@ -21,8 +21,12 @@
 
 #include "map/IMap.h"
 
+#include <QSharedPointer>
+#include <QThreadPool>
 
+class CGdalDatasetPool;
 class CMapDraw;
+class CRasterPyramid;
 class GDALDataset;
 
 class CMapVRT : public IMap
@@ -34,15 +38,58 @@ public:
 
     void draw(IDrawContext::buffer_t& buf) override;
 
+    /**
+       @brief Read an area of a dataset into an image
+
+       @param dataset       the GDAL dataset to read from
+       @param colortable    the color table used for datasets with a single band
+       @param area          the area to read [px]
+       @param size          the size of the image. If smaller than the area, the area is decimated by GDAL.
+       @param smooth        set true to average pixels when decimating. Datasets with a color table are never averaged.
+       @param img           the resulting image, either indexed or ARGB32
+       @return False on any read error.
+     */
+    static bool readImage(GDALDataset * dataset, const QVector<QRgb>& colortable, const QRect& area, const QSize& size, bool smooth, QImage& img);
+
+    struct tile_t
+    {
+        /// the area to read [px]
+        QRect area;
+        /// the size of the image
+        QSize size;
+        /// the image read, null on errors
+        QImage img;
+    };
+
+private slots:
+    void slotPyramidProgress(qint32 progress);
+
 private:
+    friend class CMapVRTReader;
+
+    /**
+       @brief Draw the reduced images of the pyramid
+
+       @param p     the painter with the offset of the buffer applied
+       @param area  the area of the map to draw [px]
+     */
+    void drawPyramid(QPainter& p, const QRectF& area);
+
+    /// read the tiles in parallel, each thread with it's own dataset handle
+    void readTiles(QVector<tile_t>& tiles);
+
     /**
        @brief Test subfiles of VRT for overviews
        @param filename The VRT filename to inspect
        @return Return true if all subfiles have overviews.
      */
     bool testForOverviews(const QString& filename);
-    /// instance of GDAL dataset
+    /// instance of GDAL dataset, used to setup the map
     GDALDataset * dataset;
+    /// the dataset handles used to read tiles
+    QSharedPointer<CGdalDatasetPool> datasets;
+    /// the threads reading tiles
+    QThreadPool pool;
     /// number of color bands used by the *vrt
     int rasterBandCount = 0;
     /// QT representation of the vrt's color table
@@ -70,6 +117,9 @@ private:
     QTransform trInv;
 
     bool hasOverviews = false;
+
+    /// reduced images if the map has no overviews but is too large to be drawn zoomed out
+    QSharedPointer<CRasterPyramid> pyramid;
 };
 
 #endif //CMAPVRT_H
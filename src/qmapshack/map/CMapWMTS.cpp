@@ -29,6 +29,9 @@
 
 #include <ogr_spatialref.h>
 
+/// the number of coarser tile matrices searched for a tile to draw in place of a missing one
+#define MAX_FALLBACK_LEVELS 5
+
 
 CMapWMTS::CMapWMTS(const QString &filename, CMapDraw *parent)
     : IMapOnline(filename,parent)
@@ -384,6 +387,8 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
 
     if(isOutOfScale(bufferScale))
     {
+        // drop all requests of the last draw operation
+        emit sigQueueChanged();
         return;
     }
 
@@ -536,10 +541,7 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
         {
             for(qint32 col = col1; col <= col2; col++)
             {
-                QString url = layer.resourceURL;
-                url = url.replace("{TileMatrix}", tileMatrixId, Qt::CaseInsensitive);
-                url = url.replace("{TileRow}", QString::number(row), Qt::CaseInsensitive);
-                url = url.replace("{TileCol}", QString::number(col), Qt::CaseInsensitive);
+                const QString& url = createUrl(layer, tileMatrixId, col, row);
 
                 if(diskCache->contains(url))
                 {
@@ -547,27 +549,267 @@ void CMapWMTS::draw(IDrawContext::buffer_t& buf) /* override */
                     diskCache->restore(url, img);
 
                     QPolygonF l;
+                    getTilePolygon(tileset, tilematrix, col, row, l);
+                    drawTile(img, l, p);
+                }
+                else
+                {
+                    QPointF pos((col + 0.5) * (xscale * tilematrix.tileWidth)  + tilematrix.topLeft.x()
+                                , (row + 0.5) * (yscale * tilematrix.tileHeight) + tilematrix.topLeft.y());
+                    pj_transform(tileset.pjsrc, pjtar, 1, 0, &pos.rx(), &pos.ry(), 0);
+                    addToQueue(url, pos, buf);
 
+                    drawFallback(layer, tileset, tileMatrixId, col, row, p);
+                }
+            }
+        }
+    }
+
+    emit sigQueueChanged();
+}
+
+QString CMapWMTS::createUrl(const layer_t& layer, const QString& tileMatrixId, qint32 col, qint32 row) const
+{
+    QString url = layer.resourceURL;
+    url = url.replace("{TileMatrix}", tileMatrixId, Qt::CaseInsensitive);
+    url = url.replace("{TileRow}", QString::number(row), Qt::CaseInsensitive);
+    url = url.replace("{TileCol}", QString::number(col), Qt::CaseInsensitive);
+    return url;
+}
+
+void CMapWMTS::getTilePolygon(const tileset_t& tileset, const tilematrix_t& tilematrix, qint32 col, qint32 row, QPolygonF& l) const
+{
+    const qreal xscale =  tilematrix.scale * 0.28e-3;
+    const qreal yscale = -tilematrix.scale * 0.28e-3;
+
+    qreal xx1 =  col      * (xscale * tilematrix.tileWidth)  + tilematrix.topLeft.x();
+    qreal yy1 =  row      * (yscale * tilematrix.tileHeight) + tilematrix.topLeft.y();
+    qreal xx2 = (col + 1) * (xscale * tilematrix.tileWidth)  + tilematrix.topLeft.x();
+    qreal yy2 = (row + 1) * (yscale * tilematrix.tileHeight) + tilematrix.topLeft.y();
+
+    l.clear();
+    l << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
+    pj_transform(tileset.pjsrc, pjtar, 1, 0, &l[0].rx(), &l[0].ry(), 0);
+    pj_transform(tileset.pjsrc, pjtar, 1, 0, &l[1].rx(), &l[1].ry(), 0);
+    pj_transform(tileset.pjsrc, pjtar, 1, 0, &l[2].rx(), &l[2].ry(), 0);
+    pj_transform(tileset.pjsrc, pjtar, 1, 0, &l[3].rx(), &l[3].ry(), 0);
+}
+
+void CMapWMTS::drawFallback(const layer_t& layer, const tileset_t& tileset, const QString& tileMatrixId, qint32 col, qint32 row, QPainter& p)
+{
+    QStringList ids;
+    getTileMatrixIds(tileset, ids);
+    const qint32 idx = ids.indexOf(tileMatrixId);
+
+    // the top left corner and the size of the missing tile in the tileset's coordinate system
+    const tilematrix_t& tilematrix = tileset.tilematrix[tileMatrixId];
+    const qreal res = tilematrix.scale * 0.28e-3;
+    const qreal x1  = tilematrix.topLeft.x() + col * res * tilematrix.tileWidth;
+    const qreal y1  = tilematrix.topLeft.y() - row * res * tilematrix.tileHeight;
+    const qreal w   = res * tilematrix.tileWidth;
+    const qreal h   = res * tilematrix.tileHeight;
+
+    QPolygonF l;
+
+    // the closest coarser tile, the part covering the missing tile is scaled up
+    for(qint32 i = idx - 1; (i >= 0) && (i >= idx - MAX_FALLBACK_LEVELS); i--)
+    {
+        const tilematrix_t& coarse = tileset.tilematrix[ids[i]];
+        const qreal resCoarse = coarse.scale * 0.28e-3;
+
+        // the coarser tile containing the center of the missing tile
+        const qint32 c = qFloor((x1 + w / 2 - coarse.topLeft.x()) / (resCoarse * coarse.tileWidth));
+        const qint32 r = qFloor((coarse.topLeft.y() - (y1 - h / 2)) / (resCoarse * coarse.tileHeight));
+
+        const QString& url = createUrl(layer, ids[i], c, r);
+        if(!diskCache->contains(url))
+        {
+            continue;
+        }
+
+        QImage img;
+        diskCache->restore(url, img);
+        if(img.isNull())
+        {
+            continue;
+        }
+
+        // the part of the coarser tile [px]
+        const qreal xx = (x1 - coarse.topLeft.x()) / resCoarse - c * coarse.tileWidth;
+        const qreal yy = (coarse.topLeft.y() - y1) / resCoarse - r * coarse.tileHeight;
+        const QRect rect = QRectF(xx, yy, w / resCoarse, h / resCoarse).toAlignedRect();
+
+        getTilePolygon(tileset, tilematrix, col, row, l);
+        drawTile(img.copy(rect), l, p);
+        break;
+    }
+
+    // the finer tiles on top
+    if((idx < 0) || (idx + 1 >= ids.size()))
+    {
+        return;
+    }
+
+    const QString& idFine       = ids[idx + 1];
+    const tilematrix_t& fine    = tileset.tilematrix[idFine];
+    const qreal resFine         = fine.scale * 0.28e-3;
+
+    const qint32 c1 = qFloor((x1 - fine.topLeft.x()) / (resFine * fine.tileWidth));
+    const qint32 c2 = qCeil((x1 + w - fine.topLeft.x()) / (resFine * fine.tileWidth)) - 1;
+    const qint32 r1 = qFloor((fine.topLeft.y() - y1) / (resFine * fine.tileHeight));
+    const qint32 r2 = qCeil((fine.topLeft.y() - (y1 - h)) / (resFine * fine.tileHeight)) - 1;
+
+    // matrices with an odd scale ratio would need a lot of tiles
+    if(((c2 - c1 + 1) * (r2 - r1 + 1)) > 16)
+    {
+        return;
+    }
+
+    for(qint32 r = r1; r <= r2; r++)
+    {
+        for(qint32 c = c1; c <= c2; c++)
+        {
+            const QString& url = createUrl(layer, idFine, c, r);
+            if(!diskCache->contains(url))
+            {
+                continue;
+            }
+
+            QImage img;
+            diskCache->restore(url, img);
+
+            getTilePolygon(tileset, fine, c, r, l);
+            drawTile(img, l, p);
+        }
+    }
+}
+
+void CMapWMTS::getTileMatrixIds(const tileset_t& tileset, QStringList& ids) const
+{
+    // order from coarse to fine
+    ids = tileset.tilematrix.keys();
+    std::sort(ids.begin(), ids.end(), [&tileset](const QString& id1, const QString& id2)
+    {
+        return tileset.tilematrix[id1].scale > tileset.tilematrix[id2].scale;
+    });
+}
+
+void CMapWMTS::getLevelRange(qint32& min, qint32& max) const /* override */
+{
+    min = 0;
+    max = 0;
+    for(const layer_t &layer : layers)
+    {
+        // do not copy the tileset, it would free the projection on destruction
+        auto tileset = tilesets.constFind(layer.tileMatrixSet);
+        if(layer.enabled && (tileset != tilesets.constEnd()))
+        {
+            max = qMax(max, tileset->tilematrix.size() - 1);
+        }
+    }
+}
+
+bool CMapWMTS::getTileUrls(const QList<QPolygonF>& area, qint32 level, QSet<QString>& urls, qint32 max) /* override */
+{
+    QMutexLocker lock(&mutex);
+
+    for(const layer_t &layer : layers)
+    {
+        if(!layer.enabled)
+        {
+            continue;
+        }
+
+        const tileset_t& tileset = tilesets[layer.tileMatrixSet];
+
+        QStringList ids;
+        getTileMatrixIds(tileset, ids);
+        if(level >= ids.size())
+        {
+            continue;
+        }
+
+        const QString& tileMatrixId     = ids[level];
+        const tilematrix_t& tilematrix  = tileset.tilematrix[tileMatrixId];
+
+        qint32 minRow = 0;
+        qint32 maxRow = tilematrix.matrixHeight - 1;
+        qint32 minCol = 0;
+        qint32 maxCol = tilematrix.matrixWidth - 1;
+        if(!layer.limits.isEmpty())
+        {
+            if(!layer.limits.contains(tileMatrixId))
+            {
+                // layer has limits but not for the selected tileMatrixId -> skip layer
+                continue;
+            }
+
+            const limit_t& limit = layer.limits[tileMatrixId];
+            minCol = limit.minTileCol;
+            maxCol = limit.maxTileCol;
+            minRow = limit.minTileRow;
+            maxRow = limit.maxTileRow;
+        }
+
+        const qreal xscale =  tilematrix.scale * 0.28e-3;
+        const qreal yscale = -tilematrix.scale * 0.28e-3;
+
+        for(const QPolygonF& polygon : area)
+        {
+            const QRectF& bbox = polygon.boundingRect();
+            if(!layer.boundingBox.intersects(QRectF(bbox.topLeft() * RAD_TO_DEG, bbox.bottomRight() * RAD_TO_DEG)))
+            {
+                continue;
+            }
+
+            // convert area to layer's coordinate system
+            QPolygonF poly = polygon;
+            for(QPointF& pt : poly)
+            {
+                pj_transform(pjtar, tileset.pjsrc, 1, 0, &pt.rx(), &pt.ry(), 0);
+                if(pj_is_latlong(tileset.pjsrc))
+                {
+                    pt *= RAD_TO_DEG;
+                }
+            }
+
+            const QRectF& rect = poly.boundingRect();
+            qint32 col1 = qFloor((rect.left()   - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth));
+            qint32 col2 = qFloor((rect.right()  - tilematrix.topLeft.x()) / (xscale * tilematrix.tileWidth));
+            qint32 row1 = qFloor((rect.bottom() - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight));
+            qint32 row2 = qFloor((rect.top()    - tilematrix.topLeft.y()) / (yscale * tilematrix.tileHeight));
+
+            col1 = qBound(minCol, col1, maxCol);
+            col2 = qBound(minCol, col2, maxCol);
+            row1 = qBound(minRow, row1, maxRow);
+            row2 = qBound(minRow, row2, maxRow);
+
+            for(qint32 row = row1; row <= row2; row++)
+            {
+                for(qint32 col = col1; col <= col2; col++)
+                {
                     qreal xx1 =  col      * (xscale * tilematrix.tileWidth)  + tilematrix.topLeft.x();
                     qreal yy1 =  row      * (yscale * tilematrix.tileHeight) + tilematrix.topLeft.y();
                     qreal xx2 = (col + 1) * (xscale * tilematrix.tileWidth)  + tilematrix.topLeft.x();
                     qreal yy2 = (row + 1) * (yscale * tilematrix.tileHeight) + tilematrix.topLeft.y();
 
-                    l << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
-                    pj_transform(tileset.pjsrc, pjtar, 1, 0, &l[0].rx(), &l[0].ry(), 0);
-                    pj_transform(tileset.pjsrc, pjtar, 1, 0, &l[1].rx(), &l[1].ry(), 0);
-                    pj_transform(tileset.pjsrc, pjtar, 1, 0, &l[2].rx(), &l[2].ry(), 0);
-                    pj_transform(tileset.pjsrc, pjtar, 1, 0, &l[3].rx(), &l[3].ry(), 0);
-
-                    drawTile(img, l, p);
-                }
-                else
-                {
-                    urlQueue << url;
+                    QPolygonF tile;
+                    tile << QPointF(xx1, yy1) << QPointF(xx2, yy1) << QPointF(xx2, yy2) << QPointF(xx1, yy2);
+                    // QPolygonF::intersects() needs Qt 5.10
+                    if(!poly.boundingRect().intersects(tile.boundingRect()) || poly.intersected(tile).isEmpty())
+                    {
+                        continue;
+                    }
+
+                    urls << createUrl(layer, tileMatrixId, col, row);
+                    if(urls.size() > max)
+                    {
+                        return false;
+                    }
                 }
             }
         }
-
-        emit sigQueueChanged();
     }
+
+    return true;
 }
@@ -40,6 +40,9 @@ public:
 
     void getLayers(QListWidget& list) override;
 
+    void getLevelRange(qint32& min, qint32& max) const override;
+    bool getTileUrls(const QList<QPolygonF>& area, qint32 level, QSet<QString>& urls, qint32 max) override;
+
     void saveConfig(QSettings& cfg) override;
     void loadConfig(QSettings& cfg) override;
 
@@ -96,6 +99,20 @@ private:
     };
 
     QMap<QString, tileset_t> tilesets;
+
+    /// get the ids of all tile matrices of a tileset ordered from coarse to fine
+    void getTileMatrixIds(const tileset_t& tileset, QStringList& ids) const;
+    QString createUrl(const layer_t& layer, const QString& tileMatrixId, qint32 col, qint32 row) const;
+    /// get the corners of a tile [rad]
+    void getTilePolygon(const tileset_t& tileset, const tilematrix_t& tilematrix, qint32 col, qint32 row, QPolygonF& l) const;
+    /**
+       @brief Draw cached tiles of other tile matrices in place of a missing tile
+
+       The closest coarser tile in the cache is scaled up. Finer tiles in the
+       cache are drawn on top of it. By that the area is not left blank until
+       the tile is received.
+     */
+    void drawFallback(const layer_t& layer, const tileset_t& tileset, const QString& tileMatrixId, qint32 col, qint32 row, QPainter& p);
 };
 
 #endif //CMAPWMTS_H
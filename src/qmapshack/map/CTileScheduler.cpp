@@ -0,0 +1,198 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "helpers/CSettings.h"
+#include "map/CTileScheduler.h"
+
+#include <QtNetwork>
+
+CTileScheduler * CTileScheduler::pSelf = nullptr;
+
+CTileScheduler::CTileScheduler(QObject *parent)
+    : QObject(parent)
+{
+    pSelf = this;
+
+    SETTINGS;
+    maxRequestsPerHost = qMax(1, cfg.value("Map/maxTileRequestsPerHost", maxRequestsPerHost).toInt());
+
+    accessManager = new QNetworkAccessManager(this);
+    connect(accessManager, &QNetworkAccessManager::finished, this, &CTileScheduler::slotRequestFinished);
+}
+
+CTileScheduler::~CTileScheduler()
+{
+    // replies aborted by the access manager's destructor are of no interest
+    disconnect(accessManager, nullptr, this, nullptr);
+
+    SETTINGS;
+    cfg.setValue("Map/maxTileRequestsPerHost", maxRequestsPerHost);
+
+    if(pSelf == this)
+    {
+        pSelf = nullptr;
+    }
+}
+
+void CTileScheduler::setMaxRequestsPerHost(int n)
+{
+    maxRequestsPerHost = qMax(1, n);
+    dispatch();
+}
+
+int CTileScheduler::count(QObject * client) const
+{
+    int cnt = 0;
+    for(const entry_t& entry : entries)
+    {
+        if(entry.clients.contains(client))
+        {
+            cnt++;
+        }
+    }
+    return cnt;
+}
+
+void CTileScheduler::setRequests(QObject * client, const QList<request_t>& requests, const headers_t& headers)
+{
+    connect(client, &QObject::destroyed, this, &CTileScheduler::slotClientDestroyed, Qt::UniqueConnection);
+
+    QSet<QString> urls;
+    for(const request_t& request : requests)
+    {
+        urls << request.url;
+
+        entry_t& entry = entries[request.url];
+        if(entry.clients.isEmpty())
+        {
+            entry.url       = request.url;
+            entry.host      = QUrl(request.url).host();
+            entry.headers   = headers;
+        }
+        entry.clients[client] = request.priority;
+    }
+
+    // drop the client from all requests it does not need anymore and update the priority of all others
+    QStringList stale;
+    for(entry_t& entry : entries)
+    {
+        if(!urls.contains(entry.url))
+        {
+            entry.clients.remove(client);
+        }
+
+        if(entry.clients.isEmpty())
+        {
+            stale << entry.url;
+            continue;
+        }
+
+        entry.priority = *std::min_element(entry.clients.begin(), entry.clients.end());
+    }
+
+    for(const QString& url : stale)
+    {
+        abort(url);
+    }
+
+    dispatch();
+}
+
+void CTileScheduler::slotClientDestroyed(QObject * client)
+{
+    setRequests(client, QList<request_t>());
+}
+
+void CTileScheduler::abort(const QString& url)
+{
+    // remove the entry first. By that the reply is ignored by slotRequestFinished()
+    entry_t entry = entries.take(url);
+    if(entry.reply != nullptr)
+    {
+        pendingPerHost[entry.host]--;
+        entry.reply->abort();
+    }
+}
+
+void CTileScheduler::dispatch()
+{
+    QList<entry_t*> queue;
+    for(entry_t& entry : entries)
+    {
+        if(entry.reply == nullptr)
+        {
+            queue << &entry;
+        }
+    }
+
+    std::stable_sort(queue.begin(), queue.end(), [](const entry_t * e1, const entry_t * e2)
+    {
+        return e1->priority < e2->priority;
+    });
+
+    for(entry_t * entry : queue)
+    {
+        int& pending = pendingPerHost[entry->host];
+        if(pending >= maxRequestsPerHost)
+        {
+            continue;
+        }
+
+        QNetworkRequest request;
+        request.setUrl(entry->url);
+        for(const QPair<QByteArray, QByteArray>& header : entry->headers)
+        {
+            request.setRawHeader(header.first, header.second);
+        }
+
+        // the reply's URL might differ from the requested one due to normalization or redirects
+        entry->reply = accessManager->get(request);
+        entry->reply->setProperty("url", entry->url);
+        pending++;
+    }
+}
+
+void CTileScheduler::slotRequestFinished(QNetworkReply * reply)
+{
+    reply->deleteLater();
+
+    const QString& url = reply->property("url").toString();
+    if(!entries.contains(url) || (entries[url].reply != reply))
+    {
+        // the request has been aborted
+        return;
+    }
+
+    const entry_t entry = entries.take(url);
+    pendingPerHost[entry.host]--;
+
+    const bool ok = (reply->error() == QNetworkReply::NoError);
+    if(!ok)
+    {
+        qDebug() << "Request to" << url << "failed:" << reply->errorString();
+    }
+
+    const QByteArray& data = ok ? reply->readAll() : QByteArray();
+    for(QObject * client : entry.clients.keys())
+    {
+        emit sigRequestFinished(client, url, data, ok);
+    }
+
+    dispatch();
+}
+
@@ -0,0 +1,132 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILESCHEDULER_H
+#define CTILESCHEDULER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPair>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+/**
+   @brief Schedule tile requests of all online maps
+
+   Each online map (the client) passes the complete list of tiles missing
+   for it's current viewport via setRequests(). Each request has a priority,
+   usually the distance of the tile from the viewport's center. The tiles
+   are requested in order of that priority. All requests of a client not
+   in the list anymore are dropped. If a request is already in flight and
+   no other client wants the tile, it is aborted. By that a pan or zoom
+   operation does not have to wait for tiles out of sight.
+
+   Requests for the same URL by several clients are coalesced into a single
+   request. Each client gets it's own sigRequestFinished() for the result.
+   The number of parallel requests per host is limited by
+   setMaxRequestsPerHost().
+ */
+class CTileScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    CTileScheduler(QObject * parent);
+    virtual ~CTileScheduler();
+
+    static CTileScheduler& self()
+    {
+        return *pSelf;
+    }
+
+    struct request_t
+    {
+        QString url;
+        /// the lower the value the higher the priority
+        qreal priority;
+    };
+
+    using headers_t = QList<QPair<QByteArray, QByteArray> >;
+
+    /**
+       @brief Replace all requests of a client
+
+       @param client    the object identifying the client
+       @param requests  all tiles the client needs right now, an empty list will cancel all requests
+       @param headers   raw header items added to the HTTP request
+     */
+    void setRequests(QObject * client, const QList<request_t>& requests, const headers_t& headers = headers_t());
+
+    /// the number of requests of a client that are queued or in flight
+    int count(QObject * client) const;
+
+    /// the limit of parallel requests per host
+    void setMaxRequestsPerHost(int n);
+    int getMaxRequestsPerHost() const
+    {
+        return maxRequestsPerHost;
+    }
+
+signals:
+    /**
+       @brief Emitted once for each client that has requested the URL
+
+       Aborted requests are not reported.
+
+       @param client    the client as passed to setRequests()
+       @param url       the tile's URL
+       @param data      the received data, empty on errors
+       @param ok        false on errors
+     */
+    void sigRequestFinished(QObject * client, const QString& url, const QByteArray& data, bool ok);
+
+private slots:
+    void slotRequestFinished(QNetworkReply * reply);
+    void slotClientDestroyed(QObject * client);
+
+private:
+    void dispatch();
+    void abort(const QString& url);
+
+    static CTileScheduler * pSelf;
+
+    struct entry_t
+    {
+        QString url;
+        QString host;
+        /// the highest priority of all clients
+        qreal priority = 0;
+        /// all clients with their priority
+        QHash<QObject*, qreal> clients;
+        headers_t headers;
+        QNetworkReply * reply = nullptr;
+    };
+
+    /// all requests queued or in flight
+    QHash<QString, entry_t> entries;
+    /// the number of requests in flight per host
+    QHash<QString, int> pendingPerHost;
+
+    int maxRequestsPerHost = 6;
+
+    QNetworkAccessManager * accessManager;
+};
+
+#endif //CTILESCHEDULER_H
+
@@ -0,0 +1,190 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CDiskCache.h"
+#include "map/CTileSeeder.h"
+
+#include <QtCore>
+
+/// far beyond any distance used by the online maps to prioritize their tiles
+#define SEED_PRIORITY 1e15
+
+CTileSeeder::CTileSeeder(CDiskCache * cache, const QStringList& urls, const CTileScheduler::headers_t& headers, QObject * parent)
+    : QObject(parent)
+    , cache(cache)
+    , urls(urls)
+    , headers(headers)
+{
+    timer = new QTimer(this);
+    timer->setSingleShot(false);
+    setRate(4);
+    connect(timer, &QTimer::timeout, this, &CTileSeeder::slotTimeout);
+
+    connect(&CTileScheduler::self(), &CTileScheduler::sigRequestFinished, this, &CTileSeeder::slotRequestFinished);
+}
+
+void CTileSeeder::setRate(qreal tilesPerSecond)
+{
+    timer->setInterval(qMax(1, qRound(1000 / qMax(0.01, tilesPerSecond))));
+}
+
+bool CTileSeeder::isRunning() const
+{
+    return timer->isActive();
+}
+
+void CTileSeeder::start()
+{
+    if(isRunning() || finished)
+    {
+        return;
+    }
+
+    timeRunning.start();
+    timer->start();
+    slotTimeout();
+}
+
+void CTileSeeder::pause()
+{
+    if(!isRunning())
+    {
+        return;
+    }
+
+    timer->stop();
+    msRunning += timeRunning.elapsed();
+
+    // drop all tiles in flight, they are requested first on the next start
+    retry = pending.toList() + retry;
+    pending.clear();
+    updateRequests();
+
+    emit sigProgress();
+}
+
+CTileSeeder::progress_t CTileSeeder::getProgress() const
+{
+    progress_t progress;
+    progress.total      = urls.size();
+    progress.cached     = cntCached;
+    progress.downloaded = cntDownloaded;
+    progress.failed     = cntFailed;
+    progress.bytes      = bytes;
+
+    const qint32 remaining = progress.total - cntCached - cntDownloaded - cntFailed;
+    if(cntDownloaded > 0)
+    {
+        progress.bytesTotal = bytes + bytes * remaining / cntDownloaded;
+    }
+
+    const qint64 ms = msRunning + (isRunning() ? timeRunning.elapsed() : 0);
+    if((cntDownloaded + cntFailed) > 0)
+    {
+        progress.eta = ms * remaining / (cntDownloaded + cntFailed) / 1000;
+    }
+
+    return progress;
+}
+
+void CTileSeeder::slotTimeout()
+{
+    if(cache.isNull())
+    {
+        // the map's cache has been replaced or the map has been removed
+        pause();
+        return;
+    }
+
+    if(pending.size() >= maxParallel)
+    {
+        return;
+    }
+
+    while(!retry.isEmpty() || (next < urls.size()))
+    {
+        const QString& url = retry.isEmpty() ? urls[next++] : retry.takeFirst();
+
+        // skip tiles already in the cache, by that an interrupted job resumes where it stopped
+        if(cache->contains(url))
+        {
+            cntCached++;
+            continue;
+        }
+
+        pending << url;
+        updateRequests();
+        break;
+    }
+
+    checkFinished();
+    emit sigProgress();
+}
+
+void CTileSeeder::slotRequestFinished(QObject * client, const QString& url, const QByteArray& data, bool ok)
+{
+    if((client != this) || !pending.remove(url))
+    {
+        return;
+    }
+
+    if(ok && !cache.isNull() && cache->store(url, data))
+    {
+        cntDownloaded++;
+        bytes += data.size();
+    }
+    else
+    {
+        cntFailed++;
+    }
+
+    checkFinished();
+    emit sigProgress();
+}
+
+void CTileSeeder::updateRequests()
+{
+    QList<CTileScheduler::request_t> requests;
+    for(const QString& url : pending)
+    {
+        requests << CTileScheduler::request_t {url, SEED_PRIORITY};
+    }
+
+    CTileScheduler::self().setRequests(this, requests, headers);
+}
+
+void CTileSeeder::checkFinished()
+{
+    if(!pending.isEmpty() || !retry.isEmpty() || (next < urls.size()))
+    {
+        return;
+    }
+
+    if(isRunning())
+    {
+        timer->stop();
+        msRunning += timeRunning.elapsed();
+    }
+
+    if(!finished)
+    {
+        finished = true;
+        emit sigFinished();
+    }
+}
+
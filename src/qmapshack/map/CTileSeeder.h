@@ -0,0 +1,122 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILESEEDER_H
+#define CTILESEEDER_H
+
+#include "map/CTileScheduler.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+
+class CDiskCache;
+class QTimer;
+
+/**
+   @brief Download a list of tiles into a tile cache
+
+   The tiles are requested via CTileScheduler with the lowest priority.
+   Thus the maps drawn on the screen are served first. The number of
+   tiles in flight and the number of tiles requested per second are
+   limited to be nice to the tile server.
+
+   Tiles already in the cache are skipped. By that a job interrupted by
+   pause() or by closing QMapShack continues where it stopped, if started
+   again with the same list of tiles.
+
+   The received data is written as it is into the cache, see
+   CDiskCache::store(const QString&, const QByteArray&).
+ */
+class CTileSeeder : public QObject
+{
+    Q_OBJECT
+public:
+    CTileSeeder(CDiskCache * cache, const QStringList& urls, const CTileScheduler::headers_t& headers, QObject * parent);
+    virtual ~CTileSeeder() = default;
+
+    struct progress_t
+    {
+        qint32 total        = 0;  //< all tiles of the job
+        qint32 cached       = 0;  //< tiles skipped because they are in the cache
+        qint32 downloaded   = 0;  //< tiles downloaded and stored
+        qint32 failed       = 0;  //< tiles failed to download or store
+        qint64 bytes        = 0;  //< the size of all downloaded tiles [bytes]
+        qint64 bytesTotal   = -1; //< the estimated size of all tiles to download [bytes], -1 if unknown
+        qint32 eta          = -1; //< the estimated time to finish [s], -1 if unknown
+    };
+
+    void start();
+    void pause();
+    bool isRunning() const;
+    bool isFinished() const
+    {
+        return finished;
+    }
+
+    /// the maximum number of tiles requested per second
+    void setRate(qreal tilesPerSecond);
+    /// the maximum number of tiles in flight
+    void setMaxParallel(qint32 n)
+    {
+        maxParallel = qMax(1, n);
+    }
+
+    progress_t getProgress() const;
+
+signals:
+    void sigProgress();
+    void sigFinished();
+
+private slots:
+    void slotTimeout();
+    void slotRequestFinished(QObject * client, const QString& url, const QByteArray& data, bool ok);
+
+private:
+    void updateRequests();
+    void checkFinished();
+
+    QPointer<CDiskCache> cache;
+    QStringList urls;
+    CTileScheduler::headers_t headers;
+
+    /// the index of the next tile in urls
+    qint32 next = 0;
+    /// tiles dropped by pause() to be requested first
+    QStringList retry;
+    /// tiles in flight
+    QSet<QString> pending;
+
+    qint32 maxParallel = 2;
+    QTimer * timer;
+
+    /// the time spent running since the start
+    QElapsedTimer timeRunning;
+    qint64 msRunning = 0;
+
+    qint32 cntCached     = 0;
+    qint32 cntDownloaded = 0;
+    qint32 cntFailed     = 0;
+    qint64 bytes         = 0;
+    bool finished        = false;
+};
+
+#endif //CTILESEEDER_H
+
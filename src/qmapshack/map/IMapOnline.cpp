@@ -28,9 +28,7 @@
 IMapOnline::IMapOnline(const QString &url, CMapDraw * parent)
 	: IMap(url,eFeatVisibility | eFeatTileCache, parent)
 {
-    accessManager = new QNetworkAccessManager(parent->thread());
-    connect(accessManager, &QNetworkAccessManager::finished, this, &IMapOnline::slotRequestFinished);
-
+    connect(&CTileScheduler::self(), &CTileScheduler::sigRequestFinished, this, &IMapOnline::slotRequestFinished);
     connect(this, &IMapOnline::sigQueueChanged, this, &IMapOnline::slotQueueChanged);
 }
 
@@ -51,48 +49,28 @@ bool IMapOnline::httpsCheck(const QString &url)
 }
 
 
+void IMapOnline::addToQueue(const QString& url, QPointF pos, const IDrawContext::buffer_t& buf)
+{
+    QPointF pp = buf.ref1;
+    map->convertRad2Px(pp);
+    map->convertRad2Px(pos);
+
+    // the squared distance to the buffer's center [px^2]
+    const QPointF& d = pos - pp - QPointF(buf.image.width(), buf.image.height()) / 2;
+    urlQueue << CTileScheduler::request_t {url, QPointF::dotProduct(d, d)};
+}
+
+
 void IMapOnline::slotQueueChanged()
 {
     QMutexLocker lock(&mutex);
 
-    if(!urlQueue.isEmpty() && urlPending.size() < 6)
-    {
-        // request up to 6 pending request
-        for(int i = 0; i < (6 - urlPending.size()); i++)
-        {
-            QString url = urlQueue.dequeue();
-            lastRequest = urlQueue.isEmpty();
-
-            QNetworkRequest request;
-            request.setUrl(url);
-            for(const rawHeaderItem_t &item : rawHeaderItems)
-            {
-                request.setRawHeader(item.name.toLatin1(), item.value.toLatin1());
-            }
-            accessManager->get(request);
-            urlPending << url;
-
-            if(lastRequest)
-            {
-                break;
-            }
-        }
-    }
-    else if(lastRequest && urlPending.isEmpty())
-    {
-        lastRequest = false;
-        // if all tiles are received the map layer can be redrawn with all tiles from cache
-        map->emitSigCanvasUpdate();
-    }
-
-    if(timeLastUpdate.elapsed() > 2000)
-    {
-        timeLastUpdate.start();
-        map->emitSigCanvasUpdate();
-    }
+    // all requests of the previous draw operation not in the queue anymore are dropped
+    CTileScheduler::self().setRequests(this, urlQueue, rawHeaderItems);
+    urlQueue.clear();
 
     // report status of pending tiles
-    int pending = urlQueue.size() + urlPending.size();
+    int pending = CTileScheduler::self().count(this);
     if(pending)
     {
         map->reportStatusToCanvas(name, tr("<b>%1</b>: %2 tiles pending<br/>").arg(name).arg(pending));
@@ -104,37 +82,41 @@ void IMapOnline::slotQueueChanged()
 }
 
 
-void IMapOnline::slotRequestFinished(QNetworkReply* reply)
+void IMapOnline::slotRequestFinished(QObject * client, const QString& url, const QByteArray& data, bool ok)
 {
+    if(client != this)
+    {
+        return;
+    }
+
     QMutexLocker lock(&mutex);
 
-    QString url = reply->url().toString();
-    if(urlPending.contains(url))
+    QImage img;
+    // only take good responses
+    if(ok)
     {
-        QImage img;
-        // only take good responses
-        if(!reply->error())
-        {
-            // read image data
-            img.loadFromData(reply->readAll());
-        }
-        // always store image to cache, the cache will take care of NULL images
-        diskCache->store(url, img);
-
-        urlPending.removeAll(url);
+        // read image data
+        img.loadFromData(data);
     }
+    // always store image to cache, the cache will take care of NULL images
+    diskCache->store(url, img);
 
-    // debug output any error
-    if(reply->error())
+    int pending = CTileScheduler::self().count(this);
+    if(pending == 0)
     {
-        qDebug() << "Request to" << url << "failed:" << reply->errorString();
+        // if all tiles are received the map layer can be redrawn with all tiles from cache
+        map->reportStatusToCanvas(name, "");
+        map->emitSigCanvasUpdate();
+    }
+    else
+    {
+        map->reportStatusToCanvas(name, tr("<b>%1</b>: %2 tiles pending<br/>").arg(name).arg(pending));
+        if(timeLastUpdate.elapsed() > 2000)
+        {
+            timeLastUpdate.start();
+            map->emitSigCanvasUpdate();
+        }
     }
-
-    // delete reply object
-    reply->deleteLater();
-
-    // check for more items to be queued
-    slotQueueChanged();
 }
 
 
@@ -19,26 +19,20 @@
 
 #ifndef IMAPONLINE_H
 #define IMAPONLINE_H
+#include "map/CTileScheduler.h"
 #include "map/IMap.h"
 #include <QMutex>
-#include <QQueue>
+#include <QSet>
 #include <QTime>
 
 class CDiskCache;
-class QNetworkAccessManager;
-class QNetworkReply;
 
 class IMapOnline : public IMap
 {
     Q_OBJECT
 
-    struct rawHeaderItem_t
-    {
-        QString name;
-        QString value;
-    };
-
-    QList<rawHeaderItem_t> rawHeaderItems;
+    /// raw header items added to each tile request
+    CTileScheduler::headers_t rawHeaderItems;
 
 signals:
     void sigQueueChanged();
@@ -46,16 +40,11 @@ signals:
 protected:
     /// Mutex to control access to url queue
     QMutex mutex {QMutex::Recursive};
-    /// a queue with all tile urls to request
-    QQueue<QString> urlQueue;
+    /// all tiles missing in the last draw operation, passed to the tile scheduler by slotQueueChanged()
+    QList<CTileScheduler::request_t> urlQueue;
     /// the tile cache
     CDiskCache * diskCache = nullptr;
-    /// access manager to request tiles
-    QNetworkAccessManager * accessManager = nullptr;
-    QList<QString> urlPending;
-
 
-    bool lastRequest = false;
     QTime timeLastUpdate;
     QString name;
 
@@ -63,17 +52,62 @@ protected:
 
     void registerHeaderItem(const QString &name, const QString &value)
     {
-        struct rawHeaderItem_t item;
-        item.name  = name;
-        item.value = value;
-        rawHeaderItems << item;
+        rawHeaderItems << qMakePair(name.toLatin1(), value.toLatin1());
     }
 
+    /**
+       @brief Add a missing tile to the url queue
+
+       Tiles close to the buffer's center are requested first.
+
+       @param url   the tile's URL
+       @param pos   the center of the tile [rad]
+       @param buf   the buffer currently drawn
+     */
+    void addToQueue(const QString& url, QPointF pos, const IDrawContext::buffer_t& buf);
+
     void configureCache() override;
 
 public:
+    /**
+       @brief Get the range of levels available for seeding the tile cache
+
+       @param min       the coarsest level
+       @param max       the finest level
+     */
+    virtual void getLevelRange(qint32& min, qint32& max) const = 0;
+
+    /**
+       @brief Collect the URLs of all tiles of a level covering an area
+
+       For TMS maps the level is the zoom level as used in the URL. For WMTS
+       maps it is the index of the tile matrix, ordered from coarse to fine.
+
+       @param area      a list of polygons [rad]
+       @param level     the level as reported by getLevelRange()
+       @param urls      the URLs of all enabled layers are added to this set
+       @param max       the maximum number of URLs in the set
+       @return False if more than max URLs would be needed.
+     */
+    virtual bool getTileUrls(const QList<QPolygonF>& area, qint32 level, QSet<QString>& urls, qint32 max) = 0;
+
+    const QString& getName() const
+    {
+        return name;
+    }
+
+    CDiskCache * getDiskCache() const
+    {
+        return diskCache;
+    }
+
+    const CTileScheduler::headers_t& getHeaders() const
+    {
+        return rawHeaderItems;
+    }
+
     void slotQueueChanged();
-    void slotRequestFinished(QNetworkReply* reply);
+    void slotRequestFinished(QObject * client, const QString& url, const QByteArray& data, bool ok);
 
 
     IMapOnline(const QString &url, CMapDraw * parent);
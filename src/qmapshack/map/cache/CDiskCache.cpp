@@ -76,6 +76,35 @@ void CDiskCache::store(const QString& key, QImage& img)
     }
 }
 
+bool CDiskCache::store(const QString& key, const QByteArray& data)
+{
+    // the image format is detected by content on restore
+    QBuffer buffer;
+    buffer.setData(data);
+    if(!QImageReader(&buffer).canRead())
+    {
+        return false;
+    }
+
+    QMutexLocker lock(&mutex);
+
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    md5.addData(key.toLatin1());
+
+    QString hash     = md5.result().toHex();
+    QString filename = QString("%1.png").arg(hash);
+
+    QFile file(dir.absoluteFilePath(filename));
+    if(!file.open(QIODevice::WriteOnly) || (file.write(data) != data.size()))
+    {
+        return false;
+    }
+
+    table[hash] = filename;
+    cache.remove(hash);
+    return true;
+}
+
 void CDiskCache::restore(const QString& key, QImage& img)
 {
     QMutexLocker lock(&mutex);
@@ -34,6 +34,18 @@ public:
     virtual ~CDiskCache() = default;
 
     void store(const QString& key, QImage& img);
+    /**
+       @brief Store the encoded image data as received from the server
+
+       The data is written as it is. No decoding or encoding is done and the
+       image is not kept in memory. Thus this is the method of choice to
+       store a large number of tiles.
+
+       @param key   the key to address the tile, usually the URL
+       @param data  the image data as received from the server
+       @return False if the data is not a readable image.
+     */
+    bool store(const QString& key, const QByteArray& data);
     void restore(const QString& key, QImage& img);
     bool contains(const QString& key) const;
 
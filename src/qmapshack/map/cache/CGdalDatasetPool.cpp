@@ -0,0 +1,92 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CGdalDatasetPool.h"
+
+#include <gdal_priv.h>
+#include <QtCore>
+
+QMutex CGdalDatasetPool::mutexPools;
+QHash<QString, QWeakPointer<CGdalDatasetPool> > CGdalDatasetPool::pools;
+
+QSharedPointer<CGdalDatasetPool> CGdalDatasetPool::get(const QString& filename)
+{
+    QMutexLocker lock(&mutexPools);
+    QSharedPointer<CGdalDatasetPool> pool = pools.value(filename).toStrongRef();
+    if(pool.isNull())
+    {
+        pool = QSharedPointer<CGdalDatasetPool>(new CGdalDatasetPool(filename));
+        pools[filename] = pool;
+    }
+    return pool;
+}
+
+CGdalDatasetPool::CGdalDatasetPool(const QString& filename)
+    : filename(filename)
+{
+}
+
+CGdalDatasetPool::~CGdalDatasetPool()
+{
+    {
+        QMutexLocker lock(&mutexPools);
+        // the entry might already belong to a new pool of the same file
+        if(pools.value(filename).isNull())
+        {
+            pools.remove(filename);
+        }
+    }
+
+    for(GDALDataset * dataset : idle)
+    {
+        GDALClose(dataset);
+    }
+}
+
+GDALDataset * CGdalDatasetPool::acquire()
+{
+    {
+        QMutexLocker lock(&mutex);
+        if(!idle.isEmpty())
+        {
+            return idle.takeLast();
+        }
+    }
+
+    // open outside the lock, this can take a while
+    return (GDALDataset*)GDALOpen(filename.toUtf8(), GA_ReadOnly);
+}
+
+void CGdalDatasetPool::release(GDALDataset * dataset)
+{
+    if(dataset == nullptr)
+    {
+        return;
+    }
+
+    {
+        QMutexLocker lock(&mutex);
+        if(idle.size() < QThread::idealThreadCount())
+        {
+            idle << dataset;
+            return;
+        }
+    }
+
+    GDALClose(dataset);
+}
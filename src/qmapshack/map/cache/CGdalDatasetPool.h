@@ -0,0 +1,110 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CGDALDATASETPOOL_H
+#define CGDALDATASETPOOL_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+
+class GDALDataset;
+
+/**
+   @brief A pool of GDAL dataset handles for a single file
+
+   A GDAL dataset must not be used by more than one thread at a time. Thus
+   each thread reading a file in parallel needs it's own handle. Opening a
+   file for each read is expensive, especially for VRTs. The pool keeps the
+   handles open and hands them out to one thread at a time.
+
+   Use CGdalDatasetPool::CHandle to acquire and release a handle within a
+   scope. All maps using the same file share a single pool. Use get() to
+   access it.
+ */
+class CGdalDatasetPool
+{
+public:
+    /**
+       @brief Get the pool for a file
+
+       @param filename  the file opened by the handles
+       @return A shared pointer to the pool.
+     */
+    static QSharedPointer<CGdalDatasetPool> get(const QString& filename);
+    virtual ~CGdalDatasetPool();
+
+    /**
+       @brief Acquire a handle for the current scope
+
+       Always test with isNull() as the file might fail to open.
+     */
+    class CHandle
+    {
+    public:
+        CHandle(CGdalDatasetPool& pool)
+            : pool(pool)
+            , dataset(pool.acquire())
+        {
+        }
+
+        ~CHandle()
+        {
+            pool.release(dataset);
+        }
+
+        bool isNull() const
+        {
+            return dataset == nullptr;
+        }
+
+        GDALDataset * operator->() const
+        {
+            return dataset;
+        }
+
+        operator GDALDataset*() const
+        {
+            return dataset;
+        }
+
+    private:
+        Q_DISABLE_COPY(CHandle)
+        CGdalDatasetPool& pool;
+        GDALDataset * dataset;
+    };
+
+private:
+    CGdalDatasetPool(const QString& filename);
+
+    /// get an idle handle or open a new one
+    GDALDataset * acquire();
+    /// return a handle to the idle ones or close it if there are enough
+    void release(GDALDataset * dataset);
+
+    static QMutex mutexPools;
+    static QHash<QString, QWeakPointer<CGdalDatasetPool> > pools;
+
+    const QString filename;
+
+    QMutex mutex;
+    QList<GDALDataset*> idle;
+};
+
+#endif //CGDALDATASETPOOL_H
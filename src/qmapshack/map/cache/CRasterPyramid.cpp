@@ -0,0 +1,383 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "map/cache/CGdalDatasetPool.h"
+#include "map/cache/CRasterPyramid.h"
+#include "map/CMapDraw.h"
+#include "map/CMapVRT.h"
+#include "units/IUnit.h"
+
+#include <QtGui>
+
+/// the maximum size of tiles kept in memory [kByte]
+#define MAX_CACHE_SIZE 32768
+/// pyramids not used for that many days are removed
+#define MAX_AGE_DAYS 90
+
+QHash<QString, QWeakPointer<CRasterPyramid> > CRasterPyramid::pyramids;
+
+class CRasterPyramidWorker : public QRunnable
+{
+public:
+    CRasterPyramidWorker(CRasterPyramid& pyramid, qint32 idxLevel, qint32 row)
+        : pyramid(pyramid)
+        , idxLevel(idxLevel)
+        , row(row)
+    {
+    }
+
+    void run() override
+    {
+        pyramid.buildRow(idxLevel, row);
+        QMetaObject::invokeMethod(&pyramid, "slotRowDone", Qt::QueuedConnection, Q_ARG(qint32, idxLevel));
+    }
+
+private:
+    CRasterPyramid& pyramid;
+    qint32 idxLevel;
+    qint32 row;
+};
+
+class CRasterPyramidCleaner : public QRunnable
+{
+public:
+    CRasterPyramidCleaner(const QDir& dir)
+        : dir(dir)
+    {
+    }
+
+    void run() override
+    {
+        const QDateTime& limit = QDateTime::currentDateTime().addDays(-MAX_AGE_DAYS);
+
+        const QFileInfoList& entries = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for(const QFileInfo& entry : entries)
+        {
+            QDir pyramid(entry.absoluteFilePath());
+            const QFileInfo source(pyramid.absoluteFilePath("source"));
+
+            if(!source.exists() || (source.lastModified() < limit) || !CRasterPyramid::isSourceValid(source.absoluteFilePath()))
+            {
+                qDebug() << "remove pyramid" << pyramid.path();
+                pyramid.removeRecursively();
+            }
+        }
+    }
+
+private:
+    QDir dir;
+};
+
+QSharedPointer<CRasterPyramid> CRasterPyramid::get(const QString& filename, const QVector<QRgb>& colortable, const QSize& size)
+{
+    QSharedPointer<CRasterPyramid> pyramid = pyramids.value(filename).toStrongRef();
+    if(pyramid.isNull())
+    {
+        pyramid = QSharedPointer<CRasterPyramid>(new CRasterPyramid(filename, colortable, size));
+        pyramids[filename] = pyramid;
+    }
+    return pyramid;
+}
+
+CRasterPyramid::CRasterPyramid(const QString& filename, const QVector<QRgb>& colortable, const QSize& size)
+    : filename(filename)
+    , colortable(colortable)
+    , size(size)
+    , datasets(CGdalDatasetPool::get(filename))
+    , cache(MAX_CACHE_SIZE)
+{
+    // a changed map file will get a new pyramid
+    const QFileInfo fi(filename);
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    md5.addData(fi.absoluteFilePath().toUtf8());
+    md5.addData(QByteArray::number(fi.size()));
+    md5.addData(QByteArray::number(fi.lastModified().toMSecsSinceEpoch()));
+
+    const QDir root(QDir(CMapDraw::getCacheRoot()).absoluteFilePath("Pyramids"));
+    dir.setPath(root.absoluteFilePath(QString(md5.result().toHex())));
+    dir.mkpath(dir.absolutePath());
+
+    // remember the map file to remove the pyramid once the file is changed or gone.
+    // Writing the file each time marks the pyramid as used.
+    QFile source(dir.absoluteFilePath("source"));
+    if(source.open(QIODevice::WriteOnly))
+    {
+        QTextStream stream(&source);
+        stream << fi.absoluteFilePath() << endl << fi.size() << endl << fi.lastModified().toMSecsSinceEpoch() << endl;
+    }
+    source.close();
+
+    // halve the resolution until the whole map fits into a single tile
+    qint32 factor = 1;
+    do
+    {
+        factor *= 2;
+
+        level_t level;
+        level.factor    = factor;
+        level.cols      = qCeil(qreal(size.width())  / (TILESIZE * factor));
+        level.rows      = qCeil(qreal(size.height()) / (TILESIZE * factor));
+        level.done      = QFile::exists(dir.absoluteFilePath(QString("%1/done").arg(factor)));
+
+        levels << level;
+        tilesTotal += level.cols * level.rows;
+        if(level.done)
+        {
+            tilesDone += level.cols * level.rows;
+        }
+    }
+    while((levels.last().cols > 1) || (levels.last().rows > 1));
+
+    progress = tilesTotal ? (100 * tilesDone / tilesTotal) : 100;
+
+    // leave one core to draw the map
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    // clean up the pyramids once per session
+    static bool isCleaned = false;
+    if(!isCleaned)
+    {
+        isCleaned = true;
+        pool.start(new CRasterPyramidCleaner(root));
+    }
+
+    startLevel();
+}
+
+CRasterPyramid::~CRasterPyramid()
+{
+    pyramids.remove(filename);
+
+    abort = 1;
+    pool.clear();
+    pool.waitForDone();
+}
+
+bool CRasterPyramid::isSourceValid(const QString& filename)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QTextStream stream(&file);
+    const QFileInfo fi(stream.readLine());
+    const qint64 size = stream.readLine().toLongLong();
+    const qint64 time = stream.readLine().toLongLong();
+
+    return fi.exists() && (fi.size() == size) && (fi.lastModified().toMSecsSinceEpoch() == time);
+}
+
+void CRasterPyramid::startLevel()
+{
+    while((idxLevel < levels.size()) && levels[idxLevel].done)
+    {
+        idxLevel++;
+    }
+
+    if(idxLevel == levels.size())
+    {
+        return;
+    }
+
+    const level_t& level = levels[idxLevel];
+    dir.mkpath(QString::number(level.factor));
+
+    rowsPending = level.rows;
+    for(qint32 row = 0; row < level.rows; row++)
+    {
+        pool.start(new CRasterPyramidWorker(*this, idxLevel, row));
+    }
+}
+
+void CRasterPyramid::slotRowDone(qint32 idx)
+{
+    if(abort || (idx != idxLevel))
+    {
+        return;
+    }
+
+    level_t& level = levels[idxLevel];
+    tilesDone += level.cols;
+    progress = 100 * tilesDone / tilesTotal;
+    emit sigProgress(progress);
+
+    if(--rowsPending > 0)
+    {
+        return;
+    }
+
+    QFile file(dir.absoluteFilePath(QString("%1/done").arg(level.factor)));
+    file.open(QIODevice::WriteOnly);
+    file.close();
+
+    mutex.lock();
+    level.done = true;
+    mutex.unlock();
+
+    emit sigLevelReady();
+    startLevel();
+}
+
+QRect CRasterPyramid::getTileArea(const level_t& level, qint32 col, qint32 row) const
+{
+    const qint32 tileSize = TILESIZE * level.factor;
+    const QRect area(col * tileSize, row * tileSize, tileSize, tileSize);
+    return area & QRect(QPoint(0, 0), size);
+}
+
+QString CRasterPyramid::getTileFilename(qint32 idx, qint32 col, qint32 row) const
+{
+    return dir.absoluteFilePath(QString("%1/%2_%3.png").arg(levels.at(idx).factor).arg(col).arg(row));
+}
+
+qint32 CRasterPyramid::getLevelIndex(qint32 factor) const
+{
+    const qint32 N = levels.size();
+    for(qint32 n = 0; n < N; n++)
+    {
+        if(levels.at(n).factor == factor)
+        {
+            return n;
+        }
+    }
+    return NOIDX;
+}
+
+void CRasterPyramid::buildRow(qint32 idx, qint32 row)
+{
+    const level_t& level = levels.at(idx);
+
+    // only the first level is read from the map
+    QScopedPointer<CGdalDatasetPool::CHandle> dataset;
+    if(idx == 0)
+    {
+        dataset.reset(new CGdalDatasetPool::CHandle(*datasets));
+        if(dataset->isNull())
+        {
+            return;
+        }
+    }
+
+    for(qint32 col = 0; col < level.cols; col++)
+    {
+        if(abort)
+        {
+            break;
+        }
+
+        const QString& tileFilename = getTileFilename(idx, col, row);
+        if(QFile::exists(tileFilename))
+        {
+            continue;
+        }
+
+        const QRect& area = getTileArea(level, col, row);
+        const QSize sizeTile(qCeil(qreal(area.width()) / level.factor), qCeil(qreal(area.height()) / level.factor));
+
+        QImage img;
+        if(!dataset.isNull())
+        {
+            if(!CMapVRT::readImage(*dataset, colortable, area, sizeTile, true, img))
+            {
+                continue;
+            }
+            img = img.convertToFormat(QImage::Format_ARGB32);
+        }
+        else
+        {
+            // join the 4 tiles of the finer level and scale them down
+            const level_t& finer = levels.at(idx - 1);
+            const QSize sizeFiner(qCeil(qreal(area.width()) / finer.factor), qCeil(qreal(area.height()) / finer.factor));
+
+            QImage tmp(sizeFiner, QImage::Format_ARGB32);
+            tmp.fill(Qt::transparent);
+
+            QPainter p(&tmp);
+            for(qint32 r = 0; r < 2; r++)
+            {
+                for(qint32 c = 0; c < 2; c++)
+                {
+                    if(((2 * col + c) < finer.cols) && ((2 * row + r) < finer.rows))
+                    {
+                        p.drawImage(c * TILESIZE, r * TILESIZE, QImage(getTileFilename(idx - 1, 2 * col + c, 2 * row + r)));
+                    }
+                }
+            }
+            p.end();
+
+            img = tmp.scaled(sizeTile, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+
+        // write to a temporary file first to never leave an incomplete tile
+        const QString tmpFilename = tileFilename + ".tmp";
+        if(img.save(tmpFilename, "PNG"))
+        {
+            QFile::rename(tmpFilename, tileFilename);
+        }
+    }
+}
+
+qint32 CRasterPyramid::findLevel(qreal factor) const
+{
+    QMutexLocker lock(&mutex);
+    for(const level_t& level : levels)
+    {
+        if(level.done && (level.factor >= factor))
+        {
+            return level.factor;
+        }
+    }
+    return 0;
+}
+
+bool CRasterPyramid::getTile(qint32 factor, qint32 col, qint32 row, QImage& img, QRect& area)
+{
+    const qint32 idx = getLevelIndex(factor);
+    if(idx == NOIDX)
+    {
+        return false;
+    }
+
+    const level_t& level = levels.at(idx);
+    if((col < 0) || (col >= level.cols) || (row < 0) || (row >= level.rows))
+    {
+        return false;
+    }
+
+    area = getTileArea(level, col, row);
+
+    const QString& tileFilename = getTileFilename(idx, col, row);
+
+    QMutexLocker lock(&mutex);
+    QImage * cached = cache.object(tileFilename);
+    if(cached != nullptr)
+    {
+        img = *cached;
+        return true;
+    }
+
+    if(!img.load(tileFilename))
+    {
+        return false;
+    }
+
+    cache.insert(tileFilename, new QImage(img), qMax(1, img.byteCount() >> 10));
+    return true;
+}
@@ -0,0 +1,161 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CRASTERPYRAMID_H
+#define CRASTERPYRAMID_H
+
+#include <QAtomicInt>
+#include <QCache>
+#include <QDir>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QVector>
+
+class CGdalDatasetPool;
+
+/**
+   @brief A pyramid of reduced images for raster maps without overviews
+
+   Without overviews a raster map has to be read at full resolution. That
+   is why CMapVRT stops to draw large maps when zoomed out. The pyramid
+   provides the missing levels instead. Each level halves the resolution of
+   the previous one and is stored as PNG tiles in a sidecar directory below
+   the map cache root.
+
+   The levels are built in the background from fine to coarse. The first
+   level is read from the map by decimated RasterIO reads, all others are
+   resampled from the 4 tiles of the level below. Rows of tiles are processed
+   in parallel by a thread pool. Each thread uses it's own GDAL dataset
+   handle from the map file's CGdalDatasetPool.
+
+   Tiles already on disk are not built again. Thus an interrupted build
+   resumes where it stopped. A level can be used as soon as it is complete.
+
+   All maps using the same file share a single pyramid. Use get() to access it.
+
+   Once per session pyramids of changed or removed map files and pyramids
+   not used for 90 days are removed.
+ */
+class CRasterPyramid : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+       @brief Get the pyramid of a raster map file
+
+       The pyramid is created and it's build is started if it does not exist yet.
+
+       @param filename      the map's filename
+       @param colortable    the color table used for maps with a single band
+       @param size          the size of the map [px]
+       @return A shared pointer to the pyramid.
+     */
+    static QSharedPointer<CRasterPyramid> get(const QString& filename, const QVector<QRgb>& colortable, const QSize& size);
+    virtual ~CRasterPyramid();
+
+    /// the maximum width and height of a tile [px]
+    static const qint32 TILESIZE = 256;
+
+    /// the build progress in percent
+    qint32 getProgress() const
+    {
+        return progress;
+    }
+
+    /**
+       @brief Find the finest complete level reducing the map at least by a factor
+
+       @param factor    the minimum reduction factor
+       @return The level's reduction factor or 0 if there is no such level (yet).
+     */
+    qint32 findLevel(qreal factor) const;
+
+    /// test if the map file described by a pyramid's source file is unchanged
+    static bool isSourceValid(const QString& filename);
+
+    /**
+       @brief Get a tile of a complete level
+
+       @param factor    the level's reduction factor as returned by findLevel()
+       @param col       the tile's column
+       @param row       the tile's row
+       @param img       the tile's image
+       @param area      the area covered by the tile in map pixel
+       @return False if there is no such tile.
+     */
+    bool getTile(qint32 factor, qint32 col, qint32 row, QImage& img, QRect& area);
+
+signals:
+    void sigProgress(qint32 progress);
+    /// a level is complete and can be used
+    void sigLevelReady();
+
+private slots:
+    void slotRowDone(qint32 idxLevel);
+
+private:
+    friend class CRasterPyramidWorker;
+    CRasterPyramid(const QString& filename, const QVector<QRgb>& colortable, const QSize& size);
+
+    struct level_t
+    {
+        qint32 factor;
+        qint32 cols;
+        qint32 rows;
+        bool done;
+    };
+
+    /// queue all rows of the first incomplete level
+    void startLevel();
+    /// build all tiles of a row missing on disk, called by the worker threads
+    void buildRow(qint32 idxLevel, qint32 row);
+    /// the area of a tile in map pixel
+    QRect getTileArea(const level_t& level, qint32 col, qint32 row) const;
+    QString getTileFilename(qint32 idxLevel, qint32 col, qint32 row) const;
+    qint32 getLevelIndex(qint32 factor) const;
+
+    static QHash<QString, QWeakPointer<CRasterPyramid> > pyramids;
+
+    const QString filename;
+    const QVector<QRgb> colortable;
+    const QSize size;
+    QSharedPointer<CGdalDatasetPool> datasets;
+
+    QDir dir;
+    QVector<level_t> levels;
+    /// the level in progress
+    qint32 idxLevel = 0;
+    qint32 rowsPending = 0;
+
+    qint32 tilesTotal = 0;
+    qint32 tilesDone = 0;
+    qint32 progress = 0;
+
+    QThreadPool pool;
+    QAtomicInt abort {0};
+
+    /// serialize access to the done flags of levels and the cache
+    mutable QMutex mutex;
+    /// recently used tiles, costs are in kByte
+    QCache<QString, QImage> cache;
+};
+
+#endif //CRASTERPYRAMID_H
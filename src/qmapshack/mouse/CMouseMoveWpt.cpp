@@ -42,7 +42,7 @@ CMouseMoveWpt::CMouseMoveWpt(CGisItemWpt &wpt, CGisDraw * gis, CCanvas *canvas,
     icon    = CWptIconManager::self().getWptIconByName(wpt.getIconName(), focus);
     newPos  = origPos;
     wpt.setHideArea(true);
-    canvas->triggerCompleteUpdate(CCanvas::eRedrawGis);
+    CGisDraw::updateArea(wpt.getBoundingRect());
 }
 
 CMouseMoveWpt::~CMouseMoveWpt()
@@ -100,9 +100,10 @@ void CMouseMoveWpt::rightButtonDown(const QPoint& point)
     if(wpt != nullptr)
     {
         wpt->setHideArea(false);
+        CGisDraw::updateArea(wpt->getBoundingRect());
     }
     canvas->resetMouse();
-    canvas->triggerCompleteUpdate(CCanvas::eRedrawGis);
+    canvas->triggerCompleteUpdate(CCanvas::eRedrawGisArea);
 }
 
 void CMouseMoveWpt::mouseMoved(const QPoint& pos)
@@ -125,7 +126,8 @@ void CMouseMoveWpt::leftClicked(const QPoint& point)
         wpt->setHideArea(false);
     }
     canvas->resetMouse();
-    canvas->slotTriggerCompleteUpdate(CCanvas::eRedrawGis);
+    // the waypoint's old and new area are marked dirty by the change
+    canvas->slotTriggerCompleteUpdate(CCanvas::eRedrawGisArea);
 }
 
 void CMouseMoveWpt::scaleChanged()
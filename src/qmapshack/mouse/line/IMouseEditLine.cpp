@@ -426,7 +426,8 @@ void IMouseEditLine::slotCopyToOrig()
 
 
     canvas->resetMouse();
-    canvas->slotTriggerCompleteUpdate(CCanvas::eRedrawGis);
+    // the changed item has marked its old and new area dirty
+    canvas->slotTriggerCompleteUpdate(CCanvas::eRedrawGisArea);
 }
 
 void IMouseEditLine::restoreFromHistory(SGisLine& line)
@@ -26,10 +26,14 @@
 #include "helpers/CProgressDialog.h"
 #include "helpers/CSettings.h"
 #include "print/CPrintDialog.h"
+#include "print/CTiledImageWriter.h"
 
 #include <QtPrintSupport>
 #include <QtWidgets>
 
+/// the size of the tiles the map is rendered in [px]
+#define TILE_SIZE 1024
+
 CPrintDialog::CPrintDialog(type_e type, const QRectF& area, CCanvas *source)
     : QDialog(&CMainWindow::self())
     , type(type)
@@ -231,14 +235,13 @@ void CPrintDialog::slotPrint()
         {
             first = false;
         }
-        if(printScaleOnAllPages || pt == centers.last())
-        {
-            canvas->print(p, rectPage, pt, true);
-        }
-        else
+        // render the page in tiles to keep the memory footprint small at high resolutions
+        const bool printScale = printScaleOnAllPages || pt == centers.last();
+        canvas->printTiled(rectPage.size().toSize(), pt, QSize(TILE_SIZE, TILE_SIZE), printScale, [&p](const QImage& tile, const QPoint& offset) -> bool
         {
-            canvas->print(p, rectPage, pt, false);
-        }
+            p.drawImage(offset, tile);
+            return true;
+        });
         PROGRESS(++n, break);
     }
 
@@ -249,27 +252,14 @@ void CPrintDialog::slotPrint()
 
 void CPrintDialog::slotSave()
 {
-    QPointF pt1 = rectSelArea.topLeft();
-    QPointF pt2 = rectSelArea.bottomRight();
-
-    canvas->convertRad2Px(pt1);
-    canvas->convertRad2Px(pt2);
-
-    QRectF rect(pt1, pt2);
-    QImage img(rect.size().toSize(), QImage::Format_ARGB32);
-
-    QPainter p(&img);
-    USE_ANTI_ALIASING(p, true);
-
-    canvas->print(p, rect, rectSelArea.center());
-
     SETTINGS;
     QString path = cfg.value("Paths/lastImagePath", "./").toString();
 
     QString filterPNG = "PNG Image (*.png)";
     QString filterJPG = "JPEG Image (*.jpg)";
+    QString filterTIF = "GeoTIFF Image (*.tif)";
     QString filter    = filterPNG;
-    QString filename = QFileDialog::getSaveFileName(this, tr("Save map..."), path, filterPNG + ";; " + filterJPG, &filter);
+    QString filename = QFileDialog::getSaveFileName(this, tr("Save map..."), path, filterPNG + ";; " + filterJPG + ";; " + filterTIF, &filter);
     if(filename.isEmpty())
     {
         return;
@@ -284,6 +274,10 @@ void CPrintDialog::slotSave()
     {
         expectedSuffix = "jpg";
     }
+    else if(filter == filterTIF)
+    {
+        expectedSuffix = "tif";
+    }
 
     QFileInfo fi(filename);
     if(fi.suffix().toLower() != expectedSuffix)
@@ -291,10 +285,59 @@ void CPrintDialog::slotSave()
         filename += "." + expectedSuffix;
     }
 
-    img.save(filename);
-
     cfg.setValue("Paths/lastImagePath", fi.absolutePath());
 
+    QPointF pt1 = rectSelArea.topLeft();
+    QPointF pt2 = rectSelArea.bottomRight();
+
+    canvas->convertRad2Px(pt1);
+    canvas->convertRad2Px(pt2);
+
+    const QSize size = QRectF(pt1, pt2).size().toSize();
+    const QPointF focus = rectSelArea.center();
+
+    // The image is rendered in tiles and streamed into the file. By that
+    // the image size is not limited by memory.
+    CTiledImageWriter writer(filename, size);
+    if(!writer.isValid())
+    {
+        QMessageBox::critical(this, tr("Error..."), writer.getError(), QMessageBox::Ok);
+        return;
+    }
+
+    // Get the georeference the same way the tiles are placed. This has to
+    // be done before rendering as rendering changes the canvas' point of focus.
+    QPointF ref1 = focus;
+    canvas->convertRad2Px(ref1);
+    ref1 -= QPointF(size.width(), size.height()) / 2;
+    QPointF ref2 = ref1 + QPointF(size.width(), size.height());
+    canvas->convertPx2M(ref1);
+    canvas->convertPx2M(ref2);
+    writer.setGeoReference(canvas->getProjection(), ref1, QPointF((ref2.x() - ref1.x()) / size.width(), (ref2.y() - ref1.y()) / size.height()));
+
+    int N = qCeil(qreal(size.width()) / TILE_SIZE) * qCeil(qreal(size.height()) / TILE_SIZE);
+    int n = 0;
+    PROGRESS_SETUP(tr("Saving map."), 0, N, this);
+
+    bool done = canvas->printTiled(size, focus, QSize(TILE_SIZE, TILE_SIZE), true, [&](const QImage& tile, const QPoint& offset) -> bool
+    {
+        writer.addTile(tile, offset);
+        PROGRESS(++n, return false);
+        return true;
+    });
+
+    if(!done)
+    {
+        // canceled by user, the writer will remove the incomplete file
+        return;
+    }
+
+    if(!writer.finish())
+    {
+        QMessageBox::critical(this, tr("Error..."), writer.getError(), QMessageBox::Ok);
+        return;
+    }
+
     QDialog::accept();
 }
 
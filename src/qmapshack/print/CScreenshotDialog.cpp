@@ -115,11 +115,14 @@ void CScreenshotDialog::slotPrint()
         return;
     }
 
+    // Let the painter scale the images to the page. Scaling them in advance
+    // would create huge images at high printer resolutions.
     const QRectF& r = printer.pageRect(QPrinter::DevicePixel);
-    const QPixmap& canvasScaled = pixmap.scaled(r.size().toSize(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    const QSize& sizeCanvas = sizePixmap.scaled(r.size().toSize(), Qt::KeepAspectRatio);
 
     QPainter p(&printer);
-    p.drawPixmap(0, 0, canvasScaled);
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    p.drawPixmap(QRect(QPoint(0, 0), sizeCanvas), pixmap);
 
     CGisItemTrk * trk = getTrackForProfile();
     if(trk != nullptr)
@@ -129,18 +132,18 @@ void CScreenshotDialog::slotPrint()
         QImage image(plot.size(), QImage::Format_ARGB32);
         plot.save(image, nullptr);
 
-        const QImage& profileScaled = image.scaled(r.size().toSize(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        const QSize& sizeProfile = image.size().scaled(r.size().toSize(), Qt::KeepAspectRatio);
 
-        if(r.height() > (canvasScaled.height() + profileScaled.height()))
+        if(r.height() > (sizeCanvas.height() + sizeProfile.height()))
         {
-            p.translate(0, canvasScaled.height());
+            p.translate(0, sizeCanvas.height());
         }
         else
         {
             printer.newPage();
         }
 
-        p.drawImage(0, 0, profileScaled);
+        p.drawImage(QRect(QPoint(0, 0), sizeProfile), image);
     }
 
 
@@ -0,0 +1,232 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "print/CTiledImageWriter.h"
+
+#include <gdal_priv.h>
+#include <ogr_spatialref.h>
+#include <proj_api.h>
+#include <QtGui>
+
+/// the number of tiles allowed to wait for a writer thread
+#define MAX_TILES_PENDING_PER_THREAD 2
+
+class CTileWriterWorker : public QRunnable
+{
+public:
+    CTileWriterWorker(CTiledImageWriter& writer, const QImage& tile, const QPoint& offset)
+        : writer(writer)
+        , tile(tile)
+        , offset(offset)
+    {
+    }
+
+    void run() override
+    {
+        writer.writeTile(tile, offset);
+        writer.tilesPending.release();
+    }
+
+private:
+    CTiledImageWriter& writer;
+    QImage tile;
+    QPoint offset;
+};
+
+CTiledImageWriter::CTiledImageWriter(const QString& filename, const QSize& size)
+    : filename(filename)
+{
+    const QString& suffix = QFileInfo(filename).suffix().toLower();
+    if(suffix == "png")
+    {
+        driverName = "PNG";
+    }
+    else if(suffix == "jpg" || suffix == "jpeg")
+    {
+        // no alpha channel for JPEG
+        driverName = "JPEG";
+        nBands = 3;
+    }
+    else
+    {
+        driverName = "GTiff";
+    }
+
+    QString filenameTif = filename;
+    if(driverName != "GTiff")
+    {
+        filenameTmp = filenameTif = filename + ".tmp.tif";
+    }
+
+    // leave one core to render the tiles
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    tilesPending.release(pool.maxThreadCount() * MAX_TILES_PENDING_PER_THREAD);
+
+    GDALDriverManager * drvman = GetGDALDriverManager();
+    if(drvman->GetDriverByName(driverName.toUtf8()) == nullptr)
+    {
+        error = tr("GDAL driver %1 is not available.").arg(driverName);
+        return;
+    }
+
+    const char * options[] =
+    {
+        "TILED=YES"
+        , "COMPRESS=DEFLATE"
+        , "BIGTIFF=IF_SAFER"
+        , "PHOTOMETRIC=RGB"
+        , nBands == 4 ? "ALPHA=YES" : nullptr
+        , nullptr
+    };
+
+    GDALDriver * driver = drvman->GetDriverByName("GTiff");
+    dataset = driver->Create(filenameTif.toUtf8(), size.width(), size.height(), nBands, GDT_Byte, (char**)options);
+    if(dataset == nullptr)
+    {
+        error = tr("Failed to create file %1.").arg(filenameTif);
+    }
+}
+
+CTiledImageWriter::~CTiledImageWriter()
+{
+    pool.waitForDone();
+    close();
+
+    if(!filenameTmp.isEmpty())
+    {
+        QFile::remove(filenameTmp);
+    }
+    if(!finished)
+    {
+        QFile::remove(filename);
+    }
+}
+
+void CTiledImageWriter::close()
+{
+    QMutexLocker lock(&mutex);
+    if(dataset != nullptr)
+    {
+        GDALClose(dataset);
+        dataset = nullptr;
+    }
+}
+
+void CTiledImageWriter::setGeoReference(const QString& proj, const QPointF& ref, const QPointF& pixelSize)
+{
+    OGRSpatialReference oSRS;
+    if(oSRS.importFromProj4(proj.toUtf8()) != OGRERR_NONE)
+    {
+        return;
+    }
+
+    // the projection's coordinates of geographic systems are in [rad]
+    const qreal f = oSRS.IsGeographic() ? RAD_TO_DEG : 1.0;
+    double adfGeoTransform[6] = {ref.x() * f, pixelSize.x() * f, 0, ref.y() * f, 0, pixelSize.y() * f};
+
+    char * wkt = nullptr;
+    oSRS.exportToWkt(&wkt);
+
+    QMutexLocker lock(&mutex);
+    if(dataset != nullptr)
+    {
+        dataset->SetProjection(wkt);
+        dataset->SetGeoTransform(adfGeoTransform);
+    }
+    CPLFree(wkt);
+}
+
+void CTiledImageWriter::addTile(const QImage& tile, const QPoint& offset)
+{
+    tilesPending.acquire();
+    pool.start(new CTileWriterWorker(*this, tile, offset));
+}
+
+void CTiledImageWriter::writeTile(const QImage& tile, const QPoint& offset)
+{
+    // convert the tile to the pixel interleaved layout of the dataset
+    QImage img;
+    if(nBands == 4)
+    {
+        img = tile.convertToFormat(QImage::Format_RGBA8888);
+    }
+    else
+    {
+        img = QImage(tile.size(), QImage::Format_RGB888);
+        img.fill(Qt::white);
+        QPainter p(&img);
+        p.drawImage(0, 0, tile);
+    }
+
+    int bandMap[4] = {1, 2, 3, 4};
+
+    QMutexLocker lock(&mutex);
+    if(dataset == nullptr)
+    {
+        return;
+    }
+
+    CPLErr err = dataset->RasterIO(GF_Write, offset.x(), offset.y(), img.width(), img.height(), img.bits()
+                                   , img.width(), img.height(), GDT_Byte, nBands, bandMap
+                                   , nBands, img.bytesPerLine(), 1);
+    if(err != CE_None)
+    {
+        error = tr("Failed to write tile at %1,%2: %3").arg(offset.x()).arg(offset.y()).arg(CPLGetLastErrorMsg());
+    }
+}
+
+bool CTiledImageWriter::finish()
+{
+    pool.waitForDone();
+    close();
+
+    if(error.isEmpty() && !filenameTmp.isEmpty())
+    {
+        GDALDataset * src = (GDALDataset*)GDALOpen(filenameTmp.toUtf8(), GA_ReadOnly);
+        GDALDriver * driver = GetGDALDriverManager()->GetDriverByName(driverName.toUtf8());
+        if(src == nullptr || driver == nullptr)
+        {
+            error = tr("Failed to open temporary file %1.").arg(filenameTmp);
+        }
+        else
+        {
+            // the driver will read the source line by line
+            const char * options[] = {"WORLDFILE=YES", nullptr};
+            GDALDataset * dst = driver->CreateCopy(filename.toUtf8(), src, FALSE, (char**)options, nullptr, nullptr);
+            if(dst == nullptr)
+            {
+                error = tr("Failed to write file %1: %2").arg(filename).arg(CPLGetLastErrorMsg());
+            }
+            else
+            {
+                GDALClose(dst);
+            }
+        }
+
+        if(src != nullptr)
+        {
+            GDALClose(src);
+        }
+        QFile::remove(filenameTmp);
+        filenameTmp.clear();
+    }
+
+    // on errors the incomplete file is removed on destruction
+    finished = error.isEmpty();
+    return finished;
+}
@@ -0,0 +1,114 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#ifndef CTILEDIMAGEWRITER_H
+#define CTILEDIMAGEWRITER_H
+
+#include <QCoreApplication>
+#include <QImage>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThreadPool>
+
+class GDALDataset;
+
+/**
+   @brief Write a large image tile by tile with constant memory
+
+   The image is written by GDAL as tiled GeoTIFF. The tiles are converted
+   and written by a thread pool while the next tile is rendered. The number
+   of tiles waiting to be written is limited. Thus memory consumption does
+   not depend on the image size.
+
+   PNG and JPEG files are written as temporary GeoTIFF first and converted by
+   GDAL's CreateCopy(), which reads the source line by line. The georeference
+   is kept by a world file.
+
+   If finish() is not called or fails the incomplete file is removed on destruction.
+ */
+class CTiledImageWriter
+{
+    Q_DECLARE_TR_FUNCTIONS(CTiledImageWriter)
+public:
+    /**
+       @param filename  the target file. The format is derived from the suffix (tif, png or jpg).
+       @param size      the size of the image [px]
+     */
+    CTiledImageWriter(const QString& filename, const QSize& size);
+    virtual ~CTiledImageWriter();
+
+    bool isValid() const
+    {
+        return dataset != nullptr;
+    }
+
+    const QString& getError() const
+    {
+        return error;
+    }
+
+    /**
+       @brief Attach a georeference to the image
+
+       @param proj      the projection as proj4 string
+       @param ref       the top left corner of the image in projected coordinates
+       @param pixelSize the size of a pixel in projected coordinates
+     */
+    void setGeoReference(const QString& proj, const QPointF& ref, const QPointF& pixelSize);
+
+    /**
+       @brief Queue a tile to be written
+
+       This will block if too many tiles are waiting to be written.
+
+       @param tile      the tile image
+       @param offset    the tile's top left corner within the image [px]
+     */
+    void addTile(const QImage& tile, const QPoint& offset);
+
+    /**
+       @brief Wait for all tiles to be written and close the file
+
+       @return False on any error. See getError().
+     */
+    bool finish();
+
+private:
+    friend class CTileWriterWorker;
+    void writeTile(const QImage& tile, const QPoint& offset);
+    void close();
+
+    QString filename;
+    /// the GeoTIFF actually written if the target is not a GeoTIFF
+    QString filenameTmp;
+    QString driverName;
+    qint32 nBands = 4;
+    bool finished = false;
+
+    GDALDataset * dataset = nullptr;
+
+    QThreadPool pool;
+    /// limits the number of tiles waiting to be written
+    QSemaphore tilesPending;
+    /// serialize access to dataset and error
+    QMutex mutex;
+    QString error;
+};
+
+#endif //CTILEDIMAGEWRITER_H
+
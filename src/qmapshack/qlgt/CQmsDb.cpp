@@ -260,7 +260,7 @@ quint64 CQmsDb::store(IGisItem& item)
 
     QSqlQuery query(db);
     // item is unknown to database -> create item in database
-    query.prepare("INSERT INTO items (type, keyqms, icon, name, date, comment, data, hash) VALUES (:type, :keyqms, :icon, :name, :date, :comment, :data, :hash)");
+    query.prepare("INSERT INTO items (type, keyqms, icon, name, date, comment, data, hash, west, east, south, north) VALUES (:type, :keyqms, :icon, :name, :date, :comment, :data, :hash, :west, :east, :south, :north)");
     query.bindValue(":type",    item.type());
     query.bindValue(":keyqms",     item.getKey().item);
     query.bindValue(":icon",    buffer.data());
@@ -269,6 +269,7 @@ quint64 CQmsDb::store(IGisItem& item)
     query.bindValue(":comment", item.getInfo(IGisItem::eFeatureShowName | IGisItem::eFeatureShowFullText));
     query.bindValue(":data", data);
     query.bindValue(":hash", item.getHash());
+    IDB::bindBoundingBox(query, item);
     QUERY_EXEC(return 0);
 
     query.prepare("SELECT last_insert_rowid() from items");
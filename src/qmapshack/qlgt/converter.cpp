@@ -119,7 +119,7 @@ CGisItemWpt::CGisItemWpt(const CQlgtWpt& wpt1, IGisProject * project)
     {
         CGisItemWpt::image_t image;
 
-        image.pixmap        = image1.pixmap.toImage();
+        image.setImage(image1.pixmap.toImage());
         image.direction     = direction;
         image.info          = image1.info;
         image.filePath      = image1.filePath;
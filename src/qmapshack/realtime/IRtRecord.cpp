@@ -20,41 +20,236 @@
 #include "realtime/IRtRecord.h"
 
 #include <QtCore>
+#include <QtGui>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define MAGIC_HEADER    0x52534d51  // "QMSR"
+#define MAGIC_CHUNK     0x4b4e4843  // "CHNK"
+#define MAGIC_INDEX     0x58444e49  // "INDX"
+#define MAGIC_END       0x444e4551  // "QEND"
+#define RECORD_VERSION  2
+
+/// write a chunk as soon as the buffer exceeds this size
+#define MAX_BUFFER_SIZE     65536
+/// the interval to write buffered entries [ms]
+#define FLUSH_INTERVAL      5000
+/// sync the file to disk every Nth flush by timer
+#define SYNC_EVERY_NTH      6
+
+/// the size of the trailer: offset of the index and the end tag
+#define SIZE_TRAILER        (sizeof(quint64) + sizeof(quint32))
+
+static void initStream(QDataStream& stream)
+{
+    stream.setVersion(QDataStream::Qt_5_2);
+    stream.setByteOrder(QDataStream::LittleEndian);
+}
 
 IRtRecord::IRtRecord(QObject *parent)
     : QObject(parent)
 {
+    timerFlush = new QTimer(this);
+    timerFlush->setInterval(FLUSH_INTERVAL);
+    connect(timerFlush, &QTimer::timeout, this, &IRtRecord::slotFlush);
+}
+
+IRtRecord::~IRtRecord()
+{
+    close();
 }
 
 bool IRtRecord::setFile(const QString& fn)
 {
+    close();
+
     track.clear();
+    line.clear();
+    chunks.clear();
     filename = fn;
 
-    if(QFile::exists(filename))
+    if(QFile::exists(filename) && (QFileInfo(filename).size() > 0))
     {
-        return readFile(filename);
+        if(!readFile(filename))
+        {
+            // the file has been truncated to the last valid data. Go on with recording.
+            openForAppend();
+            return false;
+        }
     }
-    return true;
+    return openForAppend();
 }
 
 bool IRtRecord::readFile(const QString& filename)
 {
-    QFile file(filename);
-    if(!file.open(QIODevice::ReadOnly))
+    QFile in(filename);
+    if(!in.open(QIODevice::ReadOnly))
     {
         error = tr("Failed to open record for reading.");
         return false;
     }
 
-    QDataStream stream(&file);
-    stream.setVersion(QDataStream::Qt_5_2);
-    stream.setByteOrder(QDataStream::LittleEndian);
+    QDataStream stream(&in);
+    initStream(stream);
+
+    quint32 magic = 0, version = 0;
+    stream >> magic >> version;
+    if((magic != MAGIC_HEADER) || (version != RECORD_VERSION))
+    {
+        in.close();
+        return readFileV1(filename);
+    }
+
+    // the end of all valid chunks
+    quint64 end = in.pos();
+    bool success = true;
+    if(!readChunksByIndex(stream, end))
+    {
+        // the record has not been closed properly
+        track.clear();
+        line.clear();
+        chunks.clear();
+
+        stream.resetStatus();
+        in.seek(end);
+        success = readChunks(stream, end);
+    }
+
+    in.close();
+
+    // remove the index (or the broken data) as new chunks will be appended
+    QFile::resize(filename, end);
+
+    if(!success)
+    {
+        error = tr("Failed to read entry. Truncate record to last valid entry.");
+    }
+    return success;
+}
+
+bool IRtRecord::readChunksByIndex(QDataStream& stream, quint64& end)
+{
+    QIODevice * dev = stream.device();
+    const quint64 size = dev->size();
+    if(size < end + SIZE_TRAILER)
+    {
+        return false;
+    }
+
+    quint64 offsetIndex;
+    quint32 magic;
+    dev->seek(size - SIZE_TRAILER);
+    stream >> offsetIndex >> magic;
+    if((magic != MAGIC_END) || (offsetIndex < end) || (offsetIndex >= size))
+    {
+        return false;
+    }
 
+    dev->seek(offsetIndex);
+    quint32 nChunks;
+    stream >> magic >> nChunks;
+    if((magic != MAGIC_INDEX) || (stream.status() != QDataStream::Ok))
+    {
+        return false;
+    }
+
+    QVector<chunk_t> index(nChunks);
+    quint32 nEntries = 0;
+    for(chunk_t& chunk : index)
+    {
+        stream >> chunk.offset >> chunk.entries;
+        nEntries += chunk.entries;
+    }
+
+    if(stream.status() != QDataStream::Ok)
+    {
+        return false;
+    }
+
+    track.reserve(nEntries);
+    line.reserve(nEntries);
+
+    for(const chunk_t& chunk : index)
+    {
+        dev->seek(chunk.offset);
+        if(!readChunk(stream))
+        {
+            return false;
+        }
+    }
+
+    end = offsetIndex;
+    return true;
+}
+
+bool IRtRecord::readChunks(QDataStream& stream, quint64& end)
+{
     while(!stream.atEnd())
     {
-        quint64 size = stream.device()->pos();
+        // The trailing index is not a chunk. But it is only found
+        // here if the chunks referenced by it are broken.
+        if(!readChunk(stream))
+        {
+            return false;
+        }
+        end = stream.device()->pos();
+    }
+    return true;
+}
+
+bool IRtRecord::readChunk(QDataStream& stream)
+{
+    const quint64 offset = stream.device()->pos();
+
+    quint32 magic, nEntries;
+    QByteArray payload;
+    quint16 crc;
+    stream >> magic >> nEntries >> payload >> crc;
+
+    if((magic != MAGIC_CHUNK) || (stream.status() != QDataStream::Ok) || (qChecksum(payload.data(), payload.size()) != crc))
+    {
+        return false;
+    }
+
+    QDataStream entries(&payload, QIODevice::ReadOnly);
+    initStream(entries);
+    for(quint32 i = 0; i < nEntries; i++)
+    {
+        QByteArray data;
+        entries >> data;
+        if(entries.status() != QDataStream::Ok)
+        {
+            return false;
+        }
+        readEntry(data);
+    }
+
+    chunks << chunk_t {offset, nEntries};
+    return true;
+}
+
+bool IRtRecord::readFileV1(const QString& filename)
+{
+    QFile in(filename);
+    if(!in.open(QIODevice::ReadOnly))
+    {
+        error = tr("Failed to open record for reading.");
+        return false;
+    }
 
+    QDataStream stream(&in);
+    initStream(stream);
+
+    QDataStream converted(&buffer, QIODevice::Append);
+    initStream(converted);
+
+    bool success = true;
+    while(!stream.atEnd())
+    {
         quint16 crc;
         QByteArray data;
         stream >> crc >> data;
@@ -62,77 +257,203 @@ bool IRtRecord::readFile(const QString& filename)
         if((qChecksum(data.data(), data.size()) != crc) || (stream.status() != QDataStream::Ok))
         {
             error = tr("Failed to read entry. Truncate record to last valid entry.");
+            success = false;
+            break;
+        }
+
+        readEntry(data);
+        converted << data;
+        bufferedEntries++;
+    }
+
+    in.close();
+
+    // convert the file by writing all entries in one chunk
+    QFile::resize(filename, 0);
+    if(openForAppend())
+    {
+        flush(true);
+        timerFlush->stop();
+        file.close();
+    }
+
+    return success;
+}
+
+bool IRtRecord::openForAppend()
+{
+    if(filename.isEmpty())
+    {
+        return false;
+    }
+
+    file.setFileName(filename);
+    if(!file.open(QIODevice::ReadWrite))
+    {
+        error = tr("Failed to open record for writing.");
+        return false;
+    }
+
+    if(file.size() == 0)
+    {
+        if(!writeHeader())
+        {
             file.close();
-            QFile::resize(filename, size);
             return false;
         }
+    }
 
-        readEntry(data);
+    file.seek(file.size());
+    timerFlush->start();
+    return true;
+}
+
+bool IRtRecord::writeHeader()
+{
+    QDataStream stream(&file);
+    initStream(stream);
+    stream << quint32(MAGIC_HEADER) << quint32(RECORD_VERSION);
+    return stream.status() == QDataStream::Ok;
+}
+
+bool IRtRecord::writeIndex()
+{
+    QDataStream stream(&file);
+    initStream(stream);
+
+    const quint64 offsetIndex = file.pos();
+    stream << quint32(MAGIC_INDEX) << quint32(chunks.size());
+    for(const chunk_t& chunk : chunks)
+    {
+        stream << chunk.offset << chunk.entries;
+    }
+    stream << offsetIndex << quint32(MAGIC_END);
+
+    return stream.status() == QDataStream::Ok;
+}
+
+void IRtRecord::close()
+{
+    timerFlush->stop();
+
+    if(!file.isOpen())
+    {
+        return;
     }
 
+    flush(false);
+    writeIndex();
     file.close();
-    return true;
 }
 
 bool IRtRecord::writeEntry(const QByteArray& data)
 {
-    QFile file(filename);
-    if(!file.open(QIODevice::Append))
+    if(!file.isOpen())
     {
         error = tr("Failed to open record for writing.");
         return false;
     }
 
-    QDataStream stream(&file);
-    stream.setVersion(QDataStream::Qt_5_2);
-    stream.setByteOrder(QDataStream::LittleEndian);
+    QDataStream stream(&buffer, QIODevice::Append);
+    initStream(stream);
+    stream << data;
+    bufferedEntries++;
 
-    quint16 crc = qChecksum(data.data(), data.size());
-    stream << crc << data;
+    if(buffer.size() > MAX_BUFFER_SIZE)
+    {
+        return flush(false);
+    }
+    return true;
+}
 
-    if(stream.status() != QDataStream::Ok)
+bool IRtRecord::flush(bool sync)
+{
+    if(!file.isOpen())
+    {
+        return false;
+    }
+
+    if(bufferedEntries != 0)
+    {
+        const quint64 offset = file.pos();
+
+        QDataStream stream(&file);
+        initStream(stream);
+        stream << quint32(MAGIC_CHUNK) << bufferedEntries << buffer << qChecksum(buffer.data(), buffer.size());
+
+        if(stream.status() != QDataStream::Ok)
+        {
+            error = tr("Failed to write entry.");
+            return false;
+        }
+
+        chunks << chunk_t {offset, bufferedEntries};
+        buffer.clear();
+        bufferedEntries = 0;
+    }
+
+    if(!file.flush())
     {
         error = tr("Failed to write entry.");
-        file.close();
         return false;
     }
 
-    file.close();
+    if(sync)
+    {
+#ifdef Q_OS_WIN
+        _commit(file.handle());
+#else
+        fsync(file.handle());
+#endif
+    }
     return true;
 }
 
+void IRtRecord::slotFlush()
+{
+    cntFlush = (cntFlush + 1) % SYNC_EVERY_NTH;
+    flush(cntFlush == 0);
+}
+
 bool IRtRecord::readEntry(QByteArray& data)
 {
     QDataStream stream(&data, QIODevice::ReadOnly);
-    stream.setVersion(QDataStream::Qt_5_2);
-    stream.setByteOrder(QDataStream::LittleEndian);
+    initStream(stream);
 
     quint8 version;
     stream >> version;
 
     CTrackData::trkpt_t trkpt;
     stream  >> trkpt;
-    track << trkpt;
+    addTrkPt(trkpt);
     return true;
 }
 
+void IRtRecord::addTrkPt(const CTrackData::trkpt_t& trkpt)
+{
+    track << trkpt;
+    line << QPointF(trkpt.lon * DEG_TO_RAD, trkpt.lat * DEG_TO_RAD);
+}
+
 void IRtRecord::reset()
 {
+    timerFlush->stop();
+    file.close();
+
     track.clear();
+    line.clear();
+    chunks.clear();
+    buffer.clear();
+    bufferedEntries = 0;
+
     QFile::resize(filename, 0);
+    openForAppend();
 }
 
 void IRtRecord::draw(QPainter& p, const QPolygonF& viewport, QList<QRectF>& blockedAreas, CRtDraw * rt)
 {
-    QPolygonF tmp;
-    for(const CTrackData::trkpt_t& trkpt : track)
-    {
-        tmp << QPointF(trkpt.lon * DEG_TO_RAD, trkpt.lat * DEG_TO_RAD);
-    }
-
+    QPolygonF tmp = line;
     rt->convertRad2Px(tmp);
     p.setPen(QPen(Qt::black, 3));
     p.drawPolyline(tmp);
 }
-
-
@@ -27,13 +27,30 @@
 
 class CRtDraw;
 class QPainter;
+class QTimer;
 
+/**
+   @brief Base class of all realtime records
+
+   A record file starts with a small header followed by chunks of entries.
+   Each chunk carries the number of entries and a crc16 over all of them.
+   On a clean close a trailing index with the offsets of all chunks is
+   appended. It is removed again as soon as the file is re-opened for
+   appending.
+
+   Entries are collected in memory and written as a chunk if the buffer
+   exceeds a limit or every few seconds. The file itself is kept open
+   and synced to disk periodically.
+
+   Files written by older versions with one crc per entry are converted
+   on the first access.
+ */
 class IRtRecord : public QObject
 {
     Q_OBJECT
 public:
     IRtRecord(QObject * parent);
-    virtual ~IRtRecord() = default;
+    virtual ~IRtRecord();
 
     /**
        @brief Set record file size to 0.
@@ -72,11 +89,20 @@ public:
         return track;
     }
 
+    /**
+       @brief Write all buffered entries to the file
+
+       @param sync  if true the file is synced to disk, too.
+
+       @return Return true on success.
+     */
+    bool flush(bool sync);
+
 protected:
     /**
        @brief Write block of data to file
 
-       A crc16 is calculated and stored together with the byte array into the file.
+       The data is buffered and written as part of a chunk later on.
 
        @param data  the byte array to store
 
@@ -84,6 +110,16 @@ protected:
      */
     virtual bool writeEntry(const QByteArray& data);
 
+    /**
+       @brief Append a track point to the record's track
+
+       Use this instead of accessing the track directly. It will update
+       all data derived from the track, too.
+
+       @param trkpt the track point to append
+     */
+    void addTrkPt(const CTrackData::trkpt_t& trkpt);
+
     /**
        @brief A block data has been read and needs further processing
 
@@ -97,21 +133,57 @@ protected:
      */
     virtual bool readEntry(QByteArray& data);
 
-protected:
-    QVector<CTrackData::trkpt_t> track;
+private slots:
+    void slotFlush();
 
 private:
 
     /**
-       @brief Reads file content entry by entry and tests for the checksum
+       @brief Reads file content chunk by chunk and tests for the checksum
 
        @param filename  the file name to open and read.
 
        @return Return true on success.
      */
     virtual bool readFile(const QString& filename);
+    /// read a file in the format with a crc per entry and convert it
+    bool readFileV1(const QString& filename);
+    /// read all chunks listed in the trailing index, returns false if there is no valid index
+    bool readChunksByIndex(QDataStream& stream, quint64& end);
+    /// read chunks from the current position until the first invalid one
+    bool readChunks(QDataStream& stream, quint64& end);
+    /// read a single chunk at the current position
+    bool readChunk(QDataStream& stream);
+
+    /// open the file for appending chunks, a new file gets a header
+    bool openForAppend();
+    bool writeHeader();
+    bool writeIndex();
+    void close();
+
+    QVector<CTrackData::trkpt_t> track;
+    /// the track as polyline [rad] to avoid the conversion on each redraw
+    QPolygonF line;
 
     QString filename;
+    QFile file;
+
+    struct chunk_t
+    {
+        quint64 offset;
+        quint32 entries;
+    };
+
+    /// the offsets of all chunks in the file
+    QVector<chunk_t> chunks;
+
+    /// entries not written to the file yet
+    QByteArray buffer;
+    quint32 bufferedEntries = 0;
+
+    QTimer * timerFlush;
+    /// the number of flushes done by the timer without syncing the file
+    qint32 cntFlush = 0;
 
     QString error;
 };
@@ -45,7 +45,7 @@ bool CRtGpsTetherRecord::writeEntry(qreal lon, qreal lat, qreal ele, qreal speed
     }
 
     stream << trkpt;
-    track << trkpt;
+    addTrkPt(trkpt);
 
     return writeEntry(data);
 }
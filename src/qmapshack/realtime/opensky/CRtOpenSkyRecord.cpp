@@ -41,7 +41,7 @@ bool CRtOpenSkyRecord::writeEntry(const CRtOpenSky::aircraft_t& aircraft)
     trkpt.time  = QDateTime::fromTime_t(aircraft.timePosition);
 
     stream << trkpt;
-    track << trkpt;
+    addTrkPt(trkpt);
 
     return writeEntry(data);
 }
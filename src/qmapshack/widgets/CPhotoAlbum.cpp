@@ -79,10 +79,11 @@ void CPhotoAlbum::slotAddImage()
     {
         CGisItemWpt::image_t image;
         image.fileName = filename;
-        if(image.pixmap.load(filename))
+        QImage pixmap;
+        if(pixmap.load(filename))
         {
-            int w = image.pixmap.width();
-            int h = image.pixmap.height();
+            int w = pixmap.width();
+            int h = pixmap.height();
 
             if(w < h)
             {
@@ -94,7 +95,7 @@ void CPhotoAlbum::slotAddImage()
                 h *= 600.0 / w;
                 w  = 600;
             }
-            image.pixmap = image.pixmap.scaled(w, h, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            image.setImage(pixmap.scaled(w, h, Qt::KeepAspectRatio, Qt::SmoothTransformation));
 
             images << image;
         }
@@ -177,14 +178,8 @@ void CPhotoAlbum::updateView()
     rects.clear();
     for(int i = 0; i < images.size(); i++)
     {
-        CGisItemWpt::image_t& image = images[i];
-
-        QImage tmp  = image.pixmap.scaledToHeight(label->height(), Qt::SmoothTransformation);
-
-        if(tmp.width() > label->width())
-        {
-            tmp  = image.pixmap.scaledToWidth(label->width(), Qt::SmoothTransformation);
-        }
+        // thumbnails are cached. No need to decode and scale all images again.
+        const QImage& tmp = images[i].getThumbnail(label->size());
 
         QRect r     = tmp.rect();
 
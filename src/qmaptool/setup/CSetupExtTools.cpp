@@ -48,6 +48,9 @@ CSetupExtTools::CSetupExtTools(QWidget *parent)
     connect(toolResetGdalbuildvrt, &QToolButton::pressed, this, slot2(resetGdalbuildvrtOverride));
     connect(toolResetQmtrgb2pct, &QToolButton::pressed, this, slot2(resetQmtrgb2pctOverride));
     connect(toolResetQmtmap2jnx, &QToolButton::pressed, this, slot2(resetQmtmap2jnxOverride));
+
+    spinParallelJobs->setValue(IAppSetup::self().getMaxParallelJobs());
+    connect(spinParallelJobs, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), &IAppSetup::self(), &IAppSetup::setMaxParallelJobs);
 }
 
 void CSetupExtTools::setupGui()
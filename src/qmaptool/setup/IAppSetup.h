@@ -174,6 +174,18 @@ public:
         return !pathQmtmap2jnxOverride.isEmpty();
     }
 
+    /// the maximum number of external tools run in parallel by the shell
+    qint32 getMaxParallelJobs() const
+    {
+        return maxParallelJobs;
+    }
+
+    void setMaxParallelJobs(qint32 n)
+    {
+        maxParallelJobs = qMax(1, n);
+        emit sigSetupChanged();
+    }
+
 
     virtual QString helpFile() = 0;
 signals:
@@ -207,6 +219,8 @@ protected:
     QString pathGdalbuildvrtOverride;
     QString pathQmtrgb2pctOverride;
     QString pathQmtmap2jnxOverride;
+
+    qint32 maxParallelJobs = 1;
 };
 
 #endif // IAPPSETUP_H
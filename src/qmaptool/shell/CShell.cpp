@@ -17,6 +17,7 @@
 **********************************************************************************************/
 
 #include "CMainWindow.h"
+#include "setup/IAppSetup.h"
 #include "shell/CShell.h"
 
 #include <QtWidgets>
@@ -27,23 +28,26 @@ CShell::CShell(QWidget *parent)
     : QTextBrowser(parent)
 {
     pSelf = this;
-
-    connect(&cmd, &QProcess::readyReadStandardError,  this, &CShell::slotStderr);
-    connect(&cmd, &QProcess::readyReadStandardOutput, this, &CShell::slotStdout);
-
-    connect(&cmd, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &CShell::slotFinished);
-    connect(&cmd, static_cast<void (QProcess::*)(QProcess::ProcessError)   >(&QProcess::error),    this, &CShell::slotError);
 }
 
-void CShell::slotError(QProcess::ProcessError error)
+void CShell::processError(QProcess * proc, QProcess::ProcessError error)
 {
+    if(!running.contains(proc))
+    {
+        return;
+    }
+
     setTextColor(Qt::red);
-    insertPlainText(QString(tr("Execution of external program `%1` failed: ")).arg(cmd.program()));
+    moveCursor(QTextCursor::End);
+    insertPlainText(QString(tr("\nExecution of external program `%1` failed: ")).arg(proc->program()));
+    lastOutput = -1;
     switch(error)
     {
     case QProcess::FailedToStart:
         insertPlainText(QString(tr("Process cannot be started.\n")));
-        insertPlainText(QString(tr("Make sure the required packages are installed, `%1` exists and is executable.\n")).arg(cmd.program()));
+        insertPlainText(QString(tr("Make sure the required packages are installed, `%1` exists and is executable.\n")).arg(proc->program()));
+        // there will be no finished signal for this process
+        endCommand(proc, eStateFailed);
         break;
 
     case QProcess::Crashed:
@@ -56,45 +60,34 @@ void CShell::slotError(QProcess::ProcessError error)
     }
 }
 
-void CShell::slotStderr()
+void CShell::readStderr(QProcess * proc)
 {
-    QString str;
-    setTextColor(Qt::red);
-    str = cmd.readAllStandardError();
-
-    if(str[0] == '\r')
+    if(running.contains(proc))
     {
-#ifdef WIN32
-        if(str.contains("\n"))
-        {
-            insertPlainText("\n");
-        }
-        else
-#endif // WIN32
-        {
-            moveCursor( QTextCursor::End, QTextCursor::MoveAnchor );
-            moveCursor( QTextCursor::StartOfLine, QTextCursor::MoveAnchor );
-            moveCursor( QTextCursor::End, QTextCursor::KeepAnchor );
-            textCursor().removeSelectedText();
-        }
-
-
-#ifdef WIN32
-        str = str.split("\r").last().remove("\r").remove("\n");
-#else
-        str = str.split("\r").last();
-#endif
+        output(running[proc], proc->readAllStandardError(), Qt::red);
     }
+}
 
-    insertPlainText(str);
-    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+void CShell::readStdout(QProcess * proc)
+{
+    if(running.contains(proc))
+    {
+        output(running[proc], proc->readAllStandardOutput(), Qt::blue);
+    }
 }
 
-void CShell::slotStdout()
+void CShell::output(qint32 idx, QString str, const QColor& color)
 {
-    QString str;
-    setTextColor(Qt::blue);
-    str = cmd.readAllStandardOutput();
+    if(str.isEmpty())
+    {
+        return;
+    }
+
+    setTextColor(color);
+    moveCursor(QTextCursor::End);
+
+    // a new line has to be started if another command has written last
+    bool tag = idx != lastOutput;
 
     if(str[0] == '\r')
     {
@@ -102,14 +95,18 @@ void CShell::slotStdout()
         if(str.contains("\n"))
         {
             insertPlainText("\n");
+            tag = true;
         }
         else
 #endif // WIN32
+        if(!tag)
         {
+            // replace the last line, including the tag
             moveCursor( QTextCursor::End, QTextCursor::MoveAnchor );
             moveCursor( QTextCursor::StartOfLine, QTextCursor::MoveAnchor );
             moveCursor( QTextCursor::End, QTextCursor::KeepAnchor );
             textCursor().removeSelectedText();
+            tag = true;
         }
 
 #ifdef WIN32
@@ -119,6 +116,16 @@ void CShell::slotStdout()
 #endif
     }
 
+    if(tag)
+    {
+        if(!textCursor().atBlockStart())
+        {
+            insertPlainText("\n");
+        }
+        insertPlainText(QString("[%1] ").arg(idx + 1));
+        lastOutput = idx;
+    }
+
     insertPlainText(str);
     verticalScrollBar()->setValue(verticalScrollBar()->maximum());
 }
@@ -127,6 +134,7 @@ void CShell::stdOut(const QString& str)
 {
     setTextColor(Qt::black);
     append(str);
+    lastOutput = -1;
 }
 
 
@@ -134,65 +142,180 @@ void CShell::stdErr(const QString& str)
 {
     setTextColor(Qt::red);
     append(str);
+    lastOutput = -1;
 }
 
 
-void CShell::slotFinished(int exitCode, QProcess::ExitStatus status)
+void CShell::processFinished(QProcess * proc, int exitCode, QProcess::ExitStatus status)
 {
+    if(!running.contains(proc))
+    {
+        return;
+    }
+
+    // get the rest of the output before the process is gone
+    readStdout(proc);
+    readStderr(proc);
+
     if(exitCode || status)
     {
-        emit sigFinishedJob(jobId);
-        setTextColor(Qt::red);
-        append(tr("!!! failed !!!\n"));
+        stdErr(tr("!!! [%1] failed !!!\n").arg(running[proc] + 1));
+        endCommand(proc, eStateFailed);
         return;
     }
 
-    ++idxCommand;
-    nextCommand();
+    endCommand(proc, eStateDone);
 }
 
 void CShell::slotCancel()
 {
-    if(cmd.state() == QProcess::NotRunning)
+    if(running.isEmpty())
     {
         return;
     }
 
     stdOut(tr("\nCanceled by user's request.\n"));
-    cmd.kill();
-    cmd.waitForFinished(10000);
+    isCanceled = true;
+
+    const QList<QProcess*>& procs = running.keys();
+    for(QProcess * proc : procs)
+    {
+        proc->kill();
+    }
+    for(QProcess * proc : procs)
+    {
+        proc->waitForFinished(10000);
+    }
 }
 
 int CShell::execute(QList<CShellCmd> cmds)
 {
     CMainWindow::self().makeShellVisible();
 
-    if(cmd.state() != QProcess::NotRunning)
+    if(!isFinished)
     {
         return -1;
     }
 
     clear();
 
-    idxCommand  = 0;
     commands    = cmds;
+    states.fill(eStatePending, commands.size());
+    isCanceled  = false;
+    isFinished  = false;
+    lastOutput  = -1;
 
-    nextCommand();
+    // start deferred as the caller has to know the job ID before the job finishes
+    QTimer::singleShot(0, this, &CShell::nextCommand);
     return ++jobId;
 }
 
+void CShell::startCommand(qint32 idx)
+{
+    const CShellCmd& command = commands[idx];
+
+    QProcess * proc = new QProcess(this);
+    connect(proc, &QProcess::readyReadStandardError,  this, [this, proc](){readStderr(proc);});
+    connect(proc, &QProcess::readyReadStandardOutput, this, [this, proc](){readStdout(proc);});
+    connect(proc, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [this, proc](int exitCode, QProcess::ExitStatus status)
+    {
+        processFinished(proc, exitCode, status);
+    });
+    connect(proc, &QProcess::errorOccurred, this, [this, proc](QProcess::ProcessError error){processError(proc, error);});
+
+    states[idx]     = eStateRunning;
+    running[proc]   = idx;
+
+    stdOut(QString("[%1] ").arg(idx + 1) + command.getCmd() + " " + command.getArgs().join(" ") + "\n");
+    proc->start(command.getCmd(), command.getArgs());
+}
+
+void CShell::endCommand(QProcess * proc, state_e state)
+{
+    states[running.take(proc)] = state;
+    proc->deleteLater();
+
+    nextCommand();
+}
 
 void CShell::nextCommand()
 {
-    if(idxCommand >= commands.size())
+    if(isFinished)
+    {
+        return;
+    }
+
+    const qint32 maxJobs = IAppSetup::self().getMaxParallelJobs();
+    const qint32 N = commands.size();
+    for(qint32 idx = 0; idx < N; idx++)
+    {
+        if(states[idx] != eStatePending)
+        {
+            continue;
+        }
+
+        if(isCanceled)
+        {
+            states[idx] = eStateSkipped;
+            continue;
+        }
+
+        bool ready  = true;
+        bool skip   = false;
+        for(qint32 dependency : commands[idx].getDependencies())
+        {
+            // only previous commands are valid dependencies
+            if((dependency < 0) || (dependency >= idx))
+            {
+                continue;
+            }
+
+            const state_e state = states[dependency];
+            if((state == eStateFailed) || (state == eStateSkipped))
+            {
+                skip = true;
+            }
+            else if(state != eStateDone)
+            {
+                ready = false;
+            }
+        }
+
+        if(skip)
+        {
+            // skipped commands are treated like failed ones by all commands depending on them
+            states[idx] = eStateSkipped;
+            stdErr(tr("[%1] skipped as a previous step failed.\n").arg(idx + 1));
+        }
+        else if(ready && (running.size() < maxJobs))
+        {
+            startCommand(idx);
+        }
+    }
+
+    // starting a command can end the job, too, if the command fails to start
+    if(isFinished || !running.isEmpty())
     {
-        emit sigFinishedJob(jobId);
-        setTextColor(Qt::darkGreen);
-        append(tr("!!! done !!!\n"));
         return;
     }
 
-    const CShellCmd& command = commands[idxCommand];
-    stdOut(command.getCmd() + " " + command.getArgs().join(" ") + "\n");
-    cmd.start(command.getCmd(), command.getArgs());
+    isFinished = true;
+
+    bool ok = !isCanceled;
+    for(state_e state : states)
+    {
+        ok = ok && (state == eStateDone);
+    }
+
+    emit sigFinishedJob(jobId);
+    if(ok)
+    {
+        setTextColor(Qt::darkGreen);
+        append(tr("!!! done !!!\n"));
+    }
+    else
+    {
+        setTextColor(Qt::red);
+        append(tr("!!! failed !!!\n"));
+    }
 }
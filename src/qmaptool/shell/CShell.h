@@ -21,10 +21,21 @@
 
 #include "shell/CShellCmd.h"
 
+#include <QHash>
 #include <QList>
 #include <QProcess>
 #include <QTextBrowser>
+#include <QVector>
 
+/**
+   @brief Run a list of external commands and show their output
+
+   The commands are run in parallel as far as their dependencies allow it,
+   up to the number of parallel jobs configured in the setup. Whenever the
+   output switches from one command to another a new line is started and
+   tagged with the number of the command. If a command fails all commands
+   depending on it are skipped. Independent commands are run anyway.
+ */
 class CShell : public QTextBrowser
 {
     Q_OBJECT
@@ -43,27 +54,47 @@ signals:
 public slots:
     void slotCancel();
 
-protected slots:
+protected:
+    enum state_e
+    {
+        eStatePending
+        , eStateRunning
+        , eStateDone
+        , eStateFailed
+        , eStateSkipped
+    };
+
     /// read the stderr from the process and paste it into the text browser
-    void slotStderr();
+    void readStderr(QProcess * proc);
     /// read the stdout from the process and paste it into the text browser
-    void slotStdout();
-    void slotError(QProcess::ProcessError error);
-    virtual void slotFinished(int exitCode, QProcess::ExitStatus status);
+    void readStdout(QProcess * proc);
+    void processError(QProcess * proc, QProcess::ProcessError error);
+    void processFinished(QProcess * proc, int exitCode, QProcess::ExitStatus status);
 
-protected:
+    /// start all commands with their dependencies fulfilled, report the end of the job
     void nextCommand();
+    /// start the command with the given index
+    void startCommand(qint32 idx);
+    /// the command with the given index is done. Successful or not.
+    void endCommand(QProcess * proc, state_e state);
 
+    /// write the text of a command's output channel to the text browser
+    void output(qint32 idx, QString str, const QColor& color);
     /// write text to stdout color channel of the text browser
     void stdOut(const QString& str);
     /// write text to stderr color channel of the text browser
     void stdErr(const QString& str);
 
-    QProcess cmd;
+    /// all processes currently running with the index of their command
+    QHash<QProcess*, qint32> running;
 
     QList<CShellCmd> commands;
-    qint32 idxCommand = 0;
+    QVector<state_e> states;
     qint32 jobId = 0;
+    bool isCanceled = false;
+    bool isFinished = true;
+    /// the command that wrote the last text into the text browser
+    qint32 lastOutput = -1;
 
 private:
     friend class Ui_IMainWindow;
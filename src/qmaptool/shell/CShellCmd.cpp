@@ -18,9 +18,10 @@
 
 #include "shell/CShellCmd.h"
 
-CShellCmd::CShellCmd(const QString &cmd, const QStringList &args)
+CShellCmd::CShellCmd(const QString &cmd, const QStringList &args, const QList<qint32>& dependencies)
     : cmd(cmd)
     , args(args)
+    , dependencies(dependencies)
 {
 }
 
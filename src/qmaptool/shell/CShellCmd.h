@@ -19,13 +19,23 @@
 #ifndef CSHELLCMD_H
 #define CSHELLCMD_H
 
+#include <QList>
 #include <QString>
 #include <QStringList>
 
+/**
+   @brief A single call of an external tool
+
+   A command can depend on other commands of the same list. The dependencies
+   are given as indices into the list passed to CShell::execute(). Only commands
+   before the command itself are valid dependencies, others are ignored. By that
+   the list is always a directed acyclic graph. A command is started as soon as
+   all of it's dependencies have finished successfully.
+ */
 class CShellCmd
 {
 public:
-    CShellCmd(const QString& cmd, const QStringList& args);
+    CShellCmd(const QString& cmd, const QStringList& args, const QList<qint32>& dependencies = QList<qint32>());
     virtual ~CShellCmd() = default;
 
     const QString& getCmd() const
@@ -38,9 +48,15 @@ public:
         return args;
     }
 
+    const QList<qint32>& getDependencies() const
+    {
+        return dependencies;
+    }
+
 private:
     QString cmd;
     QStringList args;
+    QList<qint32> dependencies;
 };
 
 #endif //CSHELLCMD_H
@@ -172,10 +172,11 @@ void CToolCutMap::buildCmd(QList<CShellCmd>& cmds, const IItem *iitem)
     args << inFilename;
     args << outFilename;
 
+    const qint32 idxWarp = cmds.size();
     cmds << CShellCmd(IAppSetup::self().getGdalwarp(), args);
 
     // ---- command 2 ----------------------
-    groupOverviews->buildCmd(cmds, outFilename, context->is32BitRgb() ? "cubic" : "nearest");
+    groupOverviews->buildCmd(cmds, outFilename, context->is32BitRgb() ? "cubic" : "nearest", idxWarp);
 }
 
 void CToolCutMap::slotStart()
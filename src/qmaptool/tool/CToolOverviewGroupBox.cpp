@@ -52,7 +52,7 @@ void CToolOverviewGroupBox::loadSettings(QSettings& cfg)
 }
 
 
-void CToolOverviewGroupBox::buildCmd(QList<CShellCmd>& cmds, const QString& filename, const QString& resampling)
+void CToolOverviewGroupBox::buildCmd(QList<CShellCmd>& cmds, const QString& filename, const QString& resampling, qint32 dependency)
 {
     if(isChecked())
     {
@@ -90,6 +90,6 @@ void CToolOverviewGroupBox::buildCmd(QList<CShellCmd>& cmds, const QString& file
         {
             args << "64";
         }
-        cmds << CShellCmd(IAppSetup::self().getGdaladdo(), args);
+        cmds << CShellCmd(IAppSetup::self().getGdaladdo(), args, {dependency});
     }
 }
@@ -36,7 +36,7 @@ public:
     void loadSettings(QSettings& cfg);
 
 
-    void buildCmd(QList<CShellCmd>& cmds, const QString& filename, const QString &resampling);
+    void buildCmd(QList<CShellCmd>& cmds, const QString& filename, const QString &resampling, qint32 dependency);
 };
 
 #endif //CTOOLOVERVIEWGROUPBOX_H
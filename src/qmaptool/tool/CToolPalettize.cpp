@@ -179,6 +179,7 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
     args.clear();
     args << vrtFilename;
     args << "-input_file_list" << inputFileList1->fileName();
+    const qint32 idxVrt = cmds.size();
     cmds << CShellCmd(IAppSetup::self().getGdalbuildvrt(), args);
 
     // ---- command 2 ----------------------
@@ -186,7 +187,8 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
     args.clear();
     args << "--sct" << pctFilename;
     args << vrtFilename;
-    cmds << CShellCmd(IAppSetup::self().getQmtrgb2pct(), args);
+    const qint32 idxPct = cmds.size();
+    cmds << CShellCmd(IAppSetup::self().getQmtrgb2pct(), args, {idxVrt});
 
     // ---- command 2..2 + N ----------------------
     if(radioCombined->isChecked())
@@ -194,6 +196,9 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
         inputFileList2->open();
         QTextStream stream(inputFileList2);
 
+        // all files have to be palettized before they are combined
+        QList<qint32> idxFiles;
+
         const int N = itemList->count();
         for(int n = 0; n < N; n++)
         {
@@ -211,7 +216,8 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
             args << "--pct" << pctFilename;
             args << inFilename;
             args << outFilename;
-            cmds << CShellCmd(IAppSetup::self().getQmtrgb2pct(), args);
+            idxFiles << cmds.size();
+            cmds << CShellCmd(IAppSetup::self().getQmtrgb2pct(), args, {idxPct});
         }
 
         inputFileList2->close();
@@ -221,7 +227,8 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
         args.clear();
         args << vrtFilename;
         args << "-input_file_list" << inputFileList2->fileName();
-        cmds << CShellCmd(IAppSetup::self().getGdalbuildvrt(), args);
+        const qint32 idxVrtFiles = cmds.size();
+        cmds << CShellCmd(IAppSetup::self().getGdalbuildvrt(), args, idxFiles);
 
         // ---- command 2 + N + 2 ----------------------
         QString outFilename = lineFilename->text();        
@@ -235,7 +242,8 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
         args << "-co" << "COMPRESS=LZW";
         args << vrtFilename;
         args << outFilename;
-        cmds << CShellCmd(IAppSetup::self().getGdaltranslate(), args);
+        qint32 idxLast = cmds.size();
+        cmds << CShellCmd(IAppSetup::self().getGdaltranslate(), args, {idxVrtFiles});
 
         QString lastOutFilname = outFilename;
         // ---- command 2 + N + 3 ----------------------
@@ -245,12 +253,13 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
             QString vrtFilename = fi.absoluteDir().absoluteFilePath(fi.completeBaseName() + ".vrt");
             args.clear();
             args << vrtFilename << outFilename;
-            cmds << CShellCmd(IAppSetup::self().getGdalbuildvrt(), args);
+            cmds << CShellCmd(IAppSetup::self().getGdalbuildvrt(), args, {idxLast});
+            idxLast = cmds.size() - 1;
             lastOutFilname = vrtFilename;
         }
 
         // ---- command 2 + N + 4 ----------------------
-        groupOverviews->buildCmd(cmds, lastOutFilname, "nearest");
+        groupOverviews->buildCmd(cmds, lastOutFilname, "nearest", idxLast);
     }
     else
     {
@@ -272,7 +281,8 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
             args << "--pct" << pctFilename;
             args << inFilename;
             args << outFilename;
-            cmds << CShellCmd(IAppSetup::self().getQmtrgb2pct(), args);
+            qint32 idxLast = cmds.size();
+            cmds << CShellCmd(IAppSetup::self().getQmtrgb2pct(), args, {idxPct});
 
             QString lastOutFilname = outFilename;
             // ---- command n*3 + 1 ----------------------
@@ -282,12 +292,13 @@ void CToolPalettize::buildCmdFinal(QList<CShellCmd>& cmds)
                 QString vrtFilename = fi.absoluteDir().absoluteFilePath(fi.completeBaseName() + ".vrt");
                 args.clear();
                 args << vrtFilename << outFilename;
-                cmds << CShellCmd(IAppSetup::self().getGdalbuildvrt(), args);
+                cmds << CShellCmd(IAppSetup::self().getGdalbuildvrt(), args, {idxLast});
+                idxLast = cmds.size() - 1;
                 lastOutFilname = vrtFilename;
             }
 
             // ---- command n*3 + 2 ----------------------
-            groupOverviews->buildCmd(cmds, lastOutFilname, "nearest");
+            groupOverviews->buildCmd(cmds, lastOutFilname, "nearest", idxLast);
         }
     }
 }
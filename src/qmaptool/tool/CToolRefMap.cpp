@@ -171,6 +171,7 @@ void CToolRefMap::buildCmd(QList<CShellCmd>& cmds, const IItem *iitem)
     QString tmpname1    = createTempFile("tif");
     QString inFilename  = item->getFilename();
     args << inFilename << tmpname1;
+    const qint32 idxTranslate1 = cmds.size();
     cmds << CShellCmd(IAppSetup::self().getGdaltranslate(), args);
 
     // ---- command 2 ----------------------
@@ -202,7 +203,8 @@ void CToolRefMap::buildCmd(QList<CShellCmd>& cmds, const IItem *iitem)
 
     QString tmpname2 = createTempFile("tif");
     args << tmpname1 << tmpname2;
-    cmds << CShellCmd(IAppSetup::self().getGdalwarp(), args);
+    const qint32 idxWarp = cmds.size();
+    cmds << CShellCmd(IAppSetup::self().getGdalwarp(), args, {idxTranslate1});
 
     // ---- command 3 ----------------------
     QFileInfo fi(inFilename);
@@ -211,7 +213,8 @@ void CToolRefMap::buildCmd(QList<CShellCmd>& cmds, const IItem *iitem)
     args.clear();
     args << "-co" << "tiled=yes" << "-co" << "compress=deflate";
     args << tmpname2 << outFilename;
-    cmds << CShellCmd(IAppSetup::self().getGdaltranslate(), args);
+    qint32 idxLast = cmds.size();
+    cmds << CShellCmd(IAppSetup::self().getGdaltranslate(), args, {idxWarp});
 
     QString lastOutFilname = outFilename;
     // ---- command 4 ----------------------
@@ -221,12 +224,13 @@ void CToolRefMap::buildCmd(QList<CShellCmd>& cmds, const IItem *iitem)
         QString vrtFilename = fi.absoluteDir().absoluteFilePath(fi.completeBaseName() + ".vrt");
         args.clear();
         args << vrtFilename << outFilename;
-        cmds << CShellCmd(IAppSetup::self().getGdalbuildvrt(), args);
+        cmds << CShellCmd(IAppSetup::self().getGdalbuildvrt(), args, {idxLast});
+        idxLast = cmds.size() - 1;
         lastOutFilname = vrtFilename;
     }
 
     // ---- command 5 ----------------------
-    groupOverviews->buildCmd(cmds, lastOutFilname, context->is32BitRgb() ? "cubic" : "nearest");
+    groupOverviews->buildCmd(cmds, lastOutFilname, context->is32BitRgb() ? "cubic" : "nearest", idxLast);
 
     pj_free(pjsrc);
     pj_free(pjtar);
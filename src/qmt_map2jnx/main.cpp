@@ -26,12 +26,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include <wctype.h>
 
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <list>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <gdal_priv.h>
@@ -61,6 +69,9 @@ extern "C"
 
 #define HEADER_BLOCK_SIZE   1024
 
+/// the number of tiles an encoder thread may be ahead of the writer
+#define TILES_AHEAD_PER_THREAD  4
+
 #pragma pack(1)
 
 struct jnx_hdr_t
@@ -173,14 +184,103 @@ static projPJ wgs84;
 static jnx_hdr_t jnx_hdr;
 /// the tile information table for all 5 levels
 static jnx_tile_t tileTable[JNX_MAX_TILES * 5];
-/// tile buffer for 8 bit palette tiles, private to readTile
-static uint8_t  tileBuf8Bit[JNX_MAX_TILE_SIZE * JNX_MAX_TILE_SIZE] = {0};
-/// tile buffer for 24 bit raw RGB tiles, private to writeTile
-static uint8_t tileBuf24Bit[JNX_MAX_TILE_SIZE * JNX_MAX_TILE_SIZE * 3] = {0};
-/// tile buffer for 32 bit raw RGBA tiles
-static uint32_t tileBuf32Bit[JNX_MAX_TILE_SIZE * JNX_MAX_TILE_SIZE] = {0};
-/// internal jpeg buffer used by write tile.
-static std::vector<JOCTET> jpgbuf;
+
+/// a tile to be read from a file and to be encoded as JPEG
+struct job_t
+{
+    file_t * file;
+    uint32_t xoff;
+    uint32_t yoff;
+    uint32_t xsize;
+    uint32_t ysize;
+};
+
+/// the encoded tile waiting for the writer
+struct result_t
+{
+    result_t() : done(false), ok(false){}
+    bool done;
+    bool ok;
+    std::vector<JOCTET> jpg;
+};
+
+/**
+   The tiles are read and encoded by several threads, each with it's own
+   GDAL dataset handles and buffers. The results are written in the order
+   of the jobs. Thus the output does not depend on the number of threads.
+ */
+struct pipeline_t
+{
+    pipeline_t() : nextJob(0), nextWrite(0), window(0), abort(false){}
+    std::vector<job_t> jobs;
+    std::vector<result_t> results;
+    /// the next job to be taken by an encoder thread
+    std::atomic<uint32_t> nextJob;
+    /// the next job to be written, guarded by mutex
+    uint32_t nextWrite;
+    /// the number of jobs an encoder may be ahead of the writer
+    uint32_t window;
+    /// stop all encoders, guarded by mutex
+    bool abort;
+    int quality;
+    int subsampling;
+
+    std::mutex mutex;
+    /// signaled when a result is done
+    std::condition_variable resultDone;
+    /// signaled when the writer proceeds
+    std::condition_variable resultWritten;
+};
+
+/// buffers and GDAL handles private to one encoder thread
+struct worker_t
+{
+    worker_t()
+        : datasetFile(0)
+        , dataset(0)
+        , tileBuf8Bit(JNX_MAX_TILE_SIZE * JNX_MAX_TILE_SIZE)
+        , tileBuf24Bit(JNX_MAX_TILE_SIZE * JNX_MAX_TILE_SIZE * 3)
+        , tileBuf32Bit(JNX_MAX_TILE_SIZE * JNX_MAX_TILE_SIZE)
+    {
+    }
+
+    ~worker_t()
+    {
+        if(dataset != 0)
+        {
+            GDALClose(dataset);
+        }
+    }
+
+    /**
+       GDAL datasets must not be shared by threads. Each thread opens it's own.
+       Only the dataset of the current file is kept open. The tiles are read
+       file by file, thus it is closed as soon as the worker moves on.
+     */
+    GDALDataset * getDataset(file_t& file)
+    {
+        if(datasetFile != &file)
+        {
+            if(dataset != 0)
+            {
+                GDALClose(dataset);
+            }
+            dataset     = (GDALDataset*)GDALOpen(file.filename.c_str(), GA_ReadOnly);
+            datasetFile = &file;
+        }
+        return dataset;
+    }
+
+    /// the file the dataset belongs to
+    file_t * datasetFile;
+    GDALDataset * dataset;
+    /// tile buffer for 8 bit palette tiles, private to readTile
+    std::vector<uint8_t> tileBuf8Bit;
+    /// tile buffer for 24 bit raw RGB tiles, private to encodeTile
+    std::vector<uint8_t> tileBuf24Bit;
+    /// tile buffer for 32 bit raw RGBA tiles
+    std::vector<uint32_t> tileBuf32Bit;
+};
 
 static void prinfFileinfo(const file_t& file)
 {
@@ -202,9 +302,16 @@ static void prinfFileinfo(const file_t& file)
     printf("\nreal scale: %f m/px", file.scale);
 }
 
-bool readTile(uint32_t xoff, uint32_t yoff, uint32_t xsize, uint32_t ysize, file_t& file, uint32_t * output)
+static bool readTile(uint32_t xoff, uint32_t yoff, uint32_t xsize, uint32_t ysize, file_t& file, worker_t& worker)
 {
-    GDALDataset * dataset = file.dataset;
+    GDALDataset * dataset = worker.getDataset(file);
+    if(dataset == 0)
+    {
+        return false;
+    }
+
+    uint32_t * output       = worker.tileBuf32Bit.data();
+    uint8_t * tileBuf8Bit   = worker.tileBuf8Bit.data();
     int32_t rasterBandCount = dataset->GetRasterCount();
 
     memset(output,-1, sizeof(uint32_t) * xsize * ysize);
@@ -255,6 +362,7 @@ bool readTile(uint32_t xoff, uint32_t yoff, uint32_t xsize, uint32_t ysize, file
 
 static void init_destination (j_compress_ptr cinfo)
 {
+    std::vector<JOCTET>& jpgbuf = *(std::vector<JOCTET>*)cinfo->client_data;
     jpgbuf.resize(JPG_BLOCK_SIZE);
     cinfo->dest->next_output_byte   = &jpgbuf[0];
     cinfo->dest->free_in_buffer     = jpgbuf.size();
@@ -262,6 +370,7 @@ static void init_destination (j_compress_ptr cinfo)
 
 static boolean empty_output_buffer (j_compress_ptr cinfo)
 {
+    std::vector<JOCTET>& jpgbuf = *(std::vector<JOCTET>*)cinfo->client_data;
     size_t oldsize = jpgbuf.size();
     jpgbuf.resize(oldsize + JPG_BLOCK_SIZE);
     cinfo->dest->next_output_byte   = &jpgbuf[oldsize];
@@ -271,13 +380,15 @@ static boolean empty_output_buffer (j_compress_ptr cinfo)
 
 static void term_destination (j_compress_ptr cinfo)
 {
+    std::vector<JOCTET>& jpgbuf = *(std::vector<JOCTET>*)cinfo->client_data;
     jpgbuf.resize(jpgbuf.size() - cinfo->dest->free_in_buffer);
 }
 
 
-static uint32_t writeTile(uint32_t xsize, uint32_t ysize, uint32_t * raw_image, FILE * fid, int quality, int subsampling)
+static void encodeTile(uint32_t xsize, uint32_t ysize, worker_t& worker, std::vector<JOCTET>& jpgbuf, int quality, int subsampling)
 {
-    uint32_t size = 0;
+    uint32_t * raw_image    = worker.tileBuf32Bit.data();
+    uint8_t * tileBuf24Bit  = worker.tileBuf24Bit.data();
     struct jpeg_compress_struct cinfo;
     struct jpeg_error_mgr jerr;
     JSAMPROW row_pointer[1];
@@ -302,6 +413,7 @@ static uint32_t writeTile(uint32_t xsize, uint32_t ysize, uint32_t * raw_image,
     cinfo.err = jpeg_std_error( &jerr );
     jpeg_create_compress(&cinfo);
 
+    cinfo.client_data       = &jpgbuf;
     cinfo.dest              = &destmgr;
     cinfo.image_width       = xsize;
     cinfo.image_height      = ysize;
@@ -362,12 +474,46 @@ static uint32_t writeTile(uint32_t xsize, uint32_t ysize, uint32_t * raw_image,
     /* similar to read file, clean up after we're done compressing */
     jpeg_finish_compress( &cinfo );
     jpeg_destroy_compress( &cinfo );
+}
 
-    // write data to output file
-    size = jpgbuf.size() - 2;
-    fwrite(&jpgbuf[2], size, 1, fid);
+/// the encoder thread: read and encode tiles until all jobs are taken
+static void encodeTiles(pipeline_t& pipeline)
+{
+    worker_t worker;
+
+    while(true)
+    {
+        const uint32_t idx = pipeline.nextJob++;
+        if(idx >= pipeline.jobs.size())
+        {
+            break;
+        }
+
+        {
+            // do not run too far ahead of the writer, else memory will grow
+            std::unique_lock<std::mutex> lock(pipeline.mutex);
+            pipeline.resultWritten.wait(lock, [&]{return pipeline.abort || idx < pipeline.nextWrite + pipeline.window;});
+            if(pipeline.abort)
+            {
+                break;
+            }
+        }
+
+        const job_t& job    = pipeline.jobs[idx];
+        result_t& result    = pipeline.results[idx];
+
+        result.ok = readTile(job.xoff, job.yoff, job.xsize, job.ysize, *job.file, worker);
+        if(result.ok)
+        {
+            encodeTile(job.xsize, job.ysize, worker, result.jpg, pipeline.quality, pipeline.subsampling);
+        }
 
-    return size;
+        {
+            std::lock_guard<std::mutex> lock(pipeline.mutex);
+            result.done = true;
+        }
+        pipeline.resultDone.notify_all();
+    }
 }
 
 static double distance(const double u1, const double v1, const double u2, const double v2)
@@ -532,6 +678,7 @@ int main(int argc, char ** argv)
     OGRSpatialReference oSRS;
     int quality         = -1;
     int subsampling     = -1;
+    int nThreads        = std::thread::hardware_concurrency();
 
     const char *copyright = "Unknown";
     const char *subscname = "BirdsEye";
@@ -547,7 +694,7 @@ int main(int argc, char ** argv)
 
     if(argc < 2)
     {
-        fprintf(stderr,"\nusage: qmt_map2jnx -q <1..100> -s <411|422|444> -p <0..> -c \"copyright notice\" -m \"BirdsEye\" -n \"Unknown\" -x file1_scale,file2_scale,...,fileN_scale <file1> <file2> ... <fileN> <outputfile>\n");
+        fprintf(stderr,"\nusage: qmt_map2jnx -q <1..100> -s <411|422|444> -p <0..> -c \"copyright notice\" -m \"BirdsEye\" -n \"Unknown\" -x file1_scale,file2_scale,...,fileN_scale -t <1..> <file1> <file2> ... <fileN> <outputfile>\n");
         fprintf(stderr,"\n");
         fprintf(stderr,"  -q The JPEG quality from 1 to 100. Default is 75 \n");
         fprintf(stderr,"  -s The chroma subsampling. Default is 411  \n");
@@ -557,6 +704,7 @@ int main(int argc, char ** argv)
         fprintf(stderr,"  -n The map name. Default is \"Unknown\"  \n");
         fprintf(stderr,"  -z The z order (drawing order). Default is 25\n");
         fprintf(stderr,"  -x Override levels scale. Default: autodetect\n");
+        fprintf(stderr,"  -t, --threads The number of threads to encode tiles. Default is the number of CPU cores\n");
         fprintf(stderr,"\n");
         fprintf(stderr,"\nThe projection of the input files must have the same latitude along");
         fprintf(stderr,"\na pixel row. Mecator and Longitude/Latitude projections match this");
@@ -606,7 +754,13 @@ int main(int argc, char ** argv)
 
         if (argv[i][0] == '-')
         {
-            if (towupper(argv[i][1]) == 'Q')
+            if ((strcmp(argv[i], "--threads") == 0) || (towupper(argv[i][1]) == 'T'))
+            {
+                nThreads = atol(argv[i+1]);
+                skip_next_arg = 1;
+                continue;
+            }
+            else if (towupper(argv[i][1]) == 'Q')
             {
                 quality = atol(argv[i+1]);
                 skip_next_arg = 1;
@@ -930,8 +1084,12 @@ int main(int argc, char ** argv)
     fwrite(tileTable, sizeof(jnx_tile_t), tilesTotal, fid);
 
     // --------------------------------------------------------------
-    // read tiles from input files and write jpeg coded tiles to output file
-    printf("\n\nStart conversion:\n");
+    // collect all tiles in the order they are written to the output file
+    pipeline_t pipeline;
+    pipeline.quality     = quality;
+    pipeline.subsampling = subsampling;
+    pipeline.jobs.reserve(tilesTotal);
+
     for(int l = 0; l < nLevels; l++)
     {
         level_t& level = levels[l];
@@ -965,11 +1123,8 @@ int main(int argc, char ** argv)
                     }
 
                     // //
-                    if(!readTile(xoff, yoff, xsize, ysize, file, tileBuf32Bit))
-                    {
-                        fprintf(stderr,"\nError reading tiles from map file\n");
-                        exit(-1);
-                    }
+                    job_t job = {&file, xoff, yoff, xsize, ysize};
+                    pipeline.jobs.push_back(job);
 
                     jnx_tile_t& tile = tileTable[tileCnt++];
                     if(pj_is_latlong(file.pj))
@@ -1005,10 +1160,6 @@ int main(int argc, char ** argv)
 
                     tile.width  = xsize;
                     tile.height = ysize;
-                    tile.offset = (uint32_t)(ftello(fid) & 0x0FFFFFFFF);
-                    tile.size   = writeTile(xsize, ysize, tileBuf32Bit, fid, quality, subsampling);
-
-                    printProgress(tileCnt, tilesTotal);
                     // //
                     xoff += xsize;
                 }
@@ -1018,6 +1169,75 @@ int main(int argc, char ** argv)
         }
     }
 
+    // --------------------------------------------------------------
+    // read tiles from input files and write jpeg coded tiles to output file
+    if(nThreads < 1)
+    {
+        nThreads = 1;
+    }
+    printf("\n\nStart conversion with %i threads:\n", nThreads);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    pipeline.results.resize(pipeline.jobs.size());
+    pipeline.window = nThreads * TILES_AHEAD_PER_THREAD;
+
+    std::vector<std::thread> encoders;
+    for(int i = 0; i < nThreads; i++)
+    {
+        encoders.push_back(std::thread(encodeTiles, std::ref(pipeline)));
+    }
+
+    bool ok = true;
+    const uint32_t N = pipeline.jobs.size();
+    for(uint32_t i = 0; i < N; i++)
+    {
+        result_t& result = pipeline.results[i];
+        {
+            std::unique_lock<std::mutex> lock(pipeline.mutex);
+            pipeline.resultDone.wait(lock, [&]{return result.done;});
+        }
+
+        if(!result.ok)
+        {
+            ok = false;
+            break;
+        }
+
+        jnx_tile_t& tile = tileTable[i];
+        tile.offset = (uint32_t)(ftello(fid) & 0x0FFFFFFFF);
+        tile.size   = result.jpg.size() - 2;
+        fwrite(&result.jpg[2], tile.size, 1, fid);
+        std::vector<JOCTET>().swap(result.jpg);
+
+        {
+            std::lock_guard<std::mutex> lock(pipeline.mutex);
+            pipeline.nextWrite = i + 1;
+        }
+        pipeline.resultWritten.notify_all();
+
+        printProgress(i + 1, tilesTotal);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pipeline.mutex);
+        pipeline.abort = true;
+    }
+    pipeline.resultWritten.notify_all();
+    for(std::thread& encoder : encoders)
+    {
+        encoder.join();
+    }
+
+    if(!ok)
+    {
+        fprintf(stderr,"\nError reading tiles from map file\n");
+        exit(-1);
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("\n%u tiles in %.1f s (%.1f tiles/s)", tilesTotal, seconds, seconds > 0 ? tilesTotal / seconds : 0.0);
+
     // terminate output file
     fwrite("BirdsEye", 8, 1, fid);
 
@@ -17,11 +17,15 @@
 **********************************************************************************************/
 
 #include "CApp.h"
+#include "CQuantizer.h"
 
-#include <gdal_alg.h>
 #include <gdal_priv.h>
 #include <iostream>
 
+/// the size of the raster blocks, aligned to the target's tiles. Columns of blocks are dithered in parallel.
+#define BLOCK_WIDTH     1024
+#define BLOCK_HEIGHT    256
+
 const GDALColorEntry CApp::noColor = {255,255,255,0};
 
 void printStdoutQString(const QString& str)
@@ -75,7 +79,7 @@ qint32 CApp::exec()
 
         ct = createColorTable(ncolors, pctFilename, dsSrc);
         saveColorTable(ct, sctFilename);
-        ditherMap(dsSrc, tarFilename, ct);
+        ditherMap(dsSrc, srcFilename, tarFilename, ct);
     }
     catch(const QString& msg)
     {
@@ -96,24 +100,8 @@ GDALColorTable * CApp::createColorTable(qint32 ncolors, const QString& pctFilena
     {
         if(pctFilename.isEmpty())
         {
-            ct = (GDALColorTable*)GDALCreateColorTable(GPI_RGB);
-
             printStdoutQString(tr("Calculate optimal color table from source file"));
-
-            int ok = GDALComputeMedianCutPCT(dataset->GetRasterBand(1),
-                                             dataset->GetRasterBand(2),
-                                             dataset->GetRasterBand(3),
-                                             nullptr,
-                                             ncolors,
-                                             ct,
-                                             GDALTermProgress,
-                                             0
-                                             );
-
-            if(ok != CE_None)
-            {
-                throw tr("Failed to create color table.");
-            }
+            ct = CQuantizer::createColorTable(dataset, ncolors);
         }
         else
         {
@@ -177,7 +165,190 @@ void CApp::saveColorTable(GDALColorTable * ct, QString& sctFilename)
     GDALClose(dataset);
 }
 
-void CApp::ditherMap(GDALDataset * dsSrc, const QString& tarFilename, GDALColorTable *ct)
+namespace
+{
+/// the state shared by all dither threads
+struct dither_t
+{
+    QString srcFilename;
+    /// the target band, guarded by mutex
+    GDALRasterBand * band = nullptr;
+    const CQuantizer * quantizer = nullptr;
+    quint8 nodataTar = 0;
+    bool hasNoData = false;
+    qint32 nodata[3] = {0, 0, 0};
+
+    qint32 xsize = 0;
+    qint32 ysize = 0;
+    qint32 nColumns = 0;
+    qint32 nBlocks = 0;
+
+    QAtomicInt nextColumn;
+    QAtomicInt blocksDone;
+    QAtomicInt abort;
+
+    QMutex mutex;
+    /// the first error of any thread, guarded by mutex
+    QString error;
+};
+
+/**
+   @brief Dither columns of blocks of the source until all columns are done
+
+   Each thread opens it's own handle to the source file. Floyd-Steinberg
+   dithering is applied per column of blocks. The blocks of a column are
+   processed top down and the error of a block's last line is carried into
+   the block below. Thus there are no seams between blocks of a column. As
+   columns are dithered in parallel, the error is not carried across the
+   border between two columns. Transparent and "no data" pixels are set to
+   the target's "no data" value in the same pass.
+ */
+class CDitherWorker : public QRunnable
+{
+public:
+    CDitherWorker(dither_t& dither)
+        : dither(dither)
+    {
+    }
+
+    void run() override
+    {
+        GDALDataset * dsSrc = (GDALDataset*)GDALOpen(dither.srcFilename.toUtf8(), GA_ReadOnly);
+        if(dsSrc == nullptr)
+        {
+            setError(CApp::tr("Failed to open source file."));
+            return;
+        }
+
+        const qint32 nBands = dsSrc->GetRasterCount();
+        QVector<quint8> src(BLOCK_WIDTH * BLOCK_HEIGHT * nBands);
+        QVector<quint8> tar(BLOCK_WIDTH * BLOCK_HEIGHT);
+        int bandMap[4] = {1, 2, 3, 4};
+
+        while(!dither.abort.load())
+        {
+            const qint32 column = dither.nextColumn.fetchAndAddRelaxed(1);
+            if(column >= dither.nColumns)
+            {
+                break;
+            }
+
+            const qint32 x = column * BLOCK_WIDTH;
+            const qint32 w = qMin(BLOCK_WIDTH, dither.xsize - x);
+
+            // the error of the current and the next line, scaled by 16, with a guard on both ends
+            err1.fill(0, (w + 2) * 3);
+            err2.fill(0, (w + 2) * 3);
+
+            for(qint32 y = 0; (y < dither.ysize) && !dither.abort.load(); y += BLOCK_HEIGHT)
+            {
+                const qint32 h = qMin(BLOCK_HEIGHT, dither.ysize - y);
+
+                CPLErr res = dsSrc->RasterIO(GF_Read, x, y, w, h, src.data(), w, h, GDT_Byte, nBands, bandMap, nBands, nBands * w, 1);
+                if(res != CE_None)
+                {
+                    setError(CApp::tr("Failed to read from source file."));
+                    break;
+                }
+
+                ditherBlock(src.constData(), nBands, w, h, tar.data());
+
+                QMutexLocker lock(&dither.mutex);
+                res = dither.band->RasterIO(GF_Write, x, y, w, h, tar.data(), w, h, GDT_Byte, 0, 0);
+                lock.unlock();
+
+                if(res != CE_None)
+                {
+                    setError(CApp::tr("Failed to write to target file."));
+                    break;
+                }
+
+                dither.blocksDone.ref();
+            }
+        }
+
+        GDALClose(dsSrc);
+    }
+
+private:
+    void setError(const QString& msg)
+    {
+        QMutexLocker lock(&dither.mutex);
+        if(dither.error.isEmpty())
+        {
+            dither.error = msg;
+        }
+        dither.abort = 1;
+    }
+
+    void ditherBlock(const quint8 * src, qint32 nBands, qint32 w, qint32 h, quint8 * tar)
+    {
+        // err1 holds the error carried from the block above
+        const qint32 size = (w + 2) * 3;
+        qint32 * cur    = err1.data();
+        qint32 * next   = err2.data();
+
+        const CQuantizer& quantizer = *dither.quantizer;
+
+        for(qint32 y = 0; y < h; y++)
+        {
+            for(qint32 i = 0; i < size; i++)
+            {
+                next[i] = 0;
+            }
+
+            for(qint32 x = 0; x < w; x++, src += nBands, tar++)
+            {
+                if((nBands == 4) && (src[3] != 0xFF))
+                {
+                    *tar = dither.nodataTar;
+                    continue;
+                }
+                if(dither.hasNoData && (src[0] == dither.nodata[0]) && (src[1] == dither.nodata[1]) && (src[2] == dither.nodata[2]))
+                {
+                    *tar = dither.nodataTar;
+                    continue;
+                }
+
+                const qint32 e = (x + 1) * 3;
+                const qint32 c[3] =
+                {
+                    qBound(0, src[0] + ((cur[e    ] + 8) >> 4), 255)
+                    , qBound(0, src[1] + ((cur[e + 1] + 8) >> 4), 255)
+                    , qBound(0, src[2] + ((cur[e + 2] + 8) >> 4), 255)
+                };
+
+                *tar = quantizer.nearest(c[0], c[1], c[2]);
+
+                const GDALColorEntry& color = quantizer.color(*tar);
+                const qint32 d[3] = {c[0] - color.c1, c[1] - color.c2, c[2] - color.c3};
+                for(qint32 k = 0; k < 3; k++)
+                {
+                    cur[e + 3 + k]  += d[k] * 7;
+                    next[e - 3 + k] += d[k] * 3;
+                    next[e + k]     += d[k] * 5;
+                    next[e + 3 + k] += d[k];
+                }
+            }
+
+            qSwap(cur, next);
+        }
+
+        // pass the error of the last line to the block below
+        if(cur != err1.data())
+        {
+            err1.swap(err2);
+        }
+    }
+
+    dither_t& dither;
+
+    QVector<qint32> err1;
+    QVector<qint32> err2;
+};
+}
+
+void CApp::ditherMap(GDALDataset * dsSrc, const QString& srcFilename, const QString& tarFilename, GDALColorTable *ct)
 {
     if(tarFilename.isEmpty())
     {
@@ -212,62 +383,37 @@ void CApp::ditherMap(GDALDataset * dsSrc, const QString& tarFilename, GDALColorT
         dataset->SetGeoTransform(adfGeoTransform);
 
         printStdoutQString(tr("Dither source file to target file"));
-        int res = GDALDitherRGB2PCT(dsSrc->GetRasterBand(1),
-                                    dsSrc->GetRasterBand(2),
-                                    dsSrc->GetRasterBand(3),
-                                    dataset->GetRasterBand(1),
-                                    ct,
-                                    GDALTermProgress,
-                                    0
-                                    );
-        if(res != CE_None)
+
+        CQuantizer quantizer(ct);
+
+        dither_t dither;
+        dither.srcFilename  = srcFilename;
+        dither.band         = dataset->GetRasterBand(1);
+        dither.quantizer    = &quantizer;
+        dither.nodataTar    = quint8(ct->GetColorEntryCount());
+        dither.hasNoData    = CQuantizer::getNoData(dsSrc, dither.nodata);
+        dither.xsize        = xsize;
+        dither.ysize        = ysize;
+        dither.nColumns     = (xsize + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+        dither.nBlocks      = dither.nColumns * ((ysize + BLOCK_HEIGHT - 1) / BLOCK_HEIGHT);
+
+        QThreadPool pool;
+        const qint32 nThreads = qBound(1, QThread::idealThreadCount(), dither.nColumns);
+        for(qint32 i = 0; i < nThreads; i++)
         {
-            throw tr("Failed to dither file.");
+            pool.start(new CDitherWorker(dither));
         }
 
-        if(dsSrc->GetRasterCount() == 3)
+        while(!pool.waitForDone(100))
         {
-            return;
+            GDALTermProgress(double(dither.blocksDone.load()) / dither.nBlocks, 0, 0);
         }
+        GDALTermProgress(1.0,0,0);
 
-        GDALRasterBand * alpha = dsSrc->GetRasterBand(4);
-        GDALRasterBand * band  = dataset->GetRasterBand(1);
-
-        QByteArray buffer1(xsize, 0);
-        QByteArray buffer2(xsize, 0);
-
-        quint8 nodata = band->GetNoDataValue();
-        printStdoutQString(tr("Apply alpha channel as no data value to target file"));
-        for(int y = 0; y < ysize; y++)
+        if(!dither.error.isEmpty())
         {
-            GDALTermProgress(double(xsize * y)/(xsize*ysize),0,0);
-            res = alpha->RasterIO(GF_Read, 0, y, xsize, 1, buffer1.data(), xsize, 1, GDT_Byte, 0, 0);
-            if(res != CE_None)
-            {
-                throw tr("Failed to read from alpha channel.");
-            }
-
-            res = band->RasterIO(GF_Read, 0, y, xsize, 1, buffer2.data(), xsize, 1, GDT_Byte, 0, 0);
-            if(res != CE_None)
-            {
-                throw tr("Failed to read from target file.");
-            }
-
-            for(int x = 0; x < xsize; x++)
-            {
-                if(buffer1[x] != char(0xFF))
-                {
-                    buffer2[x] = nodata;
-                }
-            }
-
-            res = band->RasterIO(GF_Write, 0, y, xsize, 1, buffer2.data(), xsize, 1, GDT_Byte, 0, 0);
-            if(res != CE_None)
-            {
-                throw tr("Failed to write to target file.");
-            }
+            throw dither.error;
         }
-        GDALTermProgress(1.0,0,0);
     }
     catch(const QString& msg)
     {
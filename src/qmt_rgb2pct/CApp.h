@@ -37,7 +37,7 @@ public:
 private:
     static GDALColorTable * createColorTable(qint32 ncolors, const QString& pctFilename, GDALDataset *dataset);
     static void saveColorTable(GDALColorTable *ct, QString &sctFilename);
-    static void ditherMap(GDALDataset * dsSrc, const QString& tarFilename, GDALColorTable *ct);
+    static void ditherMap(GDALDataset * dsSrc, const QString& srcFilename, const QString& tarFilename, GDALColorTable *ct);
 
     qint32 ncolors = 0;
     QString pctFilename;
@@ -0,0 +1,349 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#include "CApp.h"
+#include "CQuantizer.h"
+
+#include <gdal_priv.h>
+
+/// the number of bits per channel of the histogram
+#define HIST_BITS       5
+#define HIST_LEVELS     (1 << HIST_BITS)
+#define HIST_SIZE       (HIST_LEVELS * HIST_LEVELS * HIST_LEVELS)
+/// the number of pixels sampled from the source to create a color table
+#define MAX_SAMPLES     (4 * 1024 * 1024)
+/// the number of buffer lines read at once while sampling
+#define SAMPLE_LINES    64
+
+namespace
+{
+struct histogram_t
+{
+    histogram_t()
+        : count(HIST_SIZE, 0)
+        , sumRed(HIST_SIZE, 0)
+        , sumGreen(HIST_SIZE, 0)
+        , sumBlue(HIST_SIZE, 0)
+    {
+    }
+
+    static qint32 index(const qint32 c[3])
+    {
+        return (c[0] << (2 * HIST_BITS)) | (c[1] << HIST_BITS) | c[2];
+    }
+
+    QVector<quint32> count;
+    /// the sum of all sampled colors of a bin, to get the exact mean color
+    QVector<quint64> sumRed;
+    QVector<quint64> sumGreen;
+    QVector<quint64> sumBlue;
+};
+
+/// a box in the histogram's color space, limits are inclusive
+struct box_t
+{
+    qint32 min[3];
+    qint32 max[3];
+    quint64 count;
+
+    bool isSplittable() const
+    {
+        return (count != 0) && ((min[0] != max[0]) || (min[1] != max[1]) || (min[2] != max[2]));
+    }
+};
+
+/// shrink the box to the bins with samples and count the samples
+void shrinkBox(const histogram_t& hist, box_t& box)
+{
+    qint32 min[3] = {HIST_LEVELS, HIST_LEVELS, HIST_LEVELS};
+    qint32 max[3] = {-1, -1, -1};
+    quint64 count = 0;
+
+    qint32 c[3];
+    for(c[0] = box.min[0]; c[0] <= box.max[0]; c[0]++)
+    {
+        for(c[1] = box.min[1]; c[1] <= box.max[1]; c[1]++)
+        {
+            for(c[2] = box.min[2]; c[2] <= box.max[2]; c[2]++)
+            {
+                const quint32 n = hist.count[histogram_t::index(c)];
+                if(n == 0)
+                {
+                    continue;
+                }
+
+                count += n;
+                for(qint32 i = 0; i < 3; i++)
+                {
+                    min[i] = qMin(min[i], c[i]);
+                    max[i] = qMax(max[i], c[i]);
+                }
+            }
+        }
+    }
+
+    box.count = count;
+    if(count != 0)
+    {
+        for(qint32 i = 0; i < 3; i++)
+        {
+            box.min[i] = min[i];
+            box.max[i] = max[i];
+        }
+    }
+}
+
+/// split the box at the median along it's longest axis
+void splitBox(const histogram_t& hist, box_t& box, box_t& other)
+{
+    qint32 axis = 0;
+    for(qint32 i = 1; i < 3; i++)
+    {
+        if((box.max[i] - box.min[i]) > (box.max[axis] - box.min[axis]))
+        {
+            axis = i;
+        }
+    }
+
+    quint64 slices[HIST_LEVELS] = {0};
+    qint32 c[3];
+    for(c[0] = box.min[0]; c[0] <= box.max[0]; c[0]++)
+    {
+        for(c[1] = box.min[1]; c[1] <= box.max[1]; c[1]++)
+        {
+            for(c[2] = box.min[2]; c[2] <= box.max[2]; c[2]++)
+            {
+                slices[c[axis]] += hist.count[histogram_t::index(c)];
+            }
+        }
+    }
+
+    qint32 split   = box.min[axis];
+    quint64 sum     = 0;
+    for(qint32 i = box.min[axis]; i < box.max[axis]; i++)
+    {
+        sum    += slices[i];
+        split   = i;
+        if(2 * sum >= box.count)
+        {
+            break;
+        }
+    }
+
+    other = box;
+    box.max[axis]   = split;
+    other.min[axis] = split + 1;
+
+    shrinkBox(hist, box);
+    shrinkBox(hist, other);
+}
+
+GDALColorEntry meanColor(const histogram_t& hist, const box_t& box)
+{
+    quint64 sum[3] = {0};
+    qint32 c[3];
+    for(c[0] = box.min[0]; c[0] <= box.max[0]; c[0]++)
+    {
+        for(c[1] = box.min[1]; c[1] <= box.max[1]; c[1]++)
+        {
+            for(c[2] = box.min[2]; c[2] <= box.max[2]; c[2]++)
+            {
+                const qint32 idx = histogram_t::index(c);
+                sum[0] += hist.sumRed[idx];
+                sum[1] += hist.sumGreen[idx];
+                sum[2] += hist.sumBlue[idx];
+            }
+        }
+    }
+
+    GDALColorEntry entry = {0, 0, 0, 255};
+    if(box.count != 0)
+    {
+        entry.c1 = short((sum[0] + box.count / 2) / box.count);
+        entry.c2 = short((sum[1] + box.count / 2) / box.count);
+        entry.c3 = short((sum[2] + box.count / 2) / box.count);
+    }
+    return entry;
+}
+}
+
+CQuantizer::CQuantizer(const GDALColorTable * ct)
+{
+    const qint32 N = qMin(ct->GetColorEntryCount(), 256);
+    for(qint32 i = 0; i < N; i++)
+    {
+        colors << *ct->GetColorEntry(i);
+    }
+
+    if(colors.isEmpty())
+    {
+        colors << GDALColorEntry {0, 0, 0, 255};
+    }
+
+    // pad with entries that are never the nearest ones
+    const qint32 M = (colors.size() + 15) & ~15;
+    red.fill(1024, M);
+    green.fill(1024, M);
+    blue.fill(1024, M);
+    for(qint32 i = 0; i < colors.size(); i++)
+    {
+        red[i]      = colors[i].c1;
+        green[i]    = colors[i].c2;
+        blue[i]     = colors[i].c3;
+    }
+
+    // use the center of each 6 bit bin as reference
+    lookup.resize(1 << 18);
+    for(qint32 i = 0; i < lookup.size(); i++)
+    {
+        lookup[i] = findNearest(((i >> 10) & 0xFC) | 2, ((i >> 4) & 0xFC) | 2, ((i << 2) & 0xFC) | 2);
+    }
+}
+
+quint8 CQuantizer::findNearest(qint32 r, qint32 g, qint32 b) const
+{
+    const qint32 M      = red.size();
+    const qint32 * pr   = red.constData();
+    const qint32 * pg   = green.constData();
+    const qint32 * pb   = blue.constData();
+
+    // keep this loop simple, to be vectorized
+    qint32 dist[256];
+    for(qint32 i = 0; i < M; i++)
+    {
+        const qint32 dr = pr[i] - r;
+        const qint32 dg = pg[i] - g;
+        const qint32 db = pb[i] - b;
+        dist[i] = dr * dr + dg * dg + db * db;
+    }
+
+    qint32 best = 0;
+    for(qint32 i = 1; i < M; i++)
+    {
+        if(dist[i] < dist[best])
+        {
+            best = i;
+        }
+    }
+    return quint8(best);
+}
+
+bool CQuantizer::getNoData(GDALDataset * dataset, qint32 nodata[3])
+{
+    for(qint32 b = 0; b < 3; b++)
+    {
+        int ok = 0;
+        nodata[b] = qint32(dataset->GetRasterBand(b + 1)->GetNoDataValue(&ok));
+        if(!ok)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+GDALColorTable * CQuantizer::createColorTable(GDALDataset * dataset, qint32 ncolors)
+{
+    const qint32 xsize  = dataset->GetRasterXSize();
+    const qint32 ysize  = dataset->GetRasterYSize();
+    const qint32 nBands = dataset->GetRasterCount();
+
+    qint32 nodata[3];
+    const bool hasNoData = getNoData(dataset, nodata);
+
+    // read a decimated version of the source. GDAL will use overviews if there are any.
+    const qreal step    = qMax(1.0, qSqrt(qreal(xsize) * ysize / MAX_SAMPLES));
+    const qint32 bufX   = qBound(1, qRound(xsize / step), xsize);
+    const qint32 bufY   = qBound(1, qRound(ysize / step), ysize);
+
+    histogram_t hist;
+    QVector<quint8> buffer(bufX * SAMPLE_LINES * nBands);
+    int bandMap[4] = {1, 2, 3, 4};
+
+    for(qint32 y = 0; y < bufY; y += SAMPLE_LINES)
+    {
+        GDALTermProgress(double(y) / bufY, 0, 0);
+
+        const qint32 lines  = qMin(SAMPLE_LINES, bufY - y);
+        const qint32 ySrc1  = qint32(qint64(y) * ysize / bufY);
+        const qint32 ySrc2  = qint32(qint64(y + lines) * ysize / bufY);
+
+        CPLErr res = dataset->RasterIO(GF_Read, 0, ySrc1, xsize, ySrc2 - ySrc1, buffer.data(), bufX, lines, GDT_Byte, nBands, bandMap, nBands, nBands * bufX, 1);
+        if(res != CE_None)
+        {
+            throw tr("Failed to read from source file.");
+        }
+
+        const quint8 * pixel = buffer.constData();
+        for(qint32 i = 0; i < bufX * lines; i++, pixel += nBands)
+        {
+            if((nBands == 4) && (pixel[3] != 0xFF))
+            {
+                continue;
+            }
+            if(hasNoData && (pixel[0] == nodata[0]) && (pixel[1] == nodata[1]) && (pixel[2] == nodata[2]))
+            {
+                continue;
+            }
+
+            const qint32 c[3] = {pixel[0] >> (8 - HIST_BITS), pixel[1] >> (8 - HIST_BITS), pixel[2] >> (8 - HIST_BITS)};
+            const qint32 idx = histogram_t::index(c);
+            hist.count[idx]++;
+            hist.sumRed[idx]    += pixel[0];
+            hist.sumGreen[idx]  += pixel[1];
+            hist.sumBlue[idx]   += pixel[2];
+        }
+    }
+    GDALTermProgress(1.0, 0, 0);
+
+    QVector<box_t> boxes;
+    box_t box = {{0, 0, 0}, {HIST_LEVELS - 1, HIST_LEVELS - 1, HIST_LEVELS - 1}, 0};
+    shrinkBox(hist, box);
+    boxes << box;
+
+    while(boxes.size() < ncolors)
+    {
+        // split the box with the most samples
+        qint32 idx = -1;
+        for(qint32 i = 0; i < boxes.size(); i++)
+        {
+            if(boxes[i].isSplittable() && ((idx < 0) || (boxes[i].count > boxes[idx].count)))
+            {
+                idx = i;
+            }
+        }
+
+        if(idx < 0)
+        {
+            break;
+        }
+
+        box_t other;
+        splitBox(hist, boxes[idx], other);
+        boxes << other;
+    }
+
+    GDALColorTable * ct = new GDALColorTable(GPI_RGB);
+    for(qint32 i = 0; i < boxes.size(); i++)
+    {
+        const GDALColorEntry& entry = meanColor(hist, boxes[i]);
+        ct->SetColorEntry(i, &entry);
+    }
+    return ct;
+}
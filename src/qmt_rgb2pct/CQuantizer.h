@@ -0,0 +1,94 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#ifndef CQUANTIZER_H
+#define CQUANTIZER_H
+
+#include <gdal.h>
+#include <QtCore>
+
+class GDALColorTable;
+class GDALDataset;
+
+/**
+   @brief Color quantization of RGB(A) rasters
+
+   The color table is created by a median cut over a histogram with 5 bit per
+   channel. The histogram is fed by a decimated read of the complete raster.
+   By that the effort depends on the number of samples and not on the size of
+   the raster. Transparent and "no data" pixels are not sampled.
+
+   To map a color to the palette a lookup table with 6 bit per channel is
+   calculated once. The palette is stored as structure of arrays, padded to a
+   multiple of 16 entries. This allows the compiler to vectorize the search for
+   the nearest color without any platform specific code.
+ */
+class CQuantizer
+{
+    Q_DECLARE_TR_FUNCTIONS(CQuantizer)
+public:
+    CQuantizer(const GDALColorTable * ct);
+    virtual ~CQuantizer() = default;
+
+    /**
+       @brief Create an optimal color table for a dataset
+
+       @param dataset   a dataset with 3 (RGB) or 4 (RGBA) bands
+       @param ncolors   the maximum number of colors in the table
+       @return A new color table. The caller takes ownership.
+     */
+    static GDALColorTable * createColorTable(GDALDataset * dataset, qint32 ncolors);
+
+    /**
+       @brief Get the "no data" color of a RGB(A) dataset
+
+       @param dataset   a dataset with 3 (RGB) or 4 (RGBA) bands
+       @param nodata    the "no data" value of the first 3 bands
+       @return True if all 3 bands have a "no data" value.
+     */
+    static bool getNoData(GDALDataset * dataset, qint32 nodata[3]);
+
+    /// get the palette index closest to the color, 8 bit per channel
+    quint8 nearest(qint32 r, qint32 g, qint32 b) const
+    {
+        return lookup[((r >> 2) << 12) | ((g >> 2) << 6) | (b >> 2)];
+    }
+
+    /// get the palette's color of an index
+    const GDALColorEntry& color(quint8 idx) const
+    {
+        return colors[idx];
+    }
+
+private:
+    /// exhaustive search of the nearest palette entry
+    quint8 findNearest(qint32 r, qint32 g, qint32 b) const;
+
+    QVector<GDALColorEntry> colors;
+
+    QVector<qint32> red;
+    QVector<qint32> green;
+    QVector<qint32> blue;
+
+    /// the palette index for each color with 6 bit per channel
+    QVector<quint8> lookup;
+};
+
+#endif //CQUANTIZER_H
+
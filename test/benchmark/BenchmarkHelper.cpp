@@ -0,0 +1,157 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#include "BenchmarkHelper.h"
+
+#include "canvas/CCanvas.h"
+#include "gis/gpx/CGpxProject.h"
+#include "gis/CGisListWks.h"
+#include "gis/trk/CGisItemTrk.h"
+#include "gis/wpt/CGisItemWpt.h"
+
+#include <random>
+
+CCanvas * BenchmarkHelper::canvas = nullptr;
+QTemporaryDir * BenchmarkHelper::tempDir = nullptr;
+
+void BenchmarkHelper::init()
+{
+    tempDir = new QTemporaryDir();
+
+    canvas = new CCanvas(nullptr, "Benchmark");
+    canvas->resize(1024, 768);
+    setupCanvas(16);
+}
+
+void BenchmarkHelper::setupCanvas(qint32 zoomIndex, const QString& demKey)
+{
+    // clone the setup of a default canvas by a temporary configuration file
+    QSettings view(getTempFileName("view.ini"), QSettings::IniFormat);
+    view.clear();
+    view.setValue("map/zoomIndex", zoomIndex);
+    view.setValue("scales", 1);
+    view.setValue("proj", "+proj=merc");
+    view.setValue("grid/proj", "+proj=longlat +datum=WGS84 +no_defs");
+    if(!demKey.isEmpty())
+    {
+        view.setValue("dem/active", QStringList(demKey));
+    }
+
+    canvas->loadConfig(view);
+}
+
+void BenchmarkHelper::cleanup()
+{
+    delete canvas;
+    canvas = nullptr;
+
+    delete tempDir;
+    tempDir = nullptr;
+}
+
+CTrackData BenchmarkHelper::createTrack(qint32 N)
+{
+    std::mt19937 gen(4711);
+    std::uniform_real_distribution<qreal> azimuth(-M_PI, M_PI);
+    std::uniform_real_distribution<qreal> step(2, 10);
+    std::uniform_int_distribution<qint32> climb(-2, 2);
+
+    CTrackData trk;
+    trk.name = "Benchmark";
+    trk.segs.resize(1);
+
+    QVector<CTrackData::trkpt_t>& pts = trk.segs[0].pts;
+    pts.resize(N);
+
+    qreal lon = 11.5;
+    qreal lat = 48.1;
+    qint32 ele = 500;
+    qreal heading = 0;
+    QDateTime time = QDateTime(QDate(2020, 6, 1), QTime(8, 0), Qt::UTC);
+
+    for(CTrackData::trkpt_t& pt : pts)
+    {
+        pt.lon  = lon;
+        pt.lat  = lat;
+        pt.ele  = ele;
+        pt.time = time;
+
+        // a smooth random walk, like a hike with 1 point per second
+        heading += 0.1 * azimuth(gen);
+        const qreal d = step(gen) / 111120;
+        lat  += d * qCos(heading);
+        lon  += d * qSin(heading) / qCos(lat * M_PI / 180);
+        ele  += climb(gen);
+        time  = time.addSecs(1);
+    }
+
+    return trk;
+}
+
+IGisProject * BenchmarkHelper::createProject(qint32 nWpt, qint32 nTrk, qint32 trkPts)
+{
+    CGpxProject * project = new CGpxProject("a very random string to prevent loading via constructor", (CGisListWks*) nullptr);
+    project->setCheckState(CGisListWks::eColumnCheckBox, Qt::Checked);
+    project->blockUpdateItems(true);
+
+    std::mt19937 gen(815);
+    std::uniform_real_distribution<qreal> offset(-0.5, 0.5);
+
+    const QDateTime time(QDate(2020, 6, 1), QTime(8, 0), Qt::UTC);
+    for(qint32 n = 0; n < nWpt; n++)
+    {
+        const QPointF pos(11.5 + offset(gen), 48.1 + offset(gen));
+        new CGisItemWpt(pos, 500, time, QString("WPT%1").arg(n), "Waypoint", project);
+    }
+
+    for(qint32 n = 0; n < nTrk; n++)
+    {
+        CTrackData trk = createTrack(trkPts);
+        trk.name = QString("TRK%1").arg(n);
+        new CGisItemTrk(trk, project);
+    }
+
+    project->blockUpdateItems(false);
+    return project;
+}
+
+CCanvas * BenchmarkHelper::getCanvas()
+{
+    return canvas;
+}
+
+QString BenchmarkHelper::getInputPath(const QString& file)
+{
+    return QCoreApplication::applicationDirPath() + "/input/" + file.right(3) + "/" + file;
+}
+
+QString BenchmarkHelper::getDataPath(const QString& file)
+{
+    const QString path = QString::fromLocal8Bit(qgetenv("QMS_BENCHMARK_DATA"));
+    if(path.isEmpty() || !QDir(path).exists(file))
+    {
+        return QString();
+    }
+    return QDir(path).absoluteFilePath(file);
+}
+
+QString BenchmarkHelper::getTempFileName(const QString& name)
+{
+    return tempDir->filePath(name);
+}
@@ -0,0 +1,87 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#ifndef BENCHMARKHELPER_H
+#define BENCHMARKHELPER_H
+
+#include "gis/trk/CTrackData.h"
+
+#include <QtCore>
+
+class CCanvas;
+class IGisProject;
+
+/**
+   @brief Fixtures shared by all benchmarks
+
+   Synthetic data is created by a fixed seed. Thus each run measures
+   the same data. File based fixtures are taken from the unit test's
+   input files and from the directory given by the environment variable
+   QMS_BENCHMARK_DATA.
+ */
+class BenchmarkHelper
+{
+public:
+    /**
+       @brief Create a track with a random walk around Munich
+
+       @param N     the number of track points
+       @return The track data with one segment
+     */
+    static CTrackData createTrack(qint32 N);
+
+    /**
+       @brief Create a project that is not attached to the workspace
+
+       @param nWpt  the number of waypoints spread over a 1°x1° area around Munich
+       @param nTrk  the number of tracks, each with trkPts points
+       @param trkPts the number of points per track
+       @return The project. The caller has to delete it.
+     */
+    static IGisProject * createProject(qint32 nWpt, qint32 nTrk, qint32 trkPts);
+
+    /// a canvas that is not shown, configured with a pseudo mercator projection
+    static CCanvas * getCanvas();
+
+    /**
+       @brief Load a new view setup into the canvas
+
+       @param zoomIndex the zoom index of all draw contexts
+       @param demKey    the key of a DEM file in the DEM path to activate
+     */
+    static void setupCanvas(qint32 zoomIndex, const QString& demKey = QString());
+
+    /// the path to the unit test's input files
+    static QString getInputPath(const QString& file);
+
+    /// the path to an optional fixture in QMS_BENCHMARK_DATA or an empty string
+    static QString getDataPath(const QString& file);
+
+    /// a file name in a temporary directory, removed on exit
+    static QString getTempFileName(const QString& name);
+
+    static void init();
+    static void cleanup();
+
+private:
+    static CCanvas * canvas;
+    static QTemporaryDir * tempDir;
+};
+
+#endif //BENCHMARKHELPER_H
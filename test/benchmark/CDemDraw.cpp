@@ -0,0 +1,177 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#include "BenchmarkHelper.h"
+
+#include "canvas/CCanvas.h"
+#include "dem/CDemDraw.h"
+#include "units/IUnit.h"
+
+#include <benchmark/benchmark.h>
+#include <gdal_priv.h>
+#include <ogr_spatialref.h>
+#include <proj_api.h>
+#include <random>
+
+/// the size of the synthetic DEM, like a 1 arc second SRTM tile
+#define DEM_SIZE 3601
+
+/**
+   Create a synthetic 1°x1° DEM east of Munich as GeoTIFF with a VRT on top.
+   The DEM is activated on the benchmark canvas.
+ */
+static bool setupDem()
+{
+    static bool isSetup = false;
+    if(isSetup)
+    {
+        return true;
+    }
+
+    QDir dir(BenchmarkHelper::getTempFileName("dem"));
+    dir.mkpath(".");
+    const QString tif = dir.absoluteFilePath("dem.tif");
+    const QString vrt = dir.absoluteFilePath("dem.vrt");
+
+    GDALDriver * driverTif = GetGDALDriverManager()->GetDriverByName("GTiff");
+    GDALDriver * driverVrt = GetGDALDriverManager()->GetDriverByName("VRT");
+    if(driverTif == nullptr || driverVrt == nullptr)
+    {
+        return false;
+    }
+
+    GDALDataset * dataset = driverTif->Create(tif.toUtf8(), DEM_SIZE, DEM_SIZE, 1, GDT_Int16, nullptr);
+    if(dataset == nullptr)
+    {
+        return false;
+    }
+
+    const qreal res = 1.0 / (DEM_SIZE - 1);
+    double adfGeoTransform[6] = {11.0 - res / 2, res, 0, 49.0 + res / 2, 0, -res};
+    dataset->SetGeoTransform(adfGeoTransform);
+
+    OGRSpatialReference oSRS;
+    oSRS.importFromEPSG(4326);
+    char * wkt = nullptr;
+    oSRS.exportToWkt(&wkt);
+    dataset->SetProjection(wkt);
+    CPLFree(wkt);
+
+    GDALRasterBand * band = dataset->GetRasterBand(1);
+    band->SetNoDataValue(-32768);
+
+    QVector<qint16> row(DEM_SIZE);
+    for(int y = 0; y < DEM_SIZE; y++)
+    {
+        for(int x = 0; x < DEM_SIZE; x++)
+        {
+            row[x] = qint16(1000 + 500 * qSin(x * 0.005) * qCos(y * 0.007) + 50 * qSin(x * 0.1 + y * 0.13));
+        }
+        CPLErr err = band->RasterIO(GF_Write, 0, y, DEM_SIZE, 1, row.data(), DEM_SIZE, 1, GDT_Int16, 0, 0);
+        if(err != CE_None)
+        {
+            GDALClose(dataset);
+            return false;
+        }
+    }
+
+    GDALDataset * datasetVrt = driverVrt->CreateCopy(vrt.toUtf8(), dataset, FALSE, nullptr, nullptr, nullptr);
+    GDALClose(dataset);
+    if(datasetVrt == nullptr)
+    {
+        return false;
+    }
+    GDALClose(datasetVrt);
+
+    // the DEM's key is the MD5 hash of the file's first 1024 bytes, like CDemDraw does
+    QFile file(vrt);
+    file.open(QIODevice::ReadOnly);
+    const QString key = QCryptographicHash::hash(file.read(1024), QCryptographicHash::Md5).toHex();
+    file.close();
+
+    CDemDraw::setupDemPath(QStringList(dir.absolutePath()));
+    BenchmarkHelper::setupCanvas(16, key);
+
+    isSetup = true;
+    return true;
+}
+
+static void createPositions(QPolygonF& pos, qint32 N)
+{
+    std::mt19937 gen(4711);
+    std::uniform_real_distribution<qreal> lon(11.0, 12.0);
+    std::uniform_real_distribution<qreal> lat(48.0, 49.0);
+
+    pos.resize(N);
+    for(QPointF& pt : pos)
+    {
+        pt = QPointF(lon(gen), lat(gen)) * DEG_TO_RAD;
+    }
+}
+
+static void BM_DemElevation(benchmark::State& state)
+{
+    if(!setupDem())
+    {
+        state.SkipWithError("Failed to create DEM");
+        return;
+    }
+
+    const qint32 N = qint32(state.range(0));
+    QPolygonF pos;
+    QPolygonF ele(N);
+    createPositions(pos, N);
+
+    CCanvas * canvas = BenchmarkHelper::getCanvas();
+    for(auto _ : state)
+    {
+        canvas->getElevationAt(pos, ele);
+    }
+
+    if(ele[0].y() == NOFLOAT)
+    {
+        state.SkipWithError("DEM is not active");
+    }
+
+    state.SetItemsProcessed(state.iterations() * N);
+}
+BENCHMARK(BM_DemElevation)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_DemSlope(benchmark::State& state)
+{
+    if(!setupDem())
+    {
+        state.SkipWithError("Failed to create DEM");
+        return;
+    }
+
+    const qint32 N = qint32(state.range(0));
+    QPolygonF pos;
+    QPolygonF slope(N);
+    createPositions(pos, N);
+
+    CCanvas * canvas = BenchmarkHelper::getCanvas();
+    for(auto _ : state)
+    {
+        canvas->getSlopeAt(pos, slope);
+    }
+
+    state.SetItemsProcessed(state.iterations() * N);
+}
+BENCHMARK(BM_DemSlope)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
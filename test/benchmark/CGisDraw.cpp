@@ -0,0 +1,78 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#include "BenchmarkHelper.h"
+
+#include "canvas/CCanvas.h"
+#include "CMainWindow.h"
+#include "gis/CGisDraw.h"
+#include "gis/prj/IGisProject.h"
+
+#include <benchmark/benchmark.h>
+#include <proj_api.h>
+#include <QtGui>
+
+/**
+   Draw N waypoints and place their labels in a 1024x768 viewport. All
+   waypoints are spread over 1°x1°, thus most of them are visible at the
+   given zoom index and most labels have to be tested against each other.
+ */
+static void BM_GisDrawLabels(benchmark::State& state)
+{
+    const qint32 N = qint32(state.range(0));
+    const qint32 zoomIndex = qint32(state.range(1));
+    IGisProject * project = BenchmarkHelper::createProject(N, 0, 0);
+
+    const QSize size(1024, 768);
+    QImage img(size, QImage::Format_ARGB32_Premultiplied);
+    QPainter p(&img);
+
+    // set the viewport of the draw context without starting it's thread
+    CGisDraw gis(BenchmarkHelper::getCanvas());
+    gis.resize(size);
+    gis.zoom(zoomIndex);
+    gis.draw(p, CCanvas::eRedrawNone, QPointF(11.5, 48.1) * DEG_TO_RAD);
+
+    QPolygonF viewport;
+    viewport << QPointF(0, 0) << QPointF(size.width(), 0) << QPointF(size.width(), size.height()) << QPointF(0, size.height());
+    for(QPointF& pt : viewport)
+    {
+        gis.convertPx2Rad(pt);
+    }
+
+    const QFontMetricsF fm(CMainWindow::self().getMapFont());
+    QList<QRectF> blockedAreas;
+
+    for(auto _ : state)
+    {
+        img.fill(Qt::transparent);
+        blockedAreas.clear();
+
+        project->drawItem(p, viewport, blockedAreas, &gis);
+        project->drawLabel(p, viewport, blockedAreas, fm, &gis);
+    }
+
+    state.SetItemsProcessed(state.iterations() * N);
+    delete project;
+}
+// zoom index 18 shows all waypoints, zoom index 12 about 1% of them
+BENCHMARK(BM_GisDrawLabels)
+    ->Args({1000, 18})->Args({10000, 18})->Args({100000, 18})
+    ->Args({1000, 12})->Args({10000, 12})->Args({100000, 12})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,114 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#include "BenchmarkHelper.h"
+
+#include "gis/prj/IGisProject.h"
+#include "gis/trk/CGisItemTrk.h"
+
+#include <benchmark/benchmark.h>
+#include <functional>
+
+/**
+   Run an operation on a fresh track for each iteration. Only the
+   operation is measured. Creating and deleting the track is not.
+ */
+static void runOnTrack(benchmark::State& state, const std::function<void(CGisItemTrk&)>& op)
+{
+    const qint32 N = qint32(state.range(0));
+    const CTrackData data = BenchmarkHelper::createTrack(N);
+    IGisProject * project = BenchmarkHelper::createProject(0, 0, 0);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        CTrackData copy = data;
+        CGisItemTrk * trk = new CGisItemTrk(copy, project);
+        state.ResumeTiming();
+
+        op(*trk);
+
+        state.PauseTiming();
+        delete trk;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * N);
+    delete project;
+}
+
+static void BM_TrkCreate(benchmark::State& state)
+{
+    const qint32 N = qint32(state.range(0));
+    const CTrackData data = BenchmarkHelper::createTrack(N);
+    IGisProject * project = BenchmarkHelper::createProject(0, 0, 0);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        CTrackData copy = data;
+        state.ResumeTiming();
+
+        CGisItemTrk * trk = new CGisItemTrk(copy, project);
+
+        state.PauseTiming();
+        delete trk;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * N);
+    delete project;
+}
+BENCHMARK(BM_TrkCreate)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_TrkSetElevation(benchmark::State& state)
+{
+    runOnTrack(state, [&](CGisItemTrk& trk)
+    {
+        trk.setElevation(qint32(state.range(0) / 2), 1000);
+    });
+}
+BENCHMARK(BM_TrkSetElevation)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_TrkFilterReducePoints(benchmark::State& state)
+{
+    runOnTrack(state, [](CGisItemTrk& trk)
+    {
+        trk.filterReducePoints(20);
+    });
+}
+BENCHMARK(BM_TrkFilterReducePoints)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_TrkFilterSmoothProfile(benchmark::State& state)
+{
+    runOnTrack(state, [](CGisItemTrk& trk)
+    {
+        trk.filterSmoothProfile(5);
+    });
+}
+BENCHMARK(BM_TrkFilterSmoothProfile)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_TrkFilterSpeed(benchmark::State& state)
+{
+    runOnTrack(state, [](CGisItemTrk& trk)
+    {
+        trk.filterSpeed(1.5);
+    });
+}
+BENCHMARK(BM_TrkFilterSpeed)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,91 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#include "BenchmarkHelper.h"
+
+#include "canvas/CCanvas.h"
+
+#include <benchmark/benchmark.h>
+#include <proj_api.h>
+#include <QtGui>
+
+/**
+   Draw a map for a fixed viewport of 1024x768 pixel. The maps are
+   configured in the group of the map's type in the file maps.ini
+   in QMS_BENCHMARK_DATA:
+
+   [img]
+   file=Munich.img
+   lon=11.57
+   lat=48.14
+   zoomIndex=12
+
+   The GEMF benchmark falls back to the world map compiled into QMapShack.
+ */
+static void BM_MapDraw(benchmark::State& state, const char * type)
+{
+    QString file;
+    QPointF focus(0, 30);
+    qint32 zoomIndex = 16;
+
+    const QString ini = BenchmarkHelper::getDataPath("maps.ini");
+    if(!ini.isEmpty())
+    {
+        QSettings cfg(ini, QSettings::IniFormat);
+        cfg.beginGroup(type);
+        if(cfg.contains("file"))
+        {
+            file      = QFileInfo(ini).dir().absoluteFilePath(cfg.value("file").toString());
+            focus     = QPointF(cfg.value("lon", 0).toReal(), cfg.value("lat", 0).toReal());
+            zoomIndex = cfg.value("zoomIndex", zoomIndex).toInt();
+        }
+        cfg.endGroup();
+    }
+
+    if(file.isEmpty() && (QString(type) == "gemf"))
+    {
+        file      = "://map/World.gemf";
+        zoomIndex = 24;
+    }
+
+    if(file.isEmpty())
+    {
+        state.SkipWithError("No map configured in QMS_BENCHMARK_DATA/maps.ini");
+        return;
+    }
+
+    CCanvas * canvas = BenchmarkHelper::getCanvas();
+    BenchmarkHelper::setupCanvas(zoomIndex);
+    canvas->setMap(file);
+
+    const QRectF area(0, 0, 1024, 768);
+    QImage img(area.size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    QPainter p(&img);
+
+    for(auto _ : state)
+    {
+        img.fill(Qt::white);
+        canvas->print(p, area, focus * DEG_TO_RAD, false);
+    }
+
+    state.SetItemsProcessed(state.iterations() * img.width() * img.height());
+}
+BENCHMARK_CAPTURE(BM_MapDraw, img,  "img")->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapDraw, jnx,  "jnx")->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_MapDraw, gemf, "gemf")->Unit(benchmark::kMillisecond)->UseRealTime();
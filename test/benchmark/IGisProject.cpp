@@ -0,0 +1,161 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#include "BenchmarkHelper.h"
+
+#include "gis/CGisListWks.h"
+#include "gis/fit/CFitProject.h"
+#include "gis/gpx/CGpxProject.h"
+#include "gis/qms/CQmsProject.h"
+#include "gis/slf/CSlfProject.h"
+#include "gis/tcx/CTcxProject.h"
+
+#include <benchmark/benchmark.h>
+
+static bool saveProject(const QString& fn, IGisProject& project)
+{
+    if(fn.endsWith(".gpx"))
+    {
+        return CGpxProject::saveAs(fn, project, false);
+    }
+    else if(fn.endsWith(".qms"))
+    {
+        return CQmsProject::saveAs(fn, project);
+    }
+    else if(fn.endsWith(".tcx"))
+    {
+        return CTcxProject::saveAs(fn, project);
+    }
+    return false;
+}
+
+static IGisProject * loadProject(const QString& fn)
+{
+    if(fn.endsWith(".gpx"))
+    {
+        CGpxProject * project = new CGpxProject("a very random string to prevent loading via constructor", (CGisListWks*) nullptr);
+        project->blockUpdateItems(true);
+        CGpxProject::loadGpx(fn, project);
+        project->blockUpdateItems(false);
+        return project;
+    }
+    else if(fn.endsWith(".qms"))
+    {
+        return new CQmsProject(fn, (CGisListWks*) nullptr);
+    }
+    else if(fn.endsWith(".tcx"))
+    {
+        return new CTcxProject(fn, (CGisListWks*) nullptr);
+    }
+    else if(fn.endsWith(".fit"))
+    {
+        return new CFitProject(fn, (CGisListWks*) nullptr);
+    }
+    else if(fn.endsWith(".slf"))
+    {
+        return new CSlfProject(fn, true);
+    }
+    return nullptr;
+}
+
+/// save a project with a single track of N points and N / 100 waypoints
+static void BM_PrjSave(benchmark::State& state, const char * ext)
+{
+    const qint32 N = qint32(state.range(0));
+    IGisProject * project = BenchmarkHelper::createProject(N / 100, 1, N);
+    const QString fn = BenchmarkHelper::getTempFileName(QString("save.%1").arg(ext));
+
+    for(auto _ : state)
+    {
+        if(!saveProject(fn, *project))
+        {
+            state.SkipWithError("Failed to save project");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * N);
+    state.SetBytesProcessed(state.iterations() * QFileInfo(fn).size());
+    delete project;
+}
+BENCHMARK_CAPTURE(BM_PrjSave, gpx, "gpx")->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PrjSave, qms, "qms")->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PrjSave, tcx, "tcx")->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+/// load a project with a single track of N points and N / 100 waypoints, saved in advance
+static void BM_PrjLoad(benchmark::State& state, const char * ext)
+{
+    const qint32 N = qint32(state.range(0));
+    const QString fn = BenchmarkHelper::getTempFileName(QString("load_%1.%2").arg(N).arg(ext));
+    if(!QFile::exists(fn))
+    {
+        IGisProject * project = BenchmarkHelper::createProject(N / 100, 1, N);
+        saveProject(fn, *project);
+        delete project;
+    }
+
+    for(auto _ : state)
+    {
+        IGisProject * project = loadProject(fn);
+        if(project == nullptr || !project->isValid())
+        {
+            state.SkipWithError("Failed to load project");
+            delete project;
+            break;
+        }
+
+        state.PauseTiming();
+        delete project;
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * N);
+    state.SetBytesProcessed(state.iterations() * QFileInfo(fn).size());
+}
+BENCHMARK_CAPTURE(BM_PrjLoad, gpx, "gpx")->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PrjLoad, qms, "qms")->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PrjLoad, tcx, "tcx")->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+/// load one of the unit test's input files
+static void BM_PrjLoadFile(benchmark::State& state, const char * file)
+{
+    const QString fn = BenchmarkHelper::getInputPath(file);
+
+    for(auto _ : state)
+    {
+        IGisProject * project = loadProject(fn);
+        if(project == nullptr || !project->isValid())
+        {
+            state.SkipWithError("Failed to load project");
+            delete project;
+            break;
+        }
+
+        state.PauseTiming();
+        delete project;
+        state.ResumeTiming();
+    }
+
+    state.SetBytesProcessed(state.iterations() * QFileInfo(fn).size());
+}
+BENCHMARK_CAPTURE(BM_PrjLoadFile, fit_activity, "2015-05-07-22-03-17.fit")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PrjLoadFile, fit_course,   "Warisouderghem_course.fit")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PrjLoadFile, slf,          "qtt_slf_file0.slf")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PrjLoadFile, gpx,          "qtt_gpx_file0.gpx")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_PrjLoadFile, qms,          "V1.6.0_file1.qms")->Unit(benchmark::kMillisecond);
@@ -0,0 +1,78 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#include "BenchmarkHelper.h"
+
+#include "CMainWindow.h"
+#include "setup/CAppOpts.h"
+#include "setup/IAppSetup.h"
+
+#include <benchmark/benchmark.h>
+#include <QtWidgets>
+
+/*
+   Run all benchmarks and write the results as JSON for tracking them over time:
+
+   qmsbenchmark --benchmark_out=results.json --benchmark_out_format=json
+
+   Use --benchmark_filter=<regex> to run a subset.
+ */
+int main(int argc, char ** argv)
+{
+    // strip all benchmark options before Qt sees them
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    // run in a temporary home to neither touch nor load the user's setup and workspace
+    QTemporaryDir home;
+    qputenv("HOME", home.path().toLocal8Bit());
+    qunsetenv("XDG_CONFIG_HOME");
+    qunsetenv("XDG_DATA_HOME");
+    qunsetenv("XDG_CACHE_HOME");
+
+    // no display needed
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    QCoreApplication::setApplicationName("QMapShack");
+    QCoreApplication::setOrganizationName("QLandkarte");
+    QCoreApplication::setOrganizationDomain("qlandkarte.org");
+
+    qlOpts = new CAppOpts(false, false, true, QDir(home.path()).absoluteFilePath("qmapshack.ini"), QStringList());
+
+    IAppSetup* env = IAppSetup::getPlatformInstance();
+    env->initLogHandler();
+    env->initQMapShack();
+
+    // the main window is needed by all draw contexts and sets up the units, it's never shown
+    CMainWindow w;
+
+    BenchmarkHelper::init();
+    benchmark::RunSpecifiedBenchmarks();
+    BenchmarkHelper::cleanup();
+
+    return 0;
+}
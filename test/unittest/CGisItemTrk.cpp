@@ -20,6 +20,7 @@
 #include "test_QMapShack.h"
 
 #include "gis/gpx/CGpxProject.h"
+#include "gis/qms/CQmsProject.h"
 #include "gis/trk/CGisItemTrk.h"
 
 #include <QtCore>
@@ -54,3 +55,105 @@ void test_QMapShack::_filterDeleteExtension()
     }
 }
 
+
+static CGisItemTrk * getTrkByName(IGisProject * proj, const QString& name)
+{
+    for(int i = 0; i < proj->childCount(); i++)
+    {
+        CGisItemTrk * trk = dynamic_cast<CGisItemTrk*>(proj->child(i));
+        if((trk != nullptr) && (name.isEmpty() || (trk->getName() == name)))
+        {
+            return trk;
+        }
+    }
+    return nullptr;
+}
+
+static void verifySecondaryData(const CGisItemTrk& exp, const CGisItemTrk& act)
+{
+    QList<const CTrackData::trkpt_t*> expPts;
+    for(const CTrackData::trkpt_t& trkpt : exp.getTrackData())
+    {
+        if(!trkpt.isHidden())
+        {
+            expPts << &trkpt;
+        }
+    }
+
+    int n = 0;
+    for(const CTrackData::trkpt_t& trkpt : act.getTrackData())
+    {
+        if(trkpt.isHidden())
+        {
+            continue;
+        }
+
+        SUBVERIFY(n < expPts.size(), "Track has more visible points than expected");
+        const CTrackData::trkpt_t& expPt = *expPts[n++];
+        SUBVERIFY(expPt.deltaDistance == trkpt.deltaDistance, QString("Distance of point %1 differs").arg(n));
+        SUBVERIFY(expPt.slope1 == trkpt.slope1, QString("Slope of point %1 differs").arg(n));
+        SUBVERIFY(expPt.speed == trkpt.speed, QString("Speed of point %1 differs").arg(n));
+    }
+    VERIFY_EQUAL(expPts.size(), n);
+}
+
+void test_QMapShack::_saveLoadSecondaryData()
+{
+    IGisProject *proj = readProjFile("qtt_gpx_file0.gpx");
+
+    CGisItemTrk * trk = getTrkByName(proj, "");
+    SUBVERIFY(nullptr != trk, "No track in qtt_gpx_file0.gpx");
+    const QString name = trk->getName();
+
+    // the history entries must not carry the secondary data
+    SUBVERIFY(trk->getHistory().derived.isEmpty(), "Secondary data stored before saving");
+
+    QString tmpFile = TestHelper::getTempFileName("qms");
+    CQmsProject::saveAs(tmpFile, *proj);
+
+    IGisProject *proj2 = readProjFile(tmpFile, true, false);
+    CGisItemTrk * trk2 = getTrkByName(proj2, name);
+    SUBVERIFY(nullptr != trk2, "Track `" + name + "` is missing");
+
+    IGisItem::history_t history = trk2->getHistory();
+    SUBVERIFY(!history.derived.isEmpty(), "No secondary data saved with the history");
+
+    // restored data has to match the data derived from scratch
+    verifySecondaryData(*trk, *trk2);
+
+    IGisItem::history_t historyFresh = history;
+    historyFresh.derived.clear();
+    CGisItemTrk * trkFresh = new CGisItemTrk(historyFresh, "", proj2);
+    verifySecondaryData(*trkFresh, *trk2);
+
+    // a track restored with secondary data has to use it instead of deriving it
+    quint8 version;
+    QByteArray hash;
+    QVector<qreal> deltaDistance, slope, speed;
+    {
+        QDataStream in(history.derived);
+        in.setByteOrder(QDataStream::LittleEndian);
+        in.setVersion(QDataStream::Qt_5_2);
+        in >> version >> hash >> deltaDistance >> slope >> speed;
+    }
+
+    speed.fill(42.0);
+
+    history.derived.clear();
+    {
+        QDataStream out(&history.derived, QIODevice::WriteOnly);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out.setVersion(QDataStream::Qt_5_2);
+        out << version << hash << deltaDistance << slope << speed;
+    }
+
+    CGisItemTrk * trkCached = new CGisItemTrk(history, "", proj2);
+    for(const CTrackData::trkpt_t& trkpt : trkCached->getTrackData())
+    {
+        SUBVERIFY(trkpt.isHidden() || (trkpt.speed == 42.0), "Secondary data has been derived again");
+    }
+
+    delete proj2;
+    delete proj;
+    QFile(tmpFile).remove();
+}
@@ -23,6 +23,9 @@
 
 #include "gis/gpx/CGpxProject.h"
 #include "gis/qms/CQmsProject.h"
+#include "gis/wpt/CGisItemWpt.h"
+
+#include <QImage>
 
 void test_QMapShack::_readQmsFile_1_6_0()
 {
@@ -55,3 +58,64 @@ void test_QMapShack::_writeReadQmsFile()
     }
 }
 
+
+static CGisItemWpt * getWptByName(IGisProject * proj, const QString& name)
+{
+    for(int i = 0; i < proj->childCount(); i++)
+    {
+        CGisItemWpt * wpt = dynamic_cast<CGisItemWpt*>(proj->child(i));
+        if((wpt != nullptr) && (name.isEmpty() || (wpt->getName() == name)))
+        {
+            return wpt;
+        }
+    }
+    return nullptr;
+}
+
+void test_QMapShack::_writeReadQmsWptImages()
+{
+    IGisProject *proj = readProjFile("qtt_gpx_file0.gpx");
+
+    CGisItemWpt * wpt = getWptByName(proj, "");
+    SUBVERIFY(nullptr != wpt, "No waypoint in qtt_gpx_file0.gpx");
+    const QString name = wpt->getName();
+
+    QImage img(64, 48, QImage::Format_RGB32);
+    img.fill(Qt::red);
+    CGisItemWpt::image_t image;
+    image.setImage(img);
+    const QByteArray data = image.getData();
+    SUBVERIFY(!data.isEmpty(), "Failed to encode image");
+
+    // several history entries refer to the same image
+    wpt->setImages({image});
+    wpt->setComment("first");
+    wpt->setComment("second");
+    VERIFY_EQUAL(1, wpt->getHistory().blobs.size());
+
+    QString tmpFile = TestHelper::getTempFileName("qms");
+    CQmsProject::saveAs(tmpFile, *proj);
+    delete proj;
+
+    proj = readProjFile(tmpFile, true, false);
+    wpt = getWptByName(proj, name);
+    SUBVERIFY(nullptr != wpt, "Waypoint `" + name + "` is missing");
+    VERIFY_EQUAL(1, wpt->getHistory().blobs.size());
+
+    // each history entry with the image has to restore it
+    const int N = wpt->getHistory().events.size();
+    for(int i = N - 3; i < N; i++)
+    {
+        wpt->loadHistory(i);
+        VERIFY_EQUAL(1, wpt->getImages().size());
+        SUBVERIFY(wpt->getImages().first().getData() == data, QString("Image of history entry %1 differs").arg(i));
+    }
+
+    // without an entry referring to the image the blob is dropped
+    wpt->setImages({});
+    wpt->cutHistoryBefore();
+    VERIFY_EQUAL(0, wpt->getHistory().blobs.size());
+
+    delete proj;
+    QFile(tmpFile).remove();
+}
@@ -0,0 +1,129 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/prj/IGisProject.h"
+#include "gis/search/CSearch.h"
+#include "gis/search/CSearchIndex.h"
+
+#include <QtCore>
+
+static QSet<QString> queryIndex(CSearchIndex& index, const CSearch& search)
+{
+    static quint32 serial = 0;
+    serial++;
+
+    bool done = false;
+    QSet<QString> result;
+    QMetaObject::Connection connection = QObject::connect(&index, &CSearchIndex::sigQueryFinished, [&](quint32 s, const QSet<QString>& matches){
+        if(s == serial)
+        {
+            result = matches;
+            done = true;
+        }
+    });
+
+    index.query(search, serial);
+
+    QElapsedTimer timer;
+    timer.start();
+    while(!done && (timer.elapsed() < 5000))
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+    }
+
+    QObject::disconnect(connection);
+    SUBVERIFY(done, "Query did not finish in time");
+    return result;
+}
+
+void test_QMapShack::verifySearchIndex(CSearchIndex& index, const QList<IGisItem*>& items, const QString& str)
+{
+    for(CSearch::search_mode_e mode : {CSearch::eSearchModeText, CSearch::eSearchModeName})
+    {
+        CSearch::setSearchMode(mode);
+        for(Qt::CaseSensitivity cs : {Qt::CaseInsensitive, Qt::CaseSensitive})
+        {
+            CSearch::setCaseSensitivity(cs);
+
+            CSearch search(str);
+            SUBVERIFY(search.isIndexable(), "Default search is not indexable");
+
+            const QSet<QString>& matches = queryIndex(index, search);
+            for(IGisItem * item : items)
+            {
+                /*
+                    Names have to match exactly as with the workspace filter
+                    without index. Full text searches use less text than the
+                    info text tested by that filter. They have to match the
+                    workspace filter for items not covered by an index query.
+                 */
+                const bool expected = (mode == CSearch::eSearchModeName)
+                                      ? search.getPropertyResult(item)
+                                      : search.getSearchResult(item);
+                const bool actual   = matches.contains(CSearchIndex::getItemKey(item));
+                SUBVERIFY(expected == actual, QString("Indexed search `%1` differs from workspace filter for item `%2`").arg(str).arg(item->getName()));
+            }
+        }
+    }
+
+    CSearch::setSearchMode(CSearch::eSearchModeText);
+    CSearch::setCaseSensitivity(Qt::CaseInsensitive);
+}
+
+void test_QMapShack::_searchIndex()
+{
+    const QStringList queries = {"a", "T", "track", "Track 1", "e t", "-", "no such text"};
+
+    for(const QString &file : inputFiles)
+    {
+        IGisProject *proj = readProjFile(file);
+
+        QList<IGisItem*> items;
+        for(int i = 0; i < proj->childCount(); i++)
+        {
+            IGisItem * item = dynamic_cast<IGisItem*>(proj->child(i));
+            if(item != nullptr)
+            {
+                items << item;
+            }
+        }
+
+        CSearchIndex index(nullptr);
+        SUBVERIFY(index.sync(items).size() == items.size(), "Not all items are indexed");
+
+        for(const QString& str : queries)
+        {
+            verifySearchIndex(index, items, str);
+        }
+
+        // a changed item has to be found by it's new text without a sync
+        if(!items.isEmpty())
+        {
+            IGisItem * item = items.first();
+            item->setComment("qtt search index marker");
+
+            const QSet<QString>& matches = queryIndex(index, CSearch("Index Marker"));
+            SUBVERIFY(matches == QSet<QString>({CSearchIndex::getItemKey(item)}), "Changed item is not found");
+        }
+
+        delete proj;
+    }
+}
@@ -0,0 +1,228 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "map/cache/CDiskCache.h"
+#include "map/CTileScheduler.h"
+#include "map/CTileSeeder.h"
+
+#include <functional>
+#include <QtCore>
+#include <QtNetwork>
+
+/**
+   @brief A minimal local HTTP server as stand-in for a tile server
+
+   Each GET request is answered after a delay with the requested path or
+   a fixed content. All requested paths and the maximum number of requests answered
+   in parallel are recorded.
+ */
+class CHttpStandIn
+{
+public:
+    CHttpStandIn(int delay)
+        : delay(delay)
+    {
+        server.listen(QHostAddress::LocalHost);
+        QObject::connect(&server, &QTcpServer::newConnection, [this]()
+        {
+            while(server.hasPendingConnections())
+            {
+                QTcpSocket * socket = server.nextPendingConnection();
+                QObject::connect(socket, &QTcpSocket::readyRead, [this, socket](){receive(socket);});
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+    }
+
+    QString getUrl(const QString& path) const
+    {
+        return QString("http://127.0.0.1:%1/%2").arg(server.serverPort()).arg(path);
+    }
+
+    QStringList paths;
+    int maxParallel = 0;
+    /// if not empty this is the reply to all requests
+    QByteArray content;
+
+private:
+    void receive(QTcpSocket * socket)
+    {
+        QByteArray& buffer = buffers[socket];
+        buffer += socket->readAll();
+
+        int end;
+        while((end = buffer.indexOf("\r\n\r\n")) >= 0)
+        {
+            const QByteArray path = buffer.left(end).split(' ').value(1).mid(1);
+            buffer.remove(0, end + 4);
+
+            paths << path;
+            maxParallel = qMax(maxParallel, ++parallel);
+
+            const QByteArray& reply = content.isEmpty() ? path : content;
+            QTimer::singleShot(delay, socket, [this, socket, reply]()
+            {
+                parallel--;
+                socket->write("HTTP/1.1 200 OK\r\nContent-Length: " + QByteArray::number(reply.size()) + "\r\n\r\n" + reply);
+            });
+        }
+    }
+
+    QTcpServer server;
+    QHash<QTcpSocket*, QByteArray> buffers;
+    int delay;
+    int parallel = 0;
+};
+
+static void waitUntil(const std::function<bool()>& done)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while(!done() && (timer.elapsed() < 5000))
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+    }
+    SUBVERIFY(done(), "Requests did not finish in time");
+}
+
+void test_QMapShack::_tileScheduler()
+{
+    CTileScheduler scheduler(nullptr);
+    const int maxRequestsPerHost = scheduler.getMaxRequestsPerHost();
+
+    QObject client1;
+    QObject client2;
+    QHash<QObject*, QStringList> received;
+    QObject::connect(&scheduler, &CTileScheduler::sigRequestFinished, [&](QObject * client, const QString& url, const QByteArray& data, bool ok)
+    {
+        // the stand-in replies with the path. Anything else is recorded as error
+        received[client] << ((ok && url.endsWith("/" + data)) ? QString(data) : QString("error"));
+    });
+
+    // tiles are requested in order of their priority
+    {
+        CHttpStandIn server(10);
+        scheduler.setMaxRequestsPerHost(1);
+        scheduler.setRequests(&client1, {{server.getUrl("c"), 3}, {server.getUrl("a"), 1}, {server.getUrl("b"), 2}});
+        waitUntil([&](){return received[&client1].size() == 3;});
+
+        VERIFY_EQUAL(QStringList({"a", "b", "c"}).join(","), server.paths.join(","));
+        VERIFY_EQUAL(QStringList({"a", "b", "c"}).join(","), received[&client1].join(","));
+        VERIFY_EQUAL(1, server.maxParallel);
+        VERIFY_EQUAL(0, scheduler.count(&client1));
+        received.clear();
+    }
+
+    // the number of parallel requests per host is limited
+    {
+        CHttpStandIn server(50);
+        scheduler.setMaxRequestsPerHost(2);
+        scheduler.setRequests(&client1, {{server.getUrl("a"), 1}, {server.getUrl("b"), 2}, {server.getUrl("c"), 3}, {server.getUrl("d"), 4}, {server.getUrl("e"), 5}});
+        waitUntil([&](){return received[&client1].size() == 5;});
+
+        VERIFY_EQUAL(5, server.paths.size());
+        SUBVERIFY(!received[&client1].contains("error"), "Bad reply");
+        SUBVERIFY(server.maxParallel <= 2, QString("%1 parallel requests").arg(server.maxParallel));
+        received.clear();
+    }
+
+    // the same tile requested by two clients is fetched once
+    {
+        CHttpStandIn server(10);
+        scheduler.setRequests(&client1, {{server.getUrl("a"), 1}, {server.getUrl("b"), 2}});
+        scheduler.setRequests(&client2, {{server.getUrl("b"), 1}});
+        VERIFY_EQUAL(2, scheduler.count(&client1));
+        VERIFY_EQUAL(1, scheduler.count(&client2));
+        waitUntil([&](){return (received[&client1].size() == 2) && (received[&client2].size() == 1);});
+
+        VERIFY_EQUAL(2, server.paths.size());
+        VERIFY_EQUAL(QStringList({"a", "b"}).join(","), received[&client1].join(","));
+        VERIFY_EQUAL(QString("b"), received[&client2].first());
+        received.clear();
+    }
+
+    // stale requests are dropped by the next call
+    {
+        CHttpStandIn server(10);
+        scheduler.setMaxRequestsPerHost(1);
+        scheduler.setRequests(&client1, {{server.getUrl("a"), 1}, {server.getUrl("b"), 2}, {server.getUrl("c"), 3}});
+        scheduler.setRequests(&client1, {{server.getUrl("d"), 1}});
+        VERIFY_EQUAL(1, scheduler.count(&client1));
+        waitUntil([&](){return received[&client1].size() == 1;});
+
+        VERIFY_EQUAL(QString("d"), received[&client1].first());
+        SUBVERIFY(!server.paths.contains("b") && !server.paths.contains("c"), "Stale tiles have been requested");
+        received.clear();
+    }
+
+    scheduler.setMaxRequestsPerHost(maxRequestsPerHost);
+}
+
+void test_QMapShack::_tileSeeder()
+{
+    CTileScheduler scheduler(nullptr);
+    QTemporaryDir dir;
+    CDiskCache cache(dir.path(), 100, 14, nullptr);
+
+    QImage img(256, 256, QImage::Format_ARGB32);
+    img.fill(Qt::red);
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    img.save(&buffer, "PNG");
+
+    CHttpStandIn server(10);
+    server.content = png;
+
+    QStringList urls;
+    for(int i = 0; i < 6; i++)
+    {
+        urls << server.getUrl(QString::number(i));
+    }
+
+    // tiles already in the cache are not requested again
+    SUBVERIFY(cache.store(urls[0], png), "Failed to store tile");
+    SUBVERIFY(cache.store(urls[3], png), "Failed to store tile");
+    SUBVERIFY(!cache.store(server.getUrl("x"), QByteArray("no image")), "Invalid image data stored");
+
+    CTileSeeder seeder(&cache, urls, CTileScheduler::headers_t(), nullptr);
+    seeder.setRate(100);
+    seeder.start();
+    waitUntil([&](){return seeder.isFinished();});
+
+    const CTileSeeder::progress_t& progress = seeder.getProgress();
+    VERIFY_EQUAL(6, progress.total);
+    VERIFY_EQUAL(2, progress.cached);
+    VERIFY_EQUAL(4, progress.downloaded);
+    VERIFY_EQUAL(0, progress.failed);
+    VERIFY_EQUAL(4 * png.size(), progress.bytes);
+
+    VERIFY_EQUAL(4, server.paths.size());
+    SUBVERIFY(!server.paths.contains("0") && !server.paths.contains("3"), "Cached tiles have been requested");
+    SUBVERIFY(server.maxParallel <= 2, QString("%1 parallel requests").arg(server.maxParallel));
+
+    for(const QString& url : urls)
+    {
+        QImage tile;
+        cache.restore(url, tile);
+        SUBVERIFY(tile.size() == img.size(), QString("Tile `%1` is not in the cache").arg(url));
+    }
+}
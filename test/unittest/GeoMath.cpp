@@ -0,0 +1,102 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+
+#include "test_QMapShack.h"
+
+#include "GeoMath.h"
+
+#include <proj_api.h>
+#include <QtCore>
+#include <random>
+
+/// a random walk over the globe with segments from 1m up to 200km
+static void createLine(QVector<qreal>& lon, QVector<qreal>& lat, qint32 N, qreal maxLength)
+{
+    std::mt19937 gen(4711);
+    std::uniform_real_distribution<qreal> azimuth(0, 2 * M_PI);
+    std::uniform_real_distribution<qreal> exponent(0, qLn(maxLength) / qLn(10));
+
+    lon.resize(N);
+    lat.resize(N);
+
+    qreal u = 11.5 * DEG_TO_RAD;
+    qreal v = 48.1 * DEG_TO_RAD;
+    for(qint32 i = 0; i < N; i++)
+    {
+        lon[i] = u;
+        lat[i] = v;
+
+        const qreal a = azimuth(gen);
+        const qreal d = qPow(10, exponent(gen)) / 6371000;
+
+        v = qBound(-89.9 * DEG_TO_RAD, v + d * qCos(a), 89.9 * DEG_TO_RAD);
+        u = u + d * qSin(a) / qMax(qCos(v), 0.01);
+        if(u > M_PI)
+        {
+            u -= 2 * M_PI;
+        }
+        else if(u < -M_PI)
+        {
+            u += 2 * M_PI;
+        }
+    }
+}
+
+void test_QMapShack::_distanceBatch()
+{
+    QVector<qreal> lon, lat;
+    createLine(lon, lat, 100000, 200000);
+
+    const qint32 N = lon.count();
+    QVector<qreal> exact(N);
+    GPS_Math_Distance(lon.constData(), lat.constData(), N, exact.data(), 0);
+
+    QCOMPARE(exact[0], 0.0);
+    for(qint32 i = 1; i < N; i++)
+    {
+        QCOMPARE(exact[i], GPS_Math_Distance(lon[i - 1], lat[i - 1], lon[i], lat[i]));
+    }
+
+    for(qreal maxError : {1.0, 0.01, 0.001})
+    {
+        QVector<qreal> dist(N);
+        GPS_Math_Distance(lon.constData(), lat.constData(), N, dist.data(), maxError);
+
+        qreal error = 0;
+        for(qint32 i = 0; i < N; i++)
+        {
+            error = qMax(error, qAbs(dist[i] - exact[i]));
+        }
+
+        SUBVERIFY(error <= maxError, QString("Max. error is %1 m, requested %2 m").arg(error).arg(maxError));
+    }
+}
+
+void test_QMapShack::benchmarkDistanceBatch(qreal maxError)
+{
+    QVector<qreal> lon, lat;
+    createLine(lon, lat, 100000, 1000);
+
+    const qint32 N = lon.count();
+    QVector<qreal> dist(N);
+    QBENCHMARK
+    {
+        GPS_Math_Distance(lon.constData(), lat.constData(), N, dist.data(), maxError);
+    }
+}
@@ -0,0 +1,121 @@
+/**********************************************************************************************
+    Copyright (C) 2020 Oliver Eichler <oliver.eichler@gmx.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+**********************************************************************************************/
+
+#include "TestHelper.h"
+#include "test_QMapShack.h"
+
+#include "gis/db/IDBSqlite.h"
+#include "gis/wpt/CGisItemWpt.h"
+
+#include <QtSql>
+
+/// expose the migration of a database opened without the version check
+class CTestDBSqlite : public IDBSqlite
+{
+public:
+    void open(const QString& filename)
+    {
+        IDB::setup("qttDB");
+        db = QSqlDatabase::addDatabase("QSQLITE", "qttDB");
+        db.setDatabaseName(filename);
+        SUBVERIFY(db.open(), "Failed to open database");
+    }
+
+    using IDBSqlite::migrateDB7to8;
+};
+
+static void insertItem(QSqlDatabase& db, const IGisItem& item)
+{
+    QByteArray data;
+    QDataStream in(&data, QIODevice::WriteOnly);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setVersion(QDataStream::Qt_5_2);
+    in << item.getHistory();
+
+    QSqlQuery query(db);
+    query.prepare("INSERT INTO items (type, keyqms, icon, name, comment, data, hash, last_user, last_change) "
+                  "VALUES (:type, :keyqms, '', :name, '', :data, :hash, 'qtt', '2001-02-03 04:05:06')");
+    query.bindValue(":type",    item.type());
+    query.bindValue(":keyqms",  item.getKey().item);
+    query.bindValue(":name",    item.getName());
+    query.bindValue(":data",    data);
+    query.bindValue(":hash",    item.getHash());
+    SUBVERIFY(query.exec(), query.lastError().text());
+}
+
+void test_QMapShack::_migrateDB7to8()
+{
+    QTemporaryDir dir;
+    SUBVERIFY(dir.isValid(), "Failed to create temporary directory");
+
+    {
+        CTestDBSqlite testDB;
+        testDB.open(dir.filePath("qtt.db"));
+        QSqlDatabase& db = testDB.getDb();
+
+        // the items table and trigger of version 7
+        QSqlQuery query(db);
+        SUBVERIFY(query.exec("CREATE TABLE items ("
+                             "id             INTEGER PRIMARY KEY AUTOINCREMENT,"
+                             "type           INTEGER,"
+                             "keyqms         TEXT NOT NULL,"
+                             "date           DATETIME DEFAULT CURRENT_TIMESTAMP,"
+                             "icon           BLOB NOT NULL,"
+                             "name           TEXT NOT NULL,"
+                             "comment        TEXT,"
+                             "data           BLOB NOT NULL,"
+                             "hash           TEXT NOT NULL,"
+                             "last_user      TEXT NOT NULL DEFAULT 'QMapShack',"
+                             "last_change    DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,"
+                             "trash          DATETIME DEFAULT NULL"
+                             ")"), query.lastError().text());
+        SUBVERIFY(query.exec("CREATE TRIGGER items_update_last_change "
+                             "AFTER UPDATE ON items BEGIN "
+                             "UPDATE items SET last_change=CURRENT_TIMESTAMP WHERE id=NEW.id; "
+                             "END;"), query.lastError().text());
+
+        // a waypoint at 0°/0° has to get a bounding box, too
+        CGisItemWpt wpt1(QPointF(0, 0), NOFLOAT, QDateTime::currentDateTimeUtc(), "qtt wpt 1", "Default", nullptr);
+        CGisItemWpt wpt2(QPointF(12.1, 49.0), NOFLOAT, QDateTime::currentDateTimeUtc(), "qtt wpt 2", "Default", nullptr);
+        insertItem(db, wpt1);
+        insertItem(db, wpt2);
+
+        SUBVERIFY(testDB.migrateDB7to8(), "Migration failed");
+
+        SUBVERIFY(query.exec("SELECT last_user, last_change, west FROM items"), query.lastError().text());
+        int cnt = 0;
+        while(query.next())
+        {
+            cnt++;
+            VERIFY_EQUAL(QString("qtt"), query.value(0).toString());
+            VERIFY_EQUAL(QString("2001-02-03 04:05:06"), query.value(1).toString());
+            SUBVERIFY(!query.value(2).isNull(), "Item without bounding box");
+        }
+        VERIFY_EQUAL(2, cnt);
+
+        SUBVERIFY(query.exec("SELECT Count(*) FROM itemsbbox") && query.next(), query.lastError().text());
+        VERIFY_EQUAL(2, query.value(0).toInt());
+
+        // the trigger has to work as before
+        SUBVERIFY(query.exec("UPDATE items SET name='qtt' WHERE name='qtt wpt 1'"), query.lastError().text());
+        SUBVERIFY(query.exec("SELECT last_change FROM items WHERE name='qtt'") && query.next(), query.lastError().text());
+        SUBVERIFY(query.value(0).toString() != "2001-02-03 04:05:06", "Trigger items_update_last_change is missing");
+    }
+
+    QSqlDatabase::removeDatabase("qttDB");
+}
@@ -25,6 +25,8 @@ class IGisProject;
 class CGpxProject;
 class CQmsProject;
 class CSlfProject;
+class CSearchIndex;
+class IGisItem;
 
 extern QString testInput;
 
@@ -63,12 +65,29 @@ class test_QMapShack : public QObject
     // CQmsProject
     void _readQmsFile_1_6_0();
     void _writeReadQmsFile();
+    void _writeReadQmsWptImages();
 
     // CFitProject
     void _readValidFitFiles();
 
     // CGisItemTrk
     void _filterDeleteExtension();
+    void _saveLoadSecondaryData();
+
+    // GeoMath
+    void _distanceBatch();
+    void benchmarkDistanceBatch(qreal maxError);
+
+    // CSearchIndex
+    void _searchIndex();
+    void verifySearchIndex(CSearchIndex& index, const QList<IGisItem*>& items, const QString& str);
+
+    // CTileScheduler
+    void _tileScheduler();
+    void _tileSeeder();
+
+    // IDBSqlite
+    void _migrateDB7to8();
 
 private slots:
     void initTestCase();
@@ -78,8 +97,18 @@ private slots:
     void testwriteReadGpxFile()         { TCWRAPPER( _writeReadGpxFile()         ) }
     void testreadQmsFile_1_6_0()        { TCWRAPPER( _readQmsFile_1_6_0()        ) }
     void testwriteReadQmsFile()         { TCWRAPPER( _writeReadQmsFile()         ) }
+    void testwriteReadQmsWptImages()    { TCWRAPPER( _writeReadQmsWptImages()    ) }
     void testreadExtGarminTPX1_gpxtpx() { TCWRAPPER( _readExtGarminTPX1_gpxtpx() ) }
     void testreadExtGarminTPX1_tp1()    { TCWRAPPER( _readExtGarminTPX1_tp1()    ) }
     void testreadValidFitFiles()        { TCWRAPPER( _readValidFitFiles()        ) }
     void testfilterDeleteExtension()    { TCWRAPPER( _filterDeleteExtension()    ) }
+    void testsaveLoadSecondaryData()    { TCWRAPPER( _saveLoadSecondaryData()    ) }
+    void testdistanceBatch()            { TCWRAPPER( _distanceBatch()            ) }
+    void testsearchIndex()              { TCWRAPPER( _searchIndex()              ) }
+    void testtileScheduler()            { TCWRAPPER( _tileScheduler()            ) }
+    void testtileSeeder()               { TCWRAPPER( _tileSeeder()               ) }
+    void testmigrateDB7to8()            { TCWRAPPER( _migrateDB7to8()            ) }
+
+    void benchmarkDistanceBatchExact()  { benchmarkDistanceBatch(0);     }
+    void benchmarkDistanceBatchQuick()  { benchmarkDistanceBatch(0.001); }
 };